@@ -0,0 +1,231 @@
+/*
+  Copyright (C) 2011, 2012, 2013 Rene Halver, Michael Hofmann
+
+  This file is part of ScaFaCoS.
+
+  ScaFaCoS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ScaFaCoS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FCSTiming.h"
+
+
+/* initial number of trace events, the event buffer is doubled whenever it is full */
+#define TRACE_MIN_EVENTS  256
+
+
+static const char *phase_names[FCS_NUM_PHASES] = {
+  "total", "sort", "ghosts", "near", "spread", "fft", "solve", "interpolate", "back_sort" };
+
+static const char *counter_names[FCS_NUM_COUNTERS] = {
+  "near_pairs", "comm_bytes", "ghost_particles" };
+
+/* the record of the run that is currently executed */
+static fcs_timing_t *current = NULL;
+
+
+void fcs_timing_create(fcs_timing_t *timing)
+{
+  memset(timing, 0, sizeof(fcs_timing_t));
+}
+
+
+void fcs_timing_destroy(fcs_timing_t *timing)
+{
+  if (current == timing) current = NULL;
+
+  fcs_timing_set_trace(timing, NULL);
+}
+
+
+void fcs_timing_set_trace(fcs_timing_t *timing, const char *filename)
+{
+  if (timing->trace_file) free(timing->trace_file);
+  timing->trace_file = NULL;
+
+  if (timing->events) free(timing->events);
+  timing->events = NULL;
+  timing->nevents = timing->max_nevents = 0;
+
+  if (filename == NULL || filename[0] == '\0') return;
+
+  timing->trace_file = malloc(strlen(filename) + 1);
+  strcpy(timing->trace_file, filename);
+}
+
+
+void fcs_timing_begin(fcs_timing_t *timing)
+{
+  int i;
+
+
+  for (i = 0; i < FCS_NUM_PHASES; ++i) timing->timings[i] = 0;
+  for (i = 0; i < FCS_NUM_COUNTERS; ++i) timing->counters[i] = 0;
+
+  timing->nevents = 0;
+  timing->trace_origin = MPI_Wtime();
+
+  current = timing;
+}
+
+
+void fcs_timing_resume(fcs_timing_t *timing)
+{
+  /* the trace events of the last run are already written, continue with the same run number */
+  if (timing->trace_file && timing->trace_run > 0)
+  {
+    --timing->trace_run;
+    timing->trace_resumed = 1;
+  }
+
+  timing->nevents = 0;
+
+  current = timing;
+}
+
+
+void fcs_timing_end(fcs_timing_t *timing, MPI_Comm comm)
+{
+  int rank, i;
+  char *filename;
+  FILE *file;
+
+
+  if (current == timing) current = NULL;
+
+  if (timing->trace_file == NULL) return;
+
+  MPI_Comm_rank(comm, &rank);
+
+  filename = malloc(strlen(timing->trace_file) + 16);
+  sprintf(filename, "%s.%d", timing->trace_file, rank);
+
+  file = fopen(filename, (timing->trace_run == 0 && !timing->trace_resumed)?"w":"a");
+
+  timing->trace_resumed = 0;
+
+  free(filename);
+
+  ++timing->trace_run;
+
+  if (file == NULL) return;
+
+  /* format: run, phase, start time (relative to the begin of the run), duration */
+  for (i = 0; i < timing->nevents; ++i)
+    fprintf(file, "%lld %s %.9f %.9f\n", timing->trace_run - 1, phase_names[timing->events[i].phase], timing->events[i].start, timing->events[i].duration);
+
+  for (i = 0; i < FCS_NUM_COUNTERS; ++i)
+    fprintf(file, "%lld %s %lld\n", timing->trace_run - 1, counter_names[i], timing->counters[i]);
+
+  fclose(file);
+
+  timing->nevents = 0;
+}
+
+
+int fcs_timing_active(void)
+{
+  return (current != NULL);
+}
+
+
+double fcs_timing_start(void)
+{
+  if (current == NULL) return 0;
+
+  return MPI_Wtime();
+}
+
+
+void fcs_timing_stop(int phase, double start)
+{
+  if (current == NULL) return;
+
+  fcs_timing_add(phase, MPI_Wtime() - start);
+}
+
+
+void fcs_timing_add(int phase, double t)
+{
+  fcs_timing_t *timing = current;
+  double stop;
+  fcs_timing_event_t *event;
+
+
+  if (timing == NULL || phase < 0 || phase >= FCS_NUM_PHASES) return;
+
+  /* phases may be reported concurrently by several threads (e.g., near and far field overlap) */
+#ifdef _OPENMP
+  #pragma omp atomic
+#endif
+  timing->timings[phase] += t;
+
+  if (timing->trace_file == NULL) return;
+
+  stop = MPI_Wtime();
+
+#ifdef _OPENMP
+  #pragma omp critical (fcs_timing)
+#endif
+  {
+    if (timing->nevents >= timing->max_nevents)
+    {
+      timing->max_nevents = (timing->max_nevents > 0)?(2 * timing->max_nevents):TRACE_MIN_EVENTS;
+      timing->events = realloc(timing->events, timing->max_nevents * sizeof(fcs_timing_event_t));
+    }
+
+    event = &timing->events[timing->nevents++];
+    event->phase = phase;
+    event->start = stop - t - timing->trace_origin;
+    event->duration = t;
+  }
+}
+
+
+void fcs_timing_count(int counter, long long n)
+{
+  fcs_timing_t *timing = current;
+
+
+  if (timing == NULL || counter < 0 || counter >= FCS_NUM_COUNTERS) return;
+
+#ifdef _OPENMP
+  #pragma omp atomic
+#endif
+  timing->counters[counter] += n;
+}
+
+
+const char *fcs_timing_phase_name(int phase)
+{
+  if (phase < 0 || phase >= FCS_NUM_PHASES) return NULL;
+
+  return phase_names[phase];
+}
+
+
+const char *fcs_timing_counter_name(int counter)
+{
+  if (counter < 0 || counter >= FCS_NUM_COUNTERS) return NULL;
+
+  return counter_names[counter];
+}
@@ -0,0 +1,164 @@
+/*
+  Copyright (C) 2011, 2012, 2013 Rene Halver, Michael Hofmann
+
+  This file is part of ScaFaCoS.
+
+  ScaFaCoS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ScaFaCoS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef FCS_TIMING_INCLUDED
+#define FCS_TIMING_INCLUDED
+
+
+#include <mpi.h>
+
+#include "fcs_definitions.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief event of the trace of a run
+ */
+typedef struct _fcs_timing_event_t
+{
+  int phase;
+  double start, duration;
+
+} fcs_timing_event_t;
+
+/**
+ * @brief per-phase timings, counters, and (optional) trace of a run
+ *
+ * The record of a run is activated with fcs_timing_begin and deactivated with fcs_timing_end. The library
+ * components (gridsort, near, the solvers) report their phases and counters with fcs_timing_start/stop and
+ * fcs_timing_count to the currently active record. Without an active record, these functions do nothing.
+ */
+typedef struct _fcs_timing_t
+{
+  double timings[FCS_NUM_PHASES];
+  long long counters[FCS_NUM_COUNTERS];
+
+  char *trace_file;
+  long long trace_run;
+  int trace_resumed;
+  double trace_origin;
+  fcs_timing_event_t *events;
+  int nevents, max_nevents;
+
+} fcs_timing_t;
+
+
+/**
+ * @brief initialize a timing record (without trace)
+ * @param timing fcs_timing_t* timing record
+ */
+void fcs_timing_create(fcs_timing_t *timing);
+
+/**
+ * @brief free the resources of a timing record
+ * @param timing fcs_timing_t* timing record
+ */
+void fcs_timing_destroy(fcs_timing_t *timing);
+
+/**
+ * @brief enable or disable the trace of a timing record
+ * @param timing fcs_timing_t* timing record
+ * @param filename const char* base name of the trace files (the rank is appended), NULL disables the trace
+ */
+void fcs_timing_set_trace(fcs_timing_t *timing, const char *filename);
+
+/**
+ * @brief reset a timing record and make it the active record
+ * @param timing fcs_timing_t* timing record
+ */
+void fcs_timing_begin(fcs_timing_t *timing);
+
+/**
+ * @brief make the timing record of the last run active again without resetting it
+ *
+ * Used for operations that belong to the last run, but are performed after it (e.g., the resorting of additional
+ * particle data). Their trace events and the updated counters are appended to the trace of the last run.
+ * @param timing fcs_timing_t* timing record
+ */
+void fcs_timing_resume(fcs_timing_t *timing);
+
+/**
+ * @brief deactivate a timing record and append its trace events to the trace file of the local process
+ * @param timing fcs_timing_t* timing record
+ * @param comm MPI_Comm communicator that determines the rank of the local process
+ */
+void fcs_timing_end(fcs_timing_t *timing, MPI_Comm comm);
+
+/**
+ * @brief determine whether a timing record is active
+ * @return int 1 if a timing record is active, 0 otherwise
+ */
+int fcs_timing_active(void);
+
+/**
+ * @brief start the measurement of a phase
+ * @return double start time of the phase (0 if no timing record is active)
+ */
+double fcs_timing_start(void);
+
+/**
+ * @brief stop the measurement of a phase and add its duration to the active timing record
+ * @param phase int phase (see FCS_PHASE_* in fcs_definitions.h)
+ * @param start double start time of the phase returned by fcs_timing_start
+ */
+void fcs_timing_stop(int phase, double start);
+
+/**
+ * @brief add the duration of a phase measured with other timers to the active timing record
+ *
+ * Used by solvers that measure their phases with their own timers. The trace event of the phase ends at the time
+ * of the call.
+ * @param phase int phase (see FCS_PHASE_* in fcs_definitions.h)
+ * @param duration double duration of the phase
+ */
+void fcs_timing_add(int phase, double duration);
+
+/**
+ * @brief add to a counter of the active timing record
+ * @param counter int counter (see FCS_COUNTER_* in fcs_definitions.h)
+ * @param n long long value to add
+ */
+void fcs_timing_count(int counter, long long n);
+
+/**
+ * @brief return the name of a phase
+ * @param phase int phase
+ * @return const char* name of the phase, NULL if the phase is unknown
+ */
+const char *fcs_timing_phase_name(int phase);
+
+/**
+ * @brief return the name of a counter
+ * @param counter int counter
+ * @return const char* name of the counter, NULL if the counter is unknown
+ */
+const char *fcs_timing_counter_name(int counter);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
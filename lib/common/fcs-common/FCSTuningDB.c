@@ -0,0 +1,131 @@
+/*
+  Copyright (C) 2011, 2012, 2013 Rene Halver, Michael Hofmann
+
+  This file is part of ScaFaCoS.
+
+  ScaFaCoS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ScaFaCoS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FCSTuningDB.h"
+
+
+/* separator between the signature and the values of an entry */
+#define SEPARATOR  " : "
+
+/* maximum length of an entry (signature and values) */
+#define MAX_LINE_LENGTH  (FCS_TUNING_DB_SIGNATURE_LENGTH + 32 * (FCS_TUNING_DB_MAX_VALUES + 1))
+
+
+void fcs_tuning_db_signature(char *signature, const char *method, const fcs_float *box_a, const fcs_float *box_b, const fcs_float *box_c,
+  const fcs_int *periodicity, long long total_particles, fcs_float sum_q2, fcs_int tolerance_type, fcs_float tolerance, int nprocs, const char *params)
+{
+  /* the sum of the squared charges is rounded, since it may differ slightly with the number of processes and the distribution of the particles */
+  snprintf(signature, FCS_TUNING_DB_SIGNATURE_LENGTH,
+    "%s box=%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e periodicity=%d,%d,%d n=%lld sum_q2=%.6e tolerance=%d,%.6e procs=%d params=%s",
+    method,
+    (double) box_a[0], (double) box_a[1], (double) box_a[2],
+    (double) box_b[0], (double) box_b[1], (double) box_b[2],
+    (double) box_c[0], (double) box_c[1], (double) box_c[2],
+    (int) periodicity[0], (int) periodicity[1], (int) periodicity[2],
+    total_particles, (double) sum_q2, (int) tolerance_type, (double) tolerance, nprocs,
+    (params && params[0] != '\0')?params:"none");
+}
+
+
+int fcs_tuning_db_lookup(const char *filename, const char *signature, fcs_float *values, int nvalues)
+{
+  FILE *file;
+  char line[MAX_LINE_LENGTH], *cur, *next;
+  size_t signature_length;
+  int found, n, i;
+  double v[FCS_TUNING_DB_MAX_VALUES];
+
+
+  if (filename == NULL || filename[0] == '\0' || nvalues > FCS_TUNING_DB_MAX_VALUES) return 0;
+
+  file = fopen(filename, "r");
+
+  if (file == NULL) return 0;
+
+  signature_length = strlen(signature);
+
+  found = 0;
+
+  while (fgets(line, MAX_LINE_LENGTH, file))
+  {
+    if (strncmp(line, signature, signature_length) != 0 || strncmp(line + signature_length, SEPARATOR, strlen(SEPARATOR)) != 0) continue;
+
+    cur = line + signature_length + strlen(SEPARATOR);
+
+    n = strtol(cur, &next, 10);
+    if (next == cur || n != nvalues) continue;
+
+    for (i = 0; i < nvalues; ++i)
+    {
+      cur = next;
+      v[i] = strtod(cur, &next);
+      if (next == cur) break;
+    }
+
+    /* skip incomplete entries (e.g., truncated by a concurrent append), the last complete entry wins */
+    if (i < nvalues || strcmp(next + strspn(next, " \t\r"), "\n") != 0) continue;
+
+    for (i = 0; i < nvalues; ++i) values[i] = v[i];
+
+    found = 1;
+  }
+
+  fclose(file);
+
+  return found;
+}
+
+
+int fcs_tuning_db_store(const char *filename, const char *signature, const fcs_float *values, int nvalues)
+{
+  FILE *file;
+  char line[MAX_LINE_LENGTH];
+  int n, i;
+
+
+  if (filename == NULL || filename[0] == '\0' || nvalues > FCS_TUNING_DB_MAX_VALUES) return 0;
+
+  n = snprintf(line, MAX_LINE_LENGTH, "%s" SEPARATOR "%d", signature, nvalues);
+  for (i = 0; i < nvalues && n < MAX_LINE_LENGTH; ++i) n += snprintf(line + n, MAX_LINE_LENGTH - n, " %.17e", (double) values[i]);
+
+  if (n >= MAX_LINE_LENGTH - 1) return 0;
+
+  line[n++] = '\n';
+  line[n] = '\0';
+
+  file = fopen(filename, "a");
+
+  if (file == NULL) return 0;
+
+  /* write the entry at once, such that concurrent jobs do not mix their entries */
+  fputs(line, file);
+
+  fclose(file);
+
+  return 1;
+}
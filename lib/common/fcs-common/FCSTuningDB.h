@@ -0,0 +1,96 @@
+/*
+  Copyright (C) 2011, 2012, 2013 Rene Halver, Michael Hofmann
+
+  This file is part of ScaFaCoS.
+
+  ScaFaCoS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ScaFaCoS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef FCS_TUNING_DB_INCLUDED
+#define FCS_TUNING_DB_INCLUDED
+
+
+#include "fcs_definitions.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* maximum length of a system signature (including the terminating zero) */
+#define FCS_TUNING_DB_SIGNATURE_LENGTH  1024
+
+/* maximum number of tuned values of an entry */
+#define FCS_TUNING_DB_MAX_VALUES  32
+
+
+/*
+ * The tuning database is a text file with one entry per line. Each entry consists of the signature of a system
+ * and the values of the parameters that were determined by the tuning of a method for this system:
+ *
+ *   <signature> : <number of values> <value 1> <value 2> ...
+ *
+ * New entries are always appended (with a single write) and the last matching entry of the file is used. Thus,
+ * several jobs can share a database and a forced re-tuning replaces an older entry without rewriting the file.
+ * The functions are not collective, they are supposed to be called by a single process (i.e., the master process)
+ * and the results have to be distributed by the method.
+ */
+
+/**
+ * @brief create the signature of a system
+ * @param signature char* buffer of FCS_TUNING_DB_SIGNATURE_LENGTH characters receiving the signature
+ * @param method const char* name of the method
+ * @param box_a const fcs_float* first base vector of the system box
+ * @param box_b const fcs_float* second base vector of the system box
+ * @param box_c const fcs_float* third base vector of the system box
+ * @param periodicity const fcs_int* periodicity of the system
+ * @param total_particles long long total number of (charged) particles
+ * @param sum_q2 fcs_float sum of the squared charges
+ * @param tolerance_type fcs_int type of the tolerance
+ * @param tolerance fcs_float value of the tolerance
+ * @param nprocs int number of processes
+ * @param params const char* method-specific description of the parameters that were not tuned (may be NULL)
+ */
+void fcs_tuning_db_signature(char *signature, const char *method, const fcs_float *box_a, const fcs_float *box_b, const fcs_float *box_c,
+  const fcs_int *periodicity, long long total_particles, fcs_float sum_q2, fcs_int tolerance_type, fcs_float tolerance, int nprocs, const char *params);
+
+/**
+ * @brief look up the tuned values of a system
+ * @param filename const char* name of the database file
+ * @param signature const char* signature of the system
+ * @param values fcs_float* array receiving the tuned values
+ * @param nvalues int number of values
+ * @return int 1 if a matching entry with nvalues values was found, 0 otherwise
+ */
+int fcs_tuning_db_lookup(const char *filename, const char *signature, fcs_float *values, int nvalues);
+
+/**
+ * @brief append the tuned values of a system to the database
+ * @param filename const char* name of the database file
+ * @param signature const char* signature of the system
+ * @param values const fcs_float* tuned values
+ * @param nvalues int number of values
+ * @return int 1 if the entry was written, 0 otherwise
+ */
+int fcs_tuning_db_store(const char *filename, const char *signature, const fcs_float *values, int nvalues);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
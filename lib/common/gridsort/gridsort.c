@@ -30,6 +30,7 @@
 #include <mpi.h>
 
 #include "common/fcs-common/FCSCommon.h"
+#include "common/fcs-common/FCSTiming.h"
 
 #include "sl_forw.h"
 #include "sl_back_fp.h"
@@ -58,6 +59,9 @@
 #define GRID_DATA_ZSLICES_HIGH  (7 * 3)
 #define GRID_DATA_LAST          (8 * 3)
 
+/* number of histogram bins per process (and dimension) used for balancing the bounds */
+#define GRIDSORT_BALANCE_NBINS  64
+
 
 #undef BOUNDS_XYZ2COORDS_TRICLINIC
 #define BOUNDS_XYZ2COORDS_NAME  bounds_xyz2coords
@@ -222,6 +226,7 @@ void fcs_gridsort_create(fcs_gridsort_t *gs)
   gs->nresort_particles = -1;
 
   gs->max_particle_move = -1;
+  gs->stable_ghosts = 0;
   gs->nprocs = -1;
   gs->procs = NULL;
 
@@ -271,6 +276,118 @@ void fcs_gridsort_set_bounds(fcs_gridsort_t *gs, fcs_float *lower_bounds, fcs_fl
 }
 
 
+fcs_int fcs_gridsort_balance_bounds(fcs_gridsort_t *gs, fcs_float *weights, MPI_Comm comm)
+{
+  fcs_int i, j, k, d, nbins[3], bins_offset[3], total_nbins;
+  int cart_dims[3], cart_periods[3], cart_coords[3], topo_status;
+  fcs_int periodicity[3];
+  fcs_float iv[9], *p, v, w, *local_hist, *global_hist, *hist, sum, target, min_width, prev, lower, upper;
+  int b;
+
+
+  MPI_Topo_test(comm, &topo_status);
+
+  if (topo_status != MPI_CART)
+  {
+    fprintf(stderr, "ERROR: no Cartesian communicator available for gridsort!\n");
+    return -1;
+  }
+
+  MPI_Cart_get(comm, 3, cart_dims, cart_periods, cart_coords);
+
+  total_nbins = 0;
+  for (d = 0; d < 3; ++d)
+  {
+    periodicity[d] = (gs->d.periodicity[d])?cart_periods[d]:0;
+    nbins[d] = GRIDSORT_BALANCE_NBINS * cart_dims[d];
+    bins_offset[d] = total_nbins;
+    total_nbins += nbins[d];
+  }
+
+  local_hist = malloc(2 * total_nbins * sizeof(fcs_float));
+  global_hist = local_hist + total_nbins;
+
+  for (i = 0; i < total_nbins; ++i) local_hist[i] = 0;
+
+  invert_3x3(gs->d.box_a, gs->d.box_b, gs->d.box_c, iv);
+
+  /* weighted histogram of the particle positions in normalized box coordinates for each dimension */
+  for (i = 0; i < gs->noriginal_particles; ++i)
+  {
+    p = &gs->original_positions[3 * i];
+    w = (weights)?weights[i]:1.0;
+
+    for (d = 0; d < 3; ++d)
+    {
+      v = (p[0] - gs->d.box_base[0]) * iv[d + 0] + (p[1] - gs->d.box_base[1]) * iv[d + 3] + (p[2] - gs->d.box_base[2]) * iv[d + 6];
+
+      if (periodicity[d]) v -= fcs_floor(v);
+
+      b = (int) (v * nbins[d]);
+      b = z_minmax(0, b, nbins[d] - 1);
+
+      local_hist[bins_offset[d] + b] += w;
+    }
+  }
+
+  MPI_Allreduce(local_hist, global_hist, total_nbins, FCS_MPI_FLOAT, MPI_SUM, comm);
+
+  /* place the splitting planes of each dimension at the weighted quantiles, every process keeps at least one bin */
+  for (d = 0; d < 3; ++d)
+  {
+    hist = &global_hist[bins_offset[d]];
+    min_width = 1.0 / nbins[d];
+
+    sum = 0;
+    for (j = 0; j < nbins[d]; ++j) sum += hist[j];
+
+    lower = 0.0;
+    upper = 1.0;
+
+    if (sum > 0)
+    {
+      j = 0;
+      w = 0;
+      prev = 0.0;
+      for (k = 1; k <= cart_coords[d] + 1 && k < cart_dims[d]; ++k)
+      {
+        target = sum * k / cart_dims[d];
+
+        while (j < nbins[d] - 1 && w + hist[j] < target) w += hist[j++];
+
+        v = (j + ((hist[j] > 0)?(target - w) / hist[j]:0)) * min_width;
+        v = z_max(v, prev + min_width);
+        v = z_min(v, 1.0 - (cart_dims[d] - k) * min_width);
+
+        if (k == cart_coords[d]) lower = v;
+        else if (k == cart_coords[d] + 1) upper = v;
+
+        prev = v;
+      }
+
+    } else
+    {
+      lower = (fcs_float) cart_coords[d] / cart_dims[d];
+      if (cart_coords[d] + 1 < cart_dims[d]) upper = (fcs_float) (cart_coords[d] + 1) / cart_dims[d];
+    }
+
+    gs->d.lower_bounds[d] = lower;
+    gs->d.upper_bounds[d] = upper;
+  }
+
+  free(local_hist);
+
+  INFO_CMD(
+    int comm_rank;
+    MPI_Comm_rank(comm, &comm_rank);
+    printf(INFO_PRINT_PREFIX "%d: balanced bounds: [%" FCS_LMOD_FLOAT "f,%" FCS_LMOD_FLOAT "f] x [%" FCS_LMOD_FLOAT "f,%" FCS_LMOD_FLOAT "f] x [%" FCS_LMOD_FLOAT "f,%" FCS_LMOD_FLOAT "f]\n",
+      comm_rank, gs->d.lower_bounds[0], gs->d.upper_bounds[0], gs->d.lower_bounds[1], gs->d.upper_bounds[1], gs->d.lower_bounds[2], gs->d.upper_bounds[2]);
+  );
+
+  return 0;
+}
+
+
 void fcs_gridsort_set_zslices(fcs_gridsort_t *gs, fcs_int local_nzslices, fcs_int ghost_nzslices)
 {
   gs->local_nzslices = local_nzslices;
@@ -305,6 +422,12 @@ void fcs_gridsort_set_max_particle_move(fcs_gridsort_t *gs, fcs_float max_partic
 }
 
 
+void fcs_gridsort_set_stable_ghosts(fcs_gridsort_t *gs, fcs_int stable_ghosts)
+{
+  gs->stable_ghosts = stable_ghosts;
+}
+
+
 void fcs_gridsort_get_sorted_particles(fcs_gridsort_t *gs, fcs_int *nparticles, fcs_int *max_nparticles, fcs_float **positions, fcs_float **charges, fcs_gridsort_index_t **indices)
 {
   if (nparticles) *nparticles = gs->nsorted_particles;
@@ -838,6 +961,26 @@ static void verify_proclist(fcs_int nprocs, int *procs, int size, int rank, MPI_
 #endif /* GRIDSORT_PROCLIST */
 
 
+/* report the particles of other processes (i.e., with an index of another process) and optionally the ghost particles to the active timing record */
+static void count_particles(fcs_int nparticles, fcs_gridsort_index_t *indices, int rank, size_t particle_size, int with_ghosts)
+{
+  fcs_int i;
+  long long nremote = 0, nghosts = 0;
+
+
+  if (!fcs_timing_active()) return;
+
+  for (i = 0; i < nparticles; ++i)
+  {
+    if (!GRIDSORT_INDEX_IS_VALID(indices[i])) ++nghosts;
+    else if (GRIDSORT_INDEX_GET_PROC(indices[i]) != rank) ++nremote;
+  }
+
+  fcs_timing_count(FCS_COUNTER_COMM_BYTES, nremote * particle_size);
+  if (with_ghosts) fcs_timing_count(FCS_COUNTER_GHOST_PARTICLES, nghosts);
+}
+
+
 fcs_int fcs_gridsort_sort_forward(fcs_gridsort_t *gs, fcs_float ghost_range, MPI_Comm comm)
 {
   int comm_size, comm_rank;
@@ -880,6 +1023,8 @@ fcs_int fcs_gridsort_sort_forward(fcs_gridsort_t *gs, fcs_float ghost_range, MPI
 
   fcs_forw_slint_t old_minalloc;
   double old_overalloc;
+
+  double timing = fcs_timing_start();
   
 #ifdef DO_TIMING
   double t[2] = { 0, 0 };
@@ -1320,6 +1465,8 @@ fcs_int fcs_gridsort_sort_forward(fcs_gridsort_t *gs, fcs_float ghost_range, MPI
 
   gs->nsorted_real_particles = sout0.size;
 
+  count_particles(gs->nsorted_particles, gs->sorted_indices, comm_rank, sizeof(fcs_gridsort_index_t) + 4 * sizeof(fcs_float), 1);
+
 #ifdef PRINT_FORWARD_SORTED
   print_particles(gs->nsorted_particles, gs->sorted_positions, comm_size, comm_rank, comm);
 #endif
@@ -1333,6 +1480,8 @@ fcs_int fcs_gridsort_sort_forward(fcs_gridsort_t *gs, fcs_float ghost_range, MPI
       printf(TIMING_PRINT_PREFIX "fcs_gridsort_sort_forward: %f  %f\n", t[0], t[1]);
   );
 
+  fcs_timing_stop(FCS_PHASE_SORT, timing);
+
   return 0;
 }
 
@@ -1460,6 +1609,8 @@ fcs_int fcs_gridsort_create_ghosts(fcs_gridsort_t *gs, fcs_float ghost_range, MP
 
   MPI_Status status;
 
+  double timing = fcs_timing_start();
+
 
   MPI_Comm_size(comm, &comm_size);
   MPI_Comm_rank(comm, &comm_rank);
@@ -1553,6 +1704,9 @@ fcs_int fcs_gridsort_create_ghosts(fcs_gridsort_t *gs, fcs_float ghost_range, MP
 
     fcs_forw_elements_realloc(&s, fcs_forw_elem_get_size(&s) + rcounts[0] + rcounts[1], SLCM_ALL);
 
+    fcs_timing_count(FCS_COUNTER_GHOST_PARTICLES, rcounts[0] + rcounts[1]);
+    fcs_timing_count(FCS_COUNTER_COMM_BYTES, (((neighbors[2 * d + 1] != comm_rank)?rcounts[0]:0) + ((neighbors[2 * d + 0] != comm_rank)?rcounts[1]:0)) * (sizeof(fcs_gridsort_index_t) + 4 * sizeof(fcs_float)));
+
     forw_sendrecv(&s, scounts[0], displs[1], neighbors[2 * d + 0], &s, rcounts[0], s.size, neighbors[2 * d + 1], comm, &received);
     if (periodic[2 * d + 1]) set_periodics(&s, rcounts[0], s.size, 2 * d + 0); else set_ghosts(&s, rcounts[0], s.size);
     s.size += rcounts[0];
@@ -1572,10 +1726,64 @@ fcs_int fcs_gridsort_create_ghosts(fcs_gridsort_t *gs, fcs_float ghost_range, MP
 
   gs->nsorted_real_particles = s.size;
 
+  fcs_timing_stop(FCS_PHASE_GHOSTS, timing);
+
   return 0;
 }
 
 
+static void separate_ghosts_stable(fcs_gridsort_t *gs)
+{
+  fcs_int i, nreal, nghost;
+  fcs_gridsort_index_t *ghost_indices;
+  fcs_float *ghost_positions, *ghost_charges;
+
+
+  nghost = 0;
+  for (i = 0; i < gs->nsorted_particles; ++i)
+  if (GRIDSORT_IS_GHOST(gs->sorted_indices[i])) ++nghost;
+
+  /* keep the order of the real and the ghost particles (i.e., subsequent sorts of already sorted particles result in the same order) */
+  ghost_indices = malloc(nghost * sizeof(fcs_gridsort_index_t));
+  ghost_positions = malloc(3 * nghost * sizeof(fcs_float));
+  ghost_charges = malloc(nghost * sizeof(fcs_float));
+
+  nreal = nghost = 0;
+  for (i = 0; i < gs->nsorted_particles; ++i)
+  {
+    if (GRIDSORT_IS_GHOST(gs->sorted_indices[i]))
+    {
+      ghost_indices[nghost] = gs->sorted_indices[i];
+      ghost_positions[3 * nghost + 0] = gs->sorted_positions[3 * i + 0];
+      ghost_positions[3 * nghost + 1] = gs->sorted_positions[3 * i + 1];
+      ghost_positions[3 * nghost + 2] = gs->sorted_positions[3 * i + 2];
+      ghost_charges[nghost] = gs->sorted_charges[i];
+      ++nghost;
+
+    } else
+    {
+      gs->sorted_indices[nreal] = gs->sorted_indices[i];
+      gs->sorted_positions[3 * nreal + 0] = gs->sorted_positions[3 * i + 0];
+      gs->sorted_positions[3 * nreal + 1] = gs->sorted_positions[3 * i + 1];
+      gs->sorted_positions[3 * nreal + 2] = gs->sorted_positions[3 * i + 2];
+      gs->sorted_charges[nreal] = gs->sorted_charges[i];
+      ++nreal;
+    }
+  }
+
+  memcpy(&gs->sorted_indices[nreal], ghost_indices, nghost * sizeof(fcs_gridsort_index_t));
+  memcpy(&gs->sorted_positions[3 * nreal], ghost_positions, 3 * nghost * sizeof(fcs_float));
+  memcpy(&gs->sorted_charges[nreal], ghost_charges, nghost * sizeof(fcs_float));
+
+  free(ghost_indices);
+  free(ghost_positions);
+  free(ghost_charges);
+
+  gs->nsorted_real_particles = nreal;
+  gs->nsorted_ghost_particles = nghost;
+}
+
+
 void fcs_gridsort_separate_ghosts(fcs_gridsort_t *gs)
 {
   fcs_int l, h;
@@ -1583,6 +1791,12 @@ void fcs_gridsort_separate_ghosts(fcs_gridsort_t *gs)
   fcs_float tf;
 
 
+  if (gs->stable_ghosts)
+  {
+    separate_ghosts_stable(gs);
+    return;
+  }
+
   l = 0;
   h = gs->nsorted_particles - 1;
 
@@ -1780,6 +1994,8 @@ fcs_int fcs_gridsort_sort_random(fcs_gridsort_t *gs, MPI_Comm comm)
 
   fcs_forw_slint_t old_minalloc;
   double old_overalloc;
+
+  double timing = fcs_timing_start();
   
 #ifdef DO_TIMING
   double t[2] = { 0, 0 };
@@ -1845,11 +2061,15 @@ fcs_int fcs_gridsort_sort_random(fcs_gridsort_t *gs, MPI_Comm comm)
 
   gs->nsorted_real_particles = sout0.size;
 
+  count_particles(gs->nsorted_particles, gs->sorted_indices, comm_rank, sizeof(fcs_gridsort_index_t) + 4 * sizeof(fcs_float), 1);
+
   fcs_forw_mpi_datatypes_release();
 
   TIMING_SYNC(comm); TIMING_STOP(t[0]);
 
   TIMING_CMD(if (comm_rank == 0) printf(TIMING_PRINT_PREFIX "fcs_gridsort_sort_random: %f  %f\n", t[0], t[1]););
+
+  fcs_timing_stop(FCS_PHASE_SORT, timing);
   
   return 0;
 }
@@ -1937,6 +2157,8 @@ fcs_int fcs_gridsort_sort_backward(fcs_gridsort_t *gs, MPI_Comm comm)
   fcs_int local_packed, global_packed, original_packed;
 #endif
 
+  double timing = fcs_timing_start();
+
 #ifdef DO_TIMING
   double t[2] = { 0, 0 };
 #endif
@@ -1947,6 +2169,9 @@ fcs_int fcs_gridsort_sort_backward(fcs_gridsort_t *gs, MPI_Comm comm)
   MPI_Comm_size(comm, &comm_size);
   MPI_Comm_rank(comm, &comm_rank);
 
+  /* the results of the particles of other processes are sent back */
+  count_particles(gs->nsorted_real_particles, gs->sorted_indices, comm_rank, sizeof(fcs_gridsort_index_t) + ((gs->original_field)?3:0) * sizeof(fcs_float) + ((gs->original_potentials)?1:0) * sizeof(fcs_float), 0);
+
   if (gs->original_field && gs->original_potentials) type = 0;
   else if (gs->original_field && !gs->original_potentials) type = 1;
   else if (!gs->original_field && gs->original_potentials) type = 2;
@@ -2118,6 +2343,8 @@ fcs_int fcs_gridsort_sort_backward(fcs_gridsort_t *gs, MPI_Comm comm)
       printf(TIMING_PRINT_PREFIX "fcs_gridsort_sort_backward: %f  %f\n", t[0], t[1]);
   );
 
+  fcs_timing_stop(FCS_PHASE_BACK_SORT, timing);
+
   return 0;
 }
 
@@ -83,6 +83,7 @@ typedef struct _fcs_gridsort_t
   fcs_int nresort_particles;
 
   fcs_float max_particle_move;
+  fcs_int stable_ghosts;
   fcs_int nprocs;
   int *procs;
 
@@ -138,6 +139,15 @@ void fcs_gridsort_set_system(fcs_gridsort_t *gs, const fcs_float *box_base, cons
  */
 void fcs_gridsort_set_bounds(fcs_gridsort_t *gs, fcs_float *lower_bounds, fcs_float *upper_bounds);
 
+/**
+ * @brief balance the lower and upper bounds of the processes within the grid according to the (weighted) particle distribution, the splitting planes of each dimension are placed such that each process slab contains an equal share of the particle weights, the resulting bounds are set for the local process as with fcs_gridsort_set_bounds
+ * @param gs fcs_gridsort_t* gridsort object (particles and system have to be set)
+ * @param weights fcs_float* weight (e.g., measured computational cost) of each local particle (can be NULL, then each particle has weight 1)
+ * @param comm MPI_Comm Cartesian communicator used for the subsequent fcs_gridsort_sort_forward
+ * @return fcs_int 0 on success, -1 on error
+ */
+fcs_int fcs_gridsort_balance_bounds(fcs_gridsort_t *gs, fcs_float *weights, MPI_Comm comm);
+
 /**
  * @brief set number of zslices per process and the number of ghost zslices
  * @param gs fcs_gridsort_t* gridsort object
@@ -181,6 +191,13 @@ void fcs_gridsort_set_particles(fcs_gridsort_t *gs, fcs_int nparticles, fcs_int
  */
 void fcs_gridsort_set_max_particle_move(fcs_gridsort_t *gs, fcs_float max_particle_move);
 
+/**
+ * @brief set whether separating real and ghost particles keeps their order (e.g., required for reusing a Verlet list), default is 0 (faster in-place separation)
+ * @param gs fcs_gridsort_t* gridsort object
+ * @param stable_ghosts fcs_int whether the order is kept (1) or not (0)
+ */
+void fcs_gridsort_set_stable_ghosts(fcs_gridsort_t *gs, fcs_int stable_ghosts);
+
 /**
  * @brief get information of sorted particles
  * @param gs fcs_gridsort_t* gridsort object
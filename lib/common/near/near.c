@@ -24,11 +24,17 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 #include <mpi.h>
 
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
 #include "common/fcs-common/FCSCommon.h"
+#include "common/fcs-common/FCSTiming.h"
 
 #include "common/gridsort/gridsort.h"
 
@@ -232,6 +238,8 @@ void fcs_near_create(fcs_near_t *near)
   near->compute_potential_3diff = NULL;
   near->compute_field_potential_3diff = NULL;
 
+  near->compute_field_potential_batch = NULL;
+
   near->compute_loop = NULL;
 
   near->box_base[0] = near->box_base[1] = near->box_base[2] = 0;
@@ -256,6 +264,10 @@ void fcs_near_create(fcs_near_t *near)
 
   near->resort = 0;
   near->gridsort_resort = FCS_GRIDSORT_RESORT_NULL;
+
+  near->num_threads = 1;
+
+  near->verlet = NULL;
 }
 
 
@@ -269,6 +281,8 @@ void fcs_near_destroy(fcs_near_t *near)
   near->compute_potential_3diff = NULL;
   near->compute_field_potential_3diff = NULL;
 
+  near->compute_field_potential_batch = NULL;
+
   near->compute_loop = NULL;
 
   near->box_base[0] = near->box_base[1] = near->box_base[2] = 0;
@@ -329,6 +343,52 @@ void fcs_near_set_field_potential_3diff(fcs_near_t *near, fcs_near_field_potenti
 }
 
 
+void fcs_near_set_field_potential_batch(fcs_near_t *near, fcs_near_field_potential_batch_f compute_field_potential_batch)
+{
+  near->compute_field_potential_batch = compute_field_potential_batch;
+}
+
+
+void fcs_near_set_num_threads(fcs_near_t *near, fcs_int num_threads)
+{
+  near->num_threads = num_threads;
+}
+
+
+void fcs_near_verlet_create(fcs_near_verlet_t *verlet, fcs_float skin)
+{
+  verlet->skin = skin;
+  verlet->cutoff = -1;
+
+  verlet->nparticles = verlet->nghosts = -1;
+  verlet->positions = verlet->ghost_positions = NULL;
+
+  verlet->nreal_pairs = verlet->max_nreal_pairs = 0;
+  verlet->real_pairs = NULL;
+  verlet->nghost_pairs = verlet->max_nghost_pairs = 0;
+  verlet->ghost_pairs = NULL;
+
+  verlet->nbuilds = verlet->nreuses = 0;
+}
+
+
+void fcs_near_verlet_destroy(fcs_near_verlet_t *verlet)
+{
+  if (verlet->positions) free(verlet->positions);
+  if (verlet->ghost_positions) free(verlet->ghost_positions);
+  if (verlet->real_pairs) free(verlet->real_pairs);
+  if (verlet->ghost_pairs) free(verlet->ghost_pairs);
+
+  fcs_near_verlet_create(verlet, verlet->skin);
+}
+
+
+void fcs_near_set_verlet(fcs_near_t *near, fcs_near_verlet_t *verlet)
+{
+  near->verlet = verlet;
+}
+
+
 void fcs_near_set_loop(fcs_near_t *near, fcs_near_loop_f compute_loop)
 {
   near->compute_loop = compute_loop;
@@ -612,18 +672,153 @@ static void find_neighbours(fcs_int nneighbours, fcs_int *neighbours, box_t *box
 }
 
 
+/* number of particle pairs passed at once to the batched field and potential computations */
+#define BATCH_SIZE  256
+
+typedef struct
+{
+  fcs_int n;
+  fcs_int i[BATCH_SIZE], j[BATCH_SIZE];
+  fcs_float d[3][BATCH_SIZE], r[BATCH_SIZE];
+  fcs_float f[BATCH_SIZE], p[BATCH_SIZE];
+
+} batch_t;
+
+
+static void compute_batch(batch_t *b, fcs_float *charges0, fcs_float *field0, fcs_float *potentials0, fcs_float *charges1, fcs_near_t *near, const void *near_param)
+{
+  fcs_int k, i, j;
+  fcs_float fx;
+
+
+  if (b->n == 0) return;
+
+  near->compute_field_potential_batch(near_param, b->n, b->r, (field0)?b->f:NULL, (potentials0)?b->p:NULL);
+
+  if (charges1 == NULL)
+  {
+    /* pairs of real particles, update both particles */
+    if (field0)
+    for (k = 0; k < b->n; ++k)
+    {
+      i = b->i[k]; j = b->j[k];
+      fx = b->f[k] / b->r[k];
+      field0[3 * i + 0] += fx * charges0[j] * b->d[0][k];
+      field0[3 * i + 1] += fx * charges0[j] * b->d[1][k];
+      field0[3 * i + 2] += fx * charges0[j] * b->d[2][k];
+      field0[3 * j + 0] -= fx * charges0[i] * b->d[0][k];
+      field0[3 * j + 1] -= fx * charges0[i] * b->d[1][k];
+      field0[3 * j + 2] -= fx * charges0[i] * b->d[2][k];
+    }
+
+    if (potentials0)
+    for (k = 0; k < b->n; ++k)
+    {
+      i = b->i[k]; j = b->j[k];
+      potentials0[i] += b->p[k] * charges0[j];
+      potentials0[j] += b->p[k] * charges0[i];
+    }
+
+  } else
+  {
+    /* pairs of real and ghost particles, update only the real particle */
+    if (field0)
+    for (k = 0; k < b->n; ++k)
+    {
+      i = b->i[k]; j = b->j[k];
+      fx = b->f[k] * charges1[j] / b->r[k];
+      field0[3 * i + 0] += fx * b->d[0][k];
+      field0[3 * i + 1] += fx * b->d[1][k];
+      field0[3 * i + 2] += fx * b->d[2][k];
+    }
+
+    if (potentials0)
+    for (k = 0; k < b->n; ++k)
+    {
+      i = b->i[k]; j = b->j[k];
+      potentials0[i] += b->p[k] * charges1[j];
+    }
+  }
+
+  b->n = 0;
+}
+
+
+static void compute_near_batch(fcs_float *positions0, fcs_float *charges0, fcs_float *field0, fcs_float *potentials0, fcs_int start0, fcs_int size0,
+                               fcs_float *positions1, fcs_float *charges1, fcs_int start1, fcs_int size1, fcs_float cutoff, fcs_near_t *near, const void *near_param)
+{
+  fcs_int i, j, j0, k;
+  fcs_float *p1;
+  const fcs_float cutoff2 = cutoff * cutoff;
+  fcs_float dx, dy, dz, r2;
+  batch_t b;
+
+
+  if (field0 == NULL && potentials0 == NULL) return;
+
+  if (positions1 == NULL || charges1 == NULL)
+  {
+    p1 = positions0;
+    charges1 = NULL;
+
+  } else p1 = positions1;
+
+  b.n = 0;
+
+  for (i = start0; i < start0 + size0; ++i)
+  {
+    j0 = (charges1 == NULL && start0 == start1)?(i + 1):(start1);
+
+    for (j = j0; j < start1 + size1; ++j)
+    {
+      dx = p1[3 * j + 0] - positions0[3 * i + 0];
+      dy = p1[3 * j + 1] - positions0[3 * i + 1];
+      dz = p1[3 * j + 2] - positions0[3 * i + 2];
+      r2 = dx * dx + dy * dy + dz * dz;
+
+      if (r2 > cutoff2) continue;
+
+      k = b.n++;
+      b.i[k] = i;
+      b.j[k] = j;
+      b.d[0][k] = dx;
+      b.d[1][k] = dy;
+      b.d[2][k] = dz;
+      b.r[k] = r2;
+
+      if (b.n == BATCH_SIZE)
+      {
+        for (k = 0; k < b.n; ++k) b.r[k] = fcs_sqrt(b.r[k]);
+        compute_batch(&b, charges0, field0, potentials0, charges1, near, near_param);
+      }
+    }
+  }
+
+  for (k = 0; k < b.n; ++k) b.r[k] = fcs_sqrt(b.r[k]);
+  compute_batch(&b, charges0, field0, potentials0, charges1, near, near_param);
+}
+
+
 static void compute_near(fcs_float *positions0, fcs_float *charges0, fcs_float *field0, fcs_float *potentials0, fcs_int start0, fcs_int size0,
                          fcs_float *positions1, fcs_float *charges1, fcs_int start1, fcs_int size1, fcs_float cutoff, fcs_near_t *near, const void *near_param)
 {
   FCS_NEAR_LOOP_HEAD();
 
 
+  fcs_timing_count(FCS_COUNTER_NEAR_PAIRS, (charges1 == NULL && start0 == start1)?((long long) size0 * (size0 - 1) / 2):((long long) size0 * size1));
+
   if (near->compute_loop)
   {
     near->compute_loop(positions0, charges0, field0, potentials0, start0, size0, positions1, charges1, start1, size1, cutoff, near_param);
     return;
   }
 
+  if (near->compute_field_potential_batch)
+  {
+    compute_near_batch(positions0, charges0, field0, potentials0, start0, size0, positions1, charges1, start1, size1, cutoff, near, near_param);
+    return;
+  }
+
 /*  printf("compute: %" FCS_LMOD_INT "d / %" FCS_LMOD_INT "d vs. %" FCS_LMOD_INT "d / %" FCS_LMOD_INT "d\n", start0, size0, start1, size1);*/
 
   if (near->compute_field_potential)
@@ -671,6 +866,367 @@ static void compute_near(fcs_float *positions0, fcs_float *charges0, fcs_float *
 }
 
 
+typedef struct
+{
+  box_t box;
+  fcs_int index;
+
+} box_index_t;
+
+
+static int compare_box_index(const void *a, const void *b)
+{
+  const box_index_t *x = a, *y = b;
+
+  if (x->box != y->box) return (x->box < y->box)?-1:1;
+
+  return (x->index < y->index)?-1:((x->index > y->index)?1:0);
+}
+
+
+/* put the particles into boxes of size range without changing their order, return the particles sorted by boxes as pairs of box number and particle index */
+static box_index_t *create_box_indices(fcs_int n, fcs_float *positions, box_t **boxes, fcs_float *box_base, fcs_float range)
+{
+  fcs_int i;
+  fcs_float base[3], irange;
+  box_index_t *bi;
+
+
+  irange = 1.0 / range;
+
+  base[0] = box_base[0] - 2 * range;
+  base[1] = box_base[1] - 2 * range;
+  base[2] = box_base[2] - 2 * range;
+
+  bi = malloc((n + 1) * sizeof(box_index_t));
+  *boxes = malloc((n + 1) * sizeof(box_t));
+
+  for (i = 0; i < n; ++i)
+  {
+    bi[i].box = BOX_SET((int) ((positions[3 * i + 0] - base[0]) * irange), (int) ((positions[3 * i + 1] - base[1]) * irange), (int) ((positions[3 * i + 2] - base[2]) * irange));
+    bi[i].index = i;
+  }
+
+  qsort(bi, n, sizeof(box_index_t), compare_box_index);
+
+  for (i = 0; i < n; ++i) (*boxes)[i] = bi[i].box;
+
+  /* sentinel with max. box number */
+  (*boxes)[n] = BOX_SET(BOX_MASK, BOX_MASK, BOX_MASK);
+
+  return bi;
+}
+
+
+static void add_pair(fcs_int *npairs, fcs_int *max_npairs, fcs_int **pairs, fcs_int i, fcs_int j)
+{
+  if (*npairs >= *max_npairs)
+  {
+    *max_npairs = (*max_npairs > 0)?(2 * *max_npairs):1024;
+    *pairs = realloc(*pairs, 2 * *max_npairs * sizeof(fcs_int));
+  }
+
+  (*pairs)[2 * *npairs + 0] = i;
+  (*pairs)[2 * *npairs + 1] = j;
+  ++*npairs;
+}
+
+
+static void add_pairs(fcs_int *npairs, fcs_int *max_npairs, fcs_int **pairs, fcs_float *positions0, box_index_t *bi0, fcs_int start0, fcs_int size0,
+                      fcs_float *positions1, box_index_t *bi1, fcs_int start1, fcs_int size1, fcs_float range2)
+{
+  fcs_int k, l, i, j;
+  fcs_float dx, dy, dz;
+
+
+  for (k = start0; k < start0 + size0; ++k)
+  for (l = ((positions1 == NULL && start0 == start1)?(k + 1):(start1)); l < start1 + size1; ++l)
+  {
+    i = bi0[k].index;
+    j = (positions1 == NULL)?bi0[l].index:bi1[l].index;
+
+    dx = ((positions1 == NULL)?positions0:positions1)[3 * j + 0] - positions0[3 * i + 0];
+    dy = ((positions1 == NULL)?positions0:positions1)[3 * j + 1] - positions0[3 * i + 1];
+    dz = ((positions1 == NULL)?positions0:positions1)[3 * j + 2] - positions0[3 * i + 2];
+
+    if (dx * dx + dy * dy + dz * dz > range2) continue;
+
+    add_pair(npairs, max_npairs, pairs, i, j);
+  }
+}
+
+
+/* create the lists of real-real and real-ghost particle pairs that are within cutoff + skin */
+static void verlet_build(fcs_near_verlet_t *verlet, fcs_near_t *near, fcs_float cutoff)
+{
+  const fcs_float range = cutoff + verlet->skin;
+  const fcs_int max_nboxes = 27;
+  fcs_int i, current_last, current_start, current_size;
+  fcs_int real_lasts[max_nboxes], real_starts[max_nboxes], real_sizes[max_nboxes];
+  fcs_int ghost_lasts[max_nboxes], ghost_starts[max_nboxes], ghost_sizes[max_nboxes];
+  box_t *real_boxes, *ghost_boxes;
+  box_index_t *real_bi, *ghost_bi;
+
+
+  verlet->nreal_pairs = verlet->nghost_pairs = 0;
+
+  if (near->nparticles <= 0) return;
+
+  real_bi = create_box_indices(near->nparticles, near->positions, &real_boxes, near->box_base, range);
+  if (near->nghosts > 0) ghost_bi = create_box_indices(near->nghosts, near->ghost_positions, &ghost_boxes, near->box_base, range);
+  else { ghost_bi = NULL; ghost_boxes = NULL; }
+
+  current_last = 0;
+  for (i = 0; i < max_nboxes; ++i) real_lasts[i] = ghost_lasts[i] = 0;
+
+  do
+  {
+    find_box(real_boxes, near->nparticles, real_boxes[current_last], current_last, &current_start, &current_size);
+
+    find_neighbours(nreal_neighbours, real_neighbours, real_boxes, near->nparticles, real_boxes[current_start], real_lasts, real_starts, real_sizes);
+    if (ghost_boxes) find_neighbours(nghost_neighbours, ghost_neighbours, ghost_boxes, near->nghosts, real_boxes[current_start], ghost_lasts, ghost_starts, ghost_sizes);
+
+    add_pairs(&verlet->nreal_pairs, &verlet->max_nreal_pairs, &verlet->real_pairs, near->positions, real_bi, current_start, current_size, NULL, NULL, current_start, current_size, range * range);
+    for (i = 0; i < nreal_neighbours; ++i)
+    {
+      add_pairs(&verlet->nreal_pairs, &verlet->max_nreal_pairs, &verlet->real_pairs, near->positions, real_bi, current_start, current_size, NULL, NULL, real_starts[i], real_sizes[i], range * range);
+      real_lasts[i] = real_starts[i] + real_sizes[i];
+    }
+
+    if (ghost_boxes)
+    for (i = 0; i < nghost_neighbours; ++i)
+    {
+      add_pairs(&verlet->nghost_pairs, &verlet->max_nghost_pairs, &verlet->ghost_pairs, near->positions, real_bi, current_start, current_size, near->ghost_positions, ghost_bi, ghost_starts[i], ghost_sizes[i], range * range);
+      ghost_lasts[i] = ghost_starts[i] + ghost_sizes[i];
+    }
+
+    current_last = current_start + current_size;
+
+  } while (current_last < near->nparticles);
+
+  free(real_bi);
+  free(real_boxes);
+  if (ghost_bi) free(ghost_bi);
+  if (ghost_boxes) free(ghost_boxes);
+}
+
+
+/* check whether the Verlet list is still valid, i.e., whether the particles at all positions of the particle arrays have moved less than half the skin since the list was created
+   (the particles do not have to be the same, because the list is still complete if all particles are within half the skin of the particles used to create it) */
+static fcs_int verlet_valid(fcs_near_verlet_t *verlet, fcs_near_t *near, fcs_float cutoff)
+{
+  fcs_int i;
+  fcs_float dx, dy, dz;
+  const fcs_float max_move2 = 0.25 * verlet->skin * verlet->skin;
+
+
+  if (verlet->cutoff != cutoff || verlet->nparticles != near->nparticles || verlet->nghosts != near->nghosts) return 0;
+
+  for (i = 0; i < near->nparticles; ++i)
+  {
+    dx = near->positions[3 * i + 0] - verlet->positions[3 * i + 0];
+    dy = near->positions[3 * i + 1] - verlet->positions[3 * i + 1];
+    dz = near->positions[3 * i + 2] - verlet->positions[3 * i + 2];
+    if (dx * dx + dy * dy + dz * dz > max_move2) return 0;
+  }
+
+  for (i = 0; i < near->nghosts; ++i)
+  {
+    dx = near->ghost_positions[3 * i + 0] - verlet->ghost_positions[3 * i + 0];
+    dy = near->ghost_positions[3 * i + 1] - verlet->ghost_positions[3 * i + 1];
+    dz = near->ghost_positions[3 * i + 2] - verlet->ghost_positions[3 * i + 2];
+    if (dx * dx + dy * dy + dz * dz > max_move2) return 0;
+  }
+
+  return 1;
+}
+
+
+static void verlet_store_particles(fcs_near_verlet_t *verlet, fcs_near_t *near, fcs_float cutoff)
+{
+  verlet->cutoff = cutoff;
+  verlet->nparticles = near->nparticles;
+  verlet->nghosts = near->nghosts;
+
+  verlet->positions = realloc(verlet->positions, (3 * near->nparticles + 1) * sizeof(fcs_float));
+  verlet->ghost_positions = realloc(verlet->ghost_positions, (3 * near->nghosts + 1) * sizeof(fcs_float));
+
+  memcpy(verlet->positions, near->positions, 3 * near->nparticles * sizeof(fcs_float));
+  memcpy(verlet->ghost_positions, near->ghost_positions, 3 * near->nghosts * sizeof(fcs_float));
+}
+
+
+static void compute_pairs(fcs_int npairs, fcs_int *pairs, fcs_float *positions0, fcs_float *charges0, fcs_float *field0, fcs_float *potentials0,
+                          fcs_float *positions1, fcs_float *charges1, fcs_float cutoff, fcs_near_t *near, const void *near_param)
+{
+  fcs_int i, j, k, l;
+  const fcs_float cutoff2 = cutoff * cutoff;
+  fcs_float dx, dy, dz, r2;
+  batch_t b;
+
+
+  if (positions1 == NULL) positions1 = positions0;
+
+  fcs_timing_count(FCS_COUNTER_NEAR_PAIRS, npairs);
+
+  b.n = 0;
+
+  for (l = 0; l < npairs; ++l)
+  {
+    i = pairs[2 * l + 0];
+    j = pairs[2 * l + 1];
+
+    dx = positions1[3 * j + 0] - positions0[3 * i + 0];
+    dy = positions1[3 * j + 1] - positions0[3 * i + 1];
+    dz = positions1[3 * j + 2] - positions0[3 * i + 2];
+    r2 = dx * dx + dy * dy + dz * dz;
+
+    if (r2 > cutoff2) continue;
+
+    k = b.n++;
+    b.i[k] = i;
+    b.j[k] = j;
+    b.d[0][k] = dx;
+    b.d[1][k] = dy;
+    b.d[2][k] = dz;
+    b.r[k] = r2;
+
+    if (b.n == BATCH_SIZE)
+    {
+      for (k = 0; k < b.n; ++k) b.r[k] = fcs_sqrt(b.r[k]);
+      compute_batch(&b, charges0, field0, potentials0, charges1, near, near_param);
+    }
+  }
+
+  for (k = 0; k < b.n; ++k) b.r[k] = fcs_sqrt(b.r[k]);
+  compute_batch(&b, charges0, field0, potentials0, charges1, near, near_param);
+}
+
+
+/* compute the near field interactions with the (reused or recreated) Verlet list */
+static void compute_verlet(fcs_near_t *near, fcs_int *periodicity, fcs_float cutoff, const void *compute_param)
+{
+  fcs_near_verlet_t *verlet = near->verlet;
+
+
+  if (periodicity[0] || periodicity[1] || periodicity[2])
+  {
+    if (near->indices) fcs_gridsort_unfold_periodic_particles(near->nparticles, near->indices, near->positions, near->box_a, near->box_b, near->box_c);
+    if (near->nghosts > 0 && near->ghost_indices) fcs_gridsort_unfold_periodic_particles(near->nghosts, near->ghost_indices, near->ghost_positions, near->box_a, near->box_b, near->box_c);
+  }
+
+  if (verlet_valid(verlet, near, cutoff)) ++verlet->nreuses;
+  else
+  {
+    verlet_store_particles(verlet, near, cutoff);
+    verlet_build(verlet, near, cutoff);
+    ++verlet->nbuilds;
+  }
+
+  compute_pairs(verlet->nreal_pairs, verlet->real_pairs, near->positions, near->charges, near->field, near->potentials, NULL, NULL, cutoff, near, compute_param);
+  if (near->nghosts > 0)
+    compute_pairs(verlet->nghost_pairs, verlet->ghost_pairs, near->positions, near->charges, near->field, near->potentials, near->ghost_positions, near->ghost_charges, cutoff, near, compute_param);
+}
+
+
+/* number of box colors, boxes with the same color are at least 3 boxes apart in one dimension */
+#define NCOLORS  27
+
+#define BOX_COLOR(_b_)  ((BOX_GET_X(_b_, 0) % 3) + 3 * (BOX_GET_X(_b_, 1) % 3) + 9 * (BOX_GET_X(_b_, 2) % 3))
+
+/* thread-parallel traversal of the boxes,
+   the boxes are processed color by color such that concurrently processed boxes never update the same (neighbouring) boxes */
+static void compute_boxes_colored(fcs_near_t *near, box_t *real_boxes, box_t *ghost_boxes, fcs_float cutoff, const void *compute_param, int num_threads)
+{
+  fcs_int i, j, nboxes, current_last;
+  const fcs_int max_nboxes = 27;
+  fcs_int real_lasts[max_nboxes], ghost_lasts[max_nboxes];
+  fcs_int *starts, *sizes, *order;
+  fcs_int *real_starts, *real_sizes, *ghost_starts, *ghost_sizes;
+  fcs_int color_displs[NCOLORS + 1];
+  int *colors;
+
+
+  if (near->nparticles <= 0) return;
+
+  /* count the (non-empty) boxes */
+  nboxes = 0;
+  for (i = 0; i < near->nparticles; ++i)
+  if (i == 0 || real_boxes[i] != real_boxes[i - 1]) ++nboxes;
+
+  starts = malloc(3 * nboxes * sizeof(fcs_int));
+  sizes = starts + nboxes;
+  order = sizes + nboxes;
+  colors = malloc(nboxes * sizeof(int));
+  real_starts = malloc(2 * nboxes * nreal_neighbours * sizeof(fcs_int));
+  real_sizes = real_starts + nboxes * nreal_neighbours;
+  if (ghost_boxes)
+  {
+    ghost_starts = malloc(2 * nboxes * nghost_neighbours * sizeof(fcs_int));
+    ghost_sizes = ghost_starts + nboxes * nghost_neighbours;
+
+  } else ghost_starts = ghost_sizes = NULL;
+
+  /* determine the boxes and their neighbours */
+  for (i = 0; i < max_nboxes; ++i) real_lasts[i] = ghost_lasts[i] = 0;
+  for (i = 0; i <= NCOLORS; ++i) color_displs[i] = 0;
+
+  current_last = 0;
+  for (j = 0; j < nboxes; ++j)
+  {
+    find_box(real_boxes, near->nparticles, real_boxes[current_last], current_last, &starts[j], &sizes[j]);
+
+    find_neighbours(nreal_neighbours, real_neighbours, real_boxes, near->nparticles, real_boxes[starts[j]], real_lasts, &real_starts[j * nreal_neighbours], &real_sizes[j * nreal_neighbours]);
+    for (i = 0; i < nreal_neighbours; ++i) real_lasts[i] = real_starts[j * nreal_neighbours + i] + real_sizes[j * nreal_neighbours + i];
+
+    if (ghost_boxes)
+    {
+      find_neighbours(nghost_neighbours, ghost_neighbours, ghost_boxes, near->nghosts, real_boxes[starts[j]], ghost_lasts, &ghost_starts[j * nghost_neighbours], &ghost_sizes[j * nghost_neighbours]);
+      for (i = 0; i < nghost_neighbours; ++i) ghost_lasts[i] = ghost_starts[j * nghost_neighbours + i] + ghost_sizes[j * nghost_neighbours + i];
+    }
+
+    colors[j] = BOX_COLOR(real_boxes[starts[j]]);
+    ++color_displs[colors[j] + 1];
+
+    current_last = starts[j] + sizes[j];
+  }
+
+  /* order the boxes by color */
+  for (i = 0; i < NCOLORS; ++i) color_displs[i + 1] += color_displs[i];
+  for (j = 0; j < nboxes; ++j) order[color_displs[colors[j]]++] = j;
+  for (i = NCOLORS; i > 0; --i) color_displs[i] = color_displs[i - 1];
+  color_displs[0] = 0;
+
+#pragma omp parallel num_threads(num_threads) private(i, j)
+  {
+    fcs_int c, k;
+
+    for (c = 0; c < NCOLORS; ++c)
+    {
+#pragma omp for schedule(dynamic)
+      for (k = color_displs[c]; k < color_displs[c + 1]; ++k)
+      {
+        j = order[k];
+
+        compute_near(near->positions, near->charges, near->field, near->potentials, starts[j], sizes[j], NULL, NULL, starts[j], sizes[j], cutoff, near, compute_param);
+
+        for (i = 0; i < nreal_neighbours; ++i)
+          compute_near(near->positions, near->charges, near->field, near->potentials, starts[j], sizes[j], NULL, NULL, real_starts[j * nreal_neighbours + i], real_sizes[j * nreal_neighbours + i], cutoff, near, compute_param);
+
+        if (ghost_boxes)
+        for (i = 0; i < nghost_neighbours; ++i)
+          compute_near(near->positions, near->charges, near->field, near->potentials, starts[j], sizes[j], near->ghost_positions, near->ghost_charges, ghost_starts[j * nghost_neighbours + i], ghost_sizes[j * nghost_neighbours + i], cutoff, near, compute_param);
+      }
+    }
+  }
+
+  free(starts);
+  free(colors);
+  free(real_starts);
+  if (ghost_starts) free(ghost_starts);
+}
+
+
 fcs_int fcs_near_compute(fcs_near_t *near,
                          fcs_float cutoff,
                          const void *compute_param,
@@ -687,6 +1243,9 @@ fcs_int fcs_near_compute(fcs_near_t *near,
   fcs_int ghost_lasts[max_nboxes], ghost_starts[max_nboxes], ghost_sizes[max_nboxes];
   fcs_int periodicity[3];
   int cart_dims[3], cart_periods[3], cart_coords[3], topo_status;
+  int num_threads;
+
+  double timing = fcs_timing_start();
 
 #ifdef DO_TIMING
   double _t, t[7] = { 0, 0, 0, 0, 0, 0, 0 };
@@ -737,6 +1296,16 @@ fcs_int fcs_near_compute(fcs_near_t *near,
     }
   );
 
+#ifndef BOX_SKIP_FORMAT
+  if (near->verlet && near->compute_field_potential_batch)
+  {
+    TIMING_SYNC(comm); TIMING_START(t[3]);
+    compute_verlet(near, periodicity, cutoff, compute_param);
+    TIMING_SYNC(comm); TIMING_STOP(t[3]);
+    goto exit;
+  }
+#endif
+
   real_boxes = malloc((near->nparticles + 1) * sizeof(box_t)); /* + 1 for a sentinel */
   if (near->nghosts > 0) ghost_boxes = malloc((near->nghosts + 1) * sizeof(box_t)); /* + 1 for a sentinel */
   else ghost_boxes = NULL;
@@ -773,6 +1342,22 @@ fcs_int fcs_near_compute(fcs_near_t *near,
 /*  for (i = 0; i < nlocal_particles; ++i)
     printf("%" FCS_LMOD_INT "d: %f,%f,%f  " box_fmt "  %lld\n", i, positions[3 * i + 0], positions[3 * i + 1], positions[3 * i + 2], box_val(&boxes[3 * i]), indices[i]);*/
 
+#ifdef _OPENMP
+  num_threads = (near->num_threads > 0)?near->num_threads:omp_get_max_threads();
+#else
+  num_threads = 1;
+#endif
+
+#ifndef BOX_SKIP_FORMAT
+  if (num_threads > 1)
+  {
+    TIMING_SYNC(comm); TIMING_START(t[3]);
+    compute_boxes_colored(near, real_boxes, ghost_boxes, cutoff, compute_param, num_threads);
+    TIMING_SYNC(comm); TIMING_STOP(t[3]);
+    goto free_boxes;
+  }
+#endif
+
   current_last = 0;
   for (i = 0; i < max_nboxes; ++i) real_lasts[i] = ghost_lasts[i] = 0;
 
@@ -819,6 +1404,7 @@ fcs_int fcs_near_compute(fcs_near_t *near,
   } while (current_last < near->nparticles);
   TIMING_SYNC(comm); TIMING_STOP(t[3]);
 
+free_boxes:
   free(real_boxes);
   if (ghost_boxes) free(ghost_boxes);
 
@@ -830,6 +1416,8 @@ exit:
       printf(TIMING_PRINT_PREFIX "fcs_near_compute: %f  %f  %f  %f  %f  %f  %f\n", t[0], t[1], t[2], t[3], t[4], t[5], t[6]);
   );
 
+  fcs_timing_stop(FCS_PHASE_NEAR, timing);
+
   return 0;
 }
 
@@ -1025,6 +1613,8 @@ fcs_int fcs_near_field_solver(fcs_near_t *near,
   fcs_near_set_potential_3diff(&near_s, near->compute_potential_3diff);
   fcs_near_set_field_potential_3diff(&near_s, near->compute_field_potential_3diff);
 
+  fcs_near_set_field_potential_batch(&near_s, near->compute_field_potential_batch);
+
   fcs_near_set_loop(&near_s, near->compute_loop);
 
   if (near->periodicity[0] < 0 || near->periodicity[1] < 0 || near->periodicity[2] < 0)
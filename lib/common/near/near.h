@@ -39,6 +39,8 @@ typedef fcs_float (*fcs_near_field_3diff_f)(const void *param, fcs_float dist, f
 typedef fcs_float (*fcs_near_potential_3diff_f)(const void *param, fcs_float dist, fcs_float dx, fcs_float dy, fcs_float dz);
 typedef void (*fcs_near_field_potential_3diff_f)(const void *param, fcs_float dist, fcs_float dx, fcs_float dy, fcs_float dz, fcs_float *f, fcs_float *p);
 
+typedef void (*fcs_near_field_potential_batch_f)(const void *param, fcs_int n, const fcs_float *dist, fcs_float *f, fcs_float *p);
+
 typedef void (*fcs_near_loop_f)(fcs_float *positions0, fcs_float *charges0, fcs_float *field0, fcs_float *potentials0, fcs_int start0, fcs_int size0,
                                 fcs_float *positions1, fcs_float *charges1, fcs_int start1, fcs_int size1, fcs_float cutoff, const void *near_param);
 
@@ -48,6 +50,24 @@ typedef fcs_gridsort_resort_t fcs_near_resort_t;
 #define FCS_NEAR_RESORT_NULL  FCS_GRIDSORT_RESORT_NULL
 
 
+/**
+ * @brief Verlet list object structure (list of particle pairs that is reused for several near field computations)
+ */
+typedef struct _fcs_near_verlet_t
+{
+  fcs_float skin, cutoff;
+
+  fcs_int nparticles, nghosts;
+  fcs_float *positions, *ghost_positions;
+
+  fcs_int nreal_pairs, max_nreal_pairs, *real_pairs;
+  fcs_int nghost_pairs, max_nghost_pairs, *ghost_pairs;
+
+  fcs_int nbuilds, nreuses;
+
+} fcs_near_verlet_t;
+
+
 /**
  * @brief near field solver object structure
  */
@@ -61,6 +81,8 @@ typedef struct _fcs_near_t
   fcs_near_potential_3diff_f compute_potential_3diff;
   fcs_near_field_potential_3diff_f compute_field_potential_3diff;
 
+  fcs_near_field_potential_batch_f compute_field_potential_batch;
+
   fcs_near_loop_f compute_loop;
 
   fcs_float box_base[3], box_a[3], box_b[3], box_c[3];
@@ -80,6 +102,10 @@ typedef struct _fcs_near_t
   fcs_int resort;
   fcs_gridsort_resort_t gridsort_resort;
 
+  fcs_int num_threads;
+
+  fcs_near_verlet_t *verlet;
+
 } fcs_near_t;
 
 
@@ -137,6 +163,48 @@ void fcs_near_set_potential_3diff(fcs_near_t *near, fcs_near_potential_3diff_f c
  */
 void fcs_near_set_field_potential_3diff(fcs_near_t *near, fcs_near_field_potential_3diff_f compute_field_potential_3diff);
 
+/**
+ * @brief set callback function for batched field and/or potential computations,
+ * the callback function receives the distances of a whole batch of particle pairs (i.e., the pairs of a box-pair within the cutoff range)
+ * and fills the arrays f and p (each can be NULL if not required) with the field and potential values of all distances
+ * @param near fcs_near_t near field solver object
+ * @param compute_field_potential_batch fcs_near_field_potential_batch_f callback function for batched field and/or potential computations
+ */
+void fcs_near_set_field_potential_batch(fcs_near_t *near, fcs_near_field_potential_batch_f compute_field_potential_batch);
+
+/**
+ * @brief set number of OpenMP threads for the computations,
+ * the callback functions have to be thread-safe if more than one thread is used
+ * @param near fcs_near_t near field solver object
+ * @param num_threads fcs_int number of threads, if num_threads <= 0 then the OpenMP default is used, default: num_threads = 1
+ */
+void fcs_near_set_num_threads(fcs_near_t *near, fcs_int num_threads);
+
+/**
+ * @brief create Verlet list object
+ * @param verlet fcs_near_verlet_t* Verlet list object
+ * @param skin fcs_float skin distance added to the cutoff range when the list of particle pairs is created
+ */
+void fcs_near_verlet_create(fcs_near_verlet_t *verlet, fcs_float skin);
+
+/**
+ * @brief destroy Verlet list object
+ * @param verlet fcs_near_verlet_t* Verlet list object
+ */
+void fcs_near_verlet_destroy(fcs_near_verlet_t *verlet);
+
+/**
+ * @brief set Verlet list object to use for the computations,
+ * the list of particle pairs stored in the Verlet list object is reused as long as the numbers of (real and ghost) particles are the same as when the list was created
+ * and no particle (i.e., the particle at the same position in the given arrays) has moved more than half the skin distance,
+ * otherwise the list is recreated, the given particles keep their order (i.e., they are not sorted into boxes),
+ * the ghost particles have to be given up to the cutoff range plus the skin distance,
+ * the Verlet list is only used with callback functions for batched computations (see fcs_near_set_field_potential_batch)
+ * @param near fcs_near_t near field solver object
+ * @param verlet fcs_near_verlet_t* Verlet list object, NULL disables the Verlet list
+ */
+void fcs_near_set_verlet(fcs_near_t *near, fcs_near_verlet_t *verlet);
+
 /**
  * @brief set callback function for whole loop of computations (created with FCS_NEAR_LOOP* macros)
  * @param near fcs_near_t near field solver object
@@ -33,6 +33,8 @@
 # include "zmpi_atasp.h"
 #endif
 
+#include "common/fcs-common/FCSTiming.h"
+
 #include "z_tools.h"
 #include "resort.h"
 
@@ -80,7 +82,8 @@
 #define TIMING_STOP_ADD(_t_, _r_)  TIMING_CMD(((_r_) += MPI_Wtime() - (_t_));)
 
 #define RESORT_PROCLIST
-/*#define RESORT_TPROC_EXDEF*/
+
+#define RESORT_PLAN_ARRAYS_INC  4
 
 
 fcs_resort_index_t *fcs_resort_indices_alloc(fcs_int nindices)
@@ -129,6 +132,14 @@ void fcs_resort_create(fcs_resort_t *resort)
 
   (*resort)->nprocs = -1;
   (*resort)->procs = NULL;
+
+  (*resort)->cache_comm = MPI_COMM_NULL;
+  (*resort)->cache_comm_size = 0;
+  (*resort)->cache_counts = NULL;
+  (*resort)->cache_send_pos = NULL;
+  (*resort)->cache_recv_pos = NULL;
+
+  (*resort)->plan = FCS_RESORT_PLAN_NULL;
 }
 
 
@@ -140,6 +151,10 @@ void fcs_resort_destroy(fcs_resort_t *resort)
 
   fcs_resort_set_proclists(*resort, -1, NULL);
 
+  fcs_resort_invalidate(*resort);
+
+  fcs_resort_plan_destroy(&(*resort)->plan);
+
   free(*resort);
 
   *resort = FCS_RESORT_NULL;
@@ -195,6 +210,8 @@ fcs_int fcs_resort_get_sorted_particles(fcs_resort_t resort)
 
 void fcs_resort_alloc_indices(fcs_resort_t resort)
 {
+  fcs_resort_invalidate(resort);
+
   if (resort->noriginal_particles < 0) return;
 
   resort->indices = fcs_resort_indices_alloc(resort->noriginal_particles);
@@ -203,6 +220,8 @@ void fcs_resort_alloc_indices(fcs_resort_t resort)
 
 void fcs_resort_free_indices(fcs_resort_t resort)
 {
+  fcs_resort_invalidate(resort);
+
   fcs_resort_indices_free(resort->indices);
 
   resort->indices = NULL;
@@ -220,6 +239,8 @@ void fcs_resort_set_proclists(fcs_resort_t resort, fcs_int nprocs, int *procs)
   fcs_int i;
 
 
+  fcs_resort_invalidate(resort);
+
   resort->nprocs = nprocs;
 
   if (resort->procs) free(resort->procs);
@@ -233,467 +254,471 @@ void fcs_resort_set_proclists(fcs_resort_t resort, fcs_int nprocs, int *procs)
 }
 
 
-static void copy_ints(fcs_int n, fcs_int *src, fcs_int *dst, fcs_int x, fcs_resort_index_t *indices)
+void fcs_resort_invalidate(fcs_resort_t resort)
 {
-  fcs_int i, j, k;
+  if (resort->cache_counts) free(resort->cache_counts);
+  if (resort->cache_send_pos) free(resort->cache_send_pos);
+  if (resort->cache_recv_pos) free(resort->cache_recv_pos);
 
+  if (resort->cache_comm != MPI_COMM_NULL) MPI_Comm_free(&resort->cache_comm);
 
-  if (indices)
-  {
-    for (i = 0; i < n; ++i)
-    {
-      k = FCS_RESORT_INDEX_GET_POS(indices[i]);
-
-      for (j = 0; j < x; ++j) dst[k * x + j] = src[i * x + j];
-    }
-
-  } else
-  {
-    memcpy(dst, src, n * x * sizeof(fcs_int));
-  }
+  resort->cache_comm = MPI_COMM_NULL;
+  resort->cache_comm_size = 0;
+  resort->cache_counts = NULL;
+  resort->cache_send_pos = NULL;
+  resort->cache_recv_pos = NULL;
 }
 
 
-static void pack_ints(fcs_int n, fcs_int *src, fcs_int x, fcs_resort_index_t *indices, char *dst)
+static void exchange(fcs_resort_t resort, void *send, void *recv, MPI_Datatype type, size_t extent, MPI_Comm comm)
 {
-  fcs_int i, j;
-  size_t offset;
-  
+  int comm_size, comm_rank;
+  int *scounts, *sdispls, *rcounts, *rdispls;
+  fcs_int i, nreqs;
+  MPI_Request *reqs;
 
-  offset = 0;
-  for (i = 0; i < n; ++i)
-  {
-    *((fcs_resort_index_t *) (dst + offset)) = indices[i];
-    offset += sizeof(fcs_resort_index_t);
-    
-    for (j = 0; j < x; ++j)
-    {
-      *((fcs_int *) (dst + offset)) = src[i * x + j];
-      offset += sizeof(fcs_int);
-    }
-  }
-}
 
+  comm_size = resort->cache_comm_size;
+  MPI_Comm_rank(comm, &comm_rank);
 
-static void unpack_ints(fcs_int n, char *src, fcs_int *dst, fcs_int x)
-{
-  fcs_int i, j, k;
-  size_t offset;
-  
+  scounts = resort->cache_counts + 0 * comm_size;
+  sdispls = resort->cache_counts + 1 * comm_size;
+  rcounts = resort->cache_counts + 2 * comm_size;
+  rdispls = resort->cache_counts + 3 * comm_size;
 
-  offset = 0;
-  for (i = 0; i < n; ++i)
+  if (fcs_timing_active())
   {
-    k = FCS_RESORT_INDEX_GET_POS(*((fcs_resort_index_t *) (src + offset)));
-    offset += sizeof(fcs_resort_index_t);
-    
-    for (j = 0; j < x; ++j)
-    {
-      dst[k * x + j] = *((fcs_int *) (src + offset));
-      offset += sizeof(fcs_int);
-    }
+    for (i = 0; i < comm_size; ++i)
+    if (i != comm_rank) fcs_timing_count(FCS_COUNTER_COMM_BYTES, (long long) scounts[i] * extent);
   }
-}
 
+#ifdef RESORT_PROCLIST
+  if (resort->nprocs >= 0)
+  {
+    reqs = malloc(2 * resort->nprocs * sizeof(MPI_Request));
 
-static void copy_floats(fcs_int n, fcs_float *src, fcs_float *dst, fcs_int x, fcs_resort_index_t *indices)
-{
-  fcs_int i, j, k;
+    nreqs = 0;
+    for (i = 0; i < resort->nprocs; ++i)
+    {
+      if (resort->procs[i] == comm_rank || rcounts[resort->procs[i]] <= 0) continue;
 
+      MPI_Irecv(((char *) recv) + rdispls[resort->procs[i]] * extent, rcounts[resort->procs[i]], type, resort->procs[i], 0, comm, &reqs[nreqs]);
+      ++nreqs;
+    }
 
-  if (indices)
-  {
-    for (i = 0; i < n; ++i)
+    for (i = 0; i < resort->nprocs; ++i)
     {
-      k = FCS_RESORT_INDEX_GET_POS(indices[i]);
+      if (resort->procs[i] == comm_rank || scounts[resort->procs[i]] <= 0) continue;
 
-      for (j = 0; j < x; ++j) dst[k * x + j] = src[i * x + j];
+      MPI_Isend(((char *) send) + sdispls[resort->procs[i]] * extent, scounts[resort->procs[i]], type, resort->procs[i], 0, comm, &reqs[nreqs]);
+      ++nreqs;
     }
 
+    memcpy(((char *) recv) + rdispls[comm_rank] * extent, ((char *) send) + sdispls[comm_rank] * extent, scounts[comm_rank] * extent);
+
+    MPI_Waitall(nreqs, reqs, MPI_STATUSES_IGNORE);
+
+    free(reqs);
+
   } else
+#endif
   {
-    memcpy(dst, src, n * x * sizeof(fcs_float));
+    MPI_Alltoallv(send, scounts, sdispls, type, recv, rcounts, rdispls, type, comm);
   }
 }
 
 
-static void pack_floats(fcs_int n, fcs_float *src, fcs_int x, fcs_resort_index_t *indices, char *dst)
+static fcs_int create_cache(fcs_resort_t resort, MPI_Comm comm)
 {
-  fcs_int i, j;
-  size_t offset;
-  
+  int comm_size, comm_rank;
+  int *scounts, *sdispls, *rcounts, *rdispls, *next;
+  fcs_int i, p, nsorted, nreqs;
+  fcs_resort_index_t *send_pos, *recv_pos;
+  MPI_Request *reqs;
+  int local_mismatch, global_mismatch, comm_cmp;
 
-  offset = 0;
-  for (i = 0; i < n; ++i)
-  {
-    *((fcs_resort_index_t *) (dst + offset)) = indices[i];
-    offset += sizeof(fcs_resort_index_t);
-    
-    for (j = 0; j < x; ++j)
-    {
-      *((fcs_float *) (dst + offset)) = src[i * x + j];
-      offset += sizeof(fcs_float);
-    }
-  }
-}
+#ifdef DO_TIMING
+  double t[3] = { 0, 0, 0 };
+#endif
 
 
-static void unpack_floats(fcs_int n, char *src, fcs_float *dst, fcs_int x)
-{
-  fcs_int i, j, k;
-  size_t offset;
-  
+  MPI_Comm_size(comm, &comm_size);
+  MPI_Comm_rank(comm, &comm_rank);
 
-  offset = 0;
-  for (i = 0; i < n; ++i)
+  /* the cached exchange pattern is valid for the same processes in the same order (i.e., also for duplicates of the communicator) */
+  if (resort->cache_counts && resort->cache_comm != MPI_COMM_NULL)
   {
-    k = FCS_RESORT_INDEX_GET_POS(*((fcs_resort_index_t *) (src + offset)));
-    offset += sizeof(fcs_resort_index_t);
-    
-    for (j = 0; j < x; ++j)
-    {
-      dst[k * x + j] = *((fcs_float *) (src + offset));
-      offset += sizeof(fcs_float);
-    }
+    MPI_Comm_compare(comm, resort->cache_comm, &comm_cmp);
+    if (comm_cmp == MPI_IDENT || comm_cmp == MPI_CONGRUENT) return 0;
   }
-}
 
+  TIMING_SYNC(comm); TIMING_START(t[0]);
 
-static void copy_bytes(fcs_int n, char *src, char *dst, char x, fcs_resort_index_t *indices)
-{
-  fcs_int i, j, k;
+  fcs_resort_invalidate(resort);
 
+  nsorted = fcs_resort_get_sorted_particles(resort);
 
-  if (indices)
-  {
-    for (i = 0; i < n; ++i)
-    {
-      k = FCS_RESORT_INDEX_GET_POS(indices[i]);
+  MPI_Comm_dup(comm, &resort->cache_comm);
+  resort->cache_comm_size = comm_size;
+  resort->cache_counts = malloc(4 * comm_size * sizeof(int));
+  resort->cache_send_pos = malloc(resort->noriginal_particles * sizeof(fcs_int));
+  resort->cache_recv_pos = malloc(nsorted * sizeof(fcs_int));
 
-      for (j = 0; j < x; ++j) dst[k * x + j] = src[i * x + j];
-    }
+  scounts = resort->cache_counts + 0 * comm_size;
+  sdispls = resort->cache_counts + 1 * comm_size;
+  rcounts = resort->cache_counts + 2 * comm_size;
+  rdispls = resort->cache_counts + 3 * comm_size;
 
-  } else
-  {
-    memcpy(dst, src, n * x * sizeof(fcs_float));
-  }
-}
+  /* determine the number of particles per target process and the position of each particle in the send buffer */
+  for (p = 0; p < comm_size; ++p) scounts[p] = 0;
 
+  for (i = 0; i < resort->noriginal_particles; ++i) ++scounts[FCS_RESORT_INDEX_GET_PROC(resort->indices[i])];
 
-static void pack_bytes(fcs_int n, char *src, fcs_int x, fcs_resort_index_t *indices, char *dst)
-{
-  fcs_int i, j;
-  size_t offset;
-  
+  sdispls[0] = 0;
+  for (p = 1; p < comm_size; ++p) sdispls[p] = sdispls[p - 1] + scounts[p - 1];
+
+  next = malloc(comm_size * sizeof(int));
+  for (p = 0; p < comm_size; ++p) next[p] = sdispls[p];
 
-  offset = 0;
-  for (i = 0; i < n; ++i)
+  send_pos = malloc(resort->noriginal_particles * sizeof(fcs_resort_index_t));
+  recv_pos = malloc(nsorted * sizeof(fcs_resort_index_t));
+
+  for (i = 0; i < resort->noriginal_particles; ++i)
   {
-    *((fcs_resort_index_t *) (dst + offset)) = indices[i];
-    offset += sizeof(fcs_resort_index_t);
-    
-    for (j = 0; j < x; ++j)
-    {
-      *((char *) (dst + offset)) = src[i * x + j];
-      offset += sizeof(char);
-    }
+    p = FCS_RESORT_INDEX_GET_PROC(resort->indices[i]);
+
+    resort->cache_send_pos[i] = next[p];
+    send_pos[next[p]] = FCS_RESORT_INDEX_GET_POS(resort->indices[i]);
+    ++next[p];
   }
-}
 
+  free(next);
 
-static void unpack_bytes(fcs_int n, char *src, char *dst, fcs_int x)
-{
-  fcs_int i, j, k;
-  size_t offset;
-  
+  TIMING_SYNC(comm); TIMING_START(t[1]);
 
-  offset = 0;
-  for (i = 0; i < n; ++i)
+  /* exchange the number of particles per process */
+#ifdef RESORT_PROCLIST
+  if (resort->nprocs >= 0)
   {
-    k = FCS_RESORT_INDEX_GET_POS(*((fcs_resort_index_t *) (src + offset)));
-    offset += sizeof(fcs_resort_index_t);
-    
-    for (j = 0; j < x; ++j)
+    for (p = 0; p < comm_size; ++p) rcounts[p] = 0;
+
+    reqs = malloc(2 * resort->nprocs * sizeof(MPI_Request));
+
+    nreqs = 0;
+    for (i = 0; i < resort->nprocs; ++i)
     {
-      dst[k * x + j] = *((char *) (src + offset));
-      offset += sizeof(char);
-    }
-  }
-}
+      if (resort->procs[i] == comm_rank) continue;
 
+      MPI_Irecv(&rcounts[resort->procs[i]], 1, MPI_INT, resort->procs[i], 0, comm, &reqs[nreqs]);
+      ++nreqs;
+      MPI_Isend(&scounts[resort->procs[i]], 1, MPI_INT, resort->procs[i], 0, comm, &reqs[nreqs]);
+      ++nreqs;
+    }
 
-static int resort_tproc(void *b,
-#if MPI_VERSION >= 3
-  MPI_Count x,
-#else
-  ZMPI_Count x,
-#endif
-  void *tproc_data)
-{
-  size_t type_size = *((fcs_int *) tproc_data);
+    rcounts[comm_rank] = scounts[comm_rank];
 
-  fcs_resort_index_t idx = *((fcs_resort_index_t *) (((char *) b) + (x * type_size)));
+    MPI_Waitall(nreqs, reqs, MPI_STATUSES_IGNORE);
 
-  return FCS_RESORT_INDEX_GET_PROC(idx);
-}
+    free(reqs);
 
-#ifdef RESORT_TPROC_EXDEF
-ZMPI_TPROC_EXDEF_DEFINE_TPROC(resort_tproc_exdef, resort_tproc, static)
+  } else
 #endif
+  {
+    MPI_Alltoall(scounts, 1, MPI_INT, rcounts, 1, MPI_INT, comm);
+  }
 
-static void resort_ints(fcs_resort_t resort, fcs_int *src, fcs_int *dst, fcs_int x, MPI_Comm comm)
-{
-  void *send, *recv;
-  size_t type_size = sizeof(fcs_resort_index_t) + x * sizeof(fcs_int);
+  rdispls[0] = 0;
+  for (p = 1; p < comm_size; ++p) rdispls[p] = rdispls[p - 1] + rcounts[p - 1];
 
-  MPI_Datatype type;
-  int lengths[2] = { 1, x };
-  MPI_Aint displs[2] = { 0, sizeof(fcs_resort_index_t) };
-  MPI_Datatype types[2] = { FCS_MPI_RESORT_INDEX, FCS_MPI_INT };
+  /* the resort indices do not match the number of sorted particles (on any process) */
+  local_mismatch = (rdispls[comm_size - 1] + rcounts[comm_size - 1] != nsorted);
+  MPI_Allreduce(&local_mismatch, &global_mismatch, 1, MPI_INT, MPI_LOR, comm);
 
-  ZMPI_Tproc tproc;
+  if (global_mismatch)
+  {
+    free(send_pos);
+    free(recv_pos);
 
-#ifdef DO_TIMING
-  double t[4] = { 0, 0, 0, 0 };
-#endif
+    fcs_resort_invalidate(resort);
 
+    return -1;
+  }
 
-  TIMING_SYNC(comm); TIMING_START(t[0]);
+  TIMING_SYNC(comm); TIMING_STOP(t[1]);
 
-  send = malloc(resort->noriginal_particles * type_size);
-  recv = malloc(resort->nsorted_particles * type_size);
+  TIMING_SYNC(comm); TIMING_START(t[2]);
 
-  TIMING_SYNC(comm); TIMING_START(t[1]);
+  /* exchange the target positions of the particles */
+  exchange(resort, send_pos, recv_pos, FCS_MPI_RESORT_INDEX, sizeof(fcs_resort_index_t), comm);
 
-  pack_ints(resort->noriginal_particles, src, x, resort->indices, send);
+  for (i = 0; i < nsorted; ++i) resort->cache_recv_pos[i] = recv_pos[i];
 
-  TIMING_SYNC(comm); TIMING_STOP(t[1]);
+  TIMING_SYNC(comm); TIMING_STOP(t[2]);
 
-  MPI_Type_create_struct(2, lengths, displs, types, &type);
-  MPI_Type_commit(&type);
+  free(send_pos);
+  free(recv_pos);
 
-  ZMPI_Tproc_create_tproc(&tproc, resort_tproc, ZMPI_TPROC_RESET_NULL,
-#ifdef RESORT_TPROC_EXDEF
-  resort_tproc_exdef
-#else
-  ZMPI_TPROC_EXDEF_NULL
-#endif
+  TIMING_SYNC(comm); TIMING_STOP(t[0]);
+
+  TIMING_CMD(
+    if (comm_rank == 0)
+      printf(TIMING_PRINT_PREFIX "create_cache: %f  %f  %f\n", t[0], t[1], t[2]);
   );
 
-#ifdef RESORT_PROCLIST
-  if (resort->nprocs >= 0) ZMPI_Tproc_set_proclists(tproc, resort->nprocs, resort->procs, resort->nprocs, resort->procs, comm);
-#endif
+  return 0;
+}
 
-  TIMING_SYNC(comm); TIMING_START(t[2]);
 
-  ZMPI_Alltoall_specific(send, resort->noriginal_particles, type, recv, resort->nsorted_particles, type, tproc, &type_size, comm,
-#if MPI_VERSION >= 3
-    MPI_STATUS_IGNORE
-#else
-    ZMPI_STATUS_IGNORE
-#endif
-    );
+void fcs_resort_plan_create(fcs_resort_plan_t *plan, fcs_resort_t resort)
+{
+  *plan = malloc(sizeof(**plan));
 
-  TIMING_SYNC(comm); TIMING_STOP(t[2]);
+  (*plan)->resort = resort;
 
-  ZMPI_Tproc_free(&tproc);
+  (*plan)->narrays = (*plan)->max_narrays = 0;
+  (*plan)->arrays = NULL;
 
-  MPI_Type_free(&type);
+  (*plan)->record_size = 0;
+  (*plan)->record_type = MPI_DATATYPE_NULL;
+}
 
-  TIMING_SYNC(comm); TIMING_START(t[3]);
 
-  unpack_ints(resort->nsorted_particles, recv, (dst)?dst:src, x);
+void fcs_resort_plan_destroy(fcs_resort_plan_t *plan)
+{
+  if (*plan == FCS_RESORT_PLAN_NULL) return;
 
-  TIMING_SYNC(comm); TIMING_STOP(t[3]);
-  
-  free(send);
-  free(recv);
+  if ((*plan)->arrays) free((*plan)->arrays);
 
-  TIMING_SYNC(comm); TIMING_STOP(t[0]);
+  if ((*plan)->record_type != MPI_DATATYPE_NULL) MPI_Type_free(&(*plan)->record_type);
 
-  TIMING_CMD(
-    if (comm_rank == 0)
-      printf(TIMING_PRINT_PREFIX "resort_ints: %f  %f  %f  %f\n", t[0], t[1], t[2], t[3]);
-  );
+  free(*plan);
+
+  *plan = FCS_RESORT_PLAN_NULL;
 }
 
 
-static void resort_floats(fcs_resort_t resort, fcs_float *src, fcs_float *dst, fcs_int x, MPI_Comm comm)
+static void plan_add(fcs_resort_plan_t plan, void *src, void *dst, fcs_int n, size_t size, MPI_Datatype type)
 {
-  void *send, *recv;
-  size_t type_size = sizeof(fcs_resort_index_t) + x * sizeof(fcs_float);
+  struct _fcs_resort_plan_array_t *a;
 
-  MPI_Datatype type;
-  int lengths[2] = { 1, x };
-  MPI_Aint displs[2] = { 0, sizeof(fcs_resort_index_t) };
-  MPI_Datatype types[2] = { FCS_MPI_RESORT_INDEX, FCS_MPI_FLOAT };
 
-  ZMPI_Tproc tproc;
+  if (plan->narrays >= plan->max_narrays)
+  {
+    plan->max_narrays += RESORT_PLAN_ARRAYS_INC;
+    plan->arrays = realloc(plan->arrays, plan->max_narrays * sizeof(struct _fcs_resort_plan_array_t));
+  }
 
-#ifdef DO_TIMING
-  double t[4] = { 0, 0, 0, 0 };
-#endif
+  a = &plan->arrays[plan->narrays];
+  ++plan->narrays;
 
+  a->src = src;
+  a->dst = dst;
+  a->n = n;
+  a->size = size;
+  a->type = type;
 
-  TIMING_SYNC(comm); TIMING_START(t[0]);
+  /* values are stored aligned to their size, the target positions of the particles are part of the cached exchange pattern */
+  a->offset = ((plan->record_size + size - 1) / size) * size;
 
-  send = malloc(resort->noriginal_particles * type_size);
-  recv = malloc(resort->nsorted_particles * type_size);
+  plan->record_size = a->offset + n * size;
 
-  TIMING_SYNC(comm); TIMING_START(t[1]);
+  /* the record datatype has to be recreated */
+  if (plan->record_type != MPI_DATATYPE_NULL) MPI_Type_free(&plan->record_type);
+}
 
-  pack_floats(resort->noriginal_particles, src, x, resort->indices, send);
 
-  TIMING_SYNC(comm); TIMING_STOP(t[1]);
+void fcs_resort_plan_add_ints(fcs_resort_plan_t plan, fcs_int *src, fcs_int *dst, fcs_int n)
+{
+  plan_add(plan, src, dst, n, sizeof(fcs_int), FCS_MPI_INT);
+}
 
-  MPI_Type_create_struct(2, lengths, displs, types, &type);
-  MPI_Type_commit(&type);
 
-  ZMPI_Tproc_create_tproc(&tproc, resort_tproc, ZMPI_TPROC_RESET_NULL, ZMPI_TPROC_EXDEF_NULL);
+void fcs_resort_plan_add_floats(fcs_resort_plan_t plan, fcs_float *src, fcs_float *dst, fcs_int n)
+{
+  plan_add(plan, src, dst, n, sizeof(fcs_float), FCS_MPI_FLOAT);
+}
 
-#ifdef RESORT_PROCLIST
-  if (resort->nprocs >= 0) ZMPI_Tproc_set_proclists(tproc, resort->nprocs, resort->procs, resort->nprocs, resort->procs, comm);
-#endif
 
-  TIMING_SYNC(comm); TIMING_START(t[2]);
+void fcs_resort_plan_add_bytes(fcs_resort_plan_t plan, void *src, void *dst, fcs_int n)
+{
+  plan_add(plan, src, dst, n, sizeof(char), MPI_BYTE);
+}
 
-  ZMPI_Alltoall_specific(send, resort->noriginal_particles, type, recv, resort->nsorted_particles, type, tproc, &type_size, comm,
-#if MPI_VERSION >= 3
-    MPI_STATUS_IGNORE
-#else
-    ZMPI_STATUS_IGNORE
-#endif
-    );
 
-  TIMING_SYNC(comm); TIMING_STOP(t[2]);
+static void plan_create_type(fcs_resort_plan_t plan)
+{
+  fcs_int i;
+  size_t record_size;
+  int *lengths;
+  MPI_Aint *displs;
+  MPI_Datatype *types, type;
 
-  ZMPI_Tproc_free(&tproc);
 
-  MPI_Type_free(&type);
+  /* the record size is rounded up to the largest element size of the record */
+  record_size = 1;
+  for (i = 0; i < plan->narrays; ++i) record_size = z_max(record_size, plan->arrays[i].size);
+  plan->record_size = ((plan->record_size + record_size - 1) / record_size) * record_size;
 
-  TIMING_SYNC(comm); TIMING_START(t[3]);
+  lengths = malloc(plan->narrays * sizeof(int));
+  displs = malloc(plan->narrays * sizeof(MPI_Aint));
+  types = malloc(plan->narrays * sizeof(MPI_Datatype));
 
-  unpack_floats(resort->nsorted_particles, recv, (dst)?dst:src, x);
-  
-  TIMING_SYNC(comm); TIMING_STOP(t[3]);
-  
-  free(send);
-  free(recv);
+  for (i = 0; i < plan->narrays; ++i)
+  {
+    lengths[i] = plan->arrays[i].n;
+    displs[i] = plan->arrays[i].offset;
+    types[i] = plan->arrays[i].type;
+  }
 
-  TIMING_SYNC(comm); TIMING_STOP(t[0]);
+  MPI_Type_create_struct(plan->narrays, lengths, displs, types, &type);
+  MPI_Type_create_resized(type, 0, plan->record_size, &plan->record_type);
+  MPI_Type_commit(&plan->record_type);
+  MPI_Type_free(&type);
 
-  TIMING_CMD(
-    if (comm_rank == 0)
-      printf(TIMING_PRINT_PREFIX "resort_floats: %f  %f  %f  %f\n", t[0], t[1], t[2], t[3]);
-  );
+  free(lengths);
+  free(displs);
+  free(types);
 }
 
 
-static void resort_bytes(fcs_resort_t resort, void *src, void *dst, fcs_int x, MPI_Comm comm)
+void fcs_resort_plan_set_resort(fcs_resort_plan_t plan, fcs_resort_t resort)
 {
-  void *send, *recv;
-  size_t type_size = sizeof(fcs_resort_index_t) + x * sizeof(char);
+  plan->resort = resort;
+}
 
-  MPI_Datatype type;
-  int lengths[2] = { 1, x };
-  MPI_Aint displs[2] = { 0, sizeof(fcs_resort_index_t) };
-  MPI_Datatype types[2] = { FCS_MPI_RESORT_INDEX, MPI_BYTE };
 
-  ZMPI_Tproc tproc;
+fcs_int fcs_resort_plan_execute(fcs_resort_plan_t plan, MPI_Comm comm)
+{
+  fcs_resort_t resort = plan->resort;
+  fcs_int i, j, nsorted;
+  char *send, *recv, *src, *dst;
+  size_t s;
+  double timing;
 
 #ifdef DO_TIMING
+  int comm_rank;
   double t[4] = { 0, 0, 0, 0 };
 #endif
 
 
+  if (plan->narrays <= 0) return 0;
+
+  if (resort->indices == NULL)
+  {
+    for (j = 0; j < plan->narrays; ++j)
+    if (plan->arrays[j].dst) memcpy(plan->arrays[j].dst, plan->arrays[j].src, resort->noriginal_particles * plan->arrays[j].n * plan->arrays[j].size);
+
+    return 0;
+  }
+
+  TIMING_CMD(MPI_Comm_rank(comm, &comm_rank););
+
   TIMING_SYNC(comm); TIMING_START(t[0]);
 
-  send = malloc(resort->noriginal_particles * type_size);
-  recv = malloc(resort->nsorted_particles * type_size);
+  timing = fcs_timing_start();
 
-  TIMING_SYNC(comm); TIMING_START(t[1]);
+  if (create_cache(resort, comm) != 0)
+  {
+    fcs_timing_stop(FCS_PHASE_SORT, timing);
+    return -1;
+  }
 
-  pack_bytes(resort->noriginal_particles, src, x, resort->indices, send);
+  if (plan->record_type == MPI_DATATYPE_NULL) plan_create_type(plan);
 
-  TIMING_SYNC(comm); TIMING_STOP(t[1]);
+  nsorted = fcs_resort_get_sorted_particles(resort);
 
-  MPI_Type_create_struct(2, lengths, displs, types, &type);
-  MPI_Type_commit(&type);
+  send = malloc(resort->noriginal_particles * plan->record_size);
+  recv = malloc(nsorted * plan->record_size);
 
-  ZMPI_Tproc_create_tproc(&tproc, resort_tproc, ZMPI_TPROC_RESET_NULL, ZMPI_TPROC_EXDEF_NULL);
+  TIMING_SYNC(comm); TIMING_START(t[1]);
 
-#ifdef RESORT_PROCLIST
-  if (resort->nprocs >= 0) ZMPI_Tproc_set_proclists(tproc, resort->nprocs, resort->procs, resort->nprocs, resort->procs, comm);
-#endif
+  for (j = 0; j < plan->narrays; ++j)
+  {
+    src = plan->arrays[j].src;
+    s = plan->arrays[j].n * plan->arrays[j].size;
+
+    for (i = 0; i < resort->noriginal_particles; ++i)
+      memcpy(send + resort->cache_send_pos[i] * plan->record_size + plan->arrays[j].offset, src + i * s, s);
+  }
+
+  TIMING_SYNC(comm); TIMING_STOP(t[1]);
 
   TIMING_SYNC(comm); TIMING_START(t[2]);
 
-  ZMPI_Alltoall_specific(send, resort->noriginal_particles, type, recv, resort->nsorted_particles, type, tproc, &type_size, comm,
-#if MPI_VERSION >= 3
-    MPI_STATUS_IGNORE
-#else
-    ZMPI_STATUS_IGNORE
-#endif
-    );
+  exchange(resort, send, recv, plan->record_type, plan->record_size, comm);
 
   TIMING_SYNC(comm); TIMING_STOP(t[2]);
 
-  ZMPI_Tproc_free(&tproc);
+  TIMING_SYNC(comm); TIMING_START(t[3]);
 
-  MPI_Type_free(&type);
+  for (j = 0; j < plan->narrays; ++j)
+  {
+    dst = (plan->arrays[j].dst)?plan->arrays[j].dst:plan->arrays[j].src;
+    s = plan->arrays[j].n * plan->arrays[j].size;
 
-  TIMING_SYNC(comm); TIMING_START(t[3]);
+    for (i = 0; i < nsorted; ++i)
+      memcpy(dst + resort->cache_recv_pos[i] * s, recv + i * plan->record_size + plan->arrays[j].offset, s);
+  }
 
-  unpack_bytes(resort->nsorted_particles, recv, (dst)?dst:src, x);
-  
   TIMING_SYNC(comm); TIMING_STOP(t[3]);
-  
+
   free(send);
   free(recv);
 
+  fcs_timing_stop(FCS_PHASE_SORT, timing);
+
   TIMING_SYNC(comm); TIMING_STOP(t[0]);
 
   TIMING_CMD(
     if (comm_rank == 0)
-      printf(TIMING_PRINT_PREFIX "resort_bytes: %f  %f  %f  %f\n", t[0], t[1], t[2], t[3]);
+      printf(TIMING_PRINT_PREFIX "fcs_resort_plan_execute: %f  %f  %f  %f\n", t[0], t[1], t[2], t[3]);
   );
+
+  return 0;
 }
 
 
-void fcs_resort_resort_ints(fcs_resort_t resort, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm)
+static fcs_int resort_single(fcs_resort_t resort, void *src, void *dst, fcs_int n, size_t size, MPI_Datatype type, MPI_Comm comm)
 {
-  if (resort->indices == NULL)
+  struct _fcs_resort_plan_array_t *a;
+
+
+  /* the plan (and its datatype) of the previous call is reused for arrays of the same layout */
+  if (resort->plan != FCS_RESORT_PLAN_NULL)
   {
-    if (dst) copy_ints(resort->noriginal_particles, src, dst, n, NULL);
-    
-    return;
+    a = &resort->plan->arrays[0];
+
+    if (a->n == n && a->size == size && a->type == type)
+    {
+      a->src = src;
+      a->dst = dst;
+
+    } else fcs_resort_plan_destroy(&resort->plan);
   }
-  
-  resort_ints(resort, src, dst, n, comm);
+
+  if (resort->plan == FCS_RESORT_PLAN_NULL)
+  {
+    fcs_resort_plan_create(&resort->plan, resort);
+    plan_add(resort->plan, src, dst, n, size, type);
+  }
+
+  return fcs_resort_plan_execute(resort->plan, comm);
 }
 
 
-void fcs_resort_resort_floats(fcs_resort_t resort, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm)
+fcs_int fcs_resort_resort_ints(fcs_resort_t resort, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm)
 {
-  if (resort->indices == NULL)
-  {
-    if (dst) copy_floats(resort->noriginal_particles, src, dst, n, NULL);
-    
-    return;
-  }
+  return resort_single(resort, src, dst, n, sizeof(fcs_int), FCS_MPI_INT, comm);
+}
 
-  resort_floats(resort, src, dst, n, comm);
+
+fcs_int fcs_resort_resort_floats(fcs_resort_t resort, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm)
+{
+  return resort_single(resort, src, dst, n, sizeof(fcs_float), FCS_MPI_FLOAT, comm);
 }
 
 
-void fcs_resort_resort_bytes(fcs_resort_t resort, void *src, void *dst, fcs_int n, MPI_Comm comm)
+fcs_int fcs_resort_resort_bytes(fcs_resort_t resort, void *src, void *dst, fcs_int n, MPI_Comm comm)
 {
-  if (resort->indices == NULL)
-  {
-    if (dst) copy_bytes(resort->noriginal_particles, src, dst, n, NULL);
-    
-    return;
-  }
-  
-  resort_bytes(resort, src, dst, n, comm);
+  return resort_single(resort, src, dst, n, sizeof(char), MPI_BYTE, comm);
 }
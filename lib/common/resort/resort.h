@@ -62,11 +62,46 @@ typedef struct _fcs_resort_t
   fcs_int nprocs;
   int *procs;
 
+  /* exchange pattern cached between resort operations while the resort indices are unchanged */
+  MPI_Comm cache_comm;
+  int cache_comm_size;
+  int *cache_counts;
+  fcs_int *cache_send_pos, *cache_recv_pos;
+
+  /* plan of the last single array resort operation (fcs_resort_resort_ints, ...), reused while the array layout is unchanged */
+  struct _fcs_resort_plan_t *plan;
+
 } *fcs_resort_t;
 
 #define FCS_RESORT_NULL  NULL
 
 
+/**
+ * @brief resort plan structure, i.e., a set of arrays that are resorted together in a single exchange
+ */
+typedef struct _fcs_resort_plan_t
+{
+  fcs_resort_t resort;
+
+  fcs_int narrays, max_narrays;
+  struct _fcs_resort_plan_array_t
+  {
+    void *src, *dst;
+    fcs_int n;
+    size_t size, offset;
+    MPI_Datatype type;
+
+  } *arrays;
+
+  /* packed record of all arrays and its datatype, created at the first execution */
+  size_t record_size;
+  MPI_Datatype record_type;
+
+} *fcs_resort_plan_t;
+
+#define FCS_RESORT_PLAN_NULL  NULL
+
+
 /**
  * @brief create resort object from given gridsort object
  * @param resort fcs_resort_t* resort object
@@ -146,6 +181,12 @@ fcs_resort_index_t *fcs_resort_get_indices(fcs_resort_t resort);
  */
 void fcs_resort_set_proclists(fcs_resort_t resort, fcs_int nprocs, int *procs);
 
+/**
+ * @brief invalidate the exchange pattern cached by the resort object, required if the resort indices were modified after a resort operation
+ * @param resort fcs_resort_t resort object
+ */
+void fcs_resort_invalidate(fcs_resort_t resort);
+
 /**
  * @brief perform resorting of integer values (i.e., fcs_int)
  * @param resort fcs_resort_t resort object
@@ -153,8 +194,9 @@ void fcs_resort_set_proclists(fcs_resort_t resort, fcs_int nprocs, int *procs);
  * @param dst fcs_int* array to store resorted integer values
  * @param n fcs_int number of integer values to resort for each particle
  * @param comm MPI_Comm MPI communicator
+ * @return fcs_int 0 on success, -1 if the resort indices do not match the number of sorted particles
  */
-void fcs_resort_resort_ints(fcs_resort_t resort, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm);
+fcs_int fcs_resort_resort_ints(fcs_resort_t resort, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm);
 
 /**
  * @brief perform resorting of float values (i.e., fcs_float)
@@ -163,8 +205,9 @@ void fcs_resort_resort_ints(fcs_resort_t resort, fcs_int *src, fcs_int *dst, fcs
  * @param dst fcs_float* array to store resorted float values
  * @param n fcs_int number of float values to resort for each particle
  * @param comm MPI_Comm MPI communicator
+ * @return fcs_int 0 on success, -1 if the resort indices do not match the number of sorted particles
  */
-void fcs_resort_resort_floats(fcs_resort_t resort, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm);
+fcs_int fcs_resort_resort_floats(fcs_resort_t resort, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm);
 
 /**
  * @brief perform resorting of byte values
@@ -173,8 +216,64 @@ void fcs_resort_resort_floats(fcs_resort_t resort, fcs_float *src, fcs_float *ds
  * @param dst void* array to store resorted byte values
  * @param n fcs_int number of byte values to resort for each particle
  * @param comm MPI_Comm MPI communicator
+ * @return fcs_int 0 on success, -1 if the resort indices do not match the number of sorted particles
+ */
+fcs_int fcs_resort_resort_bytes(fcs_resort_t resort, void *src, void *dst, fcs_int n, MPI_Comm comm);
+
+/**
+ * @brief create resort plan for the given resort object
+ * @param plan fcs_resort_plan_t* resort plan
+ * @param resort fcs_resort_t resort object
+ */
+void fcs_resort_plan_create(fcs_resort_plan_t *plan, fcs_resort_t resort);
+
+/**
+ * @brief destroy resort plan
+ * @param plan fcs_resort_plan_t* resort plan
+ */
+void fcs_resort_plan_destroy(fcs_resort_plan_t *plan);
+
+/**
+ * @brief add array of integer values (i.e., fcs_int) to the resort plan
+ * @param plan fcs_resort_plan_t resort plan
+ * @param src fcs_int* array of integer values in original (unsorted, input) order
+ * @param dst fcs_int* array to store resorted integer values (if NULL, src is used)
+ * @param n fcs_int number of integer values to resort for each particle
+ */
+void fcs_resort_plan_add_ints(fcs_resort_plan_t plan, fcs_int *src, fcs_int *dst, fcs_int n);
+
+/**
+ * @brief add array of float values (i.e., fcs_float) to the resort plan
+ * @param plan fcs_resort_plan_t resort plan
+ * @param src fcs_float* array of float values in original (unsorted, input) order
+ * @param dst fcs_float* array to store resorted float values (if NULL, src is used)
+ * @param n fcs_int number of float values to resort for each particle
+ */
+void fcs_resort_plan_add_floats(fcs_resort_plan_t plan, fcs_float *src, fcs_float *dst, fcs_int n);
+
+/**
+ * @brief add array of byte values to the resort plan
+ * @param plan fcs_resort_plan_t resort plan
+ * @param src void* array of byte values in original (unsorted, input) order
+ * @param dst void* array to store resorted byte values (if NULL, src is used)
+ * @param n fcs_int number of byte values to resort for each particle
+ */
+void fcs_resort_plan_add_bytes(fcs_resort_plan_t plan, void *src, void *dst, fcs_int n);
+
+/**
+ * @brief set the resort object used by the resort plan (e.g., after the resort object was recreated by a new run of a solver), the arrays of the plan and its datatype are kept
+ * @param plan fcs_resort_plan_t resort plan
+ * @param resort fcs_resort_t resort object
+ */
+void fcs_resort_plan_set_resort(fcs_resort_plan_t plan, fcs_resort_t resort);
+
+/**
+ * @brief perform resorting of all arrays of the resort plan with a single exchange, the plan can be executed repeatedly
+ * @param plan fcs_resort_plan_t resort plan
+ * @param comm MPI_Comm MPI communicator
+ * @return fcs_int 0 on success, -1 if the resort indices do not match the number of sorted particles
  */
-void fcs_resort_resort_bytes(fcs_resort_t resort, void *src, void *dst, fcs_int n, MPI_Comm comm);
+fcs_int fcs_resort_plan_execute(fcs_resort_plan_t plan, MPI_Comm comm);
 
 
 #ifdef __cplusplus
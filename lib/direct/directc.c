@@ -30,6 +30,7 @@
 #include <mpi.h>
 
 #include "common/fcs-common/FCSCommon.h"
+#include "common/fcs-common/FCSTiming.h"
 
 #include "common/gridsort/gridsort.h"
 #include "common/near/near.h"
@@ -112,6 +113,8 @@ void fcs_directc_create(fcs_directc_t *directc)
   directc->cutoff = 0.0;
   directc->cutoff_with_near = 0;
 
+  directc->half_ring = 1;
+
   directc->max_particle_move = -1;
 
   directc->resort = 0;
@@ -211,6 +214,18 @@ void fcs_directc_get_cutoff_with_near(fcs_directc_t *directc, fcs_int *cutoff_wi
 }
 
 
+void fcs_directc_set_half_ring(fcs_directc_t *directc, fcs_int half_ring)
+{
+  directc->half_ring = half_ring;
+}
+
+
+void fcs_directc_get_half_ring(fcs_directc_t *directc, fcs_int *half_ring)
+{
+  *half_ring = directc->half_ring;
+}
+
+
 void fcs_directc_set_max_particle_move(fcs_directc_t *directc, fcs_float max_particle_move)
 {
   directc->max_particle_move = max_particle_move;
@@ -376,56 +391,296 @@ static void directc_local_periodic(fcs_int n0, fcs_float *xyz0, fcs_float *q0, f
 }
 
 
-static void directc_global(fcs_directc_t *directc, fcs_int *periodic, int size, int rank, MPI_Comm comm)
+static void directc_local_two_sym(fcs_int n0, fcs_int m0, fcs_float *xyz0, fcs_float *q0, fcs_float *f0, fcs_float *p0, fcs_int n1, fcs_int m1, fcs_float *xyz1, fcs_float *q1, fcs_float *f1, fcs_float *p1, fcs_float cutoff)
 {
-  fcs_int l;
+  fcs_int i, j;
+  fcs_float dx, dy, dz, ir, ir3;
+
+
+  if (fcs_fabs(cutoff) > 0) cutoff = 1.0 / cutoff;
+
+  /* only the first m0 (m1) particles of the two sets receive fields and potentials */
+  for (i = 0; i < n0; ++i)
+  for (j = 0; j < ((i < m0)?n1:m1); ++j)
+  {
+    dx = xyz0[i*3+0] - xyz1[j*3+0];
+    dy = xyz0[i*3+1] - xyz1[j*3+1];
+    dz = xyz0[i*3+2] - xyz1[j*3+2];
 
-  fcs_int my_n, max_n, all_n[size], other_n, other_n_next;
+    ir = 1.0 / fcs_sqrt(z_sqr(dx) + z_sqr(dy) + z_sqr(dz));
 
-  fcs_float *other_xyzq, *other_xyz, *other_q;
+    if ((cutoff > 0 && cutoff > ir) || (cutoff < 0 && -cutoff < ir)) continue;
 
-  MPI_Status status;
+    ir3 = ir * ir * ir;
 
+    if (i < m0)
+    {
+      p0[i] += q1[j] * ir;
 
-  my_n = directc->nparticles + directc->in_nparticles;
-  MPI_Allreduce(&my_n, &max_n, 1, FCS_MPI_INT, MPI_MAX, comm);
-  MPI_Allgather(&my_n, 1, FCS_MPI_INT, all_n, 1, FCS_MPI_INT, comm);
+      f0[i*3+0] += q1[j] * dx * ir3;
+      f0[i*3+1] += q1[j] * dy * ir3;
+      f0[i*3+2] += q1[j] * dz * ir3;
+    }
+
+    if (j < m1)
+    {
+      p1[j] += q0[i] * ir;
+
+      f1[j*3+0] -= q0[i] * dx * ir3;
+      f1[j*3+1] -= q0[i] * dy * ir3;
+      f1[j*3+2] -= q0[i] * dz * ir3;
+    }
+  }
+}
 
-  other_xyzq = calloc(max_n, 4*sizeof(fcs_float));
 
-  other_n_next = all_n[rank];
+static void directc_local_periodic_sym(fcs_int n0, fcs_int m0, fcs_float *xyz0, fcs_float *q0, fcs_float *f0, fcs_float *p0, fcs_int n1, fcs_int m1, fcs_float *xyz1, fcs_float *q1, fcs_float *f1, fcs_float *p1, fcs_int *periodic, fcs_float *box_a, fcs_float *box_b, fcs_float *box_c, fcs_float cutoff)
+{
+  fcs_int i, j, pd[3];
+  fcs_float dx, dy, dz, ir, ir3;
+
+
+  if (fcs_fabs(cutoff) > 0) cutoff = 1.0 / cutoff;
+
+  for (pd[0] = -periodic[0]; pd[0] <= periodic[0]; ++pd[0])
+  for (pd[1] = -periodic[1]; pd[1] <= periodic[1]; ++pd[1])
+  for (pd[2] = -periodic[2]; pd[2] <= periodic[2]; ++pd[2])
+  {
+    if (pd[0] == 0 && pd[1] == 0 && pd[2] == 0) continue;
+
+    /* the interaction of particle j with the image of particle i shifted by -pd is the reverse of the interaction of particle i with the image of particle j shifted by pd */
+    for (i = 0; i < n0; ++i)
+    for (j = 0; j < ((i < m0)?n1:m1); ++j)
+    {
+      dx = xyz0[i*3+0] - (xyz1[j*3+0] + (pd[0] * box_a[0]) + (pd[1] * box_b[0]) + (pd[2] * box_c[0]));
+      dy = xyz0[i*3+1] - (xyz1[j*3+1] + (pd[0] * box_a[1]) + (pd[1] * box_b[1]) + (pd[2] * box_c[1]));
+      dz = xyz0[i*3+2] - (xyz1[j*3+2] + (pd[0] * box_a[2]) + (pd[1] * box_b[2]) + (pd[2] * box_c[2]));
+
+      ir = 1.0 / fcs_sqrt(z_sqr(dx) + z_sqr(dy) + z_sqr(dz));
+
+      if ((cutoff > 0 && cutoff > ir) || (cutoff < 0 && -cutoff < ir)) continue;
+
+      ir3 = ir * ir * ir;
+
+      if (i < m0)
+      {
+        p0[i] += q1[j] * ir;
+
+        f0[i*3+0] += q1[j] * dx * ir3;
+        f0[i*3+1] += q1[j] * dy * ir3;
+        f0[i*3+2] += q1[j] * dz * ir3;
+      }
+
+      if (j < m1)
+      {
+        p1[j] += q0[i] * ir;
+
+        f1[j*3+0] -= q0[i] * dx * ir3;
+        f1[j*3+1] -= q0[i] * dy * ir3;
+        f1[j*3+2] -= q0[i] * dz * ir3;
+      }
+    }
+  }
+}
+
+
+/* pack the local (and input-only) particles as block of positions followed by charges */
+static void directc_pack_local(fcs_directc_t *directc, fcs_float *xyzq, fcs_int n)
+{
+  fcs_float *xyz = xyzq, *q = xyzq + 3 * n;
 
-  other_n = other_n_next;
-  other_xyz = other_xyzq;
-  other_q = other_xyzq + 3 * other_n;
 
-  memcpy(other_xyz, directc->positions, directc->nparticles * 3 * sizeof(fcs_float));
-  memcpy(other_q, directc->charges, directc->nparticles * sizeof(fcs_float));
+  memcpy(xyz, directc->positions, directc->nparticles * 3 * sizeof(fcs_float));
+  memcpy(q, directc->charges, directc->nparticles * sizeof(fcs_float));
 
   if (directc->in_nparticles > 0 && directc->in_positions && directc->in_charges)
   {
-    memcpy(other_xyz + directc->nparticles * 3, directc->in_positions, directc->in_nparticles * 3 * sizeof(fcs_float));
-    memcpy(other_q + directc->nparticles, directc->in_charges, directc->in_nparticles * sizeof(fcs_float));
+    memcpy(xyz + directc->nparticles * 3, directc->in_positions, directc->in_nparticles * 3 * sizeof(fcs_float));
+    memcpy(q + directc->nparticles, directc->in_charges, directc->in_nparticles * sizeof(fcs_float));
   }
+}
+
+
+/* all particle blocks pass all processes, the transfer of the next block overlaps with the computations of the current block */
+static void directc_global_ring(fcs_directc_t *directc, fcs_int *periodic, int size, int rank, MPI_Comm comm)
+{
+  fcs_int l, cur, other_n;
+
+  fcs_int my_n, max_n, all_n[size];
+
+  fcs_float *other_xyzq[2], *other_xyz, *other_q;
+
+  MPI_Request reqs[2];
+
 
-  directc_local_one(directc->nparticles, other_n, other_xyz, other_q, directc->field, directc->potentials, directc->cutoff);
-  directc_local_periodic(directc->nparticles, directc->positions, directc->charges, other_n, other_xyz, other_q, directc->field, directc->potentials, periodic, directc->box_a, directc->box_b, directc->box_c, directc->cutoff);
+  my_n = directc->nparticles + directc->in_nparticles;
+  MPI_Allgather(&my_n, 1, FCS_MPI_INT, all_n, 1, FCS_MPI_INT, comm);
+
+  max_n = 0;
+  for (l = 0; l < size; ++l) max_n = z_max(max_n, all_n[l]);
+
+  other_xyzq[0] = malloc((max_n * 4 + 1) * sizeof(fcs_float));
+  other_xyzq[1] = malloc((max_n * 4 + 1) * sizeof(fcs_float));
 
-  for (l = 1; l < size; ++l)
+  cur = 0;
+  directc_pack_local(directc, other_xyzq[cur], my_n);
+
+  for (l = 0; l < size; ++l)
   {
-    other_n_next = all_n[(rank - l + size) % size];
-    
-    MPI_Sendrecv_replace(other_xyzq, max_n * (3 + 1), FCS_MPI_FLOAT, (rank + 1) % size, 0, (rank - 1 + size) % size, 0, comm, &status);
+    other_n = all_n[(rank - l + size) % size];
+    other_xyz = other_xyzq[cur];
+    other_q = other_xyzq[cur] + 3 * other_n;
+
+    if (l < size - 1)
+    {
+      MPI_Irecv(other_xyzq[1 - cur], all_n[(rank - l - 1 + size) % size] * 4, FCS_MPI_FLOAT, (rank - 1 + size) % size, 0, comm, &reqs[0]);
+      MPI_Isend(other_xyzq[cur], other_n * 4, FCS_MPI_FLOAT, (rank + 1) % size, 0, comm, &reqs[1]);
+      fcs_timing_count(FCS_COUNTER_COMM_BYTES, all_n[(rank - l - 1 + size) % size] * 4 * sizeof(fcs_float));
+    }
 
-    other_n = other_n_next;
-    other_xyz = other_xyzq;
-    other_q = other_xyzq + 3 * other_n;
+    fcs_timing_count(FCS_COUNTER_NEAR_PAIRS, (long long) directc->nparticles * other_n);
 
-    directc_local_two(directc->nparticles, directc->positions, directc->charges, other_n, other_xyz, other_q, directc->field, directc->potentials, directc->cutoff);
+    if (l == 0) directc_local_one(directc->nparticles, other_n, other_xyz, other_q, directc->field, directc->potentials, directc->cutoff);
+    else directc_local_two(directc->nparticles, directc->positions, directc->charges, other_n, other_xyz, other_q, directc->field, directc->potentials, directc->cutoff);
     directc_local_periodic(directc->nparticles, directc->positions, directc->charges, other_n, other_xyz, other_q, directc->field, directc->potentials, periodic, directc->box_a, directc->box_b, directc->box_c, directc->cutoff);
+
+    if (l < size - 1) MPI_Waitall(2, reqs, MPI_STATUSES_IGNORE);
+
+    cur = 1 - cur;
+  }
+
+  free(other_xyzq[0]);
+  free(other_xyzq[1]);
+}
+
+
+/* the particle blocks pass only half of the processes and the interactions between two blocks are computed only once,
+   the fields and potentials of the passing block are accumulated along the ring and finally sent back */
+static void directc_global_half_ring(fcs_directc_t *directc, fcs_int *periodic, int size, int rank, MPI_Comm comm)
+{
+  fcs_int i, l, nsteps, cur, src, other_n, other_m;
+
+  fcs_int my_nm[2], max_n, max_m, all_nm[2 * size];
+
+  fcs_float *my_xyzq, *other_xyzq[2], *other_fp[2], *other_xyz, *other_q, *other_f, *other_p, *my_fp;
+
+  MPI_Request reqs[3], fp_req;
+
+
+  my_nm[0] = directc->nparticles + directc->in_nparticles;
+  my_nm[1] = directc->nparticles;
+  MPI_Allgather(my_nm, 2, FCS_MPI_INT, all_nm, 2, FCS_MPI_INT, comm);
+
+  max_n = max_m = 0;
+  for (l = 0; l < size; ++l)
+  {
+    max_n = z_max(max_n, all_nm[2 * l + 0]);
+    max_m = z_max(max_m, all_nm[2 * l + 1]);
   }
 
-  free(other_xyzq);
+  /* each pair of processes is computed once, for an even number of processes the blocks of opposite processes are computed on both processes (without symmetry) */
+  nsteps = size / 2;
+
+  my_xyzq = malloc((max_n * 4 + 1) * sizeof(fcs_float));
+  other_xyzq[0] = malloc((max_n * 4 + 1) * sizeof(fcs_float));
+  other_xyzq[1] = malloc((max_n * 4 + 1) * sizeof(fcs_float));
+  other_fp[0] = malloc((max_m * 4 + 1) * sizeof(fcs_float));
+  other_fp[1] = malloc((max_m * 4 + 1) * sizeof(fcs_float));
+
+  directc_pack_local(directc, my_xyzq, my_nm[0]);
+
+  cur = 0;
+  fp_req = MPI_REQUEST_NULL;
+
+  for (l = 0; l <= nsteps; ++l)
+  {
+    src = (rank - l + size) % size;
+    other_n = all_nm[2 * src + 0];
+    other_m = all_nm[2 * src + 1];
+    other_xyz = (l == 0)?my_xyzq:other_xyzq[cur];
+    other_q = other_xyz + 3 * other_n;
+    other_f = other_fp[cur];
+    other_p = other_fp[cur] + 3 * other_m;
+
+    reqs[0] = reqs[1] = reqs[2] = MPI_REQUEST_NULL;
+
+    /* positions and charges of the current block are passed on before the computations */
+    if (l < nsteps)
+    {
+      MPI_Irecv(other_xyzq[1 - cur], all_nm[2 * ((src - 1 + size) % size) + 0] * 4, FCS_MPI_FLOAT, (rank - 1 + size) % size, 0, comm, &reqs[0]);
+      MPI_Isend(other_xyz, other_n * 4, FCS_MPI_FLOAT, (rank + 1) % size, 0, comm, &reqs[1]);
+      fcs_timing_count(FCS_COUNTER_COMM_BYTES, all_nm[2 * ((src - 1 + size) % size) + 0] * 4 * sizeof(fcs_float));
+    }
+
+    fcs_timing_count(FCS_COUNTER_NEAR_PAIRS, (long long) my_nm[1] * other_n);
+
+    if (l == 0)
+    {
+      directc_local_one(directc->nparticles, other_n, other_xyz, other_q, directc->field, directc->potentials, directc->cutoff);
+      directc_local_periodic(directc->nparticles, directc->positions, directc->charges, other_n, other_xyz, other_q, directc->field, directc->potentials, periodic, directc->box_a, directc->box_b, directc->box_c, directc->cutoff);
+
+    } else
+    {
+      /* fields and potentials of the current block are accumulated by the previous processes */
+      if (l == 1) for (i = 0; i < other_m * 4; ++i) other_fp[cur][i] = 0;
+      else MPI_Wait(&fp_req, MPI_STATUS_IGNORE);
+
+      if (2 * l == size)
+      {
+        directc_local_two(directc->nparticles, directc->positions, directc->charges, other_n, other_xyz, other_q, directc->field, directc->potentials, directc->cutoff);
+        directc_local_periodic(directc->nparticles, directc->positions, directc->charges, other_n, other_xyz, other_q, directc->field, directc->potentials, periodic, directc->box_a, directc->box_b, directc->box_c, directc->cutoff);
+
+      } else
+      {
+        directc_local_two_sym(my_nm[0], my_nm[1], my_xyzq, my_xyzq + 3 * my_nm[0], directc->field, directc->potentials, other_n, other_m, other_xyz, other_q, other_f, other_p, directc->cutoff);
+        directc_local_periodic_sym(my_nm[0], my_nm[1], my_xyzq, my_xyzq + 3 * my_nm[0], directc->field, directc->potentials, other_n, other_m, other_xyz, other_q, other_f, other_p, periodic, directc->box_a, directc->box_b, directc->box_c, directc->cutoff);
+      }
+
+      /* fields and potentials of the current block are passed on after the computations */
+      if (l < nsteps)
+      {
+        MPI_Isend(other_fp[cur], other_m * 4, FCS_MPI_FLOAT, (rank + 1) % size, 1, comm, &reqs[2]);
+        MPI_Irecv(other_fp[1 - cur], all_nm[2 * ((src - 1 + size) % size) + 1] * 4, FCS_MPI_FLOAT, (rank - 1 + size) % size, 1, comm, &fp_req);
+        fcs_timing_count(FCS_COUNTER_COMM_BYTES, all_nm[2 * ((src - 1 + size) % size) + 1] * 4 * sizeof(fcs_float));
+      }
+    }
+
+    MPI_Waitall(3, reqs, MPI_STATUSES_IGNORE);
+
+    if (l > 0 && l == nsteps)
+    {
+      /* send the fields and potentials of the last block back to its process and receive the fields and potentials of the local block */
+      my_fp = malloc((my_nm[1] * 4 + 1) * sizeof(fcs_float));
+
+      MPI_Sendrecv(other_fp[cur], other_m * 4, FCS_MPI_FLOAT, src, 2, my_fp, my_nm[1] * 4, FCS_MPI_FLOAT, (rank + nsteps) % size, 2, comm, MPI_STATUS_IGNORE);
+      fcs_timing_count(FCS_COUNTER_COMM_BYTES, my_nm[1] * 4 * sizeof(fcs_float));
+
+      for (i = 0; i < my_nm[1]; ++i)
+      {
+        directc->field[i * 3 + 0] += my_fp[i * 3 + 0];
+        directc->field[i * 3 + 1] += my_fp[i * 3 + 1];
+        directc->field[i * 3 + 2] += my_fp[i * 3 + 2];
+        directc->potentials[i] += my_fp[my_nm[1] * 3 + i];
+      }
+
+      free(my_fp);
+    }
+
+    cur = 1 - cur;
+  }
+
+  free(my_xyzq);
+  free(other_xyzq[0]);
+  free(other_xyzq[1]);
+  free(other_fp[0]);
+  free(other_fp[1]);
+}
+
+
+static void directc_global(fcs_directc_t *directc, fcs_int *periodic, int size, int rank, MPI_Comm comm)
+{
+  if (directc->half_ring) directc_global_half_ring(directc, periodic, size, rank, comm);
+  else directc_global_ring(directc, periodic, size, rank, comm);
 }
 
 
@@ -564,7 +819,9 @@ void fcs_directc_run(fcs_directc_t *directc, MPI_Comm comm)
 
   } else
   {
+    double timing = fcs_timing_start();
     directc_global(directc, periodic, comm_size, comm_rank, comm);
+    fcs_timing_stop(FCS_PHASE_NEAR, timing);
   }
 
   TIMING_SYNC(comm); TIMING_STOP(t);
@@ -605,3 +862,9 @@ void fcs_directc_resort_bytes(fcs_directc_t *directc, void *src, void *dst, fcs_
   
   fcs_near_resort_bytes(directc->near_resort, src, dst, n, comm);
 }
+
+
+void fcs_directc_get_resort_object(fcs_directc_t *directc, fcs_resort_t *resort)
+{
+  *resort = directc->near_resort;
+}
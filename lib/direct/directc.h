@@ -49,6 +49,8 @@ typedef struct _fcs_directc_t
   fcs_float cutoff;
   fcs_int cutoff_with_near;
 
+  fcs_int half_ring;
+
   fcs_float max_particle_move;
 
   fcs_int resort;
@@ -69,6 +71,8 @@ void fcs_directc_set_cutoff(fcs_directc_t *directc, fcs_float cutoff);
 void fcs_directc_get_cutoff(fcs_directc_t *directc, fcs_float *cutoff);
 void fcs_directc_set_cutoff_with_near(fcs_directc_t *directc, fcs_int cutoff_with_near);
 void fcs_directc_get_cutoff_with_near(fcs_directc_t *directc, fcs_int *cutoff_with_near);
+void fcs_directc_set_half_ring(fcs_directc_t *directc, fcs_int half_ring);
+void fcs_directc_get_half_ring(fcs_directc_t *directc, fcs_int *half_ring);
 void fcs_directc_set_max_particle_move(fcs_directc_t *directc, fcs_float max_particle_move);
 void fcs_directc_set_resort(fcs_directc_t *directc, fcs_int resort);
 void fcs_directc_get_resort(fcs_directc_t *directc, fcs_int *resort);
@@ -78,6 +82,7 @@ void fcs_directc_run(fcs_directc_t *directc, MPI_Comm comm);
 void fcs_directc_resort_ints(fcs_directc_t *directc, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm);
 void fcs_directc_resort_floats(fcs_directc_t *directc, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm);
 void fcs_directc_resort_bytes(fcs_directc_t *directc, void *src, void *dst, fcs_int n, MPI_Comm comm);
+void fcs_directc_get_resort_object(fcs_directc_t *directc, fcs_resort_t *resort);
 
 
 #ifdef __cplusplus
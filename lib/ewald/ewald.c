@@ -115,15 +115,241 @@ void ewald_tune_alpha(fcs_int N, fcs_float sum_q2, fcs_float box_l[3],
 /***************************************************
  **** K-SPACE CONTRIBUTION
  ***************************************************/
-void ewald_compute_kspace(ewald_data_struct* d, 
+
+/* The k-space sums are computed for blocks of EWALD_KSPACE_BLOCK_SIZE
+   particles. For each block, the factors exp(i*n*2*pi/L*r) of the
+   particles are tabulated for all -kmax <= n <= kmax in each
+   dimension, using the recurrence exp(i*n*x) = exp(i*(n-1)*x) *
+   exp(i*x). The term exp(i*k_vec*r_vec) of a k-vector is then the
+   product of three table entries. */
+
+/* pointer to the real (_c_ = 0) or imaginary (_c_ = 1) parts of the
+   table entries of dimension _d_ and index _n_ of all particles of a block */
+#define EWALD_KSPACE_TABLE(_t_, _kmax_, _d_, _n_, _c_) \
+  (&(_t_)[((((_d_) * (2 * (_kmax_) + 1) + (_n_) + (_kmax_)) * 2) + (_c_)) * EWALD_KSPACE_BLOCK_SIZE])
+
+/** Creates the list of k-vectors that are computed by the task with
+   the given rank. Only one of the k-vectors k_vec and -k_vec is used,
+   because their contributions are equal. The influence function is
+   doubled accordingly.
+   \param d the ewald data
+   \param rank the rank of the task
+   \param size the number of tasks the k-vectors are distributed to
+   \param kvectors (out) 3 indices nx, ny, nz per k-vector
+   \param kinfluence (out) influence function per k-vector
+   \return the number of k-vectors
+*/
+static fcs_int
+ewald_kspace_vectors(ewald_data_struct *d, int rank, int size,
+    fcs_int **kvectors, fcs_float **kinfluence) {
+  fcs_int num_k_per_dir = 2*d->kmax+1;
+  fcs_int num_k_cube = num_k_per_dir * num_k_per_dir * num_k_per_dir;
+  fcs_int num_k = 0;
+
+  *kvectors = malloc(sizeof(fcs_int) * 3 * (num_k_cube / 2 / size + 1));
+  *kinfluence = malloc(sizeof(fcs_float) * (num_k_cube / 2 / size + 1));
+
+  /* the k-vectors of one half space (with the same order as in the
+     full space) are distributed evenly */
+  for (fcs_int k_ind = num_k_cube / 2 + 1 + rank; k_ind < num_k_cube; k_ind += size) {
+    fcs_int nx = 
+      k_ind % num_k_per_dir - d->kmax;
+    fcs_int ny = 
+      k_ind % (num_k_per_dir*num_k_per_dir) / num_k_per_dir - d->kmax;
+    fcs_int nz = 
+      k_ind / (num_k_per_dir*num_k_per_dir) - d->kmax;
+    if (nx*nx + ny*ny + nz*nz <= d->kmax*d->kmax) {
+      (*kvectors)[3*num_k] = nx;
+      (*kvectors)[3*num_k+1] = ny;
+      (*kvectors)[3*num_k+2] = nz;
+      (*kinfluence)[num_k] = 2.0 * d->G[linindex(abs(nx), abs(ny), abs(nz), d->kmax)];
+      num_k++;
+    }
+  }
+
+  return num_k;
+}
+
+/** Tabulates exp(i*n*2*pi/L*r) for a block of particles (see
+   EWALD_KSPACE_TABLE). */
+static void
+ewald_kspace_tables(ewald_data_struct *d, fcs_int num_particles,
+    fcs_float *positions, fcs_float *tables) {
+  const fcs_int kmax = d->kmax;
+
+  for (fcs_int dim=0; dim < 3; dim++) {
+    fcs_float *re0 = EWALD_KSPACE_TABLE(tables, kmax, dim, 0, 0);
+    fcs_float *im0 = EWALD_KSPACE_TABLE(tables, kmax, dim, 0, 1);
+    fcs_float *re1 = EWALD_KSPACE_TABLE(tables, kmax, dim, 1, 0);
+    fcs_float *im1 = EWALD_KSPACE_TABLE(tables, kmax, dim, 1, 1);
+    const fcs_float k1 = 2.0*M_PI / d->box_l[dim];
+
+    for (fcs_int i=0; i < num_particles; i++) {
+      const fcs_float kr = k1 * positions[3*i+dim];
+      re0[i] = 1.0;
+      im0[i] = 0.0;
+      if (kmax > 0) {
+        re1[i] = cos(kr);
+        im1[i] = sin(kr);
+      }
+    }
+
+    for (fcs_int n=2; n <= kmax; n++) {
+      fcs_float *re = EWALD_KSPACE_TABLE(tables, kmax, dim, n, 0);
+      fcs_float *im = EWALD_KSPACE_TABLE(tables, kmax, dim, n, 1);
+      const fcs_float *re_prev = EWALD_KSPACE_TABLE(tables, kmax, dim, n-1, 0);
+      const fcs_float *im_prev = EWALD_KSPACE_TABLE(tables, kmax, dim, n-1, 1);
+      for (fcs_int i=0; i < num_particles; i++) {
+        re[i] = re_prev[i]*re1[i] - im_prev[i]*im1[i];
+        im[i] = re_prev[i]*im1[i] + im_prev[i]*re1[i];
+      }
+    }
+
+    /* exp(-i*x) is the complex conjugate of exp(i*x) */
+    for (fcs_int n=1; n <= kmax; n++) {
+      fcs_float *re = EWALD_KSPACE_TABLE(tables, kmax, dim, -n, 0);
+      fcs_float *im = EWALD_KSPACE_TABLE(tables, kmax, dim, -n, 1);
+      const fcs_float *re_pos = EWALD_KSPACE_TABLE(tables, kmax, dim, n, 0);
+      const fcs_float *im_pos = EWALD_KSPACE_TABLE(tables, kmax, dim, n, 1);
+      for (fcs_int i=0; i < num_particles; i++) {
+        re[i] = re_pos[i];
+        im[i] = -im_pos[i];
+      }
+    }
+  }
+}
+
+/** Computes the reciprocal charge density rhohat (Deserno, Holm
+   (1998) eq. (8)) of the given particles for the given k-vectors.
+   \param tables buffer of size EWALD_KSPACE_TABLES_SIZE(kmax)
+   \param rhohat (out) real and imaginary part per k-vector
+*/
+static void
+ewald_kspace_rhohat(ewald_data_struct *d,
+    fcs_int num_k, fcs_int *kvectors,
+    fcs_int num_particles, fcs_float *positions, fcs_float *charges,
+    fcs_float *tables, fcs_float *rhohat) {
+  const fcs_int kmax = d->kmax;
+
+  for (fcs_int k=0; k < num_k; k++)
+    rhohat[2*k] = rhohat[2*k+1] = 0.0;
+
+  for (fcs_int start=0; start < num_particles; start += EWALD_KSPACE_BLOCK_SIZE) {
+    const fcs_int nb = (num_particles - start < EWALD_KSPACE_BLOCK_SIZE) ? num_particles - start : EWALD_KSPACE_BLOCK_SIZE;
+    const fcs_float *q = &charges[start];
+
+    ewald_kspace_tables(d, nb, &positions[3*start], tables);
+
+    for (fcs_int k=0; k < num_k; k++) {
+      const fcs_float *xre = EWALD_KSPACE_TABLE(tables, kmax, 0, kvectors[3*k], 0);
+      const fcs_float *xim = EWALD_KSPACE_TABLE(tables, kmax, 0, kvectors[3*k], 1);
+      const fcs_float *yre = EWALD_KSPACE_TABLE(tables, kmax, 1, kvectors[3*k+1], 0);
+      const fcs_float *yim = EWALD_KSPACE_TABLE(tables, kmax, 1, kvectors[3*k+1], 1);
+      const fcs_float *zre = EWALD_KSPACE_TABLE(tables, kmax, 2, kvectors[3*k+2], 0);
+      const fcs_float *zim = EWALD_KSPACE_TABLE(tables, kmax, 2, kvectors[3*k+2], 1);
+      fcs_float rhohat_re = 0.0;
+      fcs_float rhohat_im = 0.0;
+
+      for (fcs_int i=0; i < nb; i++) {
+        const fcs_float xyre = xre[i]*yre[i] - xim[i]*yim[i];
+        const fcs_float xyim = xre[i]*yim[i] + xim[i]*yre[i];
+        /* rhohat = qi * exp(-i*k_vec*r_vec) */
+        rhohat_re += q[i] * (xyre*zre[i] - xyim*zim[i]);
+        rhohat_im -= q[i] * (xyre*zim[i] + xyim*zre[i]);
+      }
+
+      rhohat[2*k] += rhohat_re;
+      rhohat[2*k+1] += rhohat_im;
+    }
+  }
+}
+
+/** Adds the k-space fields and potentials of the given k-vectors at
+   the positions of the given particles.
+   \param tables buffer of size EWALD_KSPACE_TABLES_SIZE(kmax)
+   \param fields (out) fields are added (may be NULL)
+   \param potentials (out) potentials are added (may be NULL)
+*/
+static void
+ewald_kspace_fields(ewald_data_struct *d,
+    fcs_int num_k, fcs_int *kvectors, fcs_float *kinfluence, fcs_float *rhohat,
+    fcs_int num_particles, fcs_float *positions,
+    fcs_float *tables, fcs_float *fields, fcs_float *potentials) {
+  const fcs_int kmax = d->kmax;
+  fcs_float block_fields[3][EWALD_KSPACE_BLOCK_SIZE], block_potentials[EWALD_KSPACE_BLOCK_SIZE];
+
+  for (fcs_int start=0; start < num_particles; start += EWALD_KSPACE_BLOCK_SIZE) {
+    const fcs_int nb = (num_particles - start < EWALD_KSPACE_BLOCK_SIZE) ? num_particles - start : EWALD_KSPACE_BLOCK_SIZE;
+
+    ewald_kspace_tables(d, nb, &positions[3*start], tables);
+
+    for (fcs_int i=0; i < nb; i++)
+      block_fields[0][i] = block_fields[1][i] = block_fields[2][i] = block_potentials[i] = 0.0;
+
+    for (fcs_int k=0; k < num_k; k++) {
+      const fcs_float *xre = EWALD_KSPACE_TABLE(tables, kmax, 0, kvectors[3*k], 0);
+      const fcs_float *xim = EWALD_KSPACE_TABLE(tables, kmax, 0, kvectors[3*k], 1);
+      const fcs_float *yre = EWALD_KSPACE_TABLE(tables, kmax, 1, kvectors[3*k+1], 0);
+      const fcs_float *yim = EWALD_KSPACE_TABLE(tables, kmax, 1, kvectors[3*k+1], 1);
+      const fcs_float *zre = EWALD_KSPACE_TABLE(tables, kmax, 2, kvectors[3*k+2], 0);
+      const fcs_float *zim = EWALD_KSPACE_TABLE(tables, kmax, 2, kvectors[3*k+2], 1);
+      /* reciprocal vector k_vec */
+      const fcs_float kx = 2.0*M_PI*kvectors[3*k] / d->box_l[0];
+      const fcs_float ky = 2.0*M_PI*kvectors[3*k+1] / d->box_l[1];
+      const fcs_float kz = 2.0*M_PI*kvectors[3*k+2] / d->box_l[2];
+      /* rhohat times influence function */
+      const fcs_float g_re = kinfluence[k] * rhohat[2*k];
+      const fcs_float g_im = kinfluence[k] * rhohat[2*k+1];
+
+      if (fields != NULL) {
+        /* compute field at position of particle i
+           compare to Deserno, Holm (1998) eq. (15) */
+        for (fcs_int i=0; i < nb; i++) {
+          const fcs_float xyre = xre[i]*yre[i] - xim[i]*yim[i];
+          const fcs_float xyim = xre[i]*yim[i] + xim[i]*yre[i];
+          const fcs_float cos_kr = xyre*zre[i] - xyim*zim[i];
+          const fcs_float sin_kr = xyre*zim[i] + xyim*zre[i];
+          const fcs_float fak1 = g_re*sin_kr + g_im*cos_kr;
+          block_fields[0][i] += kx * fak1;
+          block_fields[1][i] += ky * fak1;
+          block_fields[2][i] += kz * fak1;
+          if (potentials != NULL)
+            block_potentials[i] += g_re*cos_kr - g_im*sin_kr;
+        }
+      } else if (potentials != NULL) {
+        /* compute potential at position of particle i
+           compare to Deserno, Holm (1998) eq. (9) */
+        for (fcs_int i=0; i < nb; i++) {
+          const fcs_float xyre = xre[i]*yre[i] - xim[i]*yim[i];
+          const fcs_float xyim = xre[i]*yim[i] + xim[i]*yre[i];
+          const fcs_float cos_kr = xyre*zre[i] - xyim*zim[i];
+          const fcs_float sin_kr = xyre*zim[i] + xyim*zre[i];
+          block_potentials[i] += g_re*cos_kr - g_im*sin_kr;
+        }
+      }
+    }
+
+    if (fields != NULL)
+      for (fcs_int i=0; i < nb; i++) {
+        fields[3*(start+i)] += block_fields[0][i];
+        fields[3*(start+i)+1] += block_fields[1][i];
+        fields[3*(start+i)+2] += block_fields[2][i];
+      }
+    if (potentials != NULL)
+      for (fcs_int i=0; i < nb; i++)
+        potentials[start+i] += block_potentials[i];
+  }
+}
+
+/* k-space contribution computed with the particles of all tasks (the
+   k-vectors are distributed) */
+static void ewald_compute_kspace_gathered(ewald_data_struct* d, 
     fcs_int num_particles,
     fcs_float *positions,
     fcs_float *charges,
     fcs_float *fields,
     fcs_float *potentials) {
 
-  FCS_INFO(fprintf(stderr, "ewald_compute_kspace started...\n"));
-
   /* DISTRIBUTE ALL PARTICLE DATA TO ALL NODES */
   /* Gather all particle numbers */
   int node_num_particles = num_particles;
@@ -181,108 +407,109 @@ void ewald_compute_kspace(ewald_data_struct* d,
   /* COMPUTE FAR FIELDS */
 
   /* evenly distribute the k-vectors onto all tasks */
-  fcs_int num_k_per_dir = 2*d->kmax+1;
-  fcs_int num_k = num_k_per_dir * num_k_per_dir * num_k_per_dir;
-  for (int k_ind = d->comm_rank; k_ind < num_k; k_ind += d->comm_size) {
-    /* compute fields and potentials */
-    fcs_int nx = 
-      k_ind % num_k_per_dir - d->kmax;
-    fcs_int ny = 
-      k_ind % (num_k_per_dir*num_k_per_dir) / num_k_per_dir - d->kmax;
-    fcs_int nz = 
-      k_ind / (num_k_per_dir*num_k_per_dir) - d->kmax;
-    if (nx*nx + ny*ny + nz*nz <= d->kmax*d->kmax) {
-      /* system length vector L_vec */
-      const fcs_float Lx = d->box_l[0];
-      const fcs_float Ly = d->box_l[1];
-      const fcs_float Lz = d->box_l[2];
-      /* reciprocal vector k_vec */
-      const fcs_float kx = 2.0*M_PI*nx / Lx;
-      const fcs_float ky = 2.0*M_PI*ny / Ly;
-      const fcs_float kz = 2.0*M_PI*nz / Lz;
-      /* reciprocal charge density rhohat */
-      fcs_float rhohat_re = 0.0;
-      fcs_float rhohat_im = 0.0;
-      
-      /* compute Deserno, Holm (1998) eq. (8) */
-      for (fcs_int i=0; i < total_particles; i++) {
-        /* charge q */
-        const fcs_float q = all_charges[i];
-        if (!fcs_float_is_zero(q)) {
-          /* particle position r_vec */
-          const fcs_float rx = all_positions[3*i];
-          const fcs_float ry = all_positions[3*i+1];
-          const fcs_float rz = all_positions[3*i+2];
-          /* compute k_vec*r_vec */
-          fcs_float kr = kx*rx + ky*ry + kz*rz;
-          /* rhohat = qi * exp(-i*k_vec*r_vec) */
-          rhohat_re += q * cos(kr);
-          rhohat_im += q * -sin(kr);
-        }
-      }
-      
-/*      FCS_DEBUG(fprintf(stderr, "  n_vec= (%d, %d, %d) rhohat_re=%e rhohat_im=%e\n",
-        nx, ny, nz, rhohat_re, rhohat_im));*/
-      
-      /* fetch influence function */
-      fcs_float g = d->G[linindex(abs(nx), abs(ny), abs(nz), d->kmax)];
-      for (fcs_int i=0; i < total_particles; i++) {
-        /* particle position r_vec */
-        const fcs_float rx = all_positions[3*i];
-        const fcs_float ry = all_positions[3*i+1];
-        const fcs_float rz = all_positions[3*i+2];
-        /* compute k_vec*r_vec */
-        fcs_float kr = kx*rx + ky*ry + kz*rz;
-
-        if (fields != NULL) {
-          /* compute field at position of particle i
-             compare to Deserno, Holm (1998) eq. (15) */
-          fcs_float fak1 = g * (rhohat_re*sin(kr) + rhohat_im*cos(kr));
-          node_fields[3*i] += kx * fak1;
-          node_fields[3*i+1] += ky * fak1;
-          node_fields[3*i+2] += kz * fak1;
-        }
-        if (potentials != NULL) {
-          /* compute potential at position of particle i
-             compare to Deserno, Holm (1998) eq. (9) */
-          node_potentials[i] += g * (rhohat_re*cos(kr) - rhohat_im*sin(kr));
-        }
-      }
-    }
-  }
+  fcs_int *kvectors;
+  fcs_float *kinfluence;
+  fcs_int num_k = ewald_kspace_vectors(d, d->comm_rank, d->comm_size, &kvectors, &kinfluence);
+
+  fcs_float *tables = malloc(sizeof(fcs_float) * EWALD_KSPACE_TABLES_SIZE(d->kmax));
+  fcs_float *rhohat = malloc(sizeof(fcs_float) * 2 * num_k);
+
+  double timing = fcs_timing_start();
+  ewald_kspace_rhohat(d, num_k, kvectors, total_particles, all_positions, all_charges, tables, rhohat);
+  fcs_timing_stop(FCS_PHASE_SPREAD, timing);
+
+/*  FCS_DEBUG(for (fcs_int k=0; k < num_k; k++) fprintf(stderr, "  n_vec= (%d, %d, %d) rhohat_re=%e rhohat_im=%e\n",
+    kvectors[3*k], kvectors[3*k+1], kvectors[3*k+2], rhohat[2*k], rhohat[2*k+1]));*/
+
+  timing = fcs_timing_start();
+  ewald_kspace_fields(d, num_k, kvectors, kinfluence, rhohat, total_particles, all_positions, tables,
+    (fields != NULL) ? node_fields : NULL, (potentials != NULL) ? node_potentials : NULL);
+  fcs_timing_stop(FCS_PHASE_INTERPOLATE, timing);
+
+  free(kvectors);
+  free(kinfluence);
+  free(tables);
+  free(rhohat);
   
   /* printf("%d: node_fields[0]=%lf\n", d->comm_rank, node_fields[0]); */
 
   /* REDISTRIBUTE COMPUTED FAR FIELDS AND POTENTIALS  */
-  if (fields != NULL) {
-    fcs_float all_fields[total_particles*3];
-    for (fcs_int pid=0; pid < total_particles; pid++) {
-      all_fields[3*pid] = 0.0;
-      all_fields[3*pid+1] = 0.0;
-      all_fields[3*pid+2] = 0.0;
-    }
+  /* Combine all fields and potentials and scatter them to the task
+     that holds the particle */
+  if (fields != NULL)
+    MPI_Reduce_scatter(node_fields, fields, node_particles3,
+      FCS_MPI_FLOAT, MPI_SUM, d->comm);
 
-    /* Combine all fields on master */
-    MPI_Reduce(node_fields, all_fields, total_particles*3, 
-      FCS_MPI_FLOAT, MPI_SUM, 0, d->comm);
-    /* if (d->comm_rank == 0) */
-    /*   printf("%d: all_fields[0]=%lf\n", d->comm_rank, all_fields[0]); */
-    /* Scatter the fields to the task that holds the particle */
-    MPI_Scatterv(all_fields, node_particles3, displs3, FCS_MPI_FLOAT,
-      fields, num_particles*3, FCS_MPI_FLOAT, 0, d->comm);
-  }
+  if (potentials != NULL)
+    MPI_Reduce_scatter(node_potentials, potentials, node_particles,
+      FCS_MPI_FLOAT, MPI_SUM, d->comm);
 
-  if (potentials != NULL) {
-    fcs_float all_potentials[total_particles];
-    for (fcs_int pid=0; pid < total_particles; pid++)
-      all_potentials[pid] = 0.0;
-    /* Combine all potentials on master */
-    MPI_Reduce(node_potentials, all_potentials, total_particles, 
-      FCS_MPI_FLOAT, MPI_SUM, 0, d->comm);
-    /* Scatter the potentials to the task that holds the particle */
-    MPI_Scatterv(all_potentials, node_particles, displs, FCS_MPI_FLOAT,
-      potentials, num_particles, FCS_MPI_FLOAT, 0, d->comm);
+  free(all_positions);
+  free(all_charges);
+  free(node_fields);
+  free(node_potentials);
+}
+
+/* k-space contribution computed with the local particles only (the
+   partial reciprocal charge densities of all k-vectors are summed up
+   over all tasks) */
+static void ewald_compute_kspace_distributed(ewald_data_struct* d, 
+    fcs_int num_particles,
+    fcs_float *positions,
+    fcs_float *charges,
+    fcs_float *fields,
+    fcs_float *potentials) {
+
+  /* all k-vectors on all tasks */
+  fcs_int *kvectors;
+  fcs_float *kinfluence;
+  fcs_int num_k = ewald_kspace_vectors(d, 0, 1, &kvectors, &kinfluence);
+
+  fcs_float *tables = malloc(sizeof(fcs_float) * EWALD_KSPACE_TABLES_SIZE(d->kmax));
+  fcs_float *rhohat = malloc(sizeof(fcs_float) * 2 * num_k);
+
+  /* compute partial rhohat of the local particles and sum up */
+  double timing = fcs_timing_start();
+  ewald_kspace_rhohat(d, num_k, kvectors, num_particles, positions, charges, tables, rhohat);
+  fcs_timing_stop(FCS_PHASE_SPREAD, timing);
+
+  timing = fcs_timing_start();
+  MPI_Allreduce(MPI_IN_PLACE, rhohat, 2 * num_k, FCS_MPI_FLOAT, MPI_SUM, d->comm);
+  fcs_timing_stop(FCS_PHASE_SOLVE, timing);
 
+  /* compute fields and potentials of the local particles */
+  if (fields != NULL)
+    for (fcs_int i=0; i < 3*num_particles; i++)
+      fields[i] = 0.0;
+  if (potentials != NULL)
+    for (fcs_int i=0; i < num_particles; i++)
+      potentials[i] = 0.0;
+
+  timing = fcs_timing_start();
+  ewald_kspace_fields(d, num_k, kvectors, kinfluence, rhohat, num_particles, positions, tables, fields, potentials);
+  fcs_timing_stop(FCS_PHASE_INTERPOLATE, timing);
+
+  free(kvectors);
+  free(kinfluence);
+  free(tables);
+  free(rhohat);
+}
+
+void ewald_compute_kspace(ewald_data_struct* d, 
+    fcs_int num_particles,
+    fcs_float *positions,
+    fcs_float *charges,
+    fcs_float *fields,
+    fcs_float *potentials) {
+
+  FCS_INFO(fprintf(stderr, "ewald_compute_kspace started...\n"));
+
+  if (d->distributed_kspace)
+    ewald_compute_kspace_distributed(d, num_particles, positions, charges, fields, potentials);
+  else
+    ewald_compute_kspace_gathered(d, num_particles, positions, charges, fields, potentials);
+
+  if (potentials != NULL) {
     /* subtract self potential */
     FCS_INFO(fprintf(stderr, "  subtracting self potential...\n"));
     for (fcs_int i=0; i < num_particles; i++) {
@@ -290,11 +517,6 @@ void ewald_compute_kspace(ewald_data_struct* d,
     }
   }
 
-  free(all_positions);
-  free(all_charges);
-  free(node_fields);
-  free(node_potentials);
-
   /* now each task should have its far field components */
   FCS_INFO(fprintf(stderr, "ewald_compute_kspace finished.\n"));
 }
@@ -368,6 +590,11 @@ void ewald_compute_rspace(ewald_data_struct* d,
   fcs_gridsort_set_particles(&gridsort, num_particles, max_num_particles,
     positions, charges);
 
+  if (d->balance_near) {
+    FCS_INFO(fprintf(stderr, "  calling fcs_gridsort_balance_bounds()...\n"));
+    fcs_gridsort_balance_bounds(&gridsort, NULL, d->comm_cart);
+  }
+
   FCS_INFO(fprintf(stderr, "  calling fcs_gridsort_sort_forward()...\n"));
   fcs_gridsort_sort_forward(&gridsort, d->r_cut, d->comm_cart);
   FCS_INFO(fprintf(stderr, "  returning from fcs_gridsort_sort_forward().\n"));
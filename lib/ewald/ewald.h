@@ -70,6 +70,11 @@
 
 #define MAXKMAX_DEFAULT 100
 
+/* number of particles that are processed together in the k-space sums */
+#define EWALD_KSPACE_BLOCK_SIZE 64
+/* size of the tables of exp(i*n*2*pi/L*r) for a block of particles */
+#define EWALD_KSPACE_TABLES_SIZE(_kmax_) (3 * (2 * (_kmax_) + 1) * 2 * EWALD_KSPACE_BLOCK_SIZE)
+
 
 /*static inline int on_root()
 {
@@ -116,6 +121,15 @@ typedef struct {
   /** maximal Kspace cutoff used by tuning */
   fcs_int maxkmax;
 
+  /** Whether the Kspace sums are computed with the local particles
+      only (instead of gathering all particles on all tasks) */
+  fcs_int distributed_kspace;
+
+  /** Whether the near field domain decomposition is balanced
+      according to the particle distribution (instead of using a
+      regular process grid) */
+  fcs_int balance_near;
+
   /* influence function */
   fcs_float* G;
 
@@ -40,6 +40,8 @@
 
 #include "mpi_fmm_sort.h"
 
+#include "common/fcs-common/FCSTiming.h"
+
 
 /*#define FMM_SORT_RADIX_1BIT*/
 
@@ -1398,6 +1400,8 @@ void mpi_fmm_sort_front_mem(
 #endif
 )
 {
+  double timing = fcs_timing_start();
+
 #ifdef WITH_SORT_FRONT_LOAD
   if (type && *type >= 2)
     mpi_fmm_sort_front_part_body(mem0, mem1, mem_sizes, depth, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, load, imba, nmin, nmax, 0, FCOMM_IFELSE(fcomm, NULL));
@@ -1406,6 +1410,8 @@ void mpi_fmm_sort_front_mem(
   else
 #endif
     mpi_fmm_sort_front_merge_body(mem0, mem1, mem_sizes, depth, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, FCOMM_IFELSE(fcomm, NULL));
+
+  fcs_timing_stop(FCS_PHASE_SORT, timing);
 }
 
 void mpi_fmm_sort_front_mem_(
@@ -1442,6 +1448,8 @@ void mpi_fmm_sort_front(
 #endif
 )
 {
+  double timing = fcs_timing_start();
+
 #ifdef WITH_SORT_FRONT_LOAD
   if (type && *type >= 2)
     mpi_fmm_sort_front_part_body(NULL, NULL, NULL, depth, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, load, imba, nmin, nmax, 0, FCOMM_IFELSE(fcomm, NULL));
@@ -1450,6 +1458,8 @@ void mpi_fmm_sort_front(
   else
 #endif
     mpi_fmm_sort_front_merge_body(NULL, NULL, NULL, depth, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, FCOMM_IFELSE(fcomm, NULL));
+
+  fcs_timing_stop(FCS_PHASE_SORT, timing);
 }
 
 void mpi_fmm_sort_front_(
@@ -1485,6 +1495,8 @@ void mpi_fmm_sort_front_3bit_mem(
 #endif
 )
 {
+  double timing = fcs_timing_start();
+
 #ifdef WITH_SORT_FRONT_LOAD
   if (type && *type >= 2)
     mpi_fmm_sort_front_part_body(mem0, mem1, mem_sizes, NULL, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, load, imba, nmin, nmax, 0, FCOMM_IFELSE(fcomm, NULL));
@@ -1493,6 +1505,8 @@ void mpi_fmm_sort_front_3bit_mem(
   else
 #endif
     mpi_fmm_sort_front_merge_body(mem0, mem1, mem_sizes, NULL, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, FCOMM_IFELSE(fcomm, NULL));
+
+  fcs_timing_stop(FCS_PHASE_SORT, timing);
 }
 
 void mpi_fmm_sort_front_3bit_mem_(
@@ -1527,6 +1541,8 @@ void mpi_fmm_sort_front_3bit(
 #endif
 )
 {
+  double timing = fcs_timing_start();
+
 #ifdef WITH_SORT_FRONT_LOAD
   if (type && *type >= 2)
     mpi_fmm_sort_front_part_body(NULL, NULL, NULL, NULL, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, load, imba, nmin, nmax, 0, FCOMM_IFELSE(fcomm, NULL));
@@ -1535,6 +1551,8 @@ void mpi_fmm_sort_front_3bit(
   else
 #endif
     mpi_fmm_sort_front_merge_body(NULL, NULL, NULL, NULL, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, FCOMM_IFELSE(fcomm, NULL));
+
+  fcs_timing_stop(FCS_PHASE_SORT, timing);
 }
 
 void mpi_fmm_sort_front_3bit_(
@@ -1570,6 +1588,8 @@ void mpi_fmm_sort_front_rebalance_mem(
 #endif
 )
 {
+  double timing = fcs_timing_start();
+
 #ifdef WITH_SORT_FRONT_LOAD
   if (type && *type >= 2)
     mpi_fmm_sort_front_part_body(mem0, mem1, mem_sizes, depth, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, load, imba, nmin, nmax, 1, FCOMM_IFELSE(fcomm, NULL));
@@ -1578,6 +1598,8 @@ void mpi_fmm_sort_front_rebalance_mem(
   else
 #endif
     mpi_fmm_sort_front_merge_body(mem0, mem1, mem_sizes, depth, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, FCOMM_IFELSE(fcomm, NULL));
+
+  fcs_timing_stop(FCS_PHASE_SORT, timing);
 }
 
 void mpi_fmm_sort_front_rebalance_mem_(
@@ -1614,6 +1636,8 @@ void mpi_fmm_sort_front_rebalance(
 #endif
 )
 {
+  double timing = fcs_timing_start();
+
 #ifdef WITH_SORT_FRONT_LOAD
   if (type && *type >= 2)
     mpi_fmm_sort_front_part_body(NULL, NULL, NULL, depth, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, load, imba, nmin, nmax, 1, FCOMM_IFELSE(fcomm, NULL));
@@ -1622,6 +1646,8 @@ void mpi_fmm_sort_front_rebalance(
   else
 #endif
     mpi_fmm_sort_front_merge_body(NULL, NULL, NULL, depth, subx, n, ibox, xyz, q, addr_desc, addr, scr, type, FCOMM_IFELSE(fcomm, NULL));
+
+  fcs_timing_stop(FCS_PHASE_SORT, timing);
 }
 
 void mpi_fmm_sort_front_rebalance_(
@@ -2781,10 +2807,14 @@ void mpi_fmm_sort_back_mem(
 #endif
 )
 {
+  double timing = fcs_timing_start();
+
   if (*nout >= 0 || mpi_fmm_sort_back_part)
     mpi_fmm_sort_back_part_body(mem0, mem1, mem_sizes, ntotal, nin, nout, addr, q, xyz, pot, grad, load, type, FCOMM_IFELSE(fcomm, NULL));
   else
     mpi_fmm_sort_back_merge_body(mem0, mem1, mem_sizes, ntotal, nin, addr, q, xyz, pot, grad, type, FCOMM_IFELSE(fcomm, NULL));
+
+  fcs_timing_stop(FCS_PHASE_BACK_SORT, timing);
 }
 
 void mpi_fmm_sort_back_mem_(
@@ -2810,10 +2840,14 @@ void mpi_fmm_sort_back(
 #endif
 )
 {
+  double timing = fcs_timing_start();
+
   if (*nout >= 0 || mpi_fmm_sort_back_part)
     mpi_fmm_sort_back_part_body(NULL, NULL, NULL, ntotal, nin, nout, addr, q, xyz, pot, grad, load, type, FCOMM_IFELSE(fcomm, NULL));
   else
     mpi_fmm_sort_back_merge_body(NULL, NULL, NULL, ntotal, nin, addr, q, xyz, pot, grad, type, FCOMM_IFELSE(fcomm, NULL));
+
+  fcs_timing_stop(FCS_PHASE_BACK_SORT, timing);
 }
 
 void mpi_fmm_sort_back_(
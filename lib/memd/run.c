@@ -30,6 +30,7 @@
 #include "helper_functions.h"
 #include "communication.h"
 #include "init.h"
+#include "FCSTiming.h"
 
 
 void ifcs_memd_assign_charges(memd_struct* memd, fcs_int local_num_real_particles, fcs_float* local_positions, fcs_float* local_charges, fcs_float* local_fields){
@@ -106,6 +107,8 @@ void ifcs_memd_run(void* rawdata, fcs_int num_particles, fcs_int max_num_particl
     if (potentials != NULL || memd->total_energy_flag)
         local_potentials = malloc(sizeof(fcs_float)*local_num_real_particles);
 
+    double timing = fcs_timing_start();
+
     if (memd->init_flag) {
         ifcs_memd_init(rawdata, memd->mpiparams.communicator);
         fcs_memd_setup_local_lattice(memd);
@@ -119,11 +122,15 @@ void ifcs_memd_run(void* rawdata, fcs_int num_particles, fcs_int max_num_particl
         printf("charges assigned.\n");
     }
     
+    fcs_timing_stop(FCS_PHASE_SPREAD, timing);
+
     printf("Charge transfer done\n"); fflush(stdout);
 
     fcs_float timestep = fcs_memd_get_time_step(rawdata);
     printf("Timestep: %f\n", timestep); fflush(stdout);
+    timing = fcs_timing_start();
     fcs_memd_propagate_B_field(memd, (timestep/2.0) );
     fcs_memd_calc_forces(memd);
     fcs_memd_propagate_B_field(memd, (timestep/2.0) );
+    fcs_timing_stop(FCS_PHASE_SOLVE, timing);
 }
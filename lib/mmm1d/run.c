@@ -23,17 +23,279 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "run.h"
 #include "types.h"
 #include "tune.h"
-#include "common/gridsort/gridsort.h"
 #include "FCSCommon.h"
-#include <stdlib.h>
-// #include <stdio.h>
-#include <math.h>
+#include "FCSTiming.h"
+
+/* the particles are redistributed if the largest local block exceeds the average block size by more than this fraction */
+#define MMM1D_MAX_IMBALANCE  0.05
+
+/* chunk size of the (dynamically scheduled) particle loop of the pair kernels */
+#define MMM1D_PAIRS_CHUNK  16
+
+static void mmm1d_coulomb_pair(mmm1d_data_struct *d, fcs_float disp[3], fcs_float *energy, fcs_float force[3]);
+
+/* particle blocks store the position and charge of each particle as [x, y, z, q],
+   result blocks store the field and potential of each particle as [fx, fy, fz, p] */
+
+/* compute the interactions of the particles of block 0 with the particles of block 1 (or among the particles of block 0 if xyzq1 is NULL),
+   the results of block 1 are accumulated only if fp1 is given, the particle loop is distributed over the threads and the results
+   of block 1 are accumulated in separate buffers of the threads */
+static void mmm1d_pairs(mmm1d_data_struct *d, fcs_int n0, fcs_float *xyzq0, fcs_float *fp0, fcs_int n1, fcs_float *xyzq1, fcs_float *fp1, fcs_int with_fields, fcs_int with_potentials)
+{
+  fcs_int self = (xyzq1 == NULL), m;
+  fcs_float *fpj, *buf = NULL;
+  int nthreads = 1;
+  double timing = fcs_timing_start();
+
+
+  if (self)
+  {
+    n1 = n0;
+    xyzq1 = xyzq0;
+    fp1 = fp0;
+  }
+
+  fcs_timing_count(FCS_COUNTER_NEAR_PAIRS, (self)?((long long) n0 * (n0 - 1) / 2):((long long) n0 * n1));
+
+  m = (fp1)?n1:0;
+  fpj = fp1;
+
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+
+  if (m > 0) buf = calloc(nthreads * 4 * m, sizeof(fcs_float));
+
+#ifdef _OPENMP
+  #pragma omp parallel num_threads(nthreads)
+#endif
+  {
+    fcs_int i, j, t;
+    fcs_float *bj = NULL, disp[3], field[3], eng, fi[4];
+
+#ifdef _OPENMP
+    if (buf) bj = buf + omp_get_thread_num() * 4 * m;
+#else
+    bj = buf;
+#endif
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, MMM1D_PAIRS_CHUNK)
+#endif
+    for (i = 0; i < n0; ++i)
+    {
+      fi[0] = fi[1] = fi[2] = fi[3] = 0;
+
+      for (j = (self)?(i + 1):0; j < n1; ++j)
+      {
+        disp[0] = xyzq0[4 * i + 0] - xyzq1[4 * j + 0];
+        disp[1] = xyzq0[4 * i + 1] - xyzq1[4 * j + 1];
+        disp[2] = xyzq0[4 * i + 2] - xyzq1[4 * j + 2];
+
+        mmm1d_coulomb_pair(d, disp, (with_potentials)?&eng:NULL, (with_fields)?field:NULL);
+
+        if (with_fields)
+        {
+          fi[0] += xyzq1[4 * j + 3] * field[0];
+          fi[1] += xyzq1[4 * j + 3] * field[1];
+          fi[2] += xyzq1[4 * j + 3] * field[2];
+
+          if (bj)
+          {
+            bj[4 * j + 0] -= xyzq0[4 * i + 3] * field[0];
+            bj[4 * j + 1] -= xyzq0[4 * i + 3] * field[1];
+            bj[4 * j + 2] -= xyzq0[4 * i + 3] * field[2];
+          }
+        }
+
+        if (with_potentials)
+        {
+          fi[3] += xyzq1[4 * j + 3] * eng;
+
+          if (bj) bj[4 * j + 3] += xyzq0[4 * i + 3] * eng;
+        }
+      }
+
+      fp0[4 * i + 0] += fi[0];
+      fp0[4 * i + 1] += fi[1];
+      fp0[4 * i + 2] += fi[2];
+      fp0[4 * i + 3] += fi[3];
+    }
+
+    /* the implicit barrier of the particle loop ensures that all results of block 0 are written before the buffers are added */
+    if (buf)
+    {
+#ifdef _OPENMP
+      #pragma omp for
+#endif
+      for (j = 0; j < 4 * m; ++j)
+        for (t = 0; t < nthreads; ++t) fpj[j] += buf[t * 4 * m + j];
+    }
+  }
+
+  if (buf) free(buf);
+
+  fcs_timing_stop(FCS_PHASE_NEAR, timing);
+}
+
+
+/* determine the send and receive counts (in number of floats) of the redistribution of the particles from the distribution all_n to
+   the balanced distribution, the first total*r/size ... total*(r+1)/size-1 particles (in the order of the processes) are assigned to process r */
+static void mmm1d_balance_counts(fcs_int *all_n, int size, int rank, int *scounts, int *sdispls, int *rcounts, int *rdispls)
+{
+  int r;
+  long long total, offset, my_low, my_high, low, high, tlow, thigh;
+
+
+  total = offset = 0;
+  for (r = 0; r < size; ++r)
+  {
+    if (r == rank) offset = total;
+    total += all_n[r];
+  }
+
+  my_low = offset;
+  my_high = offset + all_n[rank];
+
+  tlow = total * rank / size;
+  thigh = total * (rank + 1) / size;
+
+  offset = 0;
+  for (r = 0; r < size; ++r)
+  {
+    /* local particles that are assigned to process r */
+    low = total * r / size;
+    high = total * (r + 1) / size;
+    low = (low > my_low)?low:my_low;
+    high = (high < my_high)?high:my_high;
+    scounts[r] = (high > low)?(int) (4 * (high - low)):0;
+
+    /* particles of process r that are assigned to the local process */
+    low = offset;
+    high = offset + all_n[r];
+    low = (low > tlow)?low:tlow;
+    high = (high < thigh)?high:thigh;
+    rcounts[r] = (high > low)?(int) (4 * (high - low)):0;
+
+    offset += all_n[r];
+  }
+
+  sdispls[0] = rdispls[0] = 0;
+  for (r = 1; r < size; ++r)
+  {
+    sdispls[r] = sdispls[r - 1] + scounts[r - 1];
+    rdispls[r] = rdispls[r - 1] + rcounts[r - 1];
+  }
+}
+
+
+/* the particle blocks pass half of the processes along a ring and the interactions between two blocks are computed only once, the results
+   of the passing blocks are accumulated along the ring and finally sent back, the transfers of the next block overlap with the computations */
+static void mmm1d_half_ring(mmm1d_data_struct *d, fcs_int *all_n, fcs_float *xyzq, fcs_float *fp, fcs_int with_fields, fcs_int with_potentials, int size, int rank)
+{
+  fcs_int i, l, nsteps, cur, src, prev_n, other_n, max_n, n = all_n[rank];
+
+  fcs_float *other_xyzq[2], *other_fp[2], *other_xyz, *my_fp;
+
+  MPI_Request reqs[3], fp_req;
+
+  double timing;
+
+
+  max_n = 0;
+  for (l = 0; l < size; ++l) if (all_n[l] > max_n) max_n = all_n[l];
+
+  /* each pair of processes is computed once, for an even number of processes the blocks of opposite processes are computed on both processes (without symmetry) */
+  nsteps = size / 2;
+
+  other_xyzq[0] = malloc((max_n * 4 + 1) * sizeof(fcs_float));
+  other_xyzq[1] = malloc((max_n * 4 + 1) * sizeof(fcs_float));
+  other_fp[0] = malloc((max_n * 4 + 1) * sizeof(fcs_float));
+  other_fp[1] = malloc((max_n * 4 + 1) * sizeof(fcs_float));
+
+  cur = 0;
+  fp_req = MPI_REQUEST_NULL;
+
+  for (l = 0; l <= nsteps; ++l)
+  {
+    src = (rank - l + size) % size;
+    prev_n = all_n[(src - 1 + size) % size];
+    other_n = all_n[src];
+    other_xyz = (l == 0)?xyzq:other_xyzq[cur];
+
+    reqs[0] = reqs[1] = reqs[2] = MPI_REQUEST_NULL;
+
+    /* positions and charges of the current block are passed on before the computations */
+    if (l < nsteps)
+    {
+      MPI_Irecv(other_xyzq[1 - cur], prev_n * 4, FCS_MPI_FLOAT, (rank - 1 + size) % size, 0, d->comm, &reqs[0]);
+      MPI_Isend(other_xyz, other_n * 4, FCS_MPI_FLOAT, (rank + 1) % size, 0, d->comm, &reqs[1]);
+      fcs_timing_count(FCS_COUNTER_COMM_BYTES, prev_n * 4 * sizeof(fcs_float));
+      fcs_timing_count(FCS_COUNTER_GHOST_PARTICLES, prev_n);
+    }
+
+    if (l == 0) mmm1d_pairs(d, n, xyzq, fp, 0, NULL, NULL, with_fields, with_potentials);
+    else
+    {
+      /* results of the current block are accumulated by the previous processes */
+      if (l == 1) memset(other_fp[cur], 0, other_n * 4 * sizeof(fcs_float));
+      else
+      {
+        timing = fcs_timing_start();
+        MPI_Wait(&fp_req, MPI_STATUS_IGNORE);
+        fcs_timing_stop(FCS_PHASE_GHOSTS, timing);
+      }
+
+      if (2 * l == size) mmm1d_pairs(d, n, xyzq, fp, other_n, other_xyz, NULL, with_fields, with_potentials);
+      else mmm1d_pairs(d, n, xyzq, fp, other_n, other_xyz, other_fp[cur], with_fields, with_potentials);
+
+      /* results of the current block are passed on after the computations */
+      if (l < nsteps)
+      {
+        MPI_Isend(other_fp[cur], other_n * 4, FCS_MPI_FLOAT, (rank + 1) % size, 1, d->comm, &reqs[2]);
+        MPI_Irecv(other_fp[1 - cur], prev_n * 4, FCS_MPI_FLOAT, (rank - 1 + size) % size, 1, d->comm, &fp_req);
+        fcs_timing_count(FCS_COUNTER_COMM_BYTES, prev_n * 4 * sizeof(fcs_float));
+      }
+    }
+
+    timing = fcs_timing_start();
+    MPI_Waitall(3, reqs, MPI_STATUSES_IGNORE);
+    fcs_timing_stop(FCS_PHASE_GHOSTS, timing);
+
+    if (l > 0 && l == nsteps)
+    {
+      /* send the results of the last block back to its process and receive the results of the local block */
+      my_fp = malloc((n * 4 + 1) * sizeof(fcs_float));
+
+      timing = fcs_timing_start();
+      MPI_Sendrecv(other_fp[cur], other_n * 4, FCS_MPI_FLOAT, src, 2, my_fp, n * 4, FCS_MPI_FLOAT, (rank + nsteps) % size, 2, d->comm, MPI_STATUS_IGNORE);
+      fcs_timing_stop(FCS_PHASE_GHOSTS, timing);
+      fcs_timing_count(FCS_COUNTER_COMM_BYTES, n * 4 * sizeof(fcs_float));
+
+      for (i = 0; i < n * 4; ++i) fp[i] += my_fp[i];
+
+      free(my_fp);
+    }
+
+    cur = 1 - cur;
+  }
+
+  free(other_xyzq[0]);
+  free(other_xyzq[1]);
+  free(other_fp[0]);
+  free(other_fp[1]);
+}
 
-static fcs_float mmm1d_coulomb_pair_energy(mmm1d_data_struct *d, fcs_float disp[3]);
-static void mmm1d_coulomb_pair_force(mmm1d_data_struct *d, fcs_float disp[3], fcs_float force[3]);
 
 void mmm1d_run(void* rd,
         fcs_int num_particles,
@@ -44,336 +306,177 @@ void mmm1d_run(void* rd,
         fcs_float *potentials) {
   /* Here we assume, that the method is tuned and that all parameters are valid */
   mmm1d_data_struct *d = (mmm1d_data_struct*)rd;
-  
-  /* decompose system */
-  fcs_int local_num_particles=0;
-  fcs_int local_num_real_particles=0;
-  fcs_int *local_num_ghost_particles;
-  fcs_float *local_positions;
-  fcs_float *local_charges;
-  fcs_gridsort_index_t *local_indexes;
-  fcs_float box_base[3] = {0.0, 0.0, 0.0 };
-  fcs_float box_a[3] = {d->box_l[0], 0.0, 0.0 };
-  fcs_float box_b[3] = {0.0, d->box_l[1], 0.0 };
-  fcs_float box_c[3] = {0.0, 0.0, d->box_l[2] };
-  fcs_gridsort_t gridsort;
-  fcs_int comm_size;
+
+  int comm_size, comm_rank, r;
+  int *scounts, *sdispls, *rcounts, *rdispls;
+  fcs_int i, n, max_n, *all_n, balance;
+  long long total;
+  fcs_float *xyzq, *fp, *local_xyzq, *local_fp;
+  double timing;
+
   MPI_Comm_size(d->comm, &comm_size);
-  fcs_int comm_rank;
   MPI_Comm_rank(d->comm, &comm_rank);
 
-  fcs_gridsort_create(&gridsort);
-  fcs_gridsort_set_system(&gridsort, box_base, box_a, box_b, box_c, NULL);
-  fcs_gridsort_set_particles(&gridsort, num_particles, max_num_particles, positions, charges);
-  
-  fcs_gridsort_sort_forward(&gridsort, 0.0, d->comm);
+  /* the all-pairs computation does not depend on the location of the particles, only the number of particles per process has to be balanced */
+  all_n = malloc(comm_size * sizeof(fcs_int));
+  MPI_Allgather(&num_particles, 1, FCS_MPI_INT, all_n, 1, FCS_MPI_INT, d->comm);
 
-  fcs_gridsort_get_sorted_particles(&gridsort, &local_num_real_particles, NULL, &local_positions, &local_charges, &local_indexes);
-  
-  // fprintf(stderr, "rank %d, local particles %d\n", comm_rank, local_num_real_particles);
-  
-  /* assign workload to nodes and distribute ghosts */
-  // fprintf(stderr, "rank %d, assign workload to nodes\n", comm_rank);
-  fcs_int n_ghost_neighbors=0, n_clairvoyant_neighbors=0, n_ghosts=0;
-  fcs_int ghost_neighbors[(comm_size + 3)/2], clairvoyant_neighbors[(comm_size + 3)/2];
-  fcs_float **local_ghosts_positions = (fcs_float **)malloc((comm_size-1)*sizeof(fcs_float *));
-  fcs_float **local_ghosts_charges = (fcs_float **)malloc((comm_size-1)*sizeof(fcs_float *));
-  local_num_ghost_particles = (fcs_int *)malloc(sizeof(fcs_int)*(comm_size-1));
-  MPI_Status status;
-  for(fcs_int i=0; i< comm_size; i++) {
-    fcs_int p1 = i - comm_rank;
-    if (p1==0) continue;
-    if ((p1 > 0 && p1 % 2 == 0) || (p1 < 0 && -p1 % 2 == 1)) {
-      ghost_neighbors[n_ghost_neighbors]=i;
-      //printf("rank %d :receive workload from %d\n", comm_rank, i);
-      MPI_Recv(&n_ghosts, 1, FCS_MPI_INT, i, i, d->comm, &status);
-      local_num_ghost_particles[n_ghost_neighbors] = n_ghosts;
-      local_ghosts_positions[n_ghost_neighbors] = (fcs_float *)malloc(sizeof(fcs_float)*3*n_ghosts);
-      local_ghosts_charges[n_ghost_neighbors] = (fcs_float *)malloc(sizeof(fcs_float)*n_ghosts);
-      MPI_Recv(local_ghosts_positions[n_ghost_neighbors], 3*n_ghosts, FCS_MPI_FLOAT, i, i, d->comm, &status);
-      MPI_Recv(local_ghosts_charges[n_ghost_neighbors], n_ghosts, FCS_MPI_FLOAT, i, i, d->comm, &status);
-      n_ghost_neighbors++;
-    } else {
-      clairvoyant_neighbors[n_clairvoyant_neighbors]=i;
-      n_clairvoyant_neighbors++;
-      MPI_Send(&local_num_real_particles, 1, FCS_MPI_INT, i, comm_rank, d->comm);
-      MPI_Send(local_positions, 3*local_num_real_particles, FCS_MPI_FLOAT, i, comm_rank, d->comm);
-      MPI_Send(local_charges, local_num_real_particles, FCS_MPI_FLOAT, i, comm_rank, d->comm);
-      //printf("rank %d :send workload to %d\n", comm_rank, i);
-    }
+  total = max_n = 0;
+  for (r = 0; r < comm_size; ++r)
+  {
+    total += all_n[r];
+    if (all_n[r] > max_n) max_n = all_n[r];
   }
 
-  MPI_Barrier(d->comm);
-  
-  /* allocate local containers */
-  // fprintf(stderr, "rank %d, allocate containers\n", comm_rank);
-  fcs_float *local_fields = NULL;
-  fcs_float *local_potentials = NULL;
-  local_fields=malloc(sizeof(fcs_float)*3*local_num_real_particles);
-  local_potentials=malloc(sizeof(fcs_float)*local_num_real_particles);
-  for(fcs_int p1=0; p1<local_num_real_particles; p1++) {
-    fcs_int c1=3*p1;
-    local_fields[c1]=0;
-    local_fields[c1+1]=0;
-    local_fields[c1+2]=0;
-    local_potentials[p1]=0;
-  }
-  fcs_float **local_ghosts_fields = (fcs_float **)malloc(n_ghost_neighbors*sizeof(fcs_float *));
-  fcs_float **local_ghosts_potentials = (fcs_float **)malloc(n_ghost_neighbors*sizeof(fcs_float *));
-  for(fcs_int i=0; i<n_ghost_neighbors; i++) {
-    local_ghosts_fields[i]=(fcs_float *)malloc(3*local_num_ghost_particles[i]*sizeof(fcs_float));
-    local_ghosts_potentials[i]=(fcs_float *)malloc(local_num_ghost_particles[i]*sizeof(fcs_float));
-    for(fcs_int p1=0; p1<local_num_ghost_particles[i]; p1++) {
-      fcs_int c1=3*p1;
-      local_ghosts_fields[i][c1]=0;
-      local_ghosts_fields[i][c1+1]=0;
-      local_ghosts_fields[i][c1+2]=0;
-      local_ghosts_potentials[i][p1]=0;
-    }
-  }
-  
-  /* calculate local interactions */
-  // fprintf(stderr, "rank %d, local interactions\n", comm_rank);
-  for(fcs_int p1=0; p1<local_num_real_particles-1; p1++) {
-    fcs_int c1=3*p1;
-    fcs_float x1=local_positions[c1];
-    fcs_float y1=local_positions[c1+1];
-    fcs_float z1=local_positions[c1+2];
-  
-    for(fcs_int p2=p1+1; p2<local_num_real_particles; p2++) {
-      fcs_int c2=3*p2;
-      fcs_float x2=local_positions[c2];
-      fcs_float y2=local_positions[c2+1];
-      fcs_float z2=local_positions[c2+2];
-      
-      fcs_float disp[3];
-      mmm_distance2vec(x1,y1,z1,x2,y2,z2,disp);
-      // printf("mmm1d_run, selected real-real particles: %d, %d\n",p1,p2);
-
-      if (potentials) {
-        fcs_float eng = mmm1d_coulomb_pair_energy(d, disp);
-
-        local_potentials[p1]+=local_charges[p2]*eng;
-        local_potentials[p2]+=local_charges[p1]*eng;
-      }
+  balance = (max_n > (1.0 + MMM1D_MAX_IMBALANCE) * total / comm_size + 1);
 
-      if (fields) {
-        fcs_float field[3];
-        mmm1d_coulomb_pair_force(d, disp, field);
+  xyzq = malloc((num_particles * 4 + 1) * sizeof(fcs_float));
+  fp = malloc((num_particles * 4 + 1) * sizeof(fcs_float));
 
-        local_fields[c1]  += local_charges[p2]*field[0];
-        local_fields[c1+1]+= local_charges[p2]*field[1];
-        local_fields[c1+2]+= local_charges[p2]*field[2];
-        local_fields[c2]  +=-local_charges[p1]*field[0];
-        local_fields[c2+1]+=-local_charges[p1]*field[1];
-        local_fields[c2+2]+=-local_charges[p1]*field[2];
-      }
-    }
+  for (i = 0; i < num_particles; ++i)
+  {
+    xyzq[4 * i + 0] = positions[3 * i + 0];
+    xyzq[4 * i + 1] = positions[3 * i + 1];
+    xyzq[4 * i + 2] = positions[3 * i + 2];
+    xyzq[4 * i + 3] = charges[i];
   }
-  
-  /* calculate ghost interactions */
-  // fprintf(stderr, "rank %d, ghost interactions\n", comm_rank);
-  for(fcs_int p1=0; p1<local_num_real_particles; p1++) {
-    fcs_int c1=3*p1;
-    fcs_float x1=local_positions[c1];
-    fcs_float y1=local_positions[c1+1];
-    fcs_float z1=local_positions[c1+2];
-    for(fcs_int i=0; i<n_ghost_neighbors; i++){
-      for(fcs_int p2=0; p2<local_num_ghost_particles[i]; p2++) {
-        fcs_int c2=3*p2;
-        fcs_float x2=local_ghosts_positions[i][c2];
-        fcs_float y2=local_ghosts_positions[i][c2+1];
-        fcs_float z2=local_ghosts_positions[i][c2+2];
-
-
-        fcs_float disp[3];      
-        mmm_distance2vec(x1,y1,z1,x2,y2,z2,disp);
-        //printf("mmm1d_run, selected real-ghost particles: %d, %d\n",p1,p2);
-
-        if (potentials) {
-          fcs_float eng = mmm1d_coulomb_pair_energy(d, disp);
-
-          local_potentials[p1]          +=local_ghosts_charges[i][p2]*eng;
-          local_ghosts_potentials[i][p2]+=local_charges[p1]*eng;
-        }
-        if (fields) {
-          fcs_float field[3];
-          mmm1d_coulomb_pair_force(d, disp, field);
-
-          local_fields[c1]  +=local_ghosts_charges[i][p2]*field[0];
-          local_fields[c1+1]+=local_ghosts_charges[i][p2]*field[1];
-          local_fields[c1+2]+=local_ghosts_charges[i][p2]*field[2];
-          local_ghosts_fields[i][c2]  +=-local_charges[p1]*field[0];
-          local_ghosts_fields[i][c2+1]+=-local_charges[p1]*field[1];
-          local_ghosts_fields[i][c2+2]+=-local_charges[p1]*field[2];
-        }
-      }
-    }
-  }
-  
-  //printf("rank %d, locals: potential: %e, field 0: %e %e %e\n", comm_rank, local_potentials[0], local_fields[0], local_fields[1], local_fields[2]);
-  //if (comm_rank==1) printf("rank %d, local ghosts: potential: %e, field 0: %e %e %e\n", comm_rank, local_ghosts_potentials[0][0], local_ghosts_fields[0][0], local_ghosts_fields[0][1], local_ghosts_fields[0][2]);
-  
-  /* send back ghost interactions to neighbors */
-  // fprintf(stderr, "rank %d, send back ghosts\n", comm_rank);
-  fcs_float foreign_ghost_fields[3*local_num_real_particles], foreign_ghost_potentials[local_num_real_particles];
-  
-  fcs_int c1=0; fcs_int c2=0;
-  for(fcs_int i=0; i< comm_size; i++) {
-    fcs_int p1 = i - comm_rank;
-    if (p1==0) continue;
-    if ((p1 > 0 && p1 % 2 == 0) || (p1 < 0 && -p1 % 2 == 1)) {
-      //send:
-      if(local_num_ghost_particles[c1]>0) {
-        MPI_Send(local_ghosts_fields[c1], 3*local_num_ghost_particles[c1], FCS_MPI_FLOAT, ghost_neighbors[c1], comm_rank, d->comm);
-        MPI_Send(local_ghosts_potentials[c1], local_num_ghost_particles[c1], FCS_MPI_FLOAT, ghost_neighbors[c1], comm_rank, d->comm);
-      }
-      c1++;
-    } else {
-      //receive
-      if (local_num_real_particles>0) {
-        MPI_Recv(foreign_ghost_fields, 3*local_num_real_particles, FCS_MPI_FLOAT, clairvoyant_neighbors[c2], clairvoyant_neighbors[c2], d->comm, &status);
-        MPI_Recv(foreign_ghost_potentials, local_num_real_particles, FCS_MPI_FLOAT, clairvoyant_neighbors[c2], clairvoyant_neighbors[c2], d->comm, &status);
-        for(fcs_int p1=0; p1<local_num_real_particles; p1++) {
-          fcs_int p2=3*p1;
-          local_fields[p2]+=foreign_ghost_fields[p2];
-          local_fields[p2+1]+=foreign_ghost_fields[p2+1];
-          local_fields[p2+2]+=foreign_ghost_fields[p2+2];
-          local_potentials[p1]+=foreign_ghost_potentials[p2];
-        }
-      }
-      c2++;
-    }
+
+  scounts = sdispls = rcounts = rdispls = NULL;
+
+  if (balance)
+  {
+    timing = fcs_timing_start();
+
+    scounts = malloc(4 * comm_size * sizeof(int));
+    sdispls = scounts + 1 * comm_size;
+    rcounts = scounts + 2 * comm_size;
+    rdispls = scounts + 3 * comm_size;
+
+    mmm1d_balance_counts(all_n, comm_size, comm_rank, scounts, sdispls, rcounts, rdispls);
+
+    for (r = 0; r < comm_size; ++r) all_n[r] = (fcs_int) (total * (r + 1) / comm_size - total * r / comm_size);
+
+    n = all_n[comm_rank];
+    local_xyzq = malloc((n * 4 + 1) * sizeof(fcs_float));
+    local_fp = malloc((n * 4 + 1) * sizeof(fcs_float));
+
+    MPI_Alltoallv(xyzq, scounts, sdispls, FCS_MPI_FLOAT, local_xyzq, rcounts, rdispls, FCS_MPI_FLOAT, d->comm);
+
+    for (r = 0; r < comm_size; ++r) if (r != comm_rank) fcs_timing_count(FCS_COUNTER_COMM_BYTES, rcounts[r] * sizeof(fcs_float));
+
+    fcs_timing_stop(FCS_PHASE_SORT, timing);
+
+  } else
+  {
+    n = num_particles;
+    local_xyzq = xyzq;
+    local_fp = fp;
   }
-  
-  //printf("rank %d, local_potential 0: %e\n", comm_rank, local_potentials[0]);
-  
-  /* sort back, clean up and finish */
-  fcs_gridsort_set_sorted_results(&gridsort, local_num_particles, local_fields, local_potentials);
-  fcs_gridsort_set_results(&gridsort, max_num_particles, fields, potentials);
-  fcs_gridsort_sort_backward(&gridsort, d->comm);
-  
-  fcs_gridsort_free(&gridsort);
-  
-  fcs_gridsort_destroy(&gridsort);
-}
 
-fcs_float mmm1d_coulomb_pair_energy(mmm1d_data_struct *d, fcs_float disp[3])
-{
-  fcs_float rxy2, rxy2_d, z_d, E;
-  
-  rxy2   = disp[0]*disp[0] + disp[1]*disp[1];
-  rxy2_d = rxy2*d->uz2;
-  z_d    = disp[2]*d->uz;
-  
-  if (rxy2 <= d->far_switch_radius_2) {
-    //* near range formula *
-    fcs_float r2n, shift_z, add;
-    fcs_int n;
-
-    E = -2*MMM_COMMON_C_GAMMA;
-
-    //* polygamma summation *
-    r2n = 1.0;
-    for (n = 0; n < (d->polTaylor)->n_modPsi; n++) {
-      add = mmm_mod_psi_even(d->polTaylor, n, z_d)*r2n;
-      E -= add;
-      
-      if (fabs(add) < d->maxPWerror) break;
-      
-      r2n *= rxy2_d;
-    }
-    E *= d->uz;
+  memset(local_fp, 0, n * 4 * sizeof(fcs_float));
 
-    //* real space parts *
+  mmm1d_half_ring(d, all_n, local_xyzq, local_fp, (fields != NULL), (potentials != NULL), comm_size, comm_rank);
 
-    E += 1./sqrt(rxy2 + disp[2]*disp[2]); 
+  if (balance)
+  {
+    timing = fcs_timing_start();
 
-    shift_z = disp[2] + d->box_l[2];
-    E += 1./sqrt(rxy2 + shift_z*shift_z);
+    MPI_Alltoallv(local_fp, rcounts, rdispls, FCS_MPI_FLOAT, fp, scounts, sdispls, FCS_MPI_FLOAT, d->comm);
 
-    shift_z = disp[2] - d->box_l[2];
-    E += 1./sqrt(rxy2 + shift_z*shift_z);
+    for (r = 0; r < comm_size; ++r) if (r != comm_rank) fcs_timing_count(FCS_COUNTER_COMM_BYTES, scounts[r] * sizeof(fcs_float));
+
+    fcs_timing_stop(FCS_PHASE_BACK_SORT, timing);
+
+    free(local_xyzq);
+    free(local_fp);
+    free(scounts);
   }
-  else {
-    //* far range formula *
-    fcs_float rxy   = sqrt(rxy2);
-    fcs_float rxy_d = rxy*d->uz;
-    fcs_int bp;
-    // The first Bessel term will compensate a little bit the log term, so add them close together
-    E = -0.25*log(rxy2_d) + 0.5*(M_LN2 - MMM_COMMON_C_GAMMA);
-    for (bp = 1; bp < d->bessel_cutoff; bp++) {
-      if (d->bessel_radii[bp-1] < rxy) {
-        break;
-      }
-      fcs_float fq = MMM_COMMON_C_2PI*bp;
-      E += mmm_K0(fq*rxy_d)*cos(fq*z_d);
+
+  for (i = 0; i < num_particles; ++i)
+  {
+    if (fields)
+    {
+      fields[3 * i + 0] = fp[4 * i + 0];
+      fields[3 * i + 1] = fp[4 * i + 1];
+      fields[3 * i + 2] = fp[4 * i + 2];
     }
-    E *= 4.*d->uz;
+    if (potentials) potentials[i] = fp[4 * i + 3];
   }
-  
-  return E;
+
+  free(xyzq);
+  free(fp);
+  free(all_n);
 }
 
-void mmm1d_coulomb_pair_force(mmm1d_data_struct *d, fcs_float disp[3], fcs_float force[3])
+/* energy and/or force between two unit charges with distance vector disp (energy or force may be NULL),
+   both are computed within the same series to share the values of the polygamma and Bessel functions */
+void mmm1d_coulomb_pair(mmm1d_data_struct *d, fcs_float disp[3], fcs_float *energy, fcs_float force[3])
 {
   fcs_float rxy2, rxy2_d, z_d;
+  fcs_float E, Fx, Fy, Fz;
   fcs_float pref;
-  fcs_float Fx, Fy, Fz;
   
   rxy2   = disp[0]*disp[0] + disp[1]*disp[1];
   rxy2_d = rxy2*d->uz2;
   z_d    = disp[2]*d->uz;
   
-  //printf("rank %d, rxy2: %e, rxy2_d: %e, z_d: %e, far_switch_radius_2: %e\n", comm_rank, rxy2, rxy2_d, z_d, d->far_switch_radius_2);
-  
   if (rxy2 <= d->far_switch_radius_2) {
     // near range formula
-    fcs_float sr, sz, r2nm1, rt, rt2, shift_z;
-    fcs_int n;
+    fcs_float sr, sz, r2n, r2nm1, mpe, add, rt, rt2, shift_z;
+    fcs_int n, e_done, f_done;
+
+    // polygamma summation, each series stops individually when its terms become small enough
+    e_done = (energy == NULL);
+    f_done = (force == NULL);
 
-    // polygamma summation
+    E  = -2*MMM_COMMON_C_GAMMA;
     sr = 0;
-    sz = mmm_mod_psi_odd(d->polTaylor, 0, z_d);
-/*printf("rank %d, sz: %e\n", comm_rank, sz);
-for(n=0; n<d->polTaylor->n_modPsi; n++) {
-   fcs_int dim;
-   for(dim=0; dim<d->polTaylor->modPsi[n].n; dim++) {
-      printf("rank %d, taylor [%d][%d]: %e\n", comm_rank, n, dim, d->polTaylor->modPsi[n].e[dim]);
-  }
-}*/
+    sz = (f_done)?0:mmm_mod_psi_odd(d->polTaylor, 0, z_d);
+
+    r2n   = 1.0;
     r2nm1 = 1.0;
-    for (n = 1; n < (d->polTaylor)->n_modPsi; n++) {
-      fcs_float deriv = 2*n;
-      fcs_float mpe   = mmm_mod_psi_even(d->polTaylor, n, z_d);
-      fcs_float mpo   = mmm_mod_psi_odd(d->polTaylor, n, z_d);
-      fcs_float r2n   = r2nm1*rxy2_d;
+    for (n = 0; n < (d->polTaylor)->n_modPsi && !(e_done && f_done); n++) {
+      mpe = mmm_mod_psi_even(d->polTaylor, n, z_d);
 
-      sz +=         r2n*mpo;
-      sr += deriv*r2nm1*mpe;
+      if (!e_done) {
+        add = mpe*r2n;
+        E -= add;
+        if (fabs(add) < d->maxPWerror) e_done = 1;
+      }
 
-      if (fabs(deriv*r2nm1*mpe) < d->maxPWerror) break;
+      if (n > 0 && !f_done) {
+        sz += r2n*mmm_mod_psi_odd(d->polTaylor, n, z_d);
+        add = 2*n*r2nm1*mpe;
+        sr += add;
+        if (fabs(add) < d->maxPWerror) f_done = 1;
+      }
 
       r2nm1 = r2n;
+      r2n  *= rxy2_d;
     }
 
+    E *= d->uz;
+
     Fx = d->L3_i*sr*disp[0];
     Fy = d->L3_i*sr*disp[1];
     Fz = d->uz2*sz;
-    //printf("rank %d, F: %e %e %e\n", comm_rank, Fx, Fx, Fz);
 
     // real space parts
 
     shift_z = disp[2];
     rt2 = rxy2 + shift_z*shift_z;
-    pref = 1./(rt2*sqrt(rt2));
+    rt  = sqrt(rt2);
+    pref = 1./(rt2*rt);
+    E  += 1./rt;
     Fx += pref*disp[0];
     Fy += pref*disp[1];
-    Fz += pref*disp[2];
+    Fz += pref*shift_z;
 
     shift_z = disp[2] + d->box_l[2];
     rt2 = rxy2 + shift_z*shift_z;
-    pref = 1./(rt2*sqrt(rt2));
+    rt  = sqrt(rt2);
+    pref = 1./(rt2*rt);
+    E  += 1./rt;
     Fx += pref*disp[0];
     Fy += pref*disp[1];
     Fz += pref*shift_z;
@@ -381,46 +484,69 @@ for(n=0; n<d->polTaylor->n_modPsi; n++) {
     shift_z = disp[2] - d->box_l[2];
     rt2 = rxy2 + shift_z*shift_z;
     rt  = sqrt(rt2);
-    pref = 1./(rt2*rt); 
+    pref = 1./(rt2*rt);
+    E  += 1./rt;
     Fx += pref*disp[0];
     Fy += pref*disp[1];
     Fz += pref*shift_z;
-
-    force[0] = Fx;
-    force[1] = Fy;
-    force[2] = Fz;
   }
   else {
     // far range formula
     fcs_float rxy   = sqrt(rxy2);
     fcs_float rxy_d = rxy*d->uz;
     fcs_float sr = 0, sz = 0;
+    fcs_float fq, k0, k1, c1, s1, c, s, t;
     fcs_int bp;
 
+    // cos(fq*z_d) and sin(fq*z_d) of the successive Bessel terms are computed with the angle addition theorems
+    c1 = cos(MMM_COMMON_C_2PI*z_d);
+    s1 = sin(MMM_COMMON_C_2PI*z_d);
+    c  = c1;
+    s  = s1;
+
+    // The first Bessel term will compensate a little bit the log term, so add them close together
+    E = -0.25*log(rxy2_d) + 0.5*(M_LN2 - MMM_COMMON_C_GAMMA);
     for (bp = 1; bp < d->bessel_cutoff; bp++) {
       if (d->bessel_radii[bp-1] < rxy)
         break;
 
-      fcs_float fq = MMM_COMMON_C_2PI*bp, k0, k1;
-      
+      fq = MMM_COMMON_C_2PI*bp;
+
+      if (force) {
 #ifdef MMM_BESSEL_MACHINE_PREC
-      k0 = mmm_K0(fq*rxy_d);
-      k1 = mmm_K1(fq*rxy_d);
+        k0 = mmm_K0(fq*rxy_d);
+        k1 = mmm_K1(fq*rxy_d);
 #else
-      mmm_LPK01(fq*rxy_d, &k0, &k1);
+        mmm_LPK01(fq*rxy_d, &k0, &k1);
 #endif
-      sr += bp*k1*cos(fq*z_d);
-      sz += bp*k0*sin(fq*z_d);
+        sr += bp*k1*c;
+        sz += bp*k0*s;
+
+      } else k0 = mmm_K0(fq*rxy_d);
+
+      E += k0*c;
+
+      t = c*c1 - s*s1;
+      s = s*c1 + c*s1;
+      c = t;
     }
+    E *= 4.*d->uz;
+
     sr *= d->uz2*4*MMM_COMMON_C_2PI;
     sz *= d->uz2*4*MMM_COMMON_C_2PI;
     
     pref = 1.*(sr/rxy + 2*d->uz/rxy2);
 
-    force[0] = pref*disp[0];
-    force[1] = pref*disp[1];
-    force[2] = sz;
+    Fx = pref*disp[0];
+    Fy = pref*disp[1];
+    Fz = sz;
   }
 
-  //printf("rank: %d, disp: %e %e %e, charge1: %e, charge2: %e, force: %e %e %e\n", comm_rank, disp[0], disp[1], disp[2], charge1, charge2,  chpref * F[0], chpref * F[1], chpref * F[2]);
+  if (energy) *energy = E;
+
+  if (force) {
+    force[0] = Fx;
+    force[1] = Fy;
+    force[2] = Fz;
+  }
 }
@@ -81,6 +81,12 @@ void mmm2d_init(void **rd, MPI_Comm communicator) {
   d->n_scxcache = 0;
   d->scycache = NULL;
   d->n_scycache = 0;
+
+  d->max_scxcache = d->max_scycache = 0;
+  d->max_partblk = d->max_lclcblk = d->max_gblcblk = 0;
+
+  fcs_gridsort_create(&d->gridsort);
+  d->gridsort_cache = FCS_GRIDSORT_CACHE_NULL;
   
   d->needs_tuning=1;
   
@@ -102,6 +108,13 @@ static void sfree(void* ptr) {
 void mmm2d_destroy(void *rd) {
   if (rd != NULL) {
     mmm2d_data_struct *d = (mmm2d_data_struct*)rd;
+    fcs_gridsort_destroy(&d->gridsort);
+    fcs_gridsort_release_cache(&d->gridsort_cache);
+    sfree(d->scxcache);
+    sfree(d->scycache);
+    sfree(d->partblk);
+    sfree(d->lclcblk);
+    sfree(d->gblcblk);
     sfree(d);
   }
 }
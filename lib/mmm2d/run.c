@@ -32,6 +32,16 @@
 #include <stdio.h>
 #include <math.h>
 #include "FCSCommon.h"
+#include "FCSTiming.h"
+
+/* the progress output of all processes is only available with debugging enabled,
+   the processes are synchronized before each output (this is not required by the algorithm) */
+#if defined(FCS_ENABLE_DEBUG) || 0
+# define DEBUG_CMD(_cmd_)  do { MPI_Barrier(d->comm.mpicomm); _cmd_ } while (0)
+#else
+# define DEBUG_CMD(_cmd_)  do { } while (0)
+#endif
+#define DEBUG_PRINT_PREFIX  "MMM2D_DEBUG: "
 
 /***************************************************/
 /* FORWARD DECLARATIONS OF INTERNAL FUNCTIONS */
@@ -130,6 +140,8 @@ void mmm2d_run(void* rd,
   mmm2d_self_energy(d, charges, num_particles);
   //printf("rank %d, self_energy %f\n", d->comm.rank, d->self_energy);
   
+  d->total_energy = 0;
+  
   /* decompose system */
   fcs_int local_num_particles;
   fcs_int local_num_ghost_particles;
@@ -140,69 +152,39 @@ void mmm2d_run(void* rd,
   fcs_float box_a[3] = {d->box_l[0], 0.0, 0.0 };
   fcs_float box_b[3] = {0.0, d->box_l[1], 0.0 };
   fcs_float box_c[3] = {0.0, 0.0, d->box_l[2] };
-  fcs_gridsort_t gridsort;
   fcs_int zslices_nparticles[d->layers_per_node], zslices_ghost_nparticles[2];
   fcs_int i;
+  double timing;
   
-  fcs_gridsort_create(&gridsort);
-  
-  fcs_gridsort_set_system(&gridsort, box_base, box_a, box_b, box_c, NULL);
+  /* the gridsort object persists between the runs, only the system (which may have been retuned) and the particles are set again */
+  fcs_gridsort_set_system(&d->gridsort, box_base, box_a, box_b, box_c, NULL);
 
-  fcs_gridsort_set_zslices(&gridsort, d->layers_per_node, 1);
+  fcs_gridsort_set_zslices(&d->gridsort, d->layers_per_node, 1);
 
-  fcs_gridsort_set_particles(&gridsort, num_particles, max_num_particles, positions, charges);
-  
-  MPI_Barrier(d->comm.mpicomm);
-  fprintf(stderr,"mmm2d_run, %d\n", d->comm.rank);
-  //printf("layer_h: %f\n",d->layer_h);
-  
-  //printf("  calling fcs_gridsort_sort_forward()...\n");
-  
-  fcs_gridsort_sort_forward(&gridsort, 0.0, d->comm.mpicomm);
+  fcs_gridsort_set_particles(&d->gridsort, num_particles, max_num_particles, positions, charges);
+
+  fcs_gridsort_set_cache(&d->gridsort, &d->gridsort_cache);
   
-  MPI_Barrier(d->comm.mpicomm);
-  //printf("  returning from fcs_gridsort_sort_forward().\n");
+  DEBUG_CMD(fprintf(stderr, DEBUG_PRINT_PREFIX "rank %d, mmm2d_run\n", d->comm.rank););
   
-  fcs_gridsort_separate_ghosts(&gridsort);
-  //printf("  rank %d, separate ghosts\n", d->comm.rank);
+  fcs_gridsort_sort_forward(&d->gridsort, 0.0, d->comm.mpicomm);
   
-  //printf("  calling separate zslices\n");
-  fcs_gridsort_separate_zslices(&gridsort, &zslices_ghost_nparticles[0], zslices_nparticles, &zslices_ghost_nparticles[1]);
+  fcs_gridsort_separate_ghosts(&d->gridsort);
   
-  //printf("  rank %d, separate zslices: layers_per_node %d... ", d->comm.rank, d->layers_per_node);
-  /*
-  for (i=0; i<d->layers_per_node; i++) {
-    printf("rank %d, layer %d: %d parts, ", d->comm.rank, i+1, zslices_nparticles[i]);
-  }
-  printf("\n");
-  printf("rank %d, low ghost layer: %d parts\n", d->comm.rank, zslices_ghost_nparticles[0]);
-  printf("rank %d, high ghost layer: %d parts\n", d->comm.rank, zslices_ghost_nparticles[1]);
-  */
+  fcs_gridsort_separate_zslices(&d->gridsort, &zslices_ghost_nparticles[0], zslices_nparticles, &zslices_ghost_nparticles[1]);
   
-  MPI_Barrier(d->comm.mpicomm);
-  
-  fcs_gridsort_get_real_particles(&gridsort, &local_num_particles, &local_positions, &local_charges, &local_indices);
+  fcs_gridsort_get_real_particles(&d->gridsort, &local_num_particles, &local_positions, &local_charges, &local_indices);
   
   d->n_localpart=local_num_particles;
   d->local_charges=local_charges;
   d->local_positions=local_positions;
   d->zslices_nparticles=zslices_nparticles;
   
-  MPI_Barrier(d->comm.mpicomm);
-  fprintf(stderr, "rank %d, local particles: %d\n", d->comm.rank, d->n_localpart);
-  /*
-  if (d->n_localpart>0) {
-   printf("rank %d, test part[0]: local pos %f, global pos %f\n", d->comm.rank, local_positions[0], (d->local_positions)[0]);
-  }
-  */
-  
-  fcs_gridsort_get_ghost_particles(&gridsort, &local_num_ghost_particles, &local_ghost_positions, &local_ghost_charges, &local_ghost_indices);
+  fcs_gridsort_get_ghost_particles(&d->gridsort, &local_num_ghost_particles, &local_ghost_positions, &local_ghost_charges, &local_ghost_indices);
   
-  MPI_Barrier(d->comm.mpicomm);
-  fprintf(stderr, "rank %d, ghost particles: %d\n", d->comm.rank, zslices_nparticles[0]+zslices_nparticles[1]);
+  DEBUG_CMD(fprintf(stderr, DEBUG_PRINT_PREFIX "rank %d, local particles: %" FCS_LMOD_INT "d, ghost particles: %" FCS_LMOD_INT "d\n", d->comm.rank, d->n_localpart, local_num_ghost_particles););
   
   /* allocate local forces */
-  fprintf(stderr, "rank %d, allocate local containers\n", d->comm.rank);
   fcs_float *local_forces = NULL;
   //fcs_float *local_potentials = NULL;
   if (forces != NULL) {
@@ -218,12 +200,15 @@ void mmm2d_run(void* rd,
   fcs_int j, c, ci, cj, di, dj, np, npb, offset=0, offsetb=0;
   fcs_float disp[3]={0., 0., 0.}, displ;
   
+  timing = fcs_timing_start();
+
   /* near formula force calculation */
-  fprintf(stderr, "rank %d, near formula force calculation\n", d->comm.rank);
   if (forces != NULL) {
     fcs_float force[3]={0., 0., 0.};
     for (c = 0; c < d->layers_per_node; c++) {
       np   = d->zslices_nparticles[c];
+      npb  = (c>0)?d->zslices_nparticles[c-1]:zslices_ghost_nparticles[0];
+      fcs_timing_count(FCS_COUNTER_NEAR_PAIRS, (long long) np*(np-1)/2 + (long long) np*npb + ((c==d->layers_per_node-1)?(long long) np*zslices_ghost_nparticles[1]:0));
       ///@TODO: optimize indexes for minimum calculations
       for(i = 0; i < np; i++) {
         ci=i+offset;
@@ -297,12 +282,13 @@ void mmm2d_run(void* rd,
   }
   
   /* near formula energy calculations */
-  fprintf(stderr, "rank %d, near formula energy calculation\n", d->comm.rank);
   if (d->require_total_energy) {
     offset=0;
     offsetb=0;
     for (c = 0; c < d->layers_per_node; c++) {
       np   = zslices_nparticles[c];
+      npb  = (c>0)?zslices_nparticles[c-1]:zslices_ghost_nparticles[0];
+      fcs_timing_count(FCS_COUNTER_NEAR_PAIRS, (long long) np*(np-1)/2 + (long long) np*npb);
       for(i = 0; i < np; i++) {
         ci=i+offset;
         di=3*ci;
@@ -367,8 +353,11 @@ void mmm2d_run(void* rd,
     }
   }
   
+  fcs_timing_stop(FCS_PHASE_NEAR, timing);
+  
+  timing = fcs_timing_start();
+  
   /* far formula force and energy calculations */
-  fprintf(stderr, "rank %d, far formula calculations\n", d->comm.rank);
   /* allocate far formmula caches */
   ///@TODO: only if far formula is needed
   realloc_caches(d);
@@ -379,13 +368,14 @@ void mmm2d_run(void* rd,
     mmm2d_pair_interactions_far(d, local_forces);
   }
   
-  fprintf(stderr, "rank %d, dielectric contrasts contributions\n", d->comm.rank);
   /* forces from dielectric layers */
   if (forces != NULL && d->dielectric_contrast_on) dielectric_layers_force_contribution(d, local_forces);
   
   /* potentials from dielectric layers */
   if (d->require_total_energy && d->dielectric_contrast_on) d->total_energy+=dielectric_layers_energy_contribution(d);
   
+  fcs_timing_stop(FCS_PHASE_SOLVE, timing);
+  
   /* add total forces */
   /*
   if (forces != NULL) {
@@ -399,14 +389,19 @@ void mmm2d_run(void* rd,
   }
   */
   
-  /* clean up and finish */
-  fcs_gridsort_set_sorted_results(&gridsort, local_num_particles, local_forces, NULL);
-  fcs_gridsort_set_results(&gridsort, max_num_particles, forces, NULL);
-  fcs_gridsort_sort_backward(&gridsort, d->comm.mpicomm);
+  /* clean up and finish (the sorted particles are released, the gridsort object is kept for the next run) */
+  fcs_gridsort_set_sorted_results(&d->gridsort, local_num_particles, local_forces, NULL);
+  fcs_gridsort_set_results(&d->gridsort, max_num_particles, forces, NULL);
+  fcs_gridsort_sort_backward(&d->gridsort, d->comm.mpicomm);
   
-  fcs_gridsort_free(&gridsort);
+  fcs_gridsort_free(&d->gridsort);
   
-  fcs_gridsort_destroy(&gridsort);
+  if (local_forces) free(local_forces);
+  
+  d->n_localpart = 0;
+  d->local_charges = NULL;
+  d->local_positions = NULL;
+  d->zslices_nparticles = NULL;
   
   fcs_float total_energy;
   //MPI_Reduce(&d->total_energy, &total_energy, 1, FCS_MPI_FLOAT, MPI_SUM, 0, d->comm.mpicomm);
@@ -748,7 +743,6 @@ static fcs_float mmm2d_pair_interactions_far(mmm2d_data_struct *d, fcs_float *fo
   
   undone = malloc((d->n_scxcache + 1)*sizeof(fcs_int));
   
-  fprintf(stderr, "rank %d, preparing sc caches\n", d->comm.rank);
   prepare_scx_cache(d);
   prepare_scy_cache(d);
   
@@ -808,51 +802,61 @@ static fcs_float mmm2d_pair_interactions_far(mmm2d_data_struct *d, fcs_float *fo
   return 0.5*eng;
 }
 
+/* the caches and buffers are only enlarged, i.e., they are reused as long as the number of local particles and the far cutoff do not increase */
+static void *grow_buffer(void *p, fcs_int *max_n, fcs_int n, size_t size)
+{
+  if (n <= *max_n) return p;
+
+  *max_n = n;
+
+  return realloc(p, n * size);
+}
+
 static void realloc_caches(mmm2d_data_struct *d)
 {
   d->n_scxcache = (fcs_int)(ceil(d->far_cut/d->ux) + 1.);
   d->n_scycache = (fcs_int)(ceil(d->far_cut/d->uy) + 1.);
-  d->scxcache = realloc(d->scxcache, d->n_scxcache*d->n_localpart*sizeof(mmm2d_SCCache));
-  d->scycache = realloc(d->scycache, d->n_scycache*d->n_localpart*sizeof(mmm2d_SCCache));
-  d->partblk   = realloc(d->partblk,  d->n_localpart*8*sizeof(fcs_float));
-  d->lclcblk   = realloc(d->lclcblk,  d->n_total_layers*8*sizeof(fcs_float));
-  d->gblcblk   = realloc(d->gblcblk,  d->layers_per_node*8*sizeof(fcs_float));
+  d->scxcache = grow_buffer(d->scxcache, &d->max_scxcache, d->n_scxcache*d->n_localpart, sizeof(mmm2d_SCCache));
+  d->scycache = grow_buffer(d->scycache, &d->max_scycache, d->n_scycache*d->n_localpart, sizeof(mmm2d_SCCache));
+  d->partblk  = grow_buffer(d->partblk, &d->max_partblk, d->n_localpart*8, sizeof(fcs_float));
+  d->lclcblk  = grow_buffer(d->lclcblk, &d->max_lclcblk, d->n_total_layers*8, sizeof(fcs_float));
+  d->gblcblk  = grow_buffer(d->gblcblk, &d->max_gblcblk, d->layers_per_node*8, sizeof(fcs_float));
 }
 
-static void prepare_scx_cache(mmm2d_data_struct *d)
+/* the sin/cos values of the higher frequencies are computed incrementally from the values of the lower frequencies using the angle addition theorems,
+   i.e., sin and cos are evaluated only once per particle */
+static void prepare_sc_cache(mmm2d_SCCache *cache, fcs_int n_cache, fcs_float u, fcs_float *positions, fcs_int n_localpart)
 {
-  fcs_int i, ic, freq, o;
-  fcs_float pref, arg;
-  //printf("prepare_scx_cache: n_sxc: %d, n_local %d\n", d->n_scxcache, d->n_localpart);
-  for (freq = 1; freq <= d->n_scxcache; freq++) {
-    pref = MMM_COMMON_C_2PI*d->ux*freq;
-    o = (freq-1)*d->n_localpart;
-    ic = 0;
-    for (i = 0; i < d->n_localpart; i++) {
-      arg = pref*d->local_positions[i*3];
-      d->scxcache[o + ic].s = sin(arg);
-      d->scxcache[o + ic].c = cos(arg);
-      ic++;
+  fcs_int i, freq, o;
+  fcs_float arg, s1, c1;
+
+  if (n_cache < 1) return;
+
+  for (i = 0; i < n_localpart; i++) {
+    arg = MMM_COMMON_C_2PI*u*positions[i*3];
+    cache[i].s = sin(arg);
+    cache[i].c = cos(arg);
+  }
+
+  for (freq = 2; freq <= n_cache; freq++) {
+    o = (freq-1)*n_localpart;
+    for (i = 0; i < n_localpart; i++) {
+      s1 = cache[i].s;
+      c1 = cache[i].c;
+      cache[o + i].s = cache[o - n_localpart + i].s*c1 + cache[o - n_localpart + i].c*s1;
+      cache[o + i].c = cache[o - n_localpart + i].c*c1 - cache[o - n_localpart + i].s*s1;
     }
   }
 }
 
+static void prepare_scx_cache(mmm2d_data_struct *d)
+{
+  prepare_sc_cache(d->scxcache, d->n_scxcache, d->ux, d->local_positions, d->n_localpart);
+}
+
 static void prepare_scy_cache(mmm2d_data_struct *d)
 {
-  fcs_int i, ic, freq, o;
-  fcs_float pref, arg;
-
-  for (freq = 1; freq <= d->n_scycache; freq++) {
-    pref = MMM_COMMON_C_2PI*d->uy*freq;
-    o = (freq-1)*d->n_localpart;
-    ic = 0;
-    for (i = 0; i < d->n_localpart; i++) {
-      arg = pref*d->local_positions[i*3+1];
-      d->scycache[o + ic].s = sin(arg);
-      d->scycache[o + ic].c = cos(arg);
-      ic++;
-    }
-  }
+  prepare_sc_cache(d->scycache, d->n_scycache, d->uy, d->local_positions + 1, d->n_localpart);
 }
 
 /*****************************************************************/
@@ -1762,6 +1766,7 @@ static void distribute(mmm2d_data_struct *d, fcs_int e_size, fcs_float fac)
     else if (node + 1 == d->comm.rank) {
        //printf("rank %d, node %d, Recv 1!!!!!!! %d, %d\n", d->comm.rank, node, e_size, sizeof(recvbuf));
       MPI_Recv(recvbuf, 2*e_size, FCS_MPI_FLOAT, node, 0, d->comm.mpicomm, &status);
+      fcs_timing_count(FCS_COUNTER_COMM_BYTES, 2*e_size*sizeof(fcs_float));
       copy_vec(blwentry(d->gblcblk, 0, e_size), recvbuf, e_size);
       copy_vec(blwentry(d->lclcblk, 0, e_size), recvbuf + e_size, e_size);
     }
@@ -1784,6 +1789,7 @@ static void distribute(mmm2d_data_struct *d, fcs_int e_size, fcs_float fac)
     else if (inv_node - 1 == d->comm.rank) {
        //printf("rank %d, node %d, Recv 2!!!!!!! %d, %d\n", d->comm.rank, node, e_size, sizeof(recvbuf));
       MPI_Recv(recvbuf, 2*e_size, FCS_MPI_FLOAT, inv_node, 0, d->comm.mpicomm, &status);
+      fcs_timing_count(FCS_COUNTER_COMM_BYTES, 2*e_size*sizeof(fcs_float));
       copy_vec(abventry(d->gblcblk, d->layers_per_node - 1, e_size), recvbuf, e_size);
       copy_vec(abventry(d->lclcblk, d->layers_per_node + 1, e_size), recvbuf + e_size, e_size);
     }
@@ -1797,7 +1803,7 @@ static void gather_image_contributions(mmm2d_data_struct *d, fcs_int e_size)
   fcs_float recvbuf[8];
 
   //* collect the image charge contributions with at least a layer distance 
-  MPI_Allreduce(d->lclimge, recvbuf, 2*e_size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(d->lclimge, recvbuf, 2*e_size, FCS_MPI_FLOAT, MPI_SUM, d->comm.mpicomm);
 
   if (d->comm.rank == 0)
     /* the gblcblk contains all contributions from layers deeper than one layer below our system,
@@ -257,10 +257,7 @@ FCSResult mmm2d_check_system_charges(mmm2d_data_struct *d,
       local_charge += charges[i];
     }
   }
-  fprintf(stderr,"check charges: rank %d\n",d->comm.rank);
-  fprintf(stderr, "local_charges %d, net charge %e\n", num_particles, local_charge);
   MPI_Allreduce(&local_charge, &total_charge, 1, FCS_MPI_FLOAT, MPI_SUM, d->comm.mpicomm);
   d->total_charge=total_charge;
-  fprintf(stderr, "total charge %e\n", d->total_charge);
   return NULL;
 }
@@ -27,6 +27,7 @@
 #endif
 #include "communication.h"
 #include "common/mmm-common/specfunc.h"
+#include "common/gridsort/gridsort.h"
 
 /* DEFAULTS */
 /** Default for the accuracy. */
@@ -162,6 +163,8 @@ typedef struct {
   fcs_int    n_scxcache;
   mmm2d_SCCache *scycache;
   fcs_int    n_scycache;
+  /** allocated sizes of the sin/cos caches and the temporary buffers (they are only enlarged between the runs) */
+  fcs_int max_scxcache, max_scycache, max_partblk, max_lclcblk, max_gblcblk;
 
   /** height of the layers and minimal z for far formula */
   fcs_float layer_h;
@@ -181,6 +184,12 @@ typedef struct {
 
   fcs_float self_energy;
   
+  /* z-slice decomposition of the particles (kept between the runs) */
+  fcs_gridsort_t gridsort;
+
+  /* gridsort cache */
+  fcs_gridsort_cache_t gridsort_cache;
+
   /* containers for the local particles */
   fcs_int n_localpart;
   fcs_float *local_charges;
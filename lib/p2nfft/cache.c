@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2011-2013 Michael Pippig
+ *
+ * This file is part of ScaFaCoS.
+ * 
+ * ScaFaCoS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ScaFaCoS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *	
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#include "cache.h"
+
+/* identifies cache files and their format version */
+#define FCS_P2NFFT_CACHE_MAGIC "P2NFFTC1"
+
+static unsigned long long hash_key(
+    const char *name, const ifcs_p2nfft_cache_key *key);
+static void get_file_name(
+    const char *dir, const char *name, const ifcs_p2nfft_cache_key *key,
+    MPI_Comm comm, char *file_name, size_t len);
+static void get_tmp_name(
+    const char *file_name, char *tmp_name, size_t len);
+
+
+void ifcs_p2nfft_cache_key_init(
+    ifcs_p2nfft_cache_key *key
+    )
+{
+  key->num = 0;
+}
+
+void ifcs_p2nfft_cache_key_add(
+    ifcs_p2nfft_cache_key *key, const fcs_float *val, fcs_int num
+    )
+{
+  if(key->num < 0 || num > FCS_P2NFFT_CACHE_MAX_KEY - key->num){
+    key->num = -1;
+    return;
+  }
+
+  for(fcs_int t=0; t<num; t++)
+    key->val[key->num++] = val[t];
+}
+
+void ifcs_p2nfft_cache_key_add_int(
+    ifcs_p2nfft_cache_key *key, const fcs_int *val, fcs_int num
+    )
+{
+  if(key->num < 0 || num > FCS_P2NFFT_CACHE_MAX_KEY - key->num){
+    key->num = -1;
+    return;
+  }
+
+  for(fcs_int t=0; t<num; t++)
+    key->val[key->num++] = (fcs_float) val[t];
+}
+
+int ifcs_p2nfft_cache_load(
+    const char *dir, const char *name, const ifcs_p2nfft_cache_key *key,
+    void *buf, size_t nbytes, MPI_Comm comm
+    )
+{
+  char file_name[FILENAME_MAX], magic[8];
+  ifcs_p2nfft_cache_key file_key;
+  unsigned long long file_nbytes;
+  int found = 0, all_found;
+  FILE *file;
+
+  if(dir == NULL || key->num < 0)
+    return 0;
+
+  get_file_name(dir, name, key, comm, file_name, sizeof(file_name));
+
+  file = fopen(file_name, "rb");
+  if(file != NULL){
+    file_key.num = 0;
+    if(   fread(magic, sizeof(magic), 1, file) == 1
+       && memcmp(magic, FCS_P2NFFT_CACHE_MAGIC, sizeof(magic)) == 0
+       && fread(&file_key.num, sizeof(file_key.num), 1, file) == 1
+       && file_key.num == key->num
+       && fread(file_key.val, sizeof(fcs_float), file_key.num, file) == (size_t) file_key.num
+       && memcmp(file_key.val, key->val, sizeof(fcs_float) * key->num) == 0
+       && fread(&file_nbytes, sizeof(file_nbytes), 1, file) == 1
+       && file_nbytes == nbytes)
+      found = (nbytes == 0 || fread(buf, nbytes, 1, file) == 1)
+           && fgetc(file) == EOF; /* reject files with trailing data */
+    fclose(file);
+  }
+
+  /* use the cached data only if it is available on all processes */
+  MPI_Allreduce(&found, &all_found, 1, MPI_INT, MPI_MIN, comm);
+
+  return all_found;
+}
+
+void ifcs_p2nfft_cache_store(
+    const char *dir, const char *name, const ifcs_p2nfft_cache_key *key,
+    const void *buf, size_t nbytes, MPI_Comm comm
+    )
+{
+  char file_name[FILENAME_MAX], tmp_name[FILENAME_MAX + MPI_MAX_PROCESSOR_NAME + 32];
+  unsigned long long file_nbytes = nbytes;
+  int ok;
+  FILE *file;
+
+  if(dir == NULL || key->num < 0)
+    return;
+
+  get_file_name(dir, name, key, comm, file_name, sizeof(file_name));
+
+  /* write to a temporary file of this process and rename it afterwards,
+   * so that no other run sees a partially written file */
+  get_tmp_name(file_name, tmp_name, sizeof(tmp_name));
+
+  file = fopen(tmp_name, "wb");
+  if(file == NULL)
+    return;
+
+  ok =    fwrite(FCS_P2NFFT_CACHE_MAGIC, 8, 1, file) == 1
+       && fwrite(&key->num, sizeof(key->num), 1, file) == 1
+       && fwrite(key->val, sizeof(fcs_float), key->num, file) == (size_t) key->num
+       && fwrite(&file_nbytes, sizeof(file_nbytes), 1, file) == 1
+       && (nbytes == 0 || fwrite(buf, nbytes, 1, file) == 1);
+
+  if(fclose(file) != 0)
+    ok = 0;
+
+  if(!ok || rename(tmp_name, file_name) != 0)
+    remove(tmp_name);
+}
+
+
+/* FNV-1a hash of the name and the key */
+static unsigned long long hash_key(
+    const char *name, const ifcs_p2nfft_cache_key *key
+    )
+{
+  unsigned long long h = 14695981039346656037ULL;
+  const unsigned char *c;
+
+  for(c = (const unsigned char *) name; *c; c++)
+    h = (h ^ *c) * 1099511628211ULL;
+
+  c = (const unsigned char *) key->val;
+  for(size_t i=0; i<sizeof(fcs_float) * key->num; i++)
+    h = (h ^ c[i]) * 1099511628211ULL;
+
+  return h;
+}
+
+static void get_file_name(
+    const char *dir, const char *name, const ifcs_p2nfft_cache_key *key,
+    MPI_Comm comm, char *file_name, size_t len
+    )
+{
+  int rank, size;
+
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  snprintf(file_name, len, "%s/p2nfft_%s_%016llx_%d_%d.bin",
+      dir, name, hash_key(name, key), size, rank);
+}
+
+/* the name of the temporary file is unique for each writing process,
+ * concurrent runs with the same cache directory do not write to the same file */
+static void get_tmp_name(
+    const char *file_name, char *tmp_name, size_t len
+    )
+{
+  char host[MPI_MAX_PROCESSOR_NAME + 1];
+  int host_len, i;
+  long pid = 0;
+
+  MPI_Get_processor_name(host, &host_len);
+  for(i=0; i<host_len; i++)
+    if(!isalnum((unsigned char) host[i]) && host[i] != '-' && host[i] != '.')
+      host[i] = '_';
+  host[host_len] = '\0';
+
+#ifdef HAVE_UNISTD_H
+  pid = (long) getpid();
+#endif
+
+  snprintf(tmp_name, len, "%s.%s.%ld.tmp", file_name, host, pid);
+}
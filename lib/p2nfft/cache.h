@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2011-2013 Michael Pippig
+ *
+ * This file is part of ScaFaCoS.
+ * 
+ * ScaFaCoS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ScaFaCoS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *	
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _P2NFFT_CACHE_H
+#define _P2NFFT_CACHE_H
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stddef.h>
+#include <mpi.h>
+#include "FCSCommon.h"
+
+/* On-disk cache of precomputed data (regularized kernel coefficients,
+ * interpolation tables). Every process keeps its own file per data set in
+ * the cache directory. A data set is identified by a name and a key of
+ * floating point numbers that contains all parameters the data depends on.
+ * The file name is derived from a hash of the key, the full key is stored
+ * in the file and compared on loading. A key with more than
+ * FCS_P2NFFT_CACHE_MAX_KEY entries is marked invalid (num < 0), loading and
+ * storing a data set with an invalid key does nothing. */
+
+/** maximal number of entries of a cache key */
+#define FCS_P2NFFT_CACHE_MAX_KEY 64
+
+typedef struct {
+  fcs_int num;
+  fcs_float val[FCS_P2NFFT_CACHE_MAX_KEY];
+} ifcs_p2nfft_cache_key;
+
+void ifcs_p2nfft_cache_key_init(
+    ifcs_p2nfft_cache_key *key);
+void ifcs_p2nfft_cache_key_add(
+    ifcs_p2nfft_cache_key *key, const fcs_float *val, fcs_int num);
+void ifcs_p2nfft_cache_key_add_int(
+    ifcs_p2nfft_cache_key *key, const fcs_int *val, fcs_int num);
+
+/** Read nbytes of the data set name with the given key into buf.
+ *  Collective over comm, returns 1 only if all processes found a matching file. */
+int ifcs_p2nfft_cache_load(
+    const char *dir, const char *name, const ifcs_p2nfft_cache_key *key,
+    void *buf, size_t nbytes, MPI_Comm comm);
+
+/** Write nbytes of buf as data set name with the given key.
+ *  Failures to write are silently ignored, the cache is only an optimization. */
+void ifcs_p2nfft_cache_store(
+    const char *dir, const char *name, const ifcs_p2nfft_cache_key *key,
+    const void *buf, size_t nbytes, MPI_Comm comm);
+
+#endif
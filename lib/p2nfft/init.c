@@ -179,6 +179,11 @@ FCSResult ifcs_p2nfft_init(
   d->gridsort_resort = FCS_GRIDSORT_RESORT_NULL;
   d->gridsort_cache = FCS_GRIDSORT_CACHE_NULL;
 
+  d->cache_dir = NULL;
+
+  d->tuning_db = NULL;
+  d->tuning_db_retune = 0;
+
   *rd = d;
 
   return NULL;
@@ -208,6 +213,7 @@ static ifcs_p2nfft_data_struct* mkplan_p2nfft(
   d->taylor2p_coeff = NULL;
   d->taylor2p_derive_coeff = NULL;
 
+  d->N_cg_cos = 0;
   d->cg_cos_coeff = NULL;
   d->cg_sin_coeff = NULL;
 
@@ -258,6 +264,12 @@ void ifcs_p2nfft_destroy(
   if(d->virial != NULL)
     free(d->virial);
 
+  if(d->cache_dir != NULL)
+    free(d->cache_dir);
+
+  if(d->tuning_db != NULL)
+    free(d->tuning_db);
+
   /* free gridsort data */
   fcs_gridsort_release_cache(&d->gridsort_cache);
   fcs_gridsort_resort_destroy(&d->gridsort_resort);
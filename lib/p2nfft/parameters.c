@@ -683,6 +683,40 @@ FCSResult ifcs_p2nfft_get_interpolation_order(
   return NULL;
 }
 
+/* Getters and Setters for directory of the on-disk cache of precomputed data */
+FCSResult ifcs_p2nfft_set_cache_dir(
+    void *rd, const char* fnc_name, const char *cache_dir
+    )
+{
+  ifcs_p2nfft_data_struct *d = (ifcs_p2nfft_data_struct*)rd;
+  if( rd==NULL )
+    return fcs_result_create(FCS_ERROR_WRONG_ARGUMENT, fnc_name, "Got NULL Pointer.");
+
+  if(d->cache_dir != NULL)
+    free(d->cache_dir);
+  d->cache_dir = NULL;
+
+  /* NULL or an empty string turn off the cache */
+  if(cache_dir != NULL && cache_dir[0] != '\0'){
+    d->cache_dir = (char*) malloc(sizeof(char) * (strlen(cache_dir) + 1));
+    strcpy(d->cache_dir, cache_dir);
+  }
+
+  return NULL;
+}
+
+FCSResult ifcs_p2nfft_get_cache_dir(
+    void *rd, const char* fnc_name, const char **cache_dir
+    )
+{
+  ifcs_p2nfft_data_struct *d = (ifcs_p2nfft_data_struct*)rd;
+  if( rd==NULL )
+    return fcs_result_create(FCS_ERROR_WRONG_ARGUMENT, fnc_name, "Got NULL Pointer.");
+
+  *cache_dir = d->cache_dir;
+  return NULL;
+}
+
 /* Getters and Setters for far field cutoff radius */
 FCSResult ifcs_p2nfft_set_k_cut(
     void *rd, const char* fnc_name, fcs_float k_cut
@@ -730,6 +764,7 @@ IFCS_P2NFFT_SET_GET_FLAG(, ignore_tolerance,  FCS_P2NFFT_IGNORE_TOLERANCE)
 IFCS_P2NFFT_SET_GET_FLAG(, ignore_potential,  FCS_P2NFFT_IGNORE_POTENTIAL)
 IFCS_P2NFFT_SET_GET_FLAG(, ignore_field,      FCS_P2NFFT_IGNORE_FIELD)
 IFCS_P2NFFT_SET_GET_FLAG(, verbose_tuning,    FCS_P2NFFT_VERBOSE_TUNING)
+IFCS_P2NFFT_SET_GET_FLAG(, overlap_near_far,  FCS_P2NFFT_OVERLAP_NEAR_FAR)
 
 
 /****************************************************
@@ -23,6 +23,9 @@
 #include <stdlib.h>
 #include <math.h>
 #include <mpi.h>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
 
 
 #include "run.h"
@@ -31,6 +34,7 @@
 #include "nearfield.h"
 #include "interpolation.h"
 #include <common/near/near.h>
+#include <common/fcs-common/FCSTiming.h>
 //#include "constants.h"
 
 #define FCS_P2NFFT_DISABLE_PNFFT_INFO 1
@@ -82,6 +86,152 @@ static fcs_int box_not_large_enough(
 
 
 
+/* compute the near field interactions of the sorted particles with each other and with the ghost particles,
+ * results are added to sorted_field and sorted_potential */
+static FCSResult compute_near_field(
+    ifcs_p2nfft_data_struct *d,
+    fcs_int sorted_num_particles, fcs_float *sorted_positions, fcs_float *sorted_charges, fcs_gridsort_index_t *sorted_indices,
+    fcs_int ghost_num_particles, fcs_float *ghost_positions, fcs_float *ghost_charges, fcs_gridsort_index_t *ghost_indices,
+    fcs_float *sorted_field, fcs_float *sorted_potential
+    )
+{
+  fcs_near_t near;
+
+  if(!d->short_range_flag)
+    return FCS_RESULT_SUCCESS;
+
+  fcs_near_create(&near);
+
+  if(d->interpolation_order >= 0){
+    switch(d->interpolation_order){
+      case 0: fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_interpolation_const_loop); break;
+      case 1: fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_interpolation_lin_loop); break;
+      case 2: fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_interpolation_quad_loop); break;
+      case 3: fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_interpolation_cub_loop); break;
+      default: return fcs_result_create(FCS_ERROR_WRONG_ARGUMENT, "ifcs_p2nfft_run", "P2NFFT interpolation order is too large.");
+    } 
+  } else if(d->reg_kernel == FCS_P2NFFT_REG_KERNEL_EWALD) {
+    if(d->interpolation_order == -1)
+      fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_periodic_erfc_loop);
+    else
+      fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_periodic_approx_erfc_loop);
+  } else {
+    fcs_near_set_field(&near, ifcs_p2nfft_compute_near_field);
+    fcs_near_set_potential(&near, ifcs_p2nfft_compute_near_potential);
+  }
+
+  // fcs_int *periodicity = NULL; /* sorter uses periodicity of the communicator */
+  fcs_near_set_system(&near, d->box_base, d->box_a, d->box_b, d->box_c, d->periodicity);
+
+  fcs_near_set_particles(&near, sorted_num_particles, sorted_num_particles, sorted_positions, sorted_charges, sorted_indices,
+      sorted_field, sorted_potential);
+
+  fcs_near_set_ghosts(&near, ghost_num_particles, ghost_positions, ghost_charges, ghost_indices);
+
+  if(d->interpolation_order >= 0){
+    ifcs_p2nfft_near_params near_params;
+    near_params.interpolation_order = d->interpolation_order;
+    near_params.interpolation_num_nodes = d->near_interpolation_num_nodes;
+    near_params.near_interpolation_table_potential = d->near_interpolation_table_potential;
+    near_params.near_interpolation_table_force = d->near_interpolation_table_force;
+    near_params.one_over_r_cut = d->one_over_r_cut;
+
+    fcs_near_compute(&near, d->r_cut, &near_params, d->cart_comm_3d);
+  } else if(d->reg_kernel == FCS_P2NFFT_REG_KERNEL_EWALD)
+    fcs_near_compute(&near, d->r_cut, &(d->alpha), d->cart_comm_3d);
+  else
+    fcs_near_compute(&near, d->r_cut, d, d->cart_comm_3d);
+
+  fcs_near_destroy(&near);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+/* compute the far field with adjoint NFFT, convolution with the regularized kernel and NFFT,
+ * results are left in the PNFFT arrays f and grad_f */
+static void compute_far_field(
+    ifcs_p2nfft_data_struct *d
+    )
+{
+  fcs_pnfft_complex *f_hat = FCS_PNFFT(get_f_hat)(d->pnfft);
+  double timing;
+#if FCS_ENABLE_DEBUG || FCS_P2NFFT_DEBUG
+  C csum;
+  C csum_global;
+  int myrank;
+  MPI_Comm_rank(d->cart_comm_3d, &myrank);
+#endif
+
+  /* Perform adjoint NFFT */
+  timing = fcs_timing_start();
+  if(!d->pnfft_direct)
+    FCS_PNFFT(adj)(d->pnfft);
+  else
+    FCS_PNFFT(direct_adj)(d->pnfft);
+  fcs_timing_stop(FCS_PHASE_SPREAD, timing);
+
+  /* Checksum: Output of adjoint NFFT */  
+#if FCS_ENABLE_DEBUG || FCS_P2NFFT_DEBUG
+  csum = 0.0;
+  for(fcs_int k = 0; k < d->local_N[0]*d->local_N[1]*d->local_N[2]; ++k)
+     csum += fabs(creal(f_hat[k])) + _Complex_I * fabs(cimag(f_hat[k]));
+  MPI_Reduce(&csum, &csum_global, 2, MPI_DOUBLE, MPI_SUM, 0, d->cart_comm_3d);
+  if (myrank == 0) fprintf(stderr, "P2NFFT_DEBUG: checksum of Fourier coefficients before convolution: %e + I* %e\n", creal(csum_global), cimag(csum_global));
+#endif
+
+  /* Checksum: Fourier coefficients of regkernel  */  
+#if FCS_ENABLE_DEBUG || FCS_P2NFFT_DEBUG
+  csum = 0.0;
+  for(fcs_int k = 0; k < d->local_N[0]*d->local_N[1]*d->local_N[2]; ++k)
+     csum += fabs(creal(d->regkern_hat[k])) + _Complex_I * fabs(cimag(d->regkern_hat[k]));
+  MPI_Reduce(&csum, &csum_global, 2, MPI_DOUBLE, MPI_SUM, 0, d->cart_comm_3d);
+  if (myrank == 0) fprintf(stderr, "P2NFFT_DEBUG: checksum of Regkernel Fourier coefficients: %e + I* %e\n", creal(csum_global), cimag(csum_global));
+#endif
+
+  /* Multiply with the analytically given Fourier coefficients */
+  timing = fcs_timing_start();
+  convolution(d->local_N, d->regkern_hat,
+      f_hat);
+  fcs_timing_stop(FCS_PHASE_SOLVE, timing);
+
+  /* Checksum: Input of NFFT */
+#if FCS_ENABLE_DEBUG || FCS_P2NFFT_DEBUG
+  csum = 0.0;
+  for(fcs_int k = 0; k < d->local_N[0]*d->local_N[1]*d->local_N[2]; ++k)
+     csum += fabs(creal(f_hat[k])) + _Complex_I * fabs(cimag(f_hat[k]));
+  MPI_Reduce(&csum, &csum_global, 2, MPI_DOUBLE, MPI_SUM, 0, d->cart_comm_3d);
+  if (myrank == 0) fprintf(stderr, "P2NFFT_DEBUG: checksum of Fourier coefficients after convolution: %e + I* %e\n", creal(csum_global), cimag(csum_global));
+#endif
+    
+  /* Perform NFFT */
+  timing = fcs_timing_start();
+  if(!d->pnfft_direct)
+    FCS_PNFFT(trafo)(d->pnfft);
+  else
+    FCS_PNFFT(direct_trafo)(d->pnfft);
+  fcs_timing_stop(FCS_PHASE_INTERPOLATE, timing);
+}
+
+/* decide whether the near field is computed by a second thread during the far field computation */
+static fcs_int overlap_near_far(
+    ifcs_p2nfft_data_struct *d
+    )
+{
+#ifdef _OPENMP
+  int provided;
+
+  if(!(d->flags & FCS_P2NFFT_OVERLAP_NEAR_FAR) || !d->short_range_flag)
+    return 0;
+
+  /* the near field thread queries the communicator while the master thread communicates */
+  MPI_Query_thread(&provided);
+
+  return (provided >= MPI_THREAD_MULTIPLE);
+#else
+  return 0;
+#endif
+}
+
 FCSResult ifcs_p2nfft_run(
     void *rd, fcs_int local_num_particles, fcs_int max_local_num_particles,
     fcs_float *positions, fcs_float *charges,
@@ -116,9 +266,6 @@ FCSResult ifcs_p2nfft_run(
   /* Start forw sort timing */
   FCS_P2NFFT_START_TIMING(d->cart_comm_3d);
   
-  /* Compute the near field */
-  fcs_near_t near;
-
   fcs_int sorted_num_particles, ghost_num_particles;
   fcs_float *sorted_positions, *ghost_positions;
   fcs_float *sorted_charges, *ghost_charges;
@@ -165,6 +312,9 @@ FCSResult ifcs_p2nfft_run(
    * We change sorted_positions (and not positions), since we are allowed to overwrite them. */
   fcs_wrap_positions(sorted_num_particles, sorted_positions, d->box_a, d->box_b, d->box_c, d->box_base, d->periodicity);
 
+  /* Compute the near field together with the far field, if both can overlap */
+  fcs_int overlap = overlap_near_far(d);
+
   /* Start near field timing */
   FCS_P2NFFT_START_TIMING(d->cart_comm_3d);
 
@@ -191,51 +341,10 @@ FCSResult ifcs_p2nfft_run(
     for (fcs_int j = 0; j < 3 * sorted_num_particles; ++j)
       sorted_field[j] = 0;
 
-  if(d->short_range_flag){
-    fcs_near_create(&near);
-  
-    if(d->interpolation_order >= 0){
-      switch(d->interpolation_order){
-        case 0: fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_interpolation_const_loop); break;
-        case 1: fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_interpolation_lin_loop); break;
-        case 2: fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_interpolation_quad_loop); break;
-        case 3: fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_interpolation_cub_loop); break;
-        default: return fcs_result_create(FCS_ERROR_WRONG_ARGUMENT, fnc_name,"P2NFFT interpolation order is too large.");
-      } 
-    } else if(d->reg_kernel == FCS_P2NFFT_REG_KERNEL_EWALD) {
-      if(d->interpolation_order == -1)
-        fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_periodic_erfc_loop);
-      else
-        fcs_near_set_loop(&near, ifcs_p2nfft_compute_near_periodic_approx_erfc_loop);
-    } else {
-      fcs_near_set_field(&near, ifcs_p2nfft_compute_near_field);
-      fcs_near_set_potential(&near, ifcs_p2nfft_compute_near_potential);
-    }
-
-    // fcs_int *periodicity = NULL; /* sorter uses periodicity of the communicator */
-    fcs_near_set_system(&near, d->box_base, d->box_a, d->box_b, d->box_c, d->periodicity);
-  
-    fcs_near_set_particles(&near, sorted_num_particles, sorted_num_particles, sorted_positions, sorted_charges, sorted_indices,
-        (compute_field)?sorted_field:NULL, (compute_potential)?sorted_potential:NULL);
-  
-    fcs_near_set_ghosts(&near, ghost_num_particles, ghost_positions, ghost_charges, ghost_indices);
-  
-    if(d->interpolation_order >= 0){
-      ifcs_p2nfft_near_params near_params;
-      near_params.interpolation_order = d->interpolation_order;
-      near_params.interpolation_num_nodes = d->near_interpolation_num_nodes;
-      near_params.near_interpolation_table_potential = d->near_interpolation_table_potential;
-      near_params.near_interpolation_table_force = d->near_interpolation_table_force;
-      near_params.one_over_r_cut = d->one_over_r_cut;
-
-      fcs_near_compute(&near, d->r_cut, &near_params, d->cart_comm_3d);
-    } else if(d->reg_kernel == FCS_P2NFFT_REG_KERNEL_EWALD)
-      fcs_near_compute(&near, d->r_cut, &(d->alpha), d->cart_comm_3d);
-    else
-      fcs_near_compute(&near, d->r_cut, rd, d->cart_comm_3d);
-  
-    fcs_near_destroy(&near);
-
+  if(!overlap){
+    FCSResult result = compute_near_field(d, sorted_num_particles, sorted_positions, sorted_charges, sorted_indices,
+        ghost_num_particles, ghost_positions, ghost_charges, ghost_indices, sorted_field, sorted_potential);
+    if(result != FCS_RESULT_SUCCESS) return result;
   }
 
   /* Finish near field timing */
@@ -278,10 +387,9 @@ FCSResult ifcs_p2nfft_run(
       pnfft_malloc_flags,
       PNFFT_FREE_X|   PNFFT_FREE_F|   PNFFT_FREE_GRAD_F);
 
-  fcs_pnfft_complex *f_hat, *f, *grad_f;
+  fcs_pnfft_complex *f, *grad_f;
   fcs_float *x;
 
-  f_hat  = FCS_PNFFT(get_f_hat)(d->pnfft);
   f      = FCS_PNFFT(get_f)(d->pnfft);
   grad_f = FCS_PNFFT(get_grad_f)(d->pnfft);
   x      = FCS_PNFFT(get_x)(d->pnfft);
@@ -380,48 +488,27 @@ FCSResult ifcs_p2nfft_run(
   /* Start far field timing */
   FCS_P2NFFT_START_TIMING(d->cart_comm_3d);
 
-  /* Perform adjoint NFFT */
-  if(!d->pnfft_direct)
-    FCS_PNFFT(adj)(d->pnfft);
-  else
-    FCS_PNFFT(direct_adj)(d->pnfft);
-
-  /* Checksum: Output of adjoint NFFT */  
-#if FCS_ENABLE_DEBUG || FCS_P2NFFT_DEBUG
-  csum = 0.0;
-  for(fcs_int k = 0; k < d->local_N[0]*d->local_N[1]*d->local_N[2]; ++k)
-     csum += fabs(creal(f_hat[k])) + _Complex_I * fabs(cimag(f_hat[k]));
-  MPI_Reduce(&csum, &csum_global, 2, MPI_DOUBLE, MPI_SUM, 0, d->cart_comm_3d);
-  if (myrank == 0) fprintf(stderr, "P2NFFT_DEBUG: checksum of Fourier coefficients before convolution: %e + I* %e\n", creal(csum_global), cimag(csum_global));
-#endif
-
-  /* Checksum: Fourier coefficients of regkernel  */  
-#if FCS_ENABLE_DEBUG || FCS_P2NFFT_DEBUG
-  csum = 0.0;
-  for(fcs_int k = 0; k < d->local_N[0]*d->local_N[1]*d->local_N[2]; ++k)
-     csum += fabs(creal(d->regkern_hat[k])) + _Complex_I * fabs(cimag(d->regkern_hat[k]));
-  MPI_Reduce(&csum, &csum_global, 2, MPI_DOUBLE, MPI_SUM, 0, d->cart_comm_3d);
-  if (myrank == 0) fprintf(stderr, "P2NFFT_DEBUG: checksum of Regkernel Fourier coefficients: %e + I* %e\n", creal(csum_global), cimag(csum_global));
-#endif
-
-  /* Multiply with the analytically given Fourier coefficients */
-  convolution(d->local_N, d->regkern_hat,
-      f_hat);
+  if(overlap){
+#ifdef _OPENMP
+    FCSResult near_result = FCS_RESULT_SUCCESS;
+
+    /* the master thread performs the NFFTs including all of their communication,
+     * while another thread computes the near field meanwhile (OpenMP loops of the
+     * near field solver are nested in this region and therefore run on that single thread,
+     * unless nested parallelism is enabled) */
+#pragma omp parallel num_threads(2)
+    {
+      if(omp_get_thread_num() == 0)
+        compute_far_field(d);
+      if(omp_get_thread_num() == omp_get_num_threads() - 1)
+        near_result = compute_near_field(d, sorted_num_particles, sorted_positions, sorted_charges, sorted_indices,
+            ghost_num_particles, ghost_positions, ghost_charges, ghost_indices, sorted_field, sorted_potential);
+    }
 
-  /* Checksum: Input of NFFT */
-#if FCS_ENABLE_DEBUG || FCS_P2NFFT_DEBUG
-  csum = 0.0;
-  for(fcs_int k = 0; k < d->local_N[0]*d->local_N[1]*d->local_N[2]; ++k)
-     csum += fabs(creal(f_hat[k])) + _Complex_I * fabs(cimag(f_hat[k]));
-  MPI_Reduce(&csum, &csum_global, 2, MPI_DOUBLE, MPI_SUM, 0, d->cart_comm_3d);
-  if (myrank == 0) fprintf(stderr, "P2NFFT_DEBUG: checksum of Fourier coefficients after convolution: %e + I* %e\n", creal(csum_global), cimag(csum_global));
+    if(near_result != FCS_RESULT_SUCCESS) return near_result;
 #endif
-    
-  /* Perform NFFT */
-  if(!d->pnfft_direct)
-    FCS_PNFFT(trafo)(d->pnfft);
-  else
-    FCS_PNFFT(direct_trafo)(d->pnfft);
+  } else
+    compute_far_field(d);
 
   /* Copy the results to the output vector and rescale with L^{-T} */
   if(compute_potential)
@@ -454,7 +541,7 @@ FCSResult ifcs_p2nfft_run(
 #endif
 
   /* Finish far field timing */
-  FCS_P2NFFT_FINISH_TIMING(d->cart_comm_3d, "Far field computation");
+  FCS_P2NFFT_FINISH_TIMING(d->cart_comm_3d, (overlap) ? "Overlapped near and far field computation" : "Far field computation");
 
 #if FCS_ENABLE_TIMING_PNFFT
   /* Print pnfft timer */
@@ -691,3 +778,10 @@ void ifcs_p2nfft_resort_bytes(void *rd, void *src, void *dst, fcs_int n, MPI_Com
   
   fcs_gridsort_resort_bytes(d->gridsort_resort, src, dst, n, comm);
 }
+
+void ifcs_p2nfft_get_resort_object(void *rd, fcs_resort_t *resort)
+{
+  ifcs_p2nfft_data_struct *d = (ifcs_p2nfft_data_struct*) rd;
+
+  *resort = d->gridsort_resort;
+}
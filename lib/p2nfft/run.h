@@ -25,6 +25,7 @@
 #endif
 
 #include "fcs_result.h"
+#include "common/resort/resort.h"
 
 /** @brief
  *  @param rd
@@ -46,5 +47,6 @@ void ifcs_p2nfft_get_resort_particles(void *rd, fcs_int *resort_particles);
 void ifcs_p2nfft_resort_ints(void *rd, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm);
 void ifcs_p2nfft_resort_floats(void *rd, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm);
 void ifcs_p2nfft_resort_bytes(void *rd, void *src, void *dst, fcs_int n, MPI_Comm comm);
+void ifcs_p2nfft_get_resort_object(void *rd, fcs_resort_t *resort);
 
 #endif
@@ -25,12 +25,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "tune.h"
 #include "types.h"
 #include "utils.h"
 #include "constants.h"
 #include "FCSCommon.h"
+#include "FCSTuningDB.h"
 
 #include "kernels.h"
 #include "regularization.h"
@@ -42,6 +44,7 @@
 #include "cg_cos_err_sym.h"
 
 #include "bessel_k.h"
+#include "cache.h"
 #include "part_derive_one_over_norm_x.h"
 
 #define FCS_P2NFFT_DEBUG_TUNING 0
@@ -209,6 +212,14 @@ static fcs_pnfft_complex* malloc_and_precompute_regkern_hat_3dp(
 
 static fcs_int is_cubic(
     fcs_float *box_l);
+static void init_cache_key(
+    const ifcs_p2nfft_data_struct *d, fcs_int reg_near, fcs_int reg_far,
+    ifcs_p2nfft_cache_key *key);
+static void init_table_cache_key(
+    const ifcs_p2nfft_data_struct *d, fcs_int reg_near, fcs_int reg_far, fcs_int num_nodes,
+    ifcs_p2nfft_cache_key *key);
+static ptrdiff_t regkern_hat_local_size(
+    const ifcs_p2nfft_data_struct *d);
 
 
 /** Computes the real space contribution to the rms error in the
@@ -360,6 +371,48 @@ static fcs_int box_differs(
 
 
 
+/* signature of the system in the tuning database, including the parameters that are not tuned */
+static void tuning_db_signature(
+    ifcs_p2nfft_data_struct *d, char *signature
+    )
+{
+  char params[256];
+  int n, size;
+
+  MPI_Comm_size(d->cart_comm_3d, &size);
+
+  n = snprintf(params, sizeof(params), "r_cut=%.9e,direct=%d,interlaced=%d,ignore_tolerance=%d",
+      (double) d->r_cut, (int) d->pnfft_direct, (d->pnfft_flags & PNFFT_INTERLACED) != 0, (d->flags & FCS_P2NFFT_IGNORE_TOLERANCE) != 0);
+  if(!d->tune_alpha)
+    n += snprintf(params + n, sizeof(params) - n, ",alpha=%.9e", (double) d->alpha);
+  if(!d->tune_N)
+    n += snprintf(params + n, sizeof(params) - n, ",N=%td:%td:%td", d->N[0], d->N[1], d->N[2]);
+  if(!d->tune_m)
+    n += snprintf(params + n, sizeof(params) - n, ",m=%d", (int) d->m);
+
+  fcs_tuning_db_signature(signature, "p2nfft", d->box_a, d->box_b, d->box_c, d->periodicity,
+      d->sum_qpart, d->sum_q2, d->tolerance_type, d->tolerance, size, params);
+}
+
+void ifcs_p2nfft_set_tuning_db(
+    void *rd, const char *tuning_db, fcs_int retune
+    )
+{
+  ifcs_p2nfft_data_struct *d = (ifcs_p2nfft_data_struct*) rd;
+
+  if(d->tuning_db != NULL)
+    free(d->tuning_db);
+  d->tuning_db = NULL;
+
+  /* NULL or an empty string turn off the database */
+  if(tuning_db != NULL && tuning_db[0] != '\0'){
+    d->tuning_db = (char*) malloc(sizeof(char) * (strlen(tuning_db) + 1));
+    strcpy(d->tuning_db, tuning_db);
+  }
+
+  d->tuning_db_retune = retune;
+}
+
 FCSResult ifcs_p2nfft_tune(
     void *rd, const fcs_int *periodicity,
     fcs_int local_particles,
@@ -610,8 +663,30 @@ FCSResult ifcs_p2nfft_tune(
       /* set normalized near field radius, relative to minimum box length */
       d->epsI = d->r_cut / d->box_l[mindim];
       
-      /* Tune alpha for fixed N and m. */
-      if(!d->tune_N && !d->tune_m){
+      /* Look up alpha, N, and m in the tuning database. */
+      fcs_int db_found = 0;
+      char db_signature[FCS_TUNING_DB_SIGNATURE_LENGTH];
+      fcs_float db_values[5];
+      if(d->tuning_db != NULL){
+        tuning_db_signature(d, db_signature);
+        if(!d->tuning_db_retune){
+          if(!comm_rank)
+            db_found = fcs_tuning_db_lookup(d->tuning_db, db_signature, db_values, 5);
+          MPI_Bcast(&db_found, 1, FCS_MPI_INT, 0, d->cart_comm_3d);
+          MPI_Bcast(db_values, 5, FCS_MPI_FLOAT, 0, d->cart_comm_3d);
+        }
+      }
+
+      if(db_found){
+        d->alpha = db_values[0];
+        for(int t=0; t<3; t++)
+          d->N[t] = (ptrdiff_t) db_values[1+t];
+        cao = (fcs_int) db_values[4];
+
+        /* Set the errors to senseless values to indicate that they were not calculated. */
+        error = ks_error = rs_error = -1.0;
+      } else if(!d->tune_N && !d->tune_m){
+        /* Tune alpha for fixed N and m. */
         if(d->tune_alpha)
           d->alpha = p2nfft_tune_alpha(
               d->sum_qpart, d->sum_q2, dim_tune, d->box_l, d->r_cut, d->N, cao, d->tolerance, d->pnfft_direct);
@@ -697,6 +772,15 @@ FCSResult ifcs_p2nfft_tune(
         if(error > d->tolerance)
           return fcs_result_create(FCS_ERROR_WRONG_ARGUMENT, fnc_name, "Not able to reach required accuracy.");
 
+      /* Store the tuned parameters in the database. */
+      if(d->tuning_db != NULL && !db_found && !comm_rank){
+        db_values[0] = d->alpha;
+        for(int t=0; t<3; t++)
+          db_values[1+t] = d->N[t];
+        db_values[4] = cao;
+        fcs_tuning_db_store(d->tuning_db, db_signature, db_values, 5);
+      }
+
 #if FCS_P2NFFT_TEST_GENERAL_ERROR_ESTIMATE
       if(!comm_rank)
         printf("\n\nP2NFFT_INFO: P3M Tuning results in N = %td, cao = %d, alpha = %e\n", d->N[0], cao, d->alpha);
@@ -823,13 +907,22 @@ FCSResult ifcs_p2nfft_tune(
 
       if(d->far_interpolation_num_nodes > 0){
         if (d->num_periodic_dims==0) {
+          ifcs_p2nfft_cache_key key;
+          init_cache_key(d, reg_near, reg_far, &key);
+          ifcs_p2nfft_cache_key_add_int(&key, &d->far_interpolation_num_nodes, 1);
+
           d->far_interpolation_table_potential = (fcs_float*) malloc(sizeof(fcs_float) * (d->far_interpolation_num_nodes+3));
-          FCS_P2NFFT_IFDBG(double timer=-MPI_Wtime());
-          init_far_interpolation_table_potential_0dp_ewald(
-              d->far_interpolation_num_nodes, reg_far,
-              d->alpha, d->box_scales[0], d->epsB, d->p, d->c,
-              d->far_interpolation_table_potential);
-          FCS_P2NFFT_IFDBG(timer+=MPI_Wtime(); if(!comm_rank) fprintf(stderr, "init 0dp far interpolation table takes %e s\n", timer));
+          if(!ifcs_p2nfft_cache_load(d->cache_dir, "far_table", &key, d->far_interpolation_table_potential,
+                sizeof(fcs_float) * (d->far_interpolation_num_nodes+3), d->cart_comm_pnfft)){
+            FCS_P2NFFT_IFDBG(double timer=-MPI_Wtime());
+            init_far_interpolation_table_potential_0dp_ewald(
+                d->far_interpolation_num_nodes, reg_far,
+                d->alpha, d->box_scales[0], d->epsB, d->p, d->c,
+                d->far_interpolation_table_potential);
+            FCS_P2NFFT_IFDBG(timer+=MPI_Wtime(); if(!comm_rank) fprintf(stderr, "init 0dp far interpolation table takes %e s\n", timer));
+            ifcs_p2nfft_cache_store(d->cache_dir, "far_table", &key, d->far_interpolation_table_potential,
+                sizeof(fcs_float) * (d->far_interpolation_num_nodes+3), d->cart_comm_pnfft);
+          }
         }
 
         if (d->num_periodic_dims==1){
@@ -853,15 +946,25 @@ FCSResult ifcs_p2nfft_tune(
           fcs_int mem = offset * local_Ni_total;
           d->far_interpolation_table_potential = (mem>0) ? (fcs_float*) malloc(sizeof(fcs_float) * mem) : NULL;
       
-          if(local_Ni_total > 0){
-            FCS_P2NFFT_IFDBG(double timer=-MPI_Wtime());
-            fcs_int m=0;
-            for(fcs_int k=local_Ni_start[pdim]; k<local_Ni_start[pdim]+local_Ni[pdim]; ++k, ++m)
-              init_far_interpolation_table_potential_1dp(
-                  d->far_interpolation_num_nodes, reg_far, k, d->box_l[pdim],
-                  d->alpha, d->box_scales[0], d->epsB, d->p, d->c,
-                  d->far_interpolation_table_potential + m * offset);
-            FCS_P2NFFT_IFDBG(timer+=MPI_Wtime(); if(!comm_rank) fprintf(stderr, "init 1dp far interpolation tables takes %e s\n", timer));
+          /* the tables of all local k are expensive, try to load them from the cache */
+          ifcs_p2nfft_cache_key key;
+          init_cache_key(d, reg_near, reg_far, &key);
+          ifcs_p2nfft_cache_key_add_int(&key, &d->far_interpolation_num_nodes, 1);
+
+          if(!ifcs_p2nfft_cache_load(d->cache_dir, "far_table", &key, d->far_interpolation_table_potential,
+                sizeof(fcs_float) * mem, d->cart_comm_pnfft)){
+            if(local_Ni_total > 0){
+              FCS_P2NFFT_IFDBG(double timer=-MPI_Wtime());
+              fcs_int m=0;
+              for(fcs_int k=local_Ni_start[pdim]; k<local_Ni_start[pdim]+local_Ni[pdim]; ++k, ++m)
+                init_far_interpolation_table_potential_1dp(
+                    d->far_interpolation_num_nodes, reg_far, k, d->box_l[pdim],
+                    d->alpha, d->box_scales[0], d->epsB, d->p, d->c,
+                    d->far_interpolation_table_potential + m * offset);
+              FCS_P2NFFT_IFDBG(timer+=MPI_Wtime(); if(!comm_rank) fprintf(stderr, "init 1dp far interpolation tables takes %e s\n", timer));
+            }
+            ifcs_p2nfft_cache_store(d->cache_dir, "far_table", &key, d->far_interpolation_table_potential,
+                sizeof(fcs_float) * mem, d->cart_comm_pnfft);
           }
         }
       }
@@ -1084,21 +1187,35 @@ FCSResult ifcs_p2nfft_tune(
       }
 
       if(d->near_interpolation_num_nodes > 0){
+        /* the tables only depend on the regularization, try to load them from the cache */
+        ifcs_p2nfft_cache_key key;
+        init_table_cache_key(d, reg_near, reg_far, d->near_interpolation_num_nodes, &key);
+
         d->near_interpolation_table_potential = (fcs_float*) malloc(sizeof(fcs_float) * (d->near_interpolation_num_nodes+3));
-        init_near_interpolation_table_potential_0dp(
-            d->near_interpolation_num_nodes,
-            d->r_cut, d->epsI, d->p,
-            d->taylor2p_coeff,
-            d->N_cg_cos, d->cg_cos_coeff,
-            d->near_interpolation_table_potential);
+        if(!ifcs_p2nfft_cache_load(d->cache_dir, "near_table_potential", &key, d->near_interpolation_table_potential,
+              sizeof(fcs_float) * (d->near_interpolation_num_nodes+3), d->cart_comm_pnfft)){
+          init_near_interpolation_table_potential_0dp(
+              d->near_interpolation_num_nodes,
+              d->r_cut, d->epsI, d->p,
+              d->taylor2p_coeff,
+              d->N_cg_cos, d->cg_cos_coeff,
+              d->near_interpolation_table_potential);
+          ifcs_p2nfft_cache_store(d->cache_dir, "near_table_potential", &key, d->near_interpolation_table_potential,
+              sizeof(fcs_float) * (d->near_interpolation_num_nodes+3), d->cart_comm_pnfft);
+        }
 
         d->near_interpolation_table_force = (fcs_float*) malloc(sizeof(fcs_float) * (d->near_interpolation_num_nodes+3));
-        init_near_interpolation_table_force_0dp(
-            d->near_interpolation_num_nodes,
-            d->r_cut, d->epsI, d->p,
-            d->taylor2p_derive_coeff,
-            d->N_cg_cos, d->cg_cos_coeff, d->cg_sin_coeff,
-            d->near_interpolation_table_force);
+        if(!ifcs_p2nfft_cache_load(d->cache_dir, "near_table_force", &key, d->near_interpolation_table_force,
+              sizeof(fcs_float) * (d->near_interpolation_num_nodes+3), d->cart_comm_pnfft)){
+          init_near_interpolation_table_force_0dp(
+              d->near_interpolation_num_nodes,
+              d->r_cut, d->epsI, d->p,
+              d->taylor2p_derive_coeff,
+              d->N_cg_cos, d->cg_cos_coeff, d->cg_sin_coeff,
+              d->near_interpolation_table_force);
+          ifcs_p2nfft_cache_store(d->cache_dir, "near_table_force", &key, d->near_interpolation_table_force,
+              sizeof(fcs_float) * (d->near_interpolation_num_nodes+3), d->cart_comm_pnfft);
+        }
       }
 
       /* far field interpolation only works for cubic boxes and radial far field regularization */
@@ -1109,13 +1226,21 @@ FCSResult ifcs_p2nfft_tune(
         d->far_interpolation_num_nodes = 0;
 
       if(d->far_interpolation_num_nodes > 0){
+        ifcs_p2nfft_cache_key key;
+        init_table_cache_key(d, reg_near, reg_far, d->far_interpolation_num_nodes, &key);
+
         /* far field regularization table needs one extra point before 0.5-epsB for cubic interpolation */
         d->far_interpolation_table_potential = (fcs_float*) malloc(sizeof(fcs_float) * (d->far_interpolation_num_nodes+4));
-        init_far_interpolation_table_potential_0dp(
-            d->far_interpolation_num_nodes, reg_far,
-            d->epsB, d->p, d->c,
-            d->N_cg_cos, d->cg_cos_coeff,
-            d->far_interpolation_table_potential);
+        if(!ifcs_p2nfft_cache_load(d->cache_dir, "far_table_potential", &key, d->far_interpolation_table_potential,
+              sizeof(fcs_float) * (d->far_interpolation_num_nodes+4), d->cart_comm_pnfft)){
+          init_far_interpolation_table_potential_0dp(
+              d->far_interpolation_num_nodes, reg_far,
+              d->epsB, d->p, d->c,
+              d->N_cg_cos, d->cg_cos_coeff,
+              d->far_interpolation_table_potential);
+          ifcs_p2nfft_cache_store(d->cache_dir, "far_table_potential", &key, d->far_interpolation_table_potential,
+              sizeof(fcs_float) * (d->far_interpolation_num_nodes+4), d->cart_comm_pnfft);
+        }
       }
 
 
@@ -1182,35 +1307,68 @@ FCSResult ifcs_p2nfft_tune(
   /* Start timing of precomputation */
   FCS_P2NFFT_START_TIMING(d->cart_comm_3d);
   if (d->needs_retune) {
-    /* precompute Fourier coefficients for convolution */
-    if (d->num_periodic_dims == 3)
-      d->regkern_hat = malloc_and_precompute_regkern_hat_3dp(
-          d->local_N, d->local_N_start, d->box_inv, d->alpha, d->k_cut);
-    if (d->num_periodic_dims == 2)
-      d->regkern_hat = malloc_and_precompute_regkern_hat_2dp_and_1dp(
-          d->N, d->epsB, d->box_a, d->box_b, d->box_c, d->box_inv, d->box_scales, d->alpha, d->k_cut, d->periodicity, d->p, d->c, reg_far,
-          d->interpolation_order, d->far_interpolation_num_nodes, d->far_interpolation_table_potential,
-          d->cart_comm_pnfft);
-    if (d->num_periodic_dims == 1)
-      d->regkern_hat = malloc_and_precompute_regkern_hat_2dp_and_1dp(
-          d->N, d->epsB, d->box_a, d->box_b, d->box_c, d->box_inv, d->box_scales, d->alpha, d->k_cut, d->periodicity, d->p, d->c, reg_far,
-          d->interpolation_order, d->far_interpolation_num_nodes, d->far_interpolation_table_potential,
-          d->cart_comm_pnfft);
-      /* malloc_and_precompute_regkern_hat_1dp */
-    if (d->num_periodic_dims == 0) {
-      if (d->reg_kernel == FCS_P2NFFT_REG_KERNEL_EWALD) {
-        d->regkern_hat = malloc_and_precompute_regkern_hat_0dp_ewald(
-            d->N, d->epsB, d->box_scales, d->alpha, d->p, d->c, reg_far,
+    ifcs_p2nfft_cache_key key;
+    ptrdiff_t alloc_local = 0;
+    int cached = 0;
+
+    /* free Fourier coefficients of a previous tuning */
+    if (d->regkern_hat != NULL) {
+      FCS_PFFT(free)(d->regkern_hat);
+      d->regkern_hat = NULL;
+    }
+
+    /* the coefficients of the mixed periodic and nonperiodic cases are expensive,
+     * try to load them from the cache */
+    if (d->cache_dir != NULL && d->num_periodic_dims < 3) {
+      init_cache_key(d, reg_near, reg_far, &key);
+      ifcs_p2nfft_cache_key_add_int(&key, &d->near_interpolation_num_nodes, 1);
+      ifcs_p2nfft_cache_key_add_int(&key, &d->far_interpolation_num_nodes, 1);
+
+      alloc_local = regkern_hat_local_size(d);
+      d->regkern_hat = FCS_PFFT(alloc_complex)(alloc_local);
+      cached = ifcs_p2nfft_cache_load(d->cache_dir, "regkern_hat", &key, d->regkern_hat,
+          sizeof(fcs_pnfft_complex) * alloc_local, d->cart_comm_pnfft);
+      if (!cached) {
+        FCS_PFFT(free)(d->regkern_hat);
+        d->regkern_hat = NULL;
+      }
+    }
+
+    if (!cached) {
+      /* precompute Fourier coefficients for convolution */
+      if (d->num_periodic_dims == 3)
+        d->regkern_hat = malloc_and_precompute_regkern_hat_3dp(
+            d->local_N, d->local_N_start, d->box_inv, d->alpha, d->k_cut);
+      if (d->num_periodic_dims == 2)
+        d->regkern_hat = malloc_and_precompute_regkern_hat_2dp_and_1dp(
+            d->N, d->epsB, d->box_a, d->box_b, d->box_c, d->box_inv, d->box_scales, d->alpha, d->k_cut, d->periodicity, d->p, d->c, reg_far,
+            d->interpolation_order, d->far_interpolation_num_nodes, d->far_interpolation_table_potential,
+            d->cart_comm_pnfft);
+      if (d->num_periodic_dims == 1)
+        d->regkern_hat = malloc_and_precompute_regkern_hat_2dp_and_1dp(
+            d->N, d->epsB, d->box_a, d->box_b, d->box_c, d->box_inv, d->box_scales, d->alpha, d->k_cut, d->periodicity, d->p, d->c, reg_far,
             d->interpolation_order, d->far_interpolation_num_nodes, d->far_interpolation_table_potential,
-            d->cart_comm_pnfft, is_cubic(d->box_l));
-      } else if (d->reg_kernel == FCS_P2NFFT_REG_KERNEL_OTHER) {
-        d->regkern_hat = malloc_and_precompute_regkern_hat_0dp(
-            d->N, d->r_cut, d->epsI, d->epsB, d->p, d->c, d->box_scales, reg_near, reg_far,
-            d->taylor2p_coeff, d->N_cg_cos, d->cg_cos_coeff,
-            d->interpolation_order, d->near_interpolation_num_nodes, d->far_interpolation_num_nodes,
-            d->near_interpolation_table_potential, d->far_interpolation_table_potential,
-            d->cart_comm_pnfft, is_cubic(d->box_l));
+            d->cart_comm_pnfft);
+        /* malloc_and_precompute_regkern_hat_1dp */
+      if (d->num_periodic_dims == 0) {
+        if (d->reg_kernel == FCS_P2NFFT_REG_KERNEL_EWALD) {
+          d->regkern_hat = malloc_and_precompute_regkern_hat_0dp_ewald(
+              d->N, d->epsB, d->box_scales, d->alpha, d->p, d->c, reg_far,
+              d->interpolation_order, d->far_interpolation_num_nodes, d->far_interpolation_table_potential,
+              d->cart_comm_pnfft, is_cubic(d->box_l));
+        } else if (d->reg_kernel == FCS_P2NFFT_REG_KERNEL_OTHER) {
+          d->regkern_hat = malloc_and_precompute_regkern_hat_0dp(
+              d->N, d->r_cut, d->epsI, d->epsB, d->p, d->c, d->box_scales, reg_near, reg_far,
+              d->taylor2p_coeff, d->N_cg_cos, d->cg_cos_coeff,
+              d->interpolation_order, d->near_interpolation_num_nodes, d->far_interpolation_num_nodes,
+              d->near_interpolation_table_potential, d->far_interpolation_table_potential,
+              d->cart_comm_pnfft, is_cubic(d->box_l));
+        }
       }
+
+      if (d->cache_dir != NULL && d->num_periodic_dims < 3)
+        ifcs_p2nfft_cache_store(d->cache_dir, "regkern_hat", &key, d->regkern_hat,
+            sizeof(fcs_pnfft_complex) * alloc_local, d->cart_comm_pnfft);
     }
   }
   /* Finish timing of of precomputation */
@@ -2803,6 +2961,87 @@ static FCSResult check_tolerance(
   return NULL;
 }
 
+/* collect all parameters the regularized kernel and the interpolation tables depend on */
+static void init_cache_key(
+    const ifcs_p2nfft_data_struct *d, fcs_int reg_near, fcs_int reg_far,
+    ifcs_p2nfft_cache_key *key
+    )
+{
+  fcs_float N[3];
+  fcs_int param[9];
+  int ndims = 0, dims[3] = {1, 1, 1}, periods[3], coords[3];
+
+  for(int t=0; t<3; t++)
+    N[t] = (fcs_float) d->N[t];
+
+  /* the local data distribution depends on the process mesh */
+  MPI_Cartdim_get(d->cart_comm_pnfft, &ndims);
+  MPI_Cart_get(d->cart_comm_pnfft, ndims, dims, periods, coords);
+
+  param[0] = d->p;
+  param[1] = reg_near;
+  param[2] = reg_far;
+  param[3] = d->reg_kernel;
+  param[4] = d->interpolation_order;
+  param[5] = d->N_cg_cos;
+  for(int t=0; t<3; t++)
+    param[6+t] = dims[t];
+
+  ifcs_p2nfft_cache_key_init(key);
+  ifcs_p2nfft_cache_key_add(key, d->box_a, 3);
+  ifcs_p2nfft_cache_key_add(key, d->box_b, 3);
+  ifcs_p2nfft_cache_key_add(key, d->box_c, 3);
+  ifcs_p2nfft_cache_key_add(key, d->box_scales, 3);
+  ifcs_p2nfft_cache_key_add_int(key, d->periodicity, 3);
+  ifcs_p2nfft_cache_key_add(key, N, 3);
+  ifcs_p2nfft_cache_key_add(key, &d->r_cut, 1);
+  ifcs_p2nfft_cache_key_add(key, &d->epsI, 1);
+  ifcs_p2nfft_cache_key_add(key, &d->epsB, 1);
+  ifcs_p2nfft_cache_key_add(key, &d->alpha, 1);
+  ifcs_p2nfft_cache_key_add(key, &d->k_cut, 1);
+  ifcs_p2nfft_cache_key_add(key, &d->c, 1);
+  ifcs_p2nfft_cache_key_add_int(key, param, 9);
+}
+
+/* collect all parameters the nonperiodic near and far field interpolation tables depend on,
+ * in contrast to init_cache_key the tables do not depend on the box and the grid */
+static void init_table_cache_key(
+    const ifcs_p2nfft_data_struct *d, fcs_int reg_near, fcs_int reg_far, fcs_int num_nodes,
+    ifcs_p2nfft_cache_key *key
+    )
+{
+  fcs_int param[6];
+
+  param[0] = d->interpolation_order;
+  param[1] = num_nodes;
+  param[2] = d->p;
+  param[3] = reg_near;
+  param[4] = reg_far;
+  param[5] = d->N_cg_cos;
+
+  ifcs_p2nfft_cache_key_init(key);
+  ifcs_p2nfft_cache_key_add_int(key, param, 6);
+  ifcs_p2nfft_cache_key_add(key, &d->epsI, 1);
+  ifcs_p2nfft_cache_key_add(key, &d->epsB, 1);
+  ifcs_p2nfft_cache_key_add(key, &d->alpha, 1);
+  ifcs_p2nfft_cache_key_add(key, &d->r_cut, 1);
+  ifcs_p2nfft_cache_key_add(key, &d->c, 1);
+}
+
+/* local array size of the Fourier coefficients in the mixed periodic and nonperiodic cases,
+ * has to match malloc_and_precompute_regkern_hat_0dp and _2dp_and_1dp */
+static ptrdiff_t regkern_hat_local_size(
+    const ifcs_p2nfft_data_struct *d
+    )
+{
+  ptrdiff_t howmany = 1;
+  ptrdiff_t local_Ni[3], local_Ni_start[3], local_No[3], local_No_start[3];
+
+  return FCS_PFFT(local_size_many_dft)(3, d->N, d->N, d->N, howmany,
+      PFFT_DEFAULT_BLOCKS, PFFT_DEFAULT_BLOCKS, d->cart_comm_pnfft, PFFT_TRANSPOSED_OUT| PFFT_SHIFTED_IN| PFFT_SHIFTED_OUT,
+      local_Ni, local_Ni_start, local_No, local_No_start);
+}
+
 static fcs_int is_cubic(
     fcs_float *box_l
     )
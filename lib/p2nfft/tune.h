@@ -34,4 +34,7 @@ FCSResult ifcs_p2nfft_tune(
     const fcs_float *offset,
     fcs_int short_range_flag);
 
+void ifcs_p2nfft_set_tuning_db(
+    void *rd, const char *tuning_db, fcs_int retune);
+
 #endif
@@ -100,6 +100,7 @@ typedef ptrdiff_t INT;
 #define FCS_P2NFFT_IGNORE_POTENTIAL          (1U << 1)
 #define FCS_P2NFFT_IGNORE_FIELD              (1U << 2)
 #define FCS_P2NFFT_VERBOSE_TUNING            (1U << 3)
+#define FCS_P2NFFT_OVERLAP_NEAR_FAR          (1U << 4)
 
 /* p2nfft_reg_kernels */
 #define FCS_P2NFFT_REG_KERNEL_DEFAULT (-1)
@@ -268,6 +269,13 @@ typedef struct {
   /* gridsort cache */
   fcs_gridsort_cache_t gridsort_cache;
 
+  /* directory of the on-disk cache of precomputed data (NULL = no cache) */
+  char *cache_dir;
+
+  /* file of the database of tuned parameters (NULL = no database) and whether existing entries are ignored */
+  char *tuning_db;
+  fcs_int tuning_db_retune;
+
 } ifcs_p2nfft_data_struct;
 
 #endif
@@ -27,7 +27,7 @@ extern "C" {
   FCSResult 
   ifcs_p3m_run(void* rd,
                fcs_int num_particles,
-               fcs_int _max_num_particles,
+               fcs_int max_num_particles,
                fcs_float *positions,
                fcs_float *charges,
                fcs_float *fields,
@@ -37,7 +37,8 @@ extern "C" {
     Solver *d = reinterpret_cast<Solver*>(rd);
     
     try {
-      d->run(num_particles, positions, charges, fields, potentials);
+      d->run(num_particles, max_num_particles,
+             positions, charges, fields, potentials);
     } catch (std::exception &e) {
       return fcs_result_create(FCS_ERROR_LOGICAL_ERROR, "ifcs_p3m_run", e.what());
     }
@@ -212,6 +212,127 @@ void ifcs_p3m_get_tolerance_field(void *rd, fcs_float* tolerance_field) {
 	*tolerance_field = d->tolerance_field;
 }
 
+void ifcs_p3m_set_max_particle_move(void *rd, fcs_float max_particle_move) {
+	Solver *d = static_cast<Solver *>(rd);
+	d->max_particle_move = max_particle_move;
+}
+
+void ifcs_p3m_set_resort(void *rd, fcs_int resort) {
+	Solver *d = static_cast<Solver *>(rd);
+	d->resort = resort;
+}
+
+void ifcs_p3m_get_resort(void *rd, fcs_int *resort) {
+	Solver *d = static_cast<Solver *>(rd);
+	*resort = d->resort;
+}
+
+void ifcs_p3m_get_resort_availability(void *rd, fcs_int *availability) {
+	Solver *d = static_cast<Solver *>(rd);
+	*availability = fcs_gridsort_resort_is_available(d->gridsort_resort);
+}
+
+void ifcs_p3m_get_resort_particles(void *rd, fcs_int *resort_particles) {
+	Solver *d = static_cast<Solver *>(rd);
+	if (d->gridsort_resort == FCS_GRIDSORT_RESORT_NULL)
+		*resort_particles = d->local_num_particles;
+	else
+		*resort_particles = fcs_gridsort_resort_get_sorted_particles(d->gridsort_resort);
+}
+
+void ifcs_p3m_resort_ints(void *rd, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm) {
+	Solver *d = static_cast<Solver *>(rd);
+	if (d->gridsort_resort == FCS_GRIDSORT_RESORT_NULL) return;
+	fcs_gridsort_resort_ints(d->gridsort_resort, src, dst, n, comm);
+}
+
+void ifcs_p3m_resort_floats(void *rd, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm) {
+	Solver *d = static_cast<Solver *>(rd);
+	if (d->gridsort_resort == FCS_GRIDSORT_RESORT_NULL) return;
+	fcs_gridsort_resort_floats(d->gridsort_resort, src, dst, n, comm);
+}
+
+void ifcs_p3m_resort_bytes(void *rd, void *src, void *dst, fcs_int n, MPI_Comm comm) {
+	Solver *d = static_cast<Solver *>(rd);
+	if (d->gridsort_resort == FCS_GRIDSORT_RESORT_NULL) return;
+	fcs_gridsort_resort_bytes(d->gridsort_resort, src, dst, n, comm);
+}
+
+void ifcs_p3m_get_resort_object(void *rd, fcs_resort_t *resort) {
+	Solver *d = static_cast<Solver *>(rd);
+	*resort = d->gridsort_resort;
+}
+
+void ifcs_p3m_set_num_threads(void *rd, fcs_int num_threads) {
+	Solver *d = static_cast<Solver *>(rd);
+	d->num_threads = num_threads;
+	if (d->farSolver != NULL)
+		d->farSolver->setNumThreads(num_threads);
+}
+
+void ifcs_p3m_get_num_threads(void *rd, fcs_int *num_threads) {
+	Solver *d = static_cast<Solver *>(rd);
+	if (d->farSolver != NULL)
+		*num_threads = d->farSolver->getNumThreads();
+	else
+		*num_threads = d->num_threads;
+}
+
+void ifcs_p3m_set_pipelined_fft(void *rd, fcs_int flag) {
+	Solver *d = static_cast<Solver *>(rd);
+	d->pipelined_fft = flag;
+	if (d->farSolver != NULL)
+		d->farSolver->setPipelinedFFT(flag);
+}
+
+void ifcs_p3m_get_pipelined_fft(void *rd, fcs_int *flag) {
+	Solver *d = static_cast<Solver *>(rd);
+	*flag = d->pipelined_fft;
+}
+
+void ifcs_p3m_set_batched_fft(void *rd, fcs_int flag) {
+	Solver *d = static_cast<Solver *>(rd);
+	d->batched_fft = flag;
+	if (d->farSolver != NULL)
+		d->farSolver->setBatchedFFT(flag);
+}
+
+void ifcs_p3m_get_batched_fft(void *rd, fcs_int *flag) {
+	Solver *d = static_cast<Solver *>(rd);
+	*flag = d->batched_fft;
+}
+
+void ifcs_p3m_set_mixed_precision(void *rd, fcs_int flag) {
+	Solver *d = static_cast<Solver *>(rd);
+	/* the rounding error changes the error estimate */
+	if ((flag != 0) != (d->mixed_precision != 0))
+		d->needs_retune = 1;
+	d->mixed_precision = flag;
+	if (d->farSolver != NULL)
+		d->farSolver->setMixedPrecision(flag);
+}
+
+void ifcs_p3m_get_mixed_precision(void *rd, fcs_int *flag) {
+	Solver *d = static_cast<Solver *>(rd);
+	*flag = d->mixed_precision;
+}
+
+void ifcs_p3m_set_tuning_db(void *rd, const char *filename, fcs_int retune) {
+	Solver *d = static_cast<Solver *>(rd);
+	d->tuning_db = (filename != NULL) ? filename : "";
+	d->tuning_db_retune = (retune != 0);
+}
+
+void ifcs_p3m_set_verlet_skin(void *rd, fcs_float verlet_skin) {
+	Solver *d = static_cast<Solver *>(rd);
+	d->verlet_skin = verlet_skin;
+}
+
+void ifcs_p3m_get_verlet_skin(void *rd, fcs_float *verlet_skin) {
+	Solver *d = static_cast<Solver *>(rd);
+	*verlet_skin = d->verlet_skin;
+}
+
 void ifcs_p3m_require_total_energy(void *rd, fcs_int flag) {
 	Solver *d = static_cast<Solver *>(rd);
 	d->setRequireTotalEnergy(flag);
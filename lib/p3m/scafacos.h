@@ -22,6 +22,7 @@
 #include <config.h>
 #include <mpi.h>
 #include "fcs_result.h"
+#include "common/resort/resort.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -68,6 +69,34 @@ extern "C" {
   void ifcs_p3m_set_tolerance_field_tune(void *rd);
   void ifcs_p3m_get_tolerance_field(void *rd, fcs_float* tolerance_field);
 
+  void ifcs_p3m_set_max_particle_move(void *rd, fcs_float max_particle_move);
+
+  void ifcs_p3m_set_resort(void *rd, fcs_int resort);
+  void ifcs_p3m_get_resort(void *rd, fcs_int *resort);
+  void ifcs_p3m_get_resort_availability(void *rd, fcs_int *availability);
+  void ifcs_p3m_get_resort_particles(void *rd, fcs_int *resort_particles);
+  void ifcs_p3m_resort_ints(void *rd, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm);
+  void ifcs_p3m_resort_floats(void *rd, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm);
+  void ifcs_p3m_resort_bytes(void *rd, void *src, void *dst, fcs_int n, MPI_Comm comm);
+  void ifcs_p3m_get_resort_object(void *rd, fcs_resort_t *resort);
+
+  void ifcs_p3m_set_num_threads(void *rd, fcs_int num_threads);
+  void ifcs_p3m_get_num_threads(void *rd, fcs_int *num_threads);
+
+  void ifcs_p3m_set_pipelined_fft(void *rd, fcs_int flag);
+  void ifcs_p3m_get_pipelined_fft(void *rd, fcs_int *flag);
+
+  void ifcs_p3m_set_batched_fft(void *rd, fcs_int flag);
+  void ifcs_p3m_get_batched_fft(void *rd, fcs_int *flag);
+
+  void ifcs_p3m_set_mixed_precision(void *rd, fcs_int flag);
+  void ifcs_p3m_get_mixed_precision(void *rd, fcs_int *flag);
+
+  void ifcs_p3m_set_tuning_db(void *rd, const char *filename, fcs_int retune);
+
+  void ifcs_p3m_set_verlet_skin(void *rd, fcs_float verlet_skin);
+  void ifcs_p3m_get_verlet_skin(void *rd, fcs_float *verlet_skin);
+
   void ifcs_p3m_require_total_energy(void *rd, fcs_int flag);
   FCSResult ifcs_p3m_get_total_energy(void *rd, fcs_float *total_energy);
   
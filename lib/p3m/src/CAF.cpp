@@ -229,7 +229,8 @@ void CAF::DerivativeCache::update(p3m_float r0) {
 		pbegin[i] = computeDerivative(i, r0, caf.cao);
 }
 
-CAF::CAF(p3m_int _cao, bool _derivative) : cao(_cao), derivative(_derivative) {
+CAF::CAF(p3m_int _cao, bool _derivative)
+: cao(_cao), derivative(_derivative), table(NULL), table_points(0) {
 	if (cao > MAX_CAO || cao < 1) {
 		std::ostringstream s;
 		s << "Charge assignment order " << cao << " unknown.";
@@ -278,6 +279,9 @@ InterpolatedCAF::InterpolatedCAF(p3m_int cao, p3m_int _n_interpol,
 					(derivative ?
 							P3M::CAF::computeDerivative(j, i*dInterpol, cao) :
 							P3M::CAF::compute(j, i*dInterpol, cao));
+
+	table = data;
+	table_points = 2*n_interpol+1;
 }
 
 InterpolatedCAF::~InterpolatedCAF() { delete[] data; }
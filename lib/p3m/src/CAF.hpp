@@ -41,6 +41,20 @@ public:
         the charge assignment function of order \a cao. */
     static p3m_float computeDerivative(p3m_int i, p3m_float r0, p3m_int cao);
 
+    /** Returns the CAO values of the CAF centered around \a r0, either
+        from the interpolation table or computed into \a w. CAO has to
+        be the order of the CAF. In contrast to Cache::update, this is
+        not virtual, so that the assignment kernels of the FarSolver
+        that are specialised for each order can inline it. */
+    template<p3m_int CAO>
+    const p3m_float *values(p3m_float r0, p3m_float *w) const {
+        if (table != NULL)
+            return &table[static_cast<p3m_int>(table_points * (r0 + 0.5)) * CAO];
+        for (p3m_int i = 0; i < CAO; i++)
+            w[i] = derivative ? computeDerivative(i, r0, CAO) : compute(i, r0, CAO);
+        return w;
+    }
+
     /** Abstract base class that caches cao values of the CAF. */
     class Cache {
     public:
@@ -81,6 +95,10 @@ public:
     friend class InterpolatedCAF;
     p3m_int cao;
     bool derivative;
+    /** table of the interpolated values (NULL if computed directly) */
+    const p3m_float *table;
+    /** number of rows of the table */
+    p3m_int table_points;
 };
 
 class InterpolatedCAF: public CAF {
@@ -66,6 +66,10 @@ void ErrorEstimate::compute(TuneParameters& p, p3m_int num_charges,
         computeKSError(p, num_charges, sum_q2, box_l);
         else
         computeKSErrorTriclinic(p, num_charges, sum_q2, box_vectors, isTriclinic);
+
+        if (mixed_precision)
+            p.ks_error = sqrt(SQR(p.ks_error)
+                    + SQR(computeRoundingError(p, num_charges, sum_q2, box_l)));
         
         p.error = sqrt(SQR(p.rs_error) + SQR(p.ks_error));
 
@@ -194,4 +198,14 @@ void ErrorEstimate::computeRSError(TuneParameters& p, p3m_int num_charges,
             / (sqrt(num_charges * p.r_cut * box_l[0] * box_l[1] * box_l[2]));
 }
 
+p3m_float ErrorEstimate::computeRoundingError(TuneParameters& p,
+        p3m_int num_charges, p3m_float sum_q2, p3m_float box_l[3]) {
+    /* Every rounding of a grid value adds an independent relative error
+     of the unit roundoff. The rms of the k-space field of N randomly
+     distributed charges is sqrt(4 sqrt(2 pi) alpha sum_q2 / V), the rms
+     charge is sqrt(sum_q2 / N). */
+    return P3M_SINGLE_ROUNDOFF * sqrt(P3M_SINGLE_ROUNDINGS * 4.0 * sqrt(2.0 * M_PI) * p.alpha
+            / (num_charges * box_l[0] * box_l[1] * box_l[2])) * sum_q2;
+}
+
 }
@@ -39,7 +39,7 @@ public:
     };
 
     ErrorEstimate(Communication &comm)
-            : comm(comm) {
+            : comm(comm), mixed_precision(false) {
     }
     virtual ~ErrorEstimate() {
     }
@@ -58,6 +58,10 @@ public:
     computeMaster(TuneParameters &p,
             p3m_int num_charges, p3m_float sum_q2, p3m_float box_l[3], p3m_float box_vectors[3][3], bool isTriclinic);
 
+    /** Whether the grid values are communicated in single precision.
+     * This adds the rounding error to the k-space error. */
+    void setMixedPrecision(bool flag) { mixed_precision = flag; }
+
     /* Call this on the master to end the slave loop. */
     void endLoop();
 
@@ -88,8 +92,15 @@ public:
      */
     virtual void computeKSErrorTriclinic(TuneParameters &p,
             p3m_int num_charges, p3m_float sum_q2, p3m_float box_vectors[3][3], bool isTriclinic) = 0;
+
+    /** Calculates the contribution of the single precision grid
+     * communication of the mixed precision mode to the rms error in the
+     * force. */
+    virtual p3m_float computeRoundingError(TuneParameters &p,
+            p3m_int num_charges, p3m_float sum_q2, p3m_float box_l[3]);
 	protected:
 	    Communication &comm;
+	    bool mixed_precision;
 
 };
 }
@@ -21,6 +21,10 @@
  */
 #include "FarSolver.hpp"
 #include <stdexcept>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 P3M::FarSolver::FarSolver(Communication &comm, p3m_float box_l[3],
         p3m_float r_cut, p3m_float alpha, p3m_int grid[3], p3m_int cao, p3m_float box_vectors[3][3], p3m_float volume, bool isTriclinic)
@@ -96,18 +100,14 @@ P3M::FarSolver::FarSolver(Communication &comm, p3m_float box_l[3],
 
     P3M_DEBUG(printf("    Interpolating charge assignment function...\n"));
     caf = P3M::CAF::create(cao, n_interpol);
-    cafx = caf->createCache();
-    cafy = caf->createCache();
-    cafz = caf->createCache();
 #ifdef P3M_AD
     caf_d = P3M::CAF::create(cao, n_interpol, true);
-    cafx_d = caf_d->createCache();
-    cafy_d = caf_d->createCache();
-    cafz_d = caf_d->createCache();
 #else
     caf_d = NULL;
-    cafx_d = cafy_d = cafz_d = NULL;
 #endif
+    /* single-threaded until setNumThreads() is called */
+    num_threads = 1;
+    this->createThreadData();
 
     /* position offset for calc. of first gridpoint */
     pos_shift = (p3m_float)((cao-1)/2) - (cao%2)/2.0;
@@ -119,6 +119,10 @@ P3M::FarSolver::FarSolver(Communication &comm, p3m_float box_l[3],
     rs_grid = fft.malloc_data();
     ks_grid = fft.malloc_data();
     buffer = fft.malloc_data();
+    batched_fft = false;
+    for (int i = 0; i < NUM_BATCH_GRIDS; i++)
+        batch_grids[i] = NULL;
+    mixed_precision = false;
 
     /* k-space part */
     /* Calculates the Fourier transformed differential operator.
@@ -152,16 +156,13 @@ P3M::FarSolver::~FarSolver() {
     fft.free_data(rs_grid);
     fft.free_data(ks_grid);
     fft.free_data(buffer);
+    for (int i = 0; i < NUM_BATCH_GRIDS; i++)
+        fft.free_data(batch_grids[i]);
     delete[] send_grid;
     delete[] recv_grid;
+    this->destroyThreadData();
     delete caf;
-    delete cafx;
-    delete cafy;
-    delete cafz;
     delete caf_d;
-    delete cafx_d;
-    delete cafy_d;
-    delete cafz_d;
     delete[] g_force;
     delete[] g_energy;
     delete[] d_op[0];
@@ -353,6 +354,16 @@ void P3M::FarSolver::runIK(p3m_int num_charges, p3m_float* positions,
     stopTimer(FORWARD);
     P3M_DEBUG(printf("  returned from fft.forward().\n"));
 
+    if (batched_fft && fields != NULL
+            && require_timings != ESTIMATE_ALL
+            && require_timings != ESTIMATE_FFT) {
+        this->backInterpolateIKBatched(num_charges, positions, charges,
+                fields, potentials);
+        this->gatherTimings();
+        P3M_INFO(printf( "P3M::FarSolver::runIK() finished.\n"));
+        return;
+    }
+
     /********************************************/
     /* POTENTIAL COMPUTATION */
     /********************************************/
@@ -445,6 +456,81 @@ void P3M::FarSolver::runIK(p3m_int num_charges, p3m_float* positions,
     P3M_INFO(printf( "P3M::FarSolver::runIK() finished.\n"));
 }
 
+/** Back-transform and interpolate potentials and fields [IK] like
+ * runIK, but the (up to) four grids of the potential and the field
+ * components are back-transformed by one batched backward FFT, so that
+ * they share the redistributions of the FFT. */
+void P3M::FarSolver::backInterpolateIKBatched(p3m_int num_charges,
+        p3m_float* positions, p3m_float* charges, p3m_float* fields,
+        p3m_float* potentials) {
+    p3m_float *data[4], *buf[4];
+    p3m_int n = 0;
+
+    /* potentials: apply the energy optimized influence function,
+       result is in ks_grid */
+    if (require_total_energy || potentials != NULL) {
+        startTimer(INFLUENCE);
+        this->applyInfluenceFunction(rs_grid, ks_grid, g_energy);
+        stopTimer(INFLUENCE);
+
+        /* compute total energy, but not potentials */
+        if (require_total_energy && potentials == NULL) {
+            startTimer(POTENTIALS);
+            total_energy = this->computeTotalEnergy();
+            stopTimer(POTENTIALS);
+        }
+
+        if (potentials != NULL)
+            data[n++] = ks_grid;
+    }
+
+    /* fields: apply the force optimized influence function and
+       differentiate in all directions, the results are in rs_grid and
+       the first two batch grids */
+    p3m_float *ks_force = batch_grids[NUM_BATCH_GRIDS-1];
+    p3m_float *field_grids[3] = { rs_grid, batch_grids[0], batch_grids[1] };
+    startTimer(INFLUENCE);
+    this->applyInfluenceFunction(rs_grid, ks_force, g_force);
+    stopTimer(INFLUENCE);
+    startTimer(FIELDS);
+    for (int dim = 0; dim < 3; dim++) {
+        this->differentiateIK(dim, ks_force, field_grids[dim]);
+        data[n++] = field_grids[dim];
+    }
+    stopTimer(FIELDS);
+
+    /* the remaining grids are the buffers of the FFT */
+    buf[0] = buffer;
+    for (p3m_int i = 1; i < n; i++)
+        buf[i] = batch_grids[NUM_BATCH_GRIDS-i];
+
+    P3M_DEBUG(printf( "  calling batched fft.backward (%d grids)...\n", n));
+    startTimer(BACK);
+    fft.backward(n, data, buf);
+    stopTimer(BACK);
+    P3M_DEBUG(printf("  returned from fft.backward.\n"));
+
+    if (potentials != NULL) {
+        /* redistribute energy grid */
+        startTimer(SPREAD);
+        this->spreadGrid(ks_grid);
+        switchTimer(SPREAD, POTENTIALS);
+        this->assignPotentials(ks_grid,
+                num_charges, positions, charges, 0, potentials);
+        stopTimer(POTENTIALS);
+    }
+
+    for (int dim = 0; dim < 3; dim++) {
+        /* redistribute force grid */
+        startTimer(SPREAD);
+        this->spreadGrid(field_grids[dim]);
+        switchTimer(SPREAD, FIELDS);
+        this->assignFieldsIK(field_grids[dim], dim, num_charges, positions,
+                0, fields);
+        stopTimer(FIELDS);
+    }
+}
+
 /** Calculates the properties of the send/recv sub-grides of the local
  *  FFT grid.  In order to calculate the recv sub-grides there is a
  *  communication of the margins between neighbouring nodes. */
@@ -1058,10 +1144,12 @@ P3M::FarSolver::computeGridShift(int dir, p3m_int size) {
       The function returns the linear index of the top left grid point
       in the charge assignment grid that corresponds to real_pos. When
       "shifted" is set, it uses the shifted position for interlacing.
-      After the call, caf_cache contains a cache of the values of the
-      charge assignment fraction (caf) for x,y,z.
+      After the call, dist contains the normalized distances of
+      real_pos to the grid point in x,y,z, i.e. the arguments of the
+      charge assignment function (caf).
  */
-p3m_int P3M::FarSolver::getCAPoints(p3m_float real_pos[3], p3m_int shifted) {
+p3m_int P3M::FarSolver::getCAPoints(p3m_float real_pos[3], p3m_int shifted,
+        p3m_float dist[3]) {
     /* linear index of the grid point */
     p3m_int linind = 0;
 
@@ -1090,21 +1178,7 @@ p3m_int P3M::FarSolver::getCAPoints(p3m_float real_pos[3], p3m_int shifted) {
         /* linear index of grid point */
         linind = grid_ind + linind*local_grid.dim[dim];
         /* normalized distance to grid point */
-        p3m_float dist = (pos-grid_ind)-0.5;
-
-        switch (dim) {
-        case 0: cafx->update(dist); break;
-        case 1: cafy->update(dist); break;
-        case 2: cafz->update(dist); break;
-        }
-
-#ifdef P3M_AD
-        switch (dim) {
-        case 0: cafx_d->update(dist); break;
-        case 1: cafy_d->update(dist); break;
-        case 2: cafz_d->update(dist); break;
-        }
-#endif
+        dist[dim] = (pos-grid_ind)-0.5;
 
 #ifdef ADDITIONAL_CHECKS
         if (real_pos[dim] < comm.my_left[dim]
@@ -1126,41 +1200,107 @@ p3m_int P3M::FarSolver::getCAPoints(p3m_float real_pos[3], p3m_int shifted) {
     return linind;
 }
 
+/* Call the kernel of the current charge assignment order. The kernels
+   are specialised at compile time, so that the loops over the cao^3
+   assignment points have constant bounds and can be unrolled and
+   vectorised by the compiler. */
+#define P3M_CAO_DISPATCH(KERNEL, ARGS)                                  \
+    switch (cao) {                                                      \
+    case 1: this->KERNEL<1> ARGS; break;                                \
+    case 2: this->KERNEL<2> ARGS; break;                                \
+    case 3: this->KERNEL<3> ARGS; break;                                \
+    case 4: this->KERNEL<4> ARGS; break;                                \
+    case 5: this->KERNEL<5> ARGS; break;                                \
+    case 6: this->KERNEL<6> ARGS; break;                                \
+    case 7: this->KERNEL<7> ARGS; break;                                \
+    default:                                                            \
+        throw std::logic_error("Charge assignment order unknown.");     \
+    }
+
 /** Assign the charges to the grid */
 void P3M::FarSolver::assignCharges(p3m_float* data, p3m_int num_charges,
         p3m_float* positions, p3m_float* charges, p3m_int shifted) {
     P3M_DEBUG(printf( "  P3M::FarSolver::assignCharges() started...\n"));
 
-    const p3m_int q2off = local_grid.q_2_off;
-    const p3m_int q21off = local_grid.q_21_off;
-
     /* init local charge grid */
     for (p3m_int i=0; i<local_grid.size; i++) data[i] = 0.0;
 
-    /* now assign the charges */
-    for (p3m_int pid = 0; pid < num_charges; pid++) {
-        const p3m_float q = charges[pid];
-        p3m_int linind_grid = this->getCAPoints(&positions[pid*3], shifted);
+#ifdef _OPENMP
+    /* Each thread assigns a contiguous block of particles to its own grid
+     * (thread 0 directly to data), afterwards the private grids are summed
+     * up in a fixed order. Thus, the result is reproducible for a fixed
+     * number of threads. */
+#pragma omp parallel num_threads(num_threads)
+    {
+        const p3m_int thread = omp_get_thread_num();
+        const p3m_int nthreads = omp_get_num_threads();
+        const p3m_int chunk = num_charges / nthreads;
+        const p3m_int rest = num_charges % nthreads;
+        const p3m_int begin = thread*chunk + std::min(thread, rest);
+        const p3m_int end = begin + chunk + (thread < rest ? 1 : 0);
+
+        p3m_float *tdata = data;
+        if (thread > 0) {
+            tdata = &thread_grids[(thread-1)*local_grid.size];
+            for (p3m_int i=0; i<local_grid.size; i++) tdata[i] = 0.0;
+        }
 
-        /* Loop over all ca grid points nearby and compute charge assignment fraction */
-        for (p3m_float *caf_x = cafx->begin(); caf_x < cafx->end(); caf_x++) {
-            for (p3m_float *caf_y = cafy->begin(); caf_y < cafy->end(); caf_y++) {
-                p3m_float caf_xy = *caf_x * *caf_y;
-                for (p3m_float *caf_z = cafz->begin(); caf_z < cafz->end(); caf_z++) {
-                    /* add it to the grid */
-                    data[linind_grid] += q * caf_xy * *caf_z;
-                    linind_grid++;
-                }
-                linind_grid += q2off;
-            }
-            linind_grid += q21off;
+        this->assignChargesBlock(tdata, begin, end, positions, charges,
+                shifted);
+
+        if (nthreads > 1) {
+#pragma omp barrier
+#pragma omp for schedule(static)
+            for (p3m_int i=0; i<local_grid.size; i++)
+                for (p3m_int t=1; t<nthreads; t++)
+                    data[i] += thread_grids[(t-1)*local_grid.size + i];
         }
     }
+#else
+    this->assignChargesBlock(data, 0, num_charges, positions, charges,
+            shifted);
+#endif
 
     P3M_DEBUG(printf( "  P3M::FarSolver::assignCharges() finished...\n"));
 
 }
 
+void P3M::FarSolver::assignChargesBlock(p3m_float* data,
+        p3m_int begin, p3m_int end, p3m_float* positions, p3m_float* charges,
+        p3m_int shifted) {
+    P3M_CAO_DISPATCH(assignChargesKernel,
+            (data, begin, end, positions, charges, shifted));
+}
+
+template<p3m_int CAO>
+void P3M::FarSolver::assignChargesKernel(p3m_float* data,
+        p3m_int begin, p3m_int end, p3m_float* positions, p3m_float* charges,
+        p3m_int shifted) {
+    const p3m_int ystride = local_grid.dim[2];
+    const p3m_int xstride = local_grid.dim[1] * local_grid.dim[2];
+
+    for (p3m_int pid = begin; pid < end; pid++) {
+        const p3m_float q = charges[pid];
+        p3m_float dist[3], wx[CAO], wy[CAO], wz[CAO];
+        const p3m_int linind_grid =
+                this->getCAPoints(&positions[pid*3], shifted, dist);
+        const p3m_float *caf_x = caf->values<CAO>(dist[0], wx);
+        const p3m_float *caf_y = caf->values<CAO>(dist[1], wy);
+        const p3m_float *caf_z = caf->values<CAO>(dist[2], wz);
+
+        /* Loop over all ca grid points nearby and compute charge assignment fraction */
+        for (p3m_int i = 0; i < CAO; i++) {
+            for (p3m_int j = 0; j < CAO; j++) {
+                p3m_float *g = &data[linind_grid + i*xstride + j*ystride];
+                const p3m_float q_caf_xy = q * (caf_x[i] * caf_y[j]);
+                /* add it to the grid */
+                for (p3m_int k = 0; k < CAO; k++)
+                    g[k] += q_caf_xy * caf_z[k];
+            }
+        }
+    }
+}
+
 /* Gather information for FFT grid inside the nodes domain (inner local grid) */
 void P3M::FarSolver::gatherGrid(p3m_float* rs_grid) {
     P3M_DEBUG(printf( "  P3M::FarSolver::gatherGrid() started...\n"));
@@ -1176,13 +1316,25 @@ void P3M::FarSolver::gatherGrid(p3m_float* rs_grid) {
                     sm.s_dim[s_dir], local_grid.dim, 1);
 
         /* communication */
-        if (comm.node_neighbors[s_dir] != comm.rank)
+        if (comm.node_neighbors[s_dir] != comm.rank && mixed_precision) {
+            Parallel3DFFT::pack_single(send_grid, sm.s_size[s_dir]);
+            MPI_Sendrecv(send_grid, sm.s_size[s_dir], MPI_FLOAT,
+                    comm.node_neighbors[s_dir], REQ_P3M_GATHER,
+                    recv_grid, sm.r_size[r_dir], MPI_FLOAT,
+                    comm.node_neighbors[r_dir], REQ_P3M_GATHER,
+                    comm.mpicomm, MPI_STATUS_IGNORE);
+            fcs_timing_count(FCS_COUNTER_COMM_BYTES,
+                    sm.r_size[r_dir] * sizeof(float));
+            Parallel3DFFT::unpack_single(recv_grid, sm.r_size[r_dir]);
+        } else if (comm.node_neighbors[s_dir] != comm.rank) {
             MPI_Sendrecv(send_grid, sm.s_size[s_dir], P3M_MPI_FLOAT,
                     comm.node_neighbors[s_dir], REQ_P3M_GATHER,
                     recv_grid, sm.r_size[r_dir], P3M_MPI_FLOAT,
                     comm.node_neighbors[r_dir], REQ_P3M_GATHER,
                     comm.mpicomm, MPI_STATUS_IGNORE);
-        else std::swap(recv_grid, send_grid);
+            fcs_timing_count(FCS_COUNTER_COMM_BYTES,
+                    sm.r_size[r_dir] * sizeof(p3m_float));
+        } else std::swap(recv_grid, send_grid);
 
         /* add recv block */
         if(sm.r_size[r_dir]>0) {
@@ -1207,13 +1359,25 @@ void P3M::FarSolver::spreadGrid(p3m_float* rs_grid) {
             Parallel3DFFT::pack_block(rs_grid, send_grid, sm.r_ld[r_dir],
                     sm.r_dim[r_dir], local_grid.dim, 1);
         /* communication */
-        if (comm.node_neighbors[r_dir] != comm.rank)
+        if (comm.node_neighbors[r_dir] != comm.rank && mixed_precision) {
+            Parallel3DFFT::pack_single(send_grid, sm.r_size[r_dir]);
+            MPI_Sendrecv(send_grid, sm.r_size[r_dir], MPI_FLOAT,
+                    comm.node_neighbors[r_dir], REQ_P3M_SPREAD,
+                    recv_grid, sm.s_size[s_dir], MPI_FLOAT,
+                    comm.node_neighbors[s_dir], REQ_P3M_SPREAD,
+                    comm.mpicomm, MPI_STATUS_IGNORE);
+            fcs_timing_count(FCS_COUNTER_COMM_BYTES,
+                    sm.s_size[s_dir] * sizeof(float));
+            Parallel3DFFT::unpack_single(recv_grid, sm.s_size[s_dir]);
+        } else if (comm.node_neighbors[r_dir] != comm.rank) {
             MPI_Sendrecv(send_grid, sm.r_size[r_dir], P3M_MPI_FLOAT,
                     comm.node_neighbors[r_dir], REQ_P3M_SPREAD,
                     recv_grid, sm.s_size[s_dir], P3M_MPI_FLOAT,
                     comm.node_neighbors[s_dir], REQ_P3M_SPREAD,
                     comm.mpicomm, MPI_STATUS_IGNORE);
-        else std::swap(recv_grid, send_grid);
+            fcs_timing_count(FCS_COUNTER_COMM_BYTES,
+                    sm.s_size[s_dir] * sizeof(p3m_float));
+        } else std::swap(recv_grid, send_grid);
 
         /* unpack recv block */
         if (sm.s_size[s_dir]>0)
@@ -1290,11 +1454,33 @@ p3m_float P3M::FarSolver::computeTotalEnergy() {
 
     P3M_DEBUG(printf( "  P3M::FarSolver::computeTotalEnergy() started...\n"));
 
-    p3m_int size = fft.getKSSize();
-    for (p3m_int i=0; i < size; i++)
-        /* Use the energy optimized influence function */
-        k_space_energy += g_energy[i] * ( SQR(rs_grid[2*i]) +
-                SQR(rs_grid[2*i+1]) );
+    const p3m_int h = fft.getKSHermitianDim();
+    if (h < 0) {
+        p3m_int size = fft.getKSSize();
+        for (p3m_int i=0; i < size; i++)
+            /* Use the energy optimized influence function */
+            k_space_energy += g_energy[i] * ( SQR(rs_grid[2*i]) +
+                    SQR(rs_grid[2*i+1]) );
+    } else {
+        /* Only half of the Hermitian symmetric spectrum is stored in
+         * dimension h, all modes but 0 and grid/2 have to be counted twice. */
+        const p3m_int *start, *extent;
+        fft.getKSExtent(start, extent);
+        const p3m_int n_h = grid[(h+ks_pnum)%3];
+        p3m_int ind = 0;
+        p3m_int j[3];
+        for (j[0]=0; j[0] < extent[0]; j[0]++) {
+            for (j[1]=0; j[1] < extent[1]; j[1]++) {
+                for (j[2]=0; j[2] < extent[2]; j[2]++) {
+                    const p3m_int m = j[h] + start[h];
+                    const p3m_float weight = (m == 0 || 2*m == n_h) ? 1.0 : 2.0;
+                    k_space_energy += weight * g_energy[ind] *
+                            ( SQR(rs_grid[2*ind]) + SQR(rs_grid[2*ind+1]) );
+                    ind++;
+                }
+            }
+        }
+    }
 
     MPI_Reduce(MPI_IN_PLACE, &k_space_energy, 1, P3M_MPI_FLOAT,
             MPI_SUM, 0, comm.mpicomm);
@@ -1320,29 +1506,47 @@ p3m_float P3M::FarSolver::computeTotalEnergy() {
 void P3M::FarSolver::assignPotentials(p3m_float* data, p3m_int num_particles,
         p3m_float* positions, p3m_float* charges, p3m_int shifted,
         p3m_float* potentials) {
-    const p3m_int q2off = local_grid.q_2_off;
-    const p3m_int q21off = local_grid.q_21_off;
+    P3M_DEBUG(printf( "  P3M::FarSolver::assignPotentials() started...\n"));
+    P3M_CAO_DISPATCH(assignPotentialsKernel,
+            (data, num_particles, positions, charges, shifted, potentials));
+    P3M_DEBUG(printf( "  P3M::FarSolver::assignPotentials() finished.\n"));
+}
+
+template<p3m_int CAO>
+void P3M::FarSolver::assignPotentialsKernel(p3m_float* data,
+        p3m_int num_particles, p3m_float* positions, p3m_float* charges,
+        p3m_int shifted, p3m_float* potentials) {
+    const p3m_int ystride = local_grid.dim[2];
+    const p3m_int xstride = local_grid.dim[1] * local_grid.dim[2];
     const p3m_float prefactor = 1.0 / (box_l[0] * box_l[1] * box_l[2]);
 
-    P3M_DEBUG(printf( "  P3M::FarSolver::assignPotentials() started...\n"));
     /* Loop over all particles */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+#endif
     for (p3m_int pid=0; pid < num_particles; pid++) {
-        p3m_float potential = 0.0;
-        p3m_int linind_grid =
-                this->getCAPoints(&positions[pid*3], shifted);
-
-        /* Loop over all ca grid points nearby and compute charge assignment fraction */
-        for (p3m_float *caf_x = cafx->begin(); caf_x < cafx->end(); caf_x++) {
-            for (p3m_float *caf_y = cafy->begin(); caf_y < cafy->end(); caf_y++) {
-                p3m_float caf_xy = *caf_x * *caf_y;
-                for (p3m_float *caf_z = cafz->begin(); caf_z < cafz->end(); caf_z++) {
-                    potential += *caf_z * caf_xy * data[linind_grid];
-                    linind_grid++;
-                }
-                linind_grid += q2off;
+        p3m_float dist[3], wx[CAO], wy[CAO], wz[CAO];
+        const p3m_int linind_grid =
+                this->getCAPoints(&positions[pid*3], shifted, dist);
+        const p3m_float *caf_x = caf->values<CAO>(dist[0], wx);
+        const p3m_float *caf_y = caf->values<CAO>(dist[1], wy);
+        const p3m_float *caf_z = caf->values<CAO>(dist[2], wz);
+
+        /* Sum up the grid values weighted with the caf in x and y for
+           each z separately, then apply the caf in z. */
+        p3m_float sum_xy[CAO];
+        for (p3m_int k = 0; k < CAO; k++) sum_xy[k] = 0.0;
+        for (p3m_int i = 0; i < CAO; i++) {
+            for (p3m_int j = 0; j < CAO; j++) {
+                const p3m_float *g = &data[linind_grid + i*xstride + j*ystride];
+                const p3m_float caf_xy = caf_x[i] * caf_y[j];
+                for (p3m_int k = 0; k < CAO; k++)
+                    sum_xy[k] += caf_xy * g[k];
             }
-            linind_grid += q21off;
         }
+        p3m_float potential = 0.0;
+        for (p3m_int k = 0; k < CAO; k++)
+            potential += caf_z[k] * sum_xy[k];
 
         potential *= prefactor;
         /* self energy correction */
@@ -1358,38 +1562,53 @@ void P3M::FarSolver::assignPotentials(p3m_float* data, p3m_int num_particles,
         }
 
     }
-    P3M_DEBUG(printf( "  P3M::FarSolver::assignPotentials() finished.\n"));
-
 }
 
 /* Backinterpolate the forces obtained from k-space to the positions */
 void P3M::FarSolver::assignFieldsIK(p3m_float* data, p3m_int dim,
         p3m_int num_particles, p3m_float* positions, p3m_int shifted,
         p3m_float* fields){
-    const p3m_int q2off = local_grid.q_2_off;
-    const p3m_int q21off = local_grid.q_21_off;
+    P3M_DEBUG(printf( "  P3M::FarSolver::assignFieldsIK() started...\n"));
+    P3M_CAO_DISPATCH(assignFieldsIKKernel,
+            (data, dim, num_particles, positions, shifted, fields));
+    P3M_DEBUG(printf( "  P3M::FarSolver::assignFieldsIK() finished.\n"));
+}
+
+template<p3m_int CAO>
+void P3M::FarSolver::assignFieldsIKKernel(p3m_float* data, p3m_int dim,
+        p3m_int num_particles, p3m_float* positions, p3m_int shifted,
+        p3m_float* fields){
+    const p3m_int ystride = local_grid.dim[2];
+    const p3m_int xstride = local_grid.dim[1] * local_grid.dim[2];
     const p3m_float prefactor = 1.0 / (2.0 * box_l[0] * box_l[1] * box_l[2]);
     const p3m_int dim_rs = (dim+ks_pnum) % 3;
 
-    P3M_DEBUG(printf( "  P3M::FarSolver::assignFieldsIK() started...\n"));
     /* Loop over all particles */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+#endif
     for (p3m_int pid=0; pid < num_particles; pid++) {
-        p3m_float field = 0.0;
-        p3m_int linind_grid =
-                this->getCAPoints(&positions[3*pid], shifted);
+        p3m_float dist[3], wx[CAO], wy[CAO], wz[CAO];
+        const p3m_int linind_grid =
+                this->getCAPoints(&positions[3*pid], shifted, dist);
+        const p3m_float *caf_x = caf->values<CAO>(dist[0], wx);
+        const p3m_float *caf_y = caf->values<CAO>(dist[1], wy);
+        const p3m_float *caf_z = caf->values<CAO>(dist[2], wz);
 
         /* loop over the local grid, compute the field */
-        for (p3m_float *caf_x = cafx->begin(); caf_x < cafx->end(); caf_x++) {
-            for (p3m_float *caf_y = cafy->begin(); caf_y < cafy->end(); caf_y++) {
-                p3m_float caf_xy = *caf_x * *caf_y;
-                for (p3m_float *caf_z = cafz->begin(); caf_z < cafz->end(); caf_z++) {
-                    field -= *caf_z * caf_xy * data[linind_grid];
-                    linind_grid++;
-                }
-                linind_grid += q2off;
+        p3m_float sum_xy[CAO];
+        for (p3m_int k = 0; k < CAO; k++) sum_xy[k] = 0.0;
+        for (p3m_int i = 0; i < CAO; i++) {
+            for (p3m_int j = 0; j < CAO; j++) {
+                const p3m_float *g = &data[linind_grid + i*xstride + j*ystride];
+                const p3m_float caf_xy = caf_x[i] * caf_y[j];
+                for (p3m_int k = 0; k < CAO; k++)
+                    sum_xy[k] += caf_xy * g[k];
             }
-            linind_grid += q21off;
         }
+        p3m_float field = 0.0;
+        for (p3m_int k = 0; k < CAO; k++)
+            field -= caf_z[k] * sum_xy[k];
 
         field *= prefactor;
 
@@ -1399,51 +1618,72 @@ void P3M::FarSolver::assignFieldsIK(p3m_float* data, p3m_int dim,
         else
             fields[3*pid + dim_rs] = 0.5 * (fields[3*pid + dim_rs] + field);
     }
-    P3M_DEBUG(printf( "  P3M::FarSolver::assignFieldsIK() finished.\n"));
-
 }
 
 /* Backinterpolate the forces obtained from k-space to the positions */
 void P3M::FarSolver::assignFieldsAD(p3m_float* data, p3m_int num_particles,
         p3m_float* positions, p3m_int shifted, p3m_float* fields) {
-    const p3m_int q2off = local_grid.q_2_off;
-    const p3m_int q21off = local_grid.q_21_off;
+    P3M_DEBUG(printf( "  P3M::Solver::assign_fields_ad() started...\n"));
+    P3M_CAO_DISPATCH(assignFieldsADKernel,
+            (data, num_particles, positions, shifted, fields));
+    P3M_DEBUG(printf( "  assign_fields_ad() finished.\n"));
+}
+
+template<p3m_int CAO>
+void P3M::FarSolver::assignFieldsADKernel(p3m_float* data,
+        p3m_int num_particles, p3m_float* positions, p3m_int shifted,
+        p3m_float* fields) {
+    const p3m_int ystride = local_grid.dim[2];
+    const p3m_int xstride = local_grid.dim[1] * local_grid.dim[2];
     const p3m_float prefactor = 1.0 / (box_l[0] * box_l[1] * box_l[2]);
-    const p3m_float l_x_inv = 1.0/box_l[0];
-    const p3m_float l_y_inv = 1.0/box_l[1];
-    const p3m_float l_z_inv = 1.0/box_l[2];
+    const p3m_float factor_x = prefactor * grid[0] / box_l[0];
+    const p3m_float factor_y = prefactor * grid[1] / box_l[1];
+    const p3m_float factor_z = prefactor * grid[2] / box_l[2];
 
-    P3M_DEBUG(printf( "  P3M::Solver::assign_fields_ad() started...\n"));
     /* Loop over all particles */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+#endif
     for (p3m_int pid = 0; pid < num_particles; pid++) {
-        p3m_float field[3] = { 0.0, 0.0, 0.0 };
-        p3m_int linind_grid =
-                this->getCAPoints(&positions[pid*3], shifted);
-
-        p3m_float *caf_x_d = cafx_d->begin();
-        for (p3m_float *caf_x = cafx->begin(); caf_x < cafx->end(); caf_x++) {
-            p3m_float *caf_y_d = cafy_d->begin();
-            for (p3m_float *caf_y = cafy->begin(); caf_y < cafy->end(); caf_y++) {
-                p3m_float *caf_z_d = cafz_d->begin();
-                for (p3m_float *caf_z = cafz->begin(); caf_z < cafz->end(); caf_z++) {
-                    field[0] -= *caf_x_d * *caf_y * *caf_z * l_x_inv
-                            * data[linind_grid] * grid[0];
-                    field[1] -= *caf_x * *caf_y_d * *caf_z * l_y_inv
-                            * data[linind_grid] * grid[1];
-                    field[2] -= *caf_x * *caf_y * *caf_z_d * l_z_inv
-                            * data[linind_grid] * grid[2];
-                    linind_grid++;
-                    caf_z_d++;
+        p3m_float dist[3], wx[CAO], wy[CAO], wz[CAO];
+        p3m_float wx_d[CAO], wy_d[CAO], wz_d[CAO];
+        const p3m_int linind_grid =
+                this->getCAPoints(&positions[pid*3], shifted, dist);
+        const p3m_float *caf_x = caf->values<CAO>(dist[0], wx);
+        const p3m_float *caf_y = caf->values<CAO>(dist[1], wy);
+        const p3m_float *caf_z = caf->values<CAO>(dist[2], wz);
+        const p3m_float *caf_x_d = caf_d->values<CAO>(dist[0], wx_d);
+        const p3m_float *caf_y_d = caf_d->values<CAO>(dist[1], wy_d);
+        const p3m_float *caf_z_d = caf_d->values<CAO>(dist[2], wz_d);
+
+        /* Sum up the grid values weighted with the caf (or its
+           derivative) in x and y for each z separately, then apply the
+           caf (or its derivative) in z. */
+        p3m_float sum_dx_y[CAO], sum_x_dy[CAO], sum_xy[CAO];
+        for (p3m_int k = 0; k < CAO; k++)
+            sum_dx_y[k] = sum_x_dy[k] = sum_xy[k] = 0.0;
+        for (p3m_int i = 0; i < CAO; i++) {
+            for (p3m_int j = 0; j < CAO; j++) {
+                const p3m_float *g = &data[linind_grid + i*xstride + j*ystride];
+                const p3m_float caf_dx_y = caf_x_d[i] * caf_y[j];
+                const p3m_float caf_x_dy = caf_x[i] * caf_y_d[j];
+                const p3m_float caf_xy = caf_x[i] * caf_y[j];
+                for (p3m_int k = 0; k < CAO; k++) {
+                    sum_dx_y[k] += caf_dx_y * g[k];
+                    sum_x_dy[k] += caf_x_dy * g[k];
+                    sum_xy[k] += caf_xy * g[k];
                 }
-                linind_grid += q2off;
-                caf_y_d++;
             }
-            linind_grid += q21off;
-            caf_x_d++;
         }
-        field[0] *= prefactor;
-        field[1] *= prefactor;
-        field[2] *= prefactor;
+        p3m_float field[3] = { 0.0, 0.0, 0.0 };
+        for (p3m_int k = 0; k < CAO; k++) {
+            field[0] -= caf_z[k] * sum_dx_y[k];
+            field[1] -= caf_z[k] * sum_x_dy[k];
+            field[2] -= caf_z_d[k] * sum_xy[k];
+        }
+        field[0] *= factor_x;
+        field[1] *= factor_y;
+        field[2] *= factor_z;
 
         if (!shifted) {
             fields[3*pid + 0] = field[0];
@@ -1455,7 +1695,6 @@ void P3M::FarSolver::assignFieldsAD(p3m_float* data, p3m_int num_particles,
             fields[3*pid + 2] = 0.5*(fields[3*pid + 2] + field[2]);
         }
     }
-    P3M_DEBUG(printf( "  assign_fields_ad() finished.\n"));
 }
 
 /** Calculate number of charged particles, the sum of the squared
@@ -1503,6 +1742,70 @@ void P3M::FarSolver::setRequireTimings(TimingType type) {
     require_timings = type;
 }
 
+void P3M::FarSolver::setNumThreads(p3m_int num_threads) {
+#ifdef _OPENMP
+    if (num_threads <= 0)
+        num_threads = omp_get_max_threads();
+#else
+    num_threads = 1;
+#endif
+    if (num_threads == this->num_threads)
+        return;
+
+    P3M_INFO(printf("    Using " FINT " threads in charge assignment.\n", num_threads));
+    this->destroyThreadData();
+    this->num_threads = num_threads;
+    this->createThreadData();
+}
+
+p3m_int P3M::FarSolver::getNumThreads() {
+    return num_threads;
+}
+
+void P3M::FarSolver::setPipelinedFFT(bool flag) {
+    fft.setPipelined(flag);
+}
+
+bool P3M::FarSolver::getPipelinedFFT() {
+    return fft.isPipelined();
+}
+
+void P3M::FarSolver::setBatchedFFT(bool flag) {
+    if (flag == batched_fft)
+        return;
+    batched_fft = flag;
+    for (int i = 0; i < NUM_BATCH_GRIDS; i++) {
+        fft.free_data(batch_grids[i]);
+        batch_grids[i] = flag ? fft.malloc_data() : NULL;
+    }
+}
+
+bool P3M::FarSolver::getBatchedFFT() {
+    return batched_fft;
+}
+
+void P3M::FarSolver::setMixedPrecision(bool flag) {
+    mixed_precision = flag;
+    fft.setSinglePrecisionComm(flag);
+}
+
+bool P3M::FarSolver::getMixedPrecision() {
+    return mixed_precision;
+}
+
+/** Create the private charge assignment grids of the threads
+ * 1..num_threads-1. */
+void P3M::FarSolver::createThreadData() {
+    if (num_threads > 1)
+        thread_grids = new p3m_float[(num_threads-1)*local_grid.size];
+    else
+        thread_grids = NULL;
+}
+
+void P3M::FarSolver::destroyThreadData() {
+    delete[] thread_grids;
+}
+
 const double* P3M::FarSolver::measureTimings(p3m_int num_particles,
             p3m_float *positions, p3m_float *charges) {
     p3m_float *fields = new p3m_float[3*num_particles];
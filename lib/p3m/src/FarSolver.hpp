@@ -28,6 +28,7 @@
 #include "Parallel3DFFT.hpp"
 #include "ErrorEstimate.hpp"
 #include "CAF.hpp"
+#include "common/fcs-common/FCSTiming.h"
 
 namespace P3M {
 
@@ -60,6 +61,26 @@ public:
     fcs_float getTotalEnergy();
 
     void setRequireTimings(TimingType type = NONE);
+
+    /** Set the number of OpenMP threads used in charge assignment and
+     * back-interpolation (<= 0: use the OpenMP default). */
+    void setNumThreads(p3m_int num_threads);
+    p3m_int getNumThreads();
+
+    /** Use non-blocking, pipelined communication in the 3D-FFT. */
+    void setPipelinedFFT(bool flag = true);
+    bool getPipelinedFFT();
+
+    /** Back-transform the potential and the field components (ik) with
+     * one batched backward 3D-FFT that shares the redistributions. */
+    void setBatchedFFT(bool flag = true);
+    bool getBatchedFFT();
+
+    /** Send the grid values in the halo exchange and in the
+     * redistributions of the 3D-FFT in single precision. */
+    void setMixedPrecision(bool flag = true);
+    bool getMixedPrecision();
+
     /** Test run the method with the current parameters.
      * Return the total run time. */
     const double* measureTimings(p3m_int num_particles,
@@ -112,6 +133,8 @@ protected:
     TimingType require_timings;
 
     double timings[NUM_TIMINGS];
+    /** Start times of the components for the FCS phase timings. */
+    double phase_starts[NUM_TIMINGS];
 
     /****************************************************
      * METHOD DATA
@@ -152,6 +175,14 @@ protected:
     p3m_float *ks_grid;
     /** additional grid for buffering. */
     p3m_float *buffer;
+    /** whether the backward FFTs are batched (see setBatchedFFT) */
+    bool batched_fft;
+    /** additional grids for the batched backward FFT */
+    static const int NUM_BATCH_GRIDS = 5;
+    p3m_float *batch_grids[NUM_BATCH_GRIDS];
+    /** whether grid values are communicated in single precision (see
+        setMixedPrecision) */
+    bool mixed_precision;
 
     /** number of charged particles */
     p3m_int sum_qpart;
@@ -160,16 +191,15 @@ protected:
     /** square of sum of charges */
     p3m_float square_sum_q;
 
+    /** number of OpenMP threads */
+    p3m_int num_threads;
+    /** private charge assignment grids of the threads 1..num_threads-1 */
+    p3m_float *thread_grids;
+
     /** charge assignment function. */
     CAF *caf;
-    CAF::Cache *cafx;
-    CAF::Cache *cafy;
-    CAF::Cache *cafz;
     /** gradient of charge assignment function */
     CAF *caf_d;
-    CAF::Cache *cafx_d;
-    CAF::Cache *cafy_d;
-    CAF::Cache *cafz_d;
 
     /** position shift for calc. of first assignment grid point. */
     p3m_float pos_shift;
@@ -215,12 +245,43 @@ protected:
             p3m_float &numerator_energy,
             p3m_float denominator[2]);
     void cartesianizeFields(p3m_float *fields, p3m_int num_particles);
+    /* back-transform and interpolate potentials and fields [IK] with
+       the batched backward FFT */
+    void backInterpolateIKBatched(p3m_int num_charges, p3m_float *positions,
+            p3m_float *charges, p3m_float *fields, p3m_float *potentials);
     p3m_int *computeGridShift(int dir, p3m_int size);
 
+    void createThreadData();
+    void destroyThreadData();
+
     /* charge assignment */
-    p3m_int getCAPoints(p3m_float real_pos[3], p3m_int shifted);
+    p3m_int getCAPoints(p3m_float real_pos[3], p3m_int shifted,
+            p3m_float dist[3]);
     void assignCharges(p3m_float *data,
             p3m_int num_charges, p3m_float *positions, p3m_float *charges, p3m_int shifted);
+    /* assign the charges of the particles [begin,end) */
+    void assignChargesBlock(p3m_float *data,
+            p3m_int begin, p3m_int end, p3m_float *positions, p3m_float *charges,
+            p3m_int shifted);
+
+    /* kernels of the assignment functions for the charge assignment
+       order CAO (instantiated for 1..CAF::MAX_CAO, see FarSolver.cpp) */
+    template<p3m_int CAO>
+    void assignChargesKernel(p3m_float *data,
+            p3m_int begin, p3m_int end, p3m_float *positions, p3m_float *charges,
+            p3m_int shifted);
+    template<p3m_int CAO>
+    void assignPotentialsKernel(p3m_float *data,
+            p3m_int num_particles, p3m_float* positions, p3m_float* charges,
+            p3m_int shifted, p3m_float* potentials);
+    template<p3m_int CAO>
+    void assignFieldsIKKernel(p3m_float *data,
+            p3m_int dim, p3m_int num_particles, p3m_float* positions,
+            p3m_int shifted, p3m_float* fields);
+    template<p3m_int CAO>
+    void assignFieldsADKernel(p3m_float *data,
+            p3m_int num_particles, p3m_float* positions,
+            p3m_int shifted, p3m_float* fields);
 
     /* collect grid from neighbor processes */
     void gatherGrid(p3m_float* rs_grid);
@@ -262,14 +323,28 @@ protected:
             timings[i] = 0.0;
     }
 
+    /* FCS phase of a timing component (halo spread and back
+       interpolation are reported together as interpolation) */
+    static int phase(TimingComponent comp) {
+        switch (comp) {
+        case CA: case GATHER: return FCS_PHASE_SPREAD;
+        case FORWARD: case BACK: return FCS_PHASE_FFT;
+        case INFLUENCE: return FCS_PHASE_SOLVE;
+        case SPREAD: case POTENTIALS: case FIELDS: return FCS_PHASE_INTERPOLATE;
+        default: return -1;
+        }
+    }
+
     void startTimer(TimingComponent comp) {
         if (require_timings != NONE)
             timings[comp] += -MPI_Wtime();
+        phase_starts[comp] = fcs_timing_start();
     }
 
     void stopTimer(TimingComponent comp) {
         if (require_timings != NONE)
             timings[comp] += MPI_Wtime();
+        fcs_timing_stop(phase(comp), phase_starts[comp]);
     }
 
     void switchTimer(TimingComponent comp1,
@@ -278,6 +353,8 @@ protected:
             timings[comp1] += MPI_Wtime();
             timings[comp2] += -MPI_Wtime();
         }
+        fcs_timing_stop(phase(comp1), phase_starts[comp1]);
+        phase_starts[comp2] = fcs_timing_start();
     }
 };
 
@@ -27,8 +27,10 @@
 #include "types.hpp"
 #include "Parallel3DFFT.hpp"
 #include "utils.hpp"
+#include "common/fcs-common/FCSTiming.h"
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
 #include <cassert>
 #include <stdexcept>
@@ -40,6 +42,10 @@
 #define fftw_destroy_plan  FFTW_MANGLE(destroy_plan)
 #define fftw_execute  FFTW_MANGLE(execute)
 #define fftw_execute_dft  FFTW_MANGLE(execute_dft)
+#define fftw_plan_many_dft_r2c  FFTW_MANGLE(plan_many_dft_r2c)
+#define fftw_plan_many_dft_c2r  FFTW_MANGLE(plan_many_dft_c2r)
+#define fftw_execute_dft_r2c  FFTW_MANGLE(execute_dft_r2c)
+#define fftw_execute_dft_c2r  FFTW_MANGLE(execute_dft_c2r)
 #define fftw_import_system_wisdom  FFTW_MANGLE(import_system_wisdom)
 #define fftw_import_wisdom_from_filename  FFTW_MANGLE(import_wisdom_from_filename)
 #define fftw_export_wisdom_to_filename  FFTW_MANGLE(export_wisdom_to_filename)
@@ -119,10 +125,18 @@ Parallel3DFFT::Parallel3DFFT(Communication &comm) : comm(comm) {
   }
   
   is_prepared = false;
+  pipelined = false;
+  single_precision_comm = false;
   max_comm_size = 0;
+  max_total_comm_size = 0;
+  comm_batch = 1;
   max_grid_size = 0;
+  ks_hermitian_dim = -1;
   send_buf = NULL;
   recv_buf = NULL;
+  send_req = new MPI_Request[comm.size];
+  recv_req = new MPI_Request[comm.size];
+  recv_offset = new p3m_int[comm.size];
   
   // import fftw wisdom
   fftw_import_system_wisdom();
@@ -147,6 +161,9 @@ Parallel3DFFT::~Parallel3DFFT() {
   }
   sfree(send_buf);
   sfree(recv_buf);
+  sdelete(send_req);
+  sdelete(recv_req);
+  sdelete(recv_offset);
 }
 
 p3m_float* Parallel3DFFT::malloc_data() {
@@ -174,6 +191,7 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 	P3M_DEBUG(printf("    prepare() started...\n"));
 
 	max_comm_size = 0;
+	max_total_comm_size = 0;
 	max_grid_size = 0;
 
 	int *n_id[4]; /* linear node identity lists for the node grids. */
@@ -261,11 +279,26 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 	plan[2].row_dir = (plan[1].row_dir - 1) % 3;
 	plan[3].row_dir = (plan[1].row_dir - 2) % 3;
 
+#ifndef P3M_INTERLACE
+	/* The first FFT is a real to complex FFT, so the following grids only
+	 have grid/2+1 points in the first row direction (Hermitian symmetry). */
+	p3m_int hermitian_grid_dim[3];
+	for (int i = 0; i < 3; i++)
+		hermitian_grid_dim[i] = global_grid_dim[i];
+	hermitian_grid_dim[plan[1].row_dir] = global_grid_dim[plan[1].row_dir] / 2 + 1;
+#endif
+
 	/* === communication groups === */
 	/* copy local grid off real space charge assignment grid */
 	for (int i = 0; i < 3; i++)
 		plan[0].new_grid[i] = local_grid_dim[i];
 	for (int i = 1; i < 4; i++) {
+		/* global grid of the FFT in this direction */
+		p3m_int *fft_grid_dim = global_grid_dim;
+#ifndef P3M_INTERLACE
+		if (i > 1)
+			fft_grid_dim = hermitian_grid_dim;
+#endif
 		plan[i].g_size = find_comm_groups(comm, n_grid[i - 1], n_grid[i],
 				n_id[i - 1], n_id[i], plan[i].group, n_pos[i], my_pos[i]);
 		if (plan[i].g_size == -1) {
@@ -287,7 +320,7 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 				1 * plan[i].g_size * sizeof(p3m_int)));
 
 		plan[i].new_size = calc_local_grid(my_pos[i], n_grid[i],
-				global_grid_dim, global_grid_off, plan[i].new_grid,
+				fft_grid_dim, global_grid_off, plan[i].new_grid,
 				plan[i].start);
 		permute_ifield(plan[i].new_grid, 3, -(plan[i].n_permute));
 		permute_ifield(plan[i].start, 3, -(plan[i].n_permute));
@@ -298,7 +331,7 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 			/* send block: this_node to comm-group-node i (identity: node) */
 			p3m_int node = plan[i].group[j];
 			plan[i].send_size[j] = calc_send_block(my_pos[i - 1], n_grid[i - 1],
-					&(n_pos[i][3 * node]), n_grid[i], global_grid_dim,
+					&(n_pos[i][3 * node]), n_grid[i], fft_grid_dim,
 					global_grid_off, &(plan[i].send_block[6 * j]));
 			permute_ifield(&(plan[i].send_block[6 * j]), 3,
 					-(plan[i - 1].n_permute));
@@ -314,7 +347,7 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 					plan[1].send_block[6 * j + k] += local_grid_margin[2 * k];
 			/* recv block: this_node from comm-group-node i (identity: node) */
 			plan[i].recv_size[j] = calc_send_block(my_pos[i], n_grid[i],
-					&(n_pos[i - 1][3 * node]), n_grid[i - 1], global_grid_dim,
+					&(n_pos[i - 1][3 * node]), n_grid[i - 1], fft_grid_dim,
 					global_grid_off, &(plan[i].recv_block[6 * j]));
 			permute_ifield(&(plan[i].recv_block[6 * j]), 3,
 					-(plan[i].n_permute));
@@ -326,6 +359,11 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 
 		for (int j = 0; j < 3; j++)
 			plan[i].old_grid[j] = plan[i - 1].new_grid[j];
+#ifndef P3M_INTERLACE
+		/* the output of the real to complex FFT is shorter */
+		if (i == 2)
+			plan[i].old_grid[2] = plan[1].new_grid[2] / 2 + 1;
+#endif
 		if (i == 1) {
 #ifdef P3M_INTERLACE
 			plan[i].element = 2;
@@ -343,6 +381,14 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 				plan[i].recv_size[j] *= 2;
 			}
 		}
+		/* the pipelined communication holds all blocks at once */
+		p3m_int total_send_size = 0, total_recv_size = 0;
+		for (int j = 0; j < plan[i].g_size; j++) {
+			total_send_size += plan[i].send_size[j];
+			total_recv_size += plan[i].recv_size[j];
+		}
+		max_total_comm_size = std::max(max_total_comm_size,
+				std::max(total_send_size, total_recv_size));
 		/* DEBUG */
 		P3M_DEBUG(plan[i].print());
 	}
@@ -358,6 +404,14 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 	for (int i = 1; i < 4; i++)
 		if (2 * plan[i].new_size > max_grid_size)
 			max_grid_size = 2 * plan[i].new_size;
+#ifndef P3M_INTERLACE
+	/* output of the real to complex FFT */
+	if (2 * plan[1].n_ffts * (plan[1].new_grid[2] / 2 + 1) > max_grid_size)
+		max_grid_size = 2 * plan[1].n_ffts * (plan[1].new_grid[2] / 2 + 1);
+
+	/* position of the first row direction in the k-space grid */
+	ks_hermitian_dim = (plan[1].row_dir + plan[3].n_permute) % 3;
+#endif
 
 	P3M_DEBUG(
 			printf("      max_comm_size = %d, max_grid_size = %d\n",
@@ -379,17 +433,13 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 		(*ks_pnum) = 5;
 	}
 
-	/* Factor 2 for complex numbers */
-	send_buf = (p3m_float *) realloc(send_buf,
-			max_comm_size * sizeof(p3m_float));
-	recv_buf = (p3m_float *) realloc(recv_buf,
-			max_comm_size * sizeof(p3m_float));
-
-	if (!recv_buf || !send_buf)
-		throw std::logic_error("Could not allocate FFT data arrays");
+	allocCommBuffers();
 
 	p3m_float* data_buf = _malloc_data();
 	fftw_complex *c_data_buf = reinterpret_cast<fftw_complex*>(data_buf);
+#ifndef P3M_INTERLACE
+	p3m_float* real_buf = _malloc_data();
+#endif
 
 	/* FFTW WISDOM stuff. */
 	/* @todo: Planning shouldn't write to file. */
@@ -399,6 +449,17 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
           if (is_prepared)
             fftw_destroy_plan(plan[i].plan);
           //printf("plan[%d].n_ffts=%d\n",i,plan[i].n_ffts);
+#ifndef P3M_INTERLACE
+          if (i == 1) {
+            /* real input rows of length n, complex output rows of length n/2+1 */
+            p3m_int c_len = plan[1].new_grid[2] / 2 + 1;
+            plan[1].plan =
+              fftw_plan_many_dft_r2c(1, &plan[1].new_grid[2], plan[1].n_ffts, real_buf,
+                                     NULL, 1, plan[1].new_grid[2], c_data_buf, NULL, 1,
+                                     c_len, FFTW_PATIENT);
+            continue;
+          }
+#endif
           plan[i].plan =
             fftw_plan_many_dft(1, &plan[i].new_grid[2], plan[i].n_ffts, c_data_buf,
                                NULL, 1, plan[i].new_grid[2], c_data_buf, NULL, 1,
@@ -411,6 +472,15 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 		back[i].dir = FFTW_BACKWARD;
 		if (is_prepared)
 			fftw_destroy_plan(back[i].plan);
+#ifndef P3M_INTERLACE
+		if (i == 1) {
+			p3m_int c_len = plan[1].new_grid[2] / 2 + 1;
+			back[1].plan =
+			fftw_plan_many_dft_c2r(1, &plan[1].new_grid[2], plan[1].n_ffts, c_data_buf,
+					NULL, 1, c_len, real_buf, NULL, 1,
+					plan[1].new_grid[2], FFTW_PATIENT);
+		} else
+#endif
 		back[i].plan =
 		fftw_plan_many_dft(1, &plan[i].new_grid[2], plan[i].n_ffts, c_data_buf,
 				NULL, 1, plan[i].new_grid[2], c_data_buf, NULL, 1,
@@ -426,6 +496,9 @@ void Parallel3DFFT::prepare(p3m_int *local_grid_dim, p3m_int *local_grid_margin,
 		P3M_DEBUG(printf("      back plan[%d] permute 2 \n", 1));
 	}
 	free_data(data_buf);
+#ifndef P3M_INTERLACE
+	free_data(real_buf);
+#endif
 	for (int i = 0; i < 4; i++) {
 		delete[] n_id[i];
 		delete[] n_pos[i];
@@ -462,18 +535,15 @@ void Parallel3DFFT::forward(p3m_float *data, p3m_float* buffer) {
 	 }
 	 */
 
-	/* complexify the real data array (in is buffer) */
 #ifndef P3M_INTERLACE
-	for (i = 0; i < plan[1].new_size; i++) {
-		data[2 * i] = buffer[i]; /* real value */
-		data[(2 * i) + 1] = 0; /* complex value */
-	}
+	/* perform real to complex FFT (in is buffer, out is data) */
+	fftw_execute_dft_r2c(plan[1].plan, buffer, c_data);
 #else
 	for(i=0;i<(2*plan[1].new_size);i++)
 	data[i] = buffer[i]; /* real value */
-#endif
 	/* perform FFT (in/out is data)*/
 	fftw_execute_dft(plan[1].plan, c_data, c_data);
+#endif
 
 	/* ===== second direction ===== */
 	P3M_DEBUG_LOCAL(printf("    %d: fft_perform_forward: dir 2\n", comm.rank));
@@ -493,54 +563,84 @@ void Parallel3DFFT::forward(p3m_float *data, p3m_float* buffer) {
 }
 
 void Parallel3DFFT::backward(p3m_float *data, p3m_float* buffer) {
-	p3m_int i;
+	this->backward(1, &data, &buffer);
+}
 
-	fftw_complex *c_data = (fftw_complex *) data;
-	fftw_complex *c_buffer = (fftw_complex *) buffer;
+void Parallel3DFFT::backward(p3m_int n, p3m_float **data, p3m_float **buffer) {
+	if (n > comm_batch) {
+		comm_batch = n;
+		allocCommBuffers();
+	}
 
 	/* ===== third direction  ===== */
 	P3M_DEBUG(printf("    %d: backward: dir 3\n", comm.rank));
 
 	/* perform FFT (in is data) */
-	fftw_execute_dft(back[3].plan, c_data, c_data);
+	for (p3m_int k = 0; k < n; k++)
+		fftw_execute_dft(back[3].plan, (fftw_complex *) data[k],
+				(fftw_complex *) data[k]);
 	/* communicate (in is data)*/
-	backward_grid_comm(plan[3], back[3], data, buffer);
+	backward_grid_comm(plan[3], back[3], n, data, buffer);
 
 	/* ===== second direction ===== */
 	P3M_DEBUG_LOCAL(printf("    %d: back: dir 2\n", comm.rank));
 	/* perform FFT (in is buffer) */
-	fftw_execute_dft(back[2].plan, c_buffer, c_buffer);
+	for (p3m_int k = 0; k < n; k++)
+		fftw_execute_dft(back[2].plan, (fftw_complex *) buffer[k],
+				(fftw_complex *) buffer[k]);
 	/* communicate (in is buffer) */
-	backward_grid_comm(plan[2], back[2], buffer, data);
+	backward_grid_comm(plan[2], back[2], n, buffer, data);
 
 	/* ===== first direction  ===== */
 	P3M_DEBUG_LOCAL(printf("    %d: backward: dir 1\n", comm.rank));
-	/* perform FFT (in is data) */
-	fftw_execute_dft(back[1].plan, c_data, c_data);
+	for (p3m_int k = 0; k < n; k++) {
 #ifndef P3M_INTERLACE
-	/* throw away the (hopefully) empty complex component (in is data)*/
-	for (i = 0; i < plan[1].new_size; i++)
-		buffer[i] = data[2 * i]; /* real value */
-#ifdef ADDITIONAL_CHECKS
-	for (i = 0; i < plan[1].new_size; i++)
-		if (data[2 * i + 1] > 1e-5) {
-			printf("    %d: Imaginary value is not zero (i=%d,data=%g)!!!\n",
-					comm.rank, i, data[2 * i + 1]);
-			if (i > 100)
-				exit(-1);
-		}
-#endif
+		/* perform complex to real FFT (in is data, out is buffer) */
+		fftw_execute_dft_c2r(back[1].plan, (fftw_complex *) data[k], buffer[k]);
 #else
-	/* keep imaginary part */
-	for (i=0; i<(2*plan[1].new_size); i++)
-	buffer[i] = data[i];
+		/* perform FFT (in is data) */
+		fftw_execute_dft(back[1].plan, (fftw_complex *) data[k],
+				(fftw_complex *) data[k]);
+		/* keep imaginary part */
+		for (p3m_int i=0; i<(2*plan[1].new_size); i++)
+		buffer[k][i] = data[k][i];
 #endif
+	}
 	/* communicate (in is buffer) */
-	backward_grid_comm(plan[1], back[1], buffer, data);
+	backward_grid_comm(plan[1], back[1], n, buffer, data);
 
 	/* REMARK: Result has to be in data. */
 }
 
+void Parallel3DFFT::setPipelined(bool pipelined) {
+	if (pipelined == this->pipelined)
+		return;
+	this->pipelined = pipelined;
+	if (is_prepared)
+		allocCommBuffers();
+}
+
+bool Parallel3DFFT::isPipelined() const {
+	return pipelined;
+}
+
+void Parallel3DFFT::setSinglePrecisionComm(bool flag) {
+	single_precision_comm = flag;
+}
+
+bool Parallel3DFFT::isSinglePrecisionComm() const {
+	return single_precision_comm;
+}
+
+void Parallel3DFFT::allocCommBuffers() {
+	p3m_int size = comm_batch * (pipelined ? max_total_comm_size : max_comm_size);
+	send_buf = (p3m_float *) realloc(send_buf, size * sizeof(p3m_float));
+	recv_buf = (p3m_float *) realloc(recv_buf, size * sizeof(p3m_float));
+
+	if (size > 0 && (!recv_buf || !send_buf))
+		throw std::logic_error("Could not allocate FFT data arrays");
+}
+
 /** communicate the grid data according to the given forward_plan.
  * \param plan communication plan (see \ref forward_plan).
  * \param in   input grid.
@@ -548,56 +648,184 @@ void Parallel3DFFT::backward(p3m_float *data, p3m_float* buffer) {
  */
 void Parallel3DFFT::forward_grid_comm(forward_plan plan,
         p3m_float *in, p3m_float *out) {
-	for (int i = 0; i < plan.g_size; i++) {
-		plan.pack_function(in, send_buf, &(plan.send_block[6 * i]),
-				&(plan.send_block[6 * i + 3]), plan.old_grid, plan.element);
-
-		if (plan.group[i] == comm.rank)
-		    /* Self communication... */
-		    std::swap(send_buf, recv_buf);
-		else {
-		    MPI_Sendrecv(send_buf, plan.send_size[i], P3M_MPI_FLOAT, plan.group[i],
-		            REQ_FFT_FORW, recv_buf, plan.recv_size[i], P3M_MPI_FLOAT, plan.group[i],
-		            REQ_FFT_FORW, comm.mpicomm, MPI_STATUS_IGNORE);
-		}
-
-		unpack_block(recv_buf, out, &(plan.recv_block[6 * i]),
-		        &(plan.recv_block[6 * i + 3]), plan.new_grid, plan.element);
-	}
+	if (pipelined)
+		pipelined_grid_comm(plan.g_size, plan.group, plan.pack_function,
+				1, &in, plan.send_block, plan.send_size, plan.old_grid,
+				&out, plan.recv_block, plan.recv_size, plan.new_grid,
+				plan.element, REQ_FFT_FORW);
+	else
+		blocking_grid_comm(plan.g_size, plan.group, plan.pack_function,
+				1, &in, plan.send_block, plan.send_size, plan.old_grid,
+				&out, plan.recv_block, plan.recv_size, plan.new_grid,
+				plan.element, REQ_FFT_FORW);
 }
 
 /** communicate the grid data according to the given forward_plan/fft_bakc_plan.
  * \param plan_f communication plan (see \ref forward_plan).
  * \param plan_b additional backward plan (see \ref fft.backward_plan).
- * \param in     input grid.
- * \param out    output grid.
+ * \param n      number of grids.
+ * \param in     input grids.
+ * \param out    output grids.
  */
 void Parallel3DFFT::backward_grid_comm(forward_plan plan_f,
-		backward_plan plan_b, p3m_float *in, p3m_float *out) {
+		backward_plan plan_b, p3m_int n, p3m_float **in, p3m_float **out) {
 
 	/* Back means: Use the send/recieve stuff from the forward plan but
 	 replace the recieve blocks by the send blocks and vice
 	 versa. Attention then also new_grid and old_grid are exchanged */
 
-	for (int i = 0; i < plan_f.g_size; i++) {
-		plan_b.pack_function(in, send_buf, &(plan_f.recv_block[6 * i]),
-				&(plan_f.recv_block[6 * i + 3]), plan_f.new_grid,
-				plan_f.element);
-
-        if (plan_f.group[i] == comm.rank)
-            /* Self communication... */
-            std::swap(send_buf, recv_buf);
-        else {
-            MPI_Sendrecv(send_buf, plan_f.recv_size[i], P3M_MPI_FLOAT, plan_f.group[i],
-                    REQ_FFT_BACK, recv_buf, plan_f.send_size[i], P3M_MPI_FLOAT, plan_f.group[i],
-                    REQ_FFT_BACK, comm.mpicomm, MPI_STATUS_IGNORE);
-        }
+	if (pipelined)
+		pipelined_grid_comm(plan_f.g_size, plan_f.group, plan_b.pack_function,
+				n, in, plan_f.recv_block, plan_f.recv_size, plan_f.new_grid,
+				out, plan_f.send_block, plan_f.send_size, plan_f.old_grid,
+				plan_f.element, REQ_FFT_BACK);
+	else
+		blocking_grid_comm(plan_f.g_size, plan_f.group, plan_b.pack_function,
+				n, in, plan_f.recv_block, plan_f.recv_size, plan_f.new_grid,
+				out, plan_f.send_block, plan_f.send_size, plan_f.old_grid,
+				plan_f.element, REQ_FFT_BACK);
+}
+
+/** Blocking variant of the grid communication. The blocks are
+ * exchanged with one node after the other using MPI_Sendrecv. When
+ * several grids are communicated, the blocks of all grids for a node
+ * are sent in one message.
+ * \param g_size        number of nodes in the communication group.
+ * \param group         nodes in the communication group.
+ * \param pack_function packing function for the send blocks.
+ * \param n             number of grids.
+ * \param in            input grids.
+ * \param in_block      send block specifications (start[3], size[3]).
+ * \param in_size       send block communication sizes (of one grid).
+ * \param in_dim        size of the input grids.
+ * \param out           output grids.
+ * \param out_block     recv block specifications (start[3], size[3]).
+ * \param out_size      recv block communication sizes (of one grid).
+ * \param out_dim       size of the output grids.
+ * \param element       size of a grid element.
+ * \param tag           MPI tag of the communication.
+ */
+void Parallel3DFFT::blocking_grid_comm(p3m_int g_size, p3m_int *group,
+		void (*pack_function)(fcs_float*, fcs_float*, int*, int*, int*, int),
+		p3m_int n, p3m_float **in, p3m_int *in_block, p3m_int *in_size, p3m_int *in_dim,
+		p3m_float **out, p3m_int *out_block, p3m_int *out_size, p3m_int *out_dim,
+		p3m_int element, int tag) {
+	for (int i = 0; i < g_size; i++) {
+		for (int k = 0; k < n; k++)
+			pack_function(in[k], send_buf + k * in_size[i], &(in_block[6 * i]),
+					&(in_block[6 * i + 3]), in_dim, element);
+
+		if (group[i] == comm.rank)
+			/* Self communication... */
+			std::swap(send_buf, recv_buf);
+		else if (single_precision_comm) {
+			pack_single(send_buf, n * in_size[i]);
+			MPI_Sendrecv(send_buf, n * in_size[i], MPI_FLOAT, group[i],
+					tag, recv_buf, n * out_size[i], MPI_FLOAT, group[i],
+					tag, comm.mpicomm, MPI_STATUS_IGNORE);
+			fcs_timing_count(FCS_COUNTER_COMM_BYTES, n * out_size[i] * sizeof(float));
+			unpack_single(recv_buf, n * out_size[i]);
+		} else {
+			MPI_Sendrecv(send_buf, n * in_size[i], P3M_MPI_FLOAT, group[i],
+					tag, recv_buf, n * out_size[i], P3M_MPI_FLOAT, group[i],
+					tag, comm.mpicomm, MPI_STATUS_IGNORE);
+			fcs_timing_count(FCS_COUNTER_COMM_BYTES, n * out_size[i] * sizeof(p3m_float));
+		}
 
-        unpack_block(recv_buf, out, &(plan_f.send_block[6 * i]),
-                &(plan_f.send_block[6 * i + 3]), plan_f.old_grid, plan_f.element);
+		for (int k = 0; k < n; k++)
+			unpack_block(recv_buf + k * out_size[i], out[k], &(out_block[6 * i]),
+					&(out_block[6 * i + 3]), out_dim, element);
 	}
 }
 
+/** Non-blocking variant of the grid communication.  All receives are
+ * posted first. Then the send blocks are packed and sent one after the
+ * other, so that packing overlaps with the messages already in flight,
+ * and the receive blocks are unpacked in the order in which they
+ * arrive. When several grids are communicated, the blocks of all grids
+ * for a node are sent in one message.
+ * \param g_size        number of nodes in the communication group.
+ * \param group         nodes in the communication group.
+ * \param pack_function packing function for the send blocks.
+ * \param n             number of grids.
+ * \param in            input grids.
+ * \param in_block      send block specifications (start[3], size[3]).
+ * \param in_size       send block communication sizes (of one grid).
+ * \param in_dim        size of the input grids.
+ * \param out           output grids.
+ * \param out_block     recv block specifications (start[3], size[3]).
+ * \param out_size      recv block communication sizes (of one grid).
+ * \param out_dim       size of the output grids.
+ * \param element       size of a grid element.
+ * \param tag           MPI tag of the communication.
+ */
+void Parallel3DFFT::pipelined_grid_comm(p3m_int g_size, p3m_int *group,
+		void (*pack_function)(fcs_float*, fcs_float*, int*, int*, int*, int),
+		p3m_int n, p3m_float **in, p3m_int *in_block, p3m_int *in_size, p3m_int *in_dim,
+		p3m_float **out, p3m_int *out_block, p3m_int *out_size, p3m_int *out_dim,
+		p3m_int element, int tag) {
+	p3m_int self = -1;
+	p3m_int self_offset = 0;
+
+	p3m_int offset = 0;
+	for (int i = 0; i < g_size; i++) {
+		recv_offset[i] = offset;
+		if (group[i] == comm.rank) {
+			self = i;
+			recv_req[i] = MPI_REQUEST_NULL;
+		} else if (single_precision_comm) {
+			MPI_Irecv(recv_buf + offset, n * out_size[i], MPI_FLOAT, group[i],
+					tag, comm.mpicomm, &recv_req[i]);
+			fcs_timing_count(FCS_COUNTER_COMM_BYTES, n * out_size[i] * sizeof(float));
+		} else {
+			MPI_Irecv(recv_buf + offset, n * out_size[i], P3M_MPI_FLOAT, group[i],
+					tag, comm.mpicomm, &recv_req[i]);
+			fcs_timing_count(FCS_COUNTER_COMM_BYTES, n * out_size[i] * sizeof(p3m_float));
+		}
+		offset += n * out_size[i];
+	}
+
+	offset = 0;
+	for (int i = 0; i < g_size; i++) {
+		for (int k = 0; k < n; k++)
+			pack_function(in[k], send_buf + offset + k * in_size[i],
+					&(in_block[6 * i]), &(in_block[6 * i + 3]), in_dim, element);
+		if (i == self) {
+			/* Self communication... */
+			self_offset = offset;
+			send_req[i] = MPI_REQUEST_NULL;
+		} else if (single_precision_comm) {
+			pack_single(send_buf + offset, n * in_size[i]);
+			MPI_Isend(send_buf + offset, n * in_size[i], MPI_FLOAT, group[i],
+					tag, comm.mpicomm, &send_req[i]);
+		} else
+			MPI_Isend(send_buf + offset, n * in_size[i], P3M_MPI_FLOAT, group[i],
+					tag, comm.mpicomm, &send_req[i]);
+		offset += n * in_size[i];
+	}
+
+	if (self >= 0)
+		for (int k = 0; k < n; k++)
+			unpack_block(send_buf + self_offset + k * out_size[self], out[k],
+					&(out_block[6 * self]), &(out_block[6 * self + 3]), out_dim,
+					element);
+
+	while (true) {
+		int i;
+		MPI_Waitany(g_size, recv_req, &i, MPI_STATUS_IGNORE);
+		if (i == MPI_UNDEFINED)
+			break;
+		if (single_precision_comm)
+			unpack_single(recv_buf + recv_offset[i], n * out_size[i]);
+		for (int k = 0; k < n; k++)
+			unpack_block(recv_buf + recv_offset[i] + k * out_size[i], out[k],
+					&(out_block[6 * i]), &(out_block[6 * i + 3]), out_dim,
+					element);
+	}
+
+	MPI_Waitall(g_size, send_req, MPI_STATUSES_IGNORE);
+}
+
 /** This ugly function does the bookkepping which nodes have to
  *  communicate to each other, when you change the node grid.
  *  Changing the domain decomposition requieres communication. This
@@ -979,6 +1207,27 @@ void Parallel3DFFT::unpack_block(p3m_float *in, p3m_float *out,
 	}
 }
 
+void Parallel3DFFT::pack_single(p3m_float *buf, p3m_int size) {
+	char *single_buf = reinterpret_cast<char *>(buf);
+	/* Front to back: the float i overwrites parts of the value i/2,
+	 * which was already converted. */
+	for (p3m_int i = 0; i < size; i++) {
+		float value = static_cast<float>(buf[i]);
+		memcpy(single_buf + i * sizeof(float), &value, sizeof(float));
+	}
+}
+
+void Parallel3DFFT::unpack_single(p3m_float *buf, p3m_int size) {
+	const char *single_buf = reinterpret_cast<const char *>(buf);
+	/* Back to front: the value i overwrites the floats 2i and 2i+1,
+	 * which were already converted. */
+	for (p3m_int i = size - 1; i >= 0; i--) {
+		float value;
+		memcpy(&value, single_buf + i * sizeof(float), sizeof(float));
+		buf[i] = value;
+	}
+}
+
 void Parallel3DFFT::add_block(p3m_float *in, p3m_float *out,
         int start[3], int size[3], int dim[3]) {
 
@@ -1004,6 +1253,10 @@ p3m_int Parallel3DFFT::getKSSize() const {
     return plan[3].new_size;
 }
 
+p3m_int Parallel3DFFT::getKSHermitianDim() const {
+    return ks_hermitian_dim;
+}
+
 
 void Parallel3DFFT::getKSExtent(const p3m_int*& offset,
         const p3m_int*& size) const {
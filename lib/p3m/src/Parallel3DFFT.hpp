@@ -29,9 +29,12 @@
  *  1D-FFT. After performing the FFT on theat direction the data is
  *  redistributed.
  *
- *  For simplicity at the moment I have implemented a full complex to
- *  complex FFT (even though a real to complex FFT would be
- *  sufficient)
+ *  Unless interlacing is used (where the two real grids are packed
+ *  into one complex grid), the first 1D FFT is a real to complex FFT
+ *  and only the non-redundant half of the Hermitian symmetric
+ *  spectrum is kept in this direction. The following
+ *  redistributions, FFTs and all k-space operations work on this
+ *  reduced grid (see \ref getKSHermitianDim).
  *
  */
 #ifndef _P3M_FFT_HPP
@@ -126,6 +129,14 @@ private:
 
   /** Whether FFT is initialized or not. */
   bool is_prepared;
+
+  /** Whether the grid communication uses non-blocking, pipelined
+   * exchanges instead of blocking pairwise exchanges. */
+  bool pipelined;
+
+  /** Whether the grid communication sends single precision values
+   * (see \ref pack_single). */
+  bool single_precision_comm;
   
   /** Information about the three one dimensional FFTs and how the nodes
    *  have to communicate in between.
@@ -139,14 +150,29 @@ private:
   
   /** Maximal size of the communication buffers. */
   p3m_int max_comm_size;
+  /** Maximal size of the communication buffers in pipelined mode,
+   * where all blocks of a communication group are held at once. */
+  p3m_int max_total_comm_size;
+  /** Number of grids the communication buffers can hold (see the
+   * batched \ref backward). */
+  p3m_int comm_batch;
   
   /** Maximal local grid size. */
   p3m_int max_grid_size;
+
+  /** Dimension of the k-space grid in which only the non-redundant
+   * half of the Hermitian symmetric spectrum is stored (-1 if the full
+   * complex spectrum is stored). */
+  p3m_int ks_hermitian_dim;
   
   /** send buffer. */
   p3m_float *send_buf;
   /** receive buffer. */
   p3m_float *recv_buf;
+  /** requests of the pipelined communication. */
+  MPI_Request *send_req, *recv_req;
+  /** offsets of the receive blocks in the receive buffer. */
+  p3m_int *recv_offset;
 
 public:
   /***************************************************/
@@ -175,12 +201,34 @@ public:
     /** Perform the backward 3D FFT. buffer has to be of the same size as data
      * and will be used internally. */
 	void backward(p3m_float *data, p3m_float* buffer);
+    /** Perform the backward 3D FFTs of n grids at once. The grids
+     * share the redistributions, i.e. each redistribution exchanges
+     * one message per node that holds the blocks of all n grids.
+     * buffer[i] has to be of the same size as data[i]. */
+	void backward(p3m_int n, p3m_float **data, p3m_float **buffer);
+
+	/** Switch between blocking and non-blocking, pipelined grid
+	 * communication. Can be changed after prepare(). */
+	void setPipelined(bool pipelined);
+	bool isPipelined() const;
+
+	/** Switch between grid communication in p3m_float and in single
+	 * precision. The 1D FFTs always work in p3m_float, only the values
+	 * sent to other nodes are rounded to single precision. Can be
+	 * changed after prepare(). */
+	void setSinglePrecisionComm(bool flag);
+	bool isSinglePrecisionComm() const;
 
 	p3m_float *malloc_data();
 	void free_data(p3m_float* data);
 
 	int getKSSize() const;
 	void getKSExtent(const p3m_int*& offset, const p3m_int*& size) const;
+	/** Dimension of the k-space grid that only holds the indices
+	 * 0..grid/2 of the Hermitian symmetric spectrum of a real grid, or
+	 * -1 if the full spectrum is stored. Sums over k-space have to count
+	 * all other indices in this dimension twice. */
+	p3m_int getKSHermitianDim() const;
 
 	/** pack a block (size[3] starting at start[3]) of an input 3d-grid
 	 *  with dimension dim[3] into an output 3d-block with dimension size[3].
@@ -219,15 +267,45 @@ public:
 	        p3m_int start[3], p3m_int size[3], p3m_int dim[3],
 	        p3m_int element);
 
+	/** convert size values of buf to single precision in place, i.e.
+	 *  the values are afterwards stored as float in the first
+	 *  size*sizeof(float) bytes of buf.
+	 *
+	 *  \param buf  pointer to the values.
+	 *  \param size number of values.
+	 */
+	static void
+	pack_single(p3m_float *buf, p3m_int size);
+
+	/** convert size single precision values (see \ref pack_single) of
+	 *  buf back to p3m_float in place.
+	 *
+	 *  \param buf  pointer to the values.
+	 *  \param size number of values.
+	 */
+	static void
+	unpack_single(p3m_float *buf, p3m_int size);
+
 	static void
 	add_block(p3m_float *in, p3m_float *out,
 	        int start[3], int size[3], int dim[3]);
 
 private:
     p3m_float *_malloc_data();
+	void allocCommBuffers();
 	void forward_grid_comm(forward_plan plan, p3m_float *in, p3m_float *out);
 	void backward_grid_comm(forward_plan plan_f, backward_plan plan_b,
-			p3m_float *in, p3m_float *out);
+			p3m_int n, p3m_float **in, p3m_float **out);
+	void blocking_grid_comm(p3m_int g_size, p3m_int *group,
+			void (*pack_function)(fcs_float*, fcs_float*, int*, int*, int*, int),
+			p3m_int n, p3m_float **in, p3m_int *in_block, p3m_int *in_size, p3m_int *in_dim,
+			p3m_float **out, p3m_int *out_block, p3m_int *out_size, p3m_int *out_dim,
+			p3m_int element, int tag);
+	void pipelined_grid_comm(p3m_int g_size, p3m_int *group,
+			void (*pack_function)(fcs_float*, fcs_float*, int*, int*, int*, int),
+			p3m_int n, p3m_float **in, p3m_int *in_block, p3m_int *in_size, p3m_int *in_dim,
+			p3m_float **out, p3m_int *out_block, p3m_int *out_size, p3m_int *out_dim,
+			p3m_int element, int tag);
 
 	void print_global_grid(Communication &comm,
 	        Parallel3DFFT::forward_plan plan, p3m_float *data, p3m_int element,
@@ -23,6 +23,7 @@
 #include "FarSolver.hpp"
 #include "utils.hpp"
 #include "FCSCommon.h"
+#include "common/fcs-common/FCSTuningDB.h"
 #include "common/near/near.h"
 #include <stdexcept>
 
@@ -52,6 +53,17 @@ Solver::Solver(MPI_Comm mpicomm) : comm(mpicomm), errorEstimate(NULL) {
     /* P3M PARAMETERS */
     skin = 0.0;
     tolerance_field = P3M_DEFAULT_TOLERANCE_FIELD;
+    num_threads = 0;
+    pipelined_fft = 0;
+    batched_fft = 0;
+    mixed_precision = 0;
+    max_particle_move = -1.0;
+    resort = 0;
+    gridsort_resort = FCS_GRIDSORT_RESORT_NULL;
+    local_num_particles = 0;
+    gridsort_cache = FCS_GRIDSORT_CACHE_NULL;
+    verlet_skin = 0.0;
+    fcs_near_verlet_create(&near_verlet, verlet_skin);
 
     /* tunable */
     r_cut = 0.0;
@@ -68,6 +80,8 @@ Solver::Solver(MPI_Comm mpicomm) : comm(mpicomm), errorEstimate(NULL) {
     tune_grid = true;
     tune_cao = true;
 
+    tuning_db_retune = false;
+
     /* Which components to compute? */
     require_total_energy = false;
     near_field_flag = false;
@@ -86,6 +100,9 @@ Solver::Solver(MPI_Comm mpicomm) : comm(mpicomm), errorEstimate(NULL) {
 Solver::~Solver() {
     if (errorEstimate != NULL) delete errorEstimate;
     if (farSolver != NULL) delete farSolver;
+    fcs_gridsort_resort_destroy(&gridsort_resort);
+    fcs_gridsort_release_cache(&gridsort_cache);
+    fcs_near_verlet_destroy(&near_verlet);
 }
 
 void Solver::prepare() {
@@ -98,6 +115,10 @@ void Solver::prepare() {
         comm.prepare(box_length);
         farSolver = new FarSolver(comm, box_length, r_cut, alpha, grid, cao, box_vectors, volume, isTriclinic);
     }        
+    farSolver->setNumThreads(num_threads);
+    farSolver->setPipelinedFFT(pipelined_fft);
+    farSolver->setBatchedFFT(batched_fft);
+    farSolver->setMixedPrecision(mixed_precision);
 }
 
 /* callback function for near field computations */
@@ -143,12 +164,62 @@ compute_near(const void *param, p3m_float dist, p3m_float *field, p3m_float *pot
 
 }
 
-/* callback function for performing a whole loop of near field computations (using compute_near) */
-FCS_NEAR_LOOP_FP(compute_near_loop, compute_near);
+/* near field computations for a whole batch of distances, the
+   parameters are read and the choice between field and potential is
+   made once outside of the loop, so that the loop body (erfc part and
+   exp) can be vectorized by the compiler */
+template <bool with_field, bool with_potential>
+static inline void
+compute_near_loop(const near_params_t &params, fcs_int n, const p3m_float *dist,
+        p3m_float *field, p3m_float *potential)
+{
+    const p3m_float alpha = params.alpha;
+    const p3m_float potentialOffset = params.potentialOffset;
+    const p3m_float field_factor = 2.0*alpha*0.56418958354775627928034964498;
+
+    for (fcs_int k = 0; k < n; k++) {
+        const p3m_float d = dist[k];
+        const p3m_float adist = alpha * d;
+        const p3m_float exp_part = exp(-adist*adist);
+
+#ifdef P3M_USE_ERFC_APPROXIMATION
+        /* same approximation as in compute_near */
+        const p3m_float t = 1.0 / (1.0 + 0.3275911 * adist);
+        const p3m_float erfc_part_ri = exp_part *
+                (t * (0.254829592 +
+                        t * (-0.284496736 +
+                                t * (1.421413741 +
+                                        t * (-1.453152027 +
+                                                t * 1.061405429)))))
+                                                / d;
+#else
+        const p3m_float erfc_part_ri = (1.0 - erf(adist)) / d;
+#endif
+
+        if (with_potential) potential[k] = erfc_part_ri - potentialOffset;
+        if (with_field) field[k] = -(erfc_part_ri + field_factor*exp_part) / d;
+    }
+}
+
+/* callback function for performing near field computations for a
+   whole batch of distances (same results as compute_near) */
+static void
+compute_near_batch(const void *param, fcs_int n, const p3m_float *dist,
+        p3m_float *field, p3m_float *potential)
+{
+    const near_params_t &params = *(static_cast<const near_params_t*>(param));
+
+    if (field != NULL && potential != NULL)
+        compute_near_loop<true, true>(params, n, dist, field, potential);
+    else if (field != NULL)
+        compute_near_loop<true, false>(params, n, dist, field, potential);
+    else if (potential != NULL)
+        compute_near_loop<false, true>(params, n, dist, field, potential);
+}
 
 /* domain decomposition */
 void Solver::decompose(fcs_gridsort_t *gridsort,
-        p3m_int _num_particles,
+        p3m_int _num_particles, p3m_int _max_num_particles,
         p3m_float *_positions, p3m_float *_charges,
         p3m_int *num_real_particles,
         p3m_float **positions, p3m_float **charges,
@@ -163,13 +234,21 @@ void Solver::decompose(fcs_gridsort_t *gridsort,
     fcs_gridsort_create(gridsort);
 
     fcs_gridsort_set_system(gridsort, box_base, box_vectors[0], box_vectors[1], box_vectors[2], NULL);
-    fcs_gridsort_set_particles(gridsort, _num_particles, _num_particles,
+    fcs_gridsort_set_particles(gridsort, _num_particles, _max_num_particles,
             _positions, _charges);
+    /* When the particles moved only a little since the last run, only
+     * the neighboring processes have to be involved in the sort. */
+    fcs_gridsort_set_max_particle_move(gridsort, max_particle_move);
+    fcs_gridsort_set_cache(gridsort, &gridsort_cache);
+    /* A Verlet list survives the resort only if the order of the
+     * particles is kept. */
+    fcs_gridsort_set_stable_ghosts(gridsort, (near_field_flag && verlet_skin > 0.0));
 
     P3M_DEBUG(printf( "  calling fcs_gridsort_sort_forward()...\n"));
     /* @todo: Set skin to r_cut only, when near field is wanted! */
+    /* The ghosts of a Verlet list also have to cover its skin. */
     fcs_gridsort_sort_forward(gridsort,
-            (near_field_flag ? r_cut : 0.0),
+            (near_field_flag ? r_cut + (verlet_skin > 0.0 ? verlet_skin : 0.0) : 0.0),
             comm.mpicomm);
     P3M_DEBUG(printf( "  returning from fcs_gridsort_sort_forward().\n"));
     fcs_gridsort_separate_ghosts(gridsort);
@@ -220,7 +299,8 @@ void Solver::decompose(fcs_gridsort_t *gridsort,
     }
  
 void Solver::run(
-        p3m_int _num_particles, p3m_float *_positions, p3m_float *_charges,
+        p3m_int _num_particles, p3m_int _max_num_particles,
+        p3m_float *_positions, p3m_float *_charges,
         p3m_float *_fields, p3m_float *_potentials) {
     P3M_INFO(printf( "P3M::Solver::run() started...\n"));
     if (farSolver == NULL)
@@ -250,7 +330,7 @@ void Solver::run(
     fcs_gridsort_index_t *indices, *ghost_indices;
     fcs_gridsort_t gridsort;
     this->decompose(&gridsort,
-            _num_particles, _positions, _charges,
+            _num_particles, _max_num_particles, _positions, _charges,
             &num_real_particles,
             &positions, &charges, &indices,
             &num_ghost_particles,
@@ -297,7 +377,16 @@ void Solver::run(
 
         fcs_near_create(&near);
         /*  fcs_near_set_field_potential(&near, compute_near);*/
-        fcs_near_set_loop(&near, compute_near_loop);
+        fcs_near_set_field_potential_batch(&near, compute_near_batch);
+        fcs_near_set_num_threads(&near, num_threads);
+        if (verlet_skin > 0.0) {
+            /* a new skin requires a new Verlet list */
+            if (near_verlet.skin != verlet_skin) {
+                fcs_near_verlet_destroy(&near_verlet);
+                fcs_near_verlet_create(&near_verlet, verlet_skin);
+            }
+            fcs_near_set_verlet(&near, &near_verlet);
+        }
 
         p3m_float box_base[3] = {0.0, 0.0, 0.0 };
         fcs_near_set_system(&near, box_base, box_vectors[0], box_vectors[1], box_vectors[2], NULL);
@@ -324,10 +413,25 @@ void Solver::run(
     startTimer(COMP);
     /* sort particles back */
     fcs_gridsort_set_sorted_results(&gridsort, num_real_particles, fields, potentials);
-    fcs_gridsort_set_results(&gridsort, _num_particles, _fields, _potentials);
-    P3M_DEBUG(printf( "  calling fcs_gridsort_sort_backward()...\n"));
-    fcs_gridsort_sort_backward(&gridsort, comm.mpicomm);
-    P3M_DEBUG(printf( "  returning from fcs_gridsort_sort_backward().\n"));
+    fcs_gridsort_set_results(&gridsort, _max_num_particles, _fields, _potentials);
+
+    /* When resorting is enabled, the results stay in the decomposition
+     * of the solver and the resort plan is kept for the user data. */
+    p3m_int do_resort = 0;
+    if (resort)
+        do_resort = fcs_gridsort_prepare_resort(&gridsort, comm.mpicomm);
+
+    if (!do_resort) {
+        P3M_DEBUG(printf( "  calling fcs_gridsort_sort_backward()...\n"));
+        fcs_gridsort_sort_backward(&gridsort, comm.mpicomm);
+        P3M_DEBUG(printf( "  returning from fcs_gridsort_sort_backward().\n"));
+    }
+
+    fcs_gridsort_resort_destroy(&gridsort_resort);
+    if (do_resort)
+        fcs_gridsort_resort_create(&gridsort_resort, &gridsort, comm.mpicomm);
+
+    local_num_particles = _num_particles;
 
     fcs_gridsort_free(&gridsort);
     fcs_gridsort_destroy(&gridsort);
@@ -443,6 +547,9 @@ Solver::tune(p3m_int num_particles, p3m_float *positions, p3m_float *charges) {
     /* Prepare the communicator before tuning */
     comm.prepare(box_l);
 
+    /* The error estimate includes the rounding error of the mixed precision mode */
+    errorEstimate->setMixedPrecision(mixed_precision);
+
     /* Count the charges */
     p3m_float sum_q2_before = sum_q2;
     this->countCharges(num_particles, charges);
@@ -472,6 +579,19 @@ Solver::tune(p3m_int num_particles, p3m_float *positions, p3m_float *charges) {
 
         P3M_INFO(printf( "  Retuning is required.\n"));
 
+        /* Skip the tuning if the database contains the parameters */
+        char signature[FCS_TUNING_DB_SIGNATURE_LENGTH];
+        TuneParameters best;
+
+        this->tuningDBSignature(signature);
+
+        if (this->tuningDBLookup(signature, best)) {
+            P3M_INFO(printf( "    Found the parameters in the tuning database.\n"));
+            P3M_INFO(printf("    Finished tuning.\n"));
+            this->tuneBroadcastFinish(best);
+            return;
+        }
+
         if (!tune_r_cut) {
             P3M_INFO(printf( "    r_cut=" FFLOAT " (fixed)\n", r_cut));
 
@@ -484,10 +604,8 @@ Solver::tune(p3m_int num_particles, p3m_float *positions, p3m_float *charges) {
             p.r_cut = r_cut;
             TuneParameterList params_to_try =
                     this->tuneBroadcastTuneFar(p);
-            TuneParameters best =
-                    this->timeParams(num_particles, positions, charges,
-                            params_to_try);
-            this->tuneBroadcastFinish(best);
+            best = this->timeParams(num_particles, positions, charges,
+                    params_to_try);
         } else {
             TuneParameters p;
             p.cao = cao;
@@ -553,8 +671,11 @@ Solver::tune(p3m_int num_particles, p3m_float *positions, p3m_float *charges) {
             P3M_INFO(printf("    rel_timing_diff=" FFLOAT "\n", rel_timing_diff));
             P3M_INFO(printf("    Finished tuning.\n"));
 
-            this->tuneBroadcastFinish(best2);
+            best = best2;
         }
+
+        this->tuneBroadcastFinish(best);
+        this->tuningDBStore(signature, best);
     }
 }
 
@@ -856,10 +977,24 @@ const double* Solver::measureTimings(p3m_int num_particles,
     Solver::TimingType require_timings_before = this->getRequireTimings();
     this->setRequireTimings(FULL);
 
-    this->run(num_particles, positions, charges, fields, potentials);
+    /* the test run neither changes the particle decomposition nor
+     * knows how far the particles moved, and it must not measure or
+     * replace the Verlet list of the actual runs */
+    p3m_int resort_before = resort;
+    p3m_float max_particle_move_before = max_particle_move;
+    p3m_float verlet_skin_before = verlet_skin;
+    resort = 0;
+    max_particle_move = -1.0;
+    verlet_skin = 0.0;
+
+    this->run(num_particles, num_particles,
+            positions, charges, fields, potentials);
 
-    /* restore require_timings */
+    /* restore require_timings, resort, max_particle_move and verlet_skin */
     this->setRequireTimings(require_timings_before);
+    resort = resort_before;
+    max_particle_move = max_particle_move_before;
+    verlet_skin = verlet_skin_before;
 
     delete[] fields;
     delete[] potentials;
@@ -988,6 +1123,62 @@ void Solver::tuneBroadcastFinish(TuneParameters p) {
     this->prepare();
 }
 
+void Solver::tuningDBSignature(char *signature) {
+    const fcs_int periodicity[3] = { 1, 1, 1 };
+    char params[256];
+    int n = 0;
+
+    params[0] = '\0';
+
+    /* the parameters that were set by the user are part of the signature */
+    if (!tune_r_cut)
+        n += snprintf(params + n, sizeof(params) - n, "r_cut=%.9e,", (double) r_cut);
+    if (!tune_alpha)
+        n += snprintf(params + n, sizeof(params) - n, "alpha=%.9e,", (double) alpha);
+    if (!tune_grid)
+        n += snprintf(params + n, sizeof(params) - n, "grid=%d:%d:%d,", (int) grid[0], (int) grid[1], (int) grid[2]);
+    if (!tune_cao)
+        n += snprintf(params + n, sizeof(params) - n, "cao=%d,", (int) cao);
+    if (mixed_precision)
+        n += snprintf(params + n, sizeof(params) - n, "mixed_precision=1,");
+    if (n > 0) params[n - 1] = '\0';
+
+    fcs_tuning_db_signature(signature, "p3m", box_vectors[0], box_vectors[1], box_vectors[2],
+            periodicity, sum_qpart, sum_q2, FCS_TOLERANCE_TYPE_FIELD, tolerance_field,
+            comm.size, params);
+}
+
+bool Solver::tuningDBLookup(const char *signature, TuneParameters &p) {
+    fcs_float values[6];
+
+    if (tuning_db.empty() || tuning_db_retune)
+        return false;
+
+    if (!fcs_tuning_db_lookup(tuning_db.c_str(), signature, values, 6))
+        return false;
+
+    p.r_cut = values[0];
+    p.alpha = values[1];
+    p.grid[0] = static_cast<p3m_int>(values[2]);
+    p.grid[1] = static_cast<p3m_int>(values[3]);
+    p.grid[2] = static_cast<p3m_int>(values[4]);
+    p.cao = static_cast<p3m_int>(values[5]);
+
+    return true;
+}
+
+void Solver::tuningDBStore(const char *signature, TuneParameters p) {
+    fcs_float values[6] = { p.r_cut, p.alpha,
+            static_cast<fcs_float>(p.grid[0]), static_cast<fcs_float>(p.grid[1]),
+            static_cast<fcs_float>(p.grid[2]), static_cast<fcs_float>(p.cao) };
+
+    if (tuning_db.empty())
+        return;
+
+    if (!fcs_tuning_db_store(tuning_db.c_str(), signature, values, 6))
+        P3M_INFO(printf( "    Could not write the tuning database %s.\n", tuning_db.c_str()));
+}
+
 void Solver::tuneBroadcastNoTune() {
     tuneBroadcastCommand(comm, CMD_NO_TUNE);
     needs_retune = false;
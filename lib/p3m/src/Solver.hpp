@@ -28,7 +28,9 @@
 #include "FarSolver.hpp"
 #include "CAF.hpp"
 #include "common/gridsort/gridsort.h"
+#include "common/near/near.h"
 #include <list>
+#include <string>
 
 
 namespace P3M {
@@ -55,7 +57,8 @@ namespace P3M {
 
     void tune(p3m_int num_particles, p3m_float *positions, p3m_float *charges);
 
-    void run(p3m_int num_particles, p3m_float *positions, p3m_float *charges,
+    void run(p3m_int num_particles, p3m_int max_num_particles,
+             p3m_float *positions, p3m_float *charges,
              p3m_float *fields, p3m_float *potentials);
     
     void setRequireTotalEnergy(bool flag = true);
@@ -99,6 +102,24 @@ namespace P3M {
     bool near_field_flag;
     /** flag that determines if the Gaussian potentials are shifted */
     bool shiftGaussians;
+    /** number of OpenMP threads in the far field (<= 0: OpenMP default) */
+    p3m_int num_threads;
+    /** whether the 3D-FFT uses non-blocking, pipelined communication */
+    p3m_int pipelined_fft;
+    /** whether the backward 3D-FFTs of potential and fields are batched */
+    p3m_int batched_fft;
+    /** whether grid values are communicated in single precision */
+    p3m_int mixed_precision;
+    /** maximal distance a particle moved since the last run (< 0: unknown) */
+    p3m_float max_particle_move;
+    /** whether the particles are kept in the decomposition of the solver */
+    p3m_int resort;
+    /** resort plan of the last run */
+    fcs_gridsort_resort_t gridsort_resort;
+    /** number of local particles in the last run */
+    p3m_int local_num_particles;
+    /** skin of the Verlet list of the near field (<= 0: no Verlet list) */
+    p3m_float verlet_skin;
     
     /* TUNABLE PARAMETERS */
     /** cutoff radius */
@@ -120,6 +141,10 @@ namespace P3M {
     bool tune_grid;
     /** Whether or not the charge assignment order is to be automatically tuned. */
     bool tune_cao;
+    /** File of the tuning database (empty: no database). */
+    std::string tuning_db;
+    /** Whether existing entries of the tuning database are ignored. */
+    bool tuning_db_retune;
 
 private:
     /****************************************************
@@ -133,6 +158,12 @@ private:
     TimingType require_timings;
     double timings[NUM_TIMINGS];
 
+    /** Domain bounds of the last particle sort, reused by the next sort. */
+    fcs_gridsort_cache_t gridsort_cache;
+
+    /** Verlet list of the near field, reused by the next runs. */
+    fcs_near_verlet_t near_verlet;
+
     // submethods of run()
     
     /* conversion of cartesian positions to triclinic positions */
@@ -143,7 +174,7 @@ private:
     /* domain decomposition */
     void
     decompose(fcs_gridsort_t *gridsort,
-            p3m_int _num_particles,
+            p3m_int _num_particles, p3m_int _max_num_particles,
             p3m_float *_positions, p3m_float *_charges,
             p3m_int *num_real_particles,
             p3m_float **positions, p3m_float **charges,
@@ -171,6 +202,11 @@ private:
 
     void countCharges(p3m_int num_particles, p3m_float *charges);
 
+    /* tuning database */
+    void tuningDBSignature(char *signature);
+    bool tuningDBLookup(const char *signature, TuneParameters &p);
+    void tuningDBStore(const char *signature, TuneParameters p);
+
     // tuning master functions
     void tuneBroadcastSendParams(TuneParameters p);
     void tuneBroadcastFail();
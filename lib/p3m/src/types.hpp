@@ -66,6 +66,13 @@ const p3m_float P3M_DEFAULT_TOLERANCE_FIELD = 1.0e-3;
 const p3m_int P3M_MAX_GRID_DIFF = 10;
 /** This value for epsilon indicates metallic boundary conditions. */
 const p3m_float P3M_EPSILON_METALLIC = 0.0;
+/** Unit roundoff of single precision values, i.e. of the grid values
+ that are communicated in the mixed precision mode. */
+const p3m_float P3M_SINGLE_ROUNDOFF = 5.96e-8;
+/** Number of times a grid value is rounded to single precision in the
+ mixed precision mode (halo gather, three forward and three backward
+ FFT redistributions, halo spread). */
+const p3m_int P3M_SINGLE_ROUNDINGS = 8;
 /** precision limit for the r_cut zero */
 const p3m_float P3M_RCUT_PREC = 1.0e-3;
 /** Whether to use the approximation of Abramowitz/Stegun
@@ -135,3 +135,20 @@ subroutine pepc_scafacos_run(nlocal, ntotal, positions, charges, &
   deallocate(particles)
 
 end subroutine pepc_scafacos_run
+
+subroutine pepc_scafacos_timings(timings) bind(c)
+
+  use iso_c_binding
+  use module_timings
+
+  implicit none
+
+  !!! sort, ghosts, solve and back_sort phase of the last run
+  real(kind = c_double), intent(out) :: timings(4)
+
+  timings(1) = timer_read(t_domains)
+  timings(2) = timer_read(t_exchange_branches) + timer_read(t_global)
+  timings(3) = timer_read(t_local) + timer_read(t_walk)
+  timings(4) = timer_read(t_restore)
+
+end subroutine pepc_scafacos_timings
@@ -0,0 +1,45 @@
+/*
+ *    vmg - a versatile multigrid solver
+ *    Copyright (C) 2012 Institute for Numerical Simulation, University of Bonn
+ *
+ *  vmg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  vmg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   phase_timer.hpp
+ *
+ * @brief  Report the phases of a run to the timing record of the
+ *         ScaFaCoS library (sort, spread, solve, ...). Without the
+ *         ScaFaCoS library, the macros do nothing.
+ *
+ */
+
+#ifndef PHASE_TIMER_HPP_
+#define PHASE_TIMER_HPP_
+
+#ifdef HAVE_FCS_TIMING
+
+#include "common/fcs-common/FCSTiming.h"
+
+#define VMG_PHASE_START(_t_)     ((_t_) = fcs_timing_start())
+#define VMG_PHASE_STOP(_p_, _t_) fcs_timing_stop(FCS_PHASE_##_p_, (_t_))
+
+#else
+
+#define VMG_PHASE_START(_t_)     ((_t_) = 0.0)
+#define VMG_PHASE_STOP(_p_, _t_) ((void) (_t_))
+
+#endif
+
+#endif /* PHASE_TIMER_HPP_ */
@@ -0,0 +1,85 @@
+/*
+ *    vmg - a versatile multigrid solver
+ *    Copyright (C) 2012 Institute for Numerical Simulation, University of Bonn
+ *
+ *  vmg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  vmg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   com_initial_guess.cpp
+ *
+ * @brief  Sets the initial guess on the finest level to the
+ *         solution of the previous solve (WARM_START == 1) or
+ *         to a linear extrapolation of the last two solutions
+ *         (WARM_START == 2). Only the inner local points are
+ *         set, so boundary values stay untouched.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "base/command.hpp"
+#include "base/factory.hpp"
+#include "grid/grid.hpp"
+#include "grid/multigrid.hpp"
+#include "mg.hpp"
+
+using namespace VMG;
+
+class VMGCommandInitialGuess : public Command
+{
+public:
+  Request Run(Command::argument_vector arguments)
+  {
+    MPE_EVENT_BEGIN()
+
+    Factory& factory = MG::GetFactory();
+
+    const int warm_start = factory.TestObject("WARM_START") ? factory.GetObjectStorageVal<int>("WARM_START") : 0;
+
+    if (warm_start > 0 && factory.TestObject("SOL_PREVIOUS")) {
+
+      Multigrid& sol = *factory.Get(arguments[0])->Cast<Multigrid>();
+      Grid& grid = sol(sol.MaxLevel());
+      const Grid& previous = *factory.Get("SOL_PREVIOUS")->Cast<Grid>();
+      Grid::iterator iter;
+
+      if (warm_start > 1 && factory.TestObject("SOL_PREVIOUS_2")) {
+
+        const Grid& previous_2 = *factory.Get("SOL_PREVIOUS_2")->Cast<Grid>();
+
+        for (iter = grid.Iterators().Local().Begin(); iter != grid.Iterators().Local().End(); ++iter)
+          grid(*iter) = 2.0 * previous.GetVal(*iter) - previous_2.GetVal(*iter);
+
+      } else {
+
+        for (iter = grid.Iterators().Local().Begin(); iter != grid.Iterators().Local().End(); ++iter)
+          grid(*iter) = previous.GetVal(*iter);
+
+      }
+
+    }
+
+    MPE_EVENT_END()
+
+    return Continue;
+  }
+
+  static const char* Name() {return "InitialGuess";}
+  static int Arguments() {return 1;}
+};
+
+CREATE_INITIALIZER(VMGCommandInitialGuess)
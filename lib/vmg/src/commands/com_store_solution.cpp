@@ -0,0 +1,80 @@
+/*
+ *    vmg - a versatile multigrid solver
+ *    Copyright (C) 2012 Institute for Numerical Simulation, University of Bonn
+ *
+ *  vmg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  vmg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   com_store_solution.cpp
+ *
+ * @brief  Keeps the solution on the finest level (and the one of
+ *         the solve before if WARM_START == 2) for the initial
+ *         guess of the next solve.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "base/command.hpp"
+#include "base/factory.hpp"
+#include "grid/grid.hpp"
+#include "grid/multigrid.hpp"
+#include "mg.hpp"
+
+using namespace VMG;
+
+class VMGCommandStoreSolution : public Command
+{
+public:
+  Request Run(Command::argument_vector arguments)
+  {
+    MPE_EVENT_BEGIN()
+
+    Factory& factory = MG::GetFactory();
+
+    const int warm_start = factory.TestObject("WARM_START") ? factory.GetObjectStorageVal<int>("WARM_START") : 0;
+
+    if (warm_start > 0) {
+
+      Multigrid& sol = *factory.Get(arguments[0])->Cast<Multigrid>();
+      const Grid& grid = sol(sol.MaxLevel());
+
+      if (warm_start > 1 && factory.TestObject("SOL_PREVIOUS")) {
+        const Grid& previous = *factory.Get("SOL_PREVIOUS")->Cast<Grid>();
+        if (factory.TestObject("SOL_PREVIOUS_2"))
+          factory.Get("SOL_PREVIOUS_2")->Cast<Grid>()->SetGrid(previous);
+        else
+          (new Grid(previous))->Register("SOL_PREVIOUS_2");
+      }
+
+      if (factory.TestObject("SOL_PREVIOUS"))
+        factory.Get("SOL_PREVIOUS")->Cast<Grid>()->SetGrid(grid);
+      else
+        (new Grid(grid))->Register("SOL_PREVIOUS");
+
+    }
+
+    MPE_EVENT_END()
+
+    return Continue;
+  }
+
+  static const char* Name() {return "StoreSolution";}
+  static int Arguments() {return 1;}
+};
+
+CREATE_INITIALIZER(VMGCommandStoreSolution)
@@ -54,6 +54,7 @@ void CycleCSDirichlet::Generate()
   init->AddCommand("CopyBoundary", "RHS:SOL");
   init->AddCommand("InitializeIterationCounter");
   init->AddCommand("InitializeResidualNorm", "INITIAL_RESIDUAL");
+  init->AddCommand("InitialGuess", "SOL");
 
   loop->AddCommand("ClearCoarseLevels", "RHS");
   loop->AddCommand("ClearCoarseLevels", "SOL");
@@ -66,6 +67,7 @@ void CycleCSDirichlet::Generate()
   loop->AddCommand("CheckIterationCounter");
 
   finalize->AddCommand("ExportSolution");
+  finalize->AddCommand("StoreSolution", "SOL");
 
   init->Register("COMMANDLIST_INIT");
   loop->Register("COMMANDLIST_LOOP");
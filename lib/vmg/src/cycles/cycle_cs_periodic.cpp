@@ -53,6 +53,7 @@ void CycleCSPeriodic::Generate()
   init->AddCommand("CheckConsistency", "RHS");
   init->AddCommand("InitializeIterationCounter");
   init->AddCommand("InitializeResidualNorm", "INITIAL_RESIDUAL");
+  init->AddCommand("InitialGuess", "SOL");
 
   loop->AddCommand("ClearCoarseLevels", "SOL");
   loop->AddCommand("ClearCoarseLevels", "RHS");
@@ -66,6 +67,7 @@ void CycleCSPeriodic::Generate()
 
   finalize->AddCommand("SetAverageToZero", "SOL");
   finalize->AddCommand("ExportSolution");
+  finalize->AddCommand("StoreSolution", "SOL");
 
   init->Register("COMMANDLIST_INIT");
   loop->Register("COMMANDLIST_LOOP");
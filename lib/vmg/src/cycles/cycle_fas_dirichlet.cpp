@@ -54,6 +54,7 @@ void CycleFASDirichlet::Generate()
   init->AddCommand("CopyBoundary", "RHS:SOL");
   init->AddCommand("InitializeIterationCounter");
   init->AddCommand("InitializeResidualNorm", "INITIAL_RESIDUAL");
+  init->AddCommand("InitialGuess", "SOL");
 
   AddCycle(*loop, max_level-min_level+1, gamma);
 
@@ -63,6 +64,7 @@ void CycleFASDirichlet::Generate()
   loop->AddCommand("CheckIterationCounter");
 
   finalize->AddCommand("ExportSolution");
+  finalize->AddCommand("StoreSolution", "SOL");
 
   init->Register("COMMANDLIST_INIT");
   loop->Register("COMMANDLIST_LOOP");
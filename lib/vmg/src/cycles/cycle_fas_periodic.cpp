@@ -53,6 +53,7 @@ void CycleFASPeriodic::Generate()
   init->AddCommand("CheckConsistency", "RHS");
   init->AddCommand("InitializeIterationCounter");
   init->AddCommand("InitializeResidualNorm", "INITIAL_RESIDUAL");
+  init->AddCommand("InitialGuess", "SOL");
 
   AddCycle(*loop, max_level-min_level+1, gamma);
 
@@ -62,6 +63,7 @@ void CycleFASPeriodic::Generate()
   loop->AddCommand("CheckIterationCounter");
 
   finalize->AddCommand("ExportSolution");
+  finalize->AddCommand("StoreSolution", "SOL");
 
   init->Register("COMMANDLIST_INIT");
   loop->Register("COMMANDLIST_LOOP");
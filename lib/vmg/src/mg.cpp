@@ -54,6 +54,7 @@
 #include "base/discretization.hpp"
 #include "base/factory.hpp"
 #include "base/interface.hpp"
+#include "base/phase_timer.hpp"
 #include "base/timer.hpp"
 #include "comm/comm.hpp"
 #include "cycles/cycle.hpp"
@@ -87,6 +88,7 @@ static void VMGRegisterBuiltinCommands()
   REGISTER_COMMAND(VMGCommandExportSolution);
   REGISTER_COMMAND(VMGCommandForceDiscreteCompatibility);
   REGISTER_COMMAND(VMGCommandImportRightHandSide);
+  REGISTER_COMMAND(VMGCommandInitialGuess);
   REGISTER_COMMAND(VMGCommandInterpolateFMG);
   REGISTER_COMMAND(VMGCommandInitializeIterationCounter);
   REGISTER_COMMAND(VMGCommandInitializeResidualNorm);
@@ -104,6 +106,7 @@ static void VMGRegisterBuiltinCommands()
   REGISTER_COMMAND(VMGCommandSetLevel);
   REGISTER_COMMAND(VMGCommandSmooth);
   REGISTER_COMMAND(VMGCommandSolve);
+  REGISTER_COMMAND(VMGCommandStoreSolution);
 }
 
 MG::MG()
@@ -171,8 +174,13 @@ void MG::Solve()
 
   cl_init->ExecuteList();
 
+  double timing;
+  VMG_PHASE_START(timing);
+
   while (cl_loop->ExecuteList() == Continue);
 
+  VMG_PHASE_STOP(SOLVE, timing);
+
   cl_finalize->ExecuteList();
 
 #ifdef OUTPUT_TIMING
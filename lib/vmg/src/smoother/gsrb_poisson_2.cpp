@@ -35,6 +35,8 @@
 #include <mpi.h>
 #endif
 
+#include <algorithm>
+
 #include "base/helper.hpp"
 #include "comm/comm.hpp"
 #include "grid/grid.hpp"
@@ -43,21 +45,44 @@
 
 using namespace VMG;
 
+/*
+ * Size of the tiles in y direction. The three planes of a tile
+ * involved in the stencil stay in cache while sweeping over x.
+ */
+static const int tile_size = 16;
+
 static inline void ComputePartial(Grid& sol, Grid& rhs,
 				  const Index& begin, const Index& end,
 				  const vmg_float& prefactor, const int& off)
 {
   const vmg_float fac = 1.0 / 6.0;
 
-  for (int i=begin.X(); i<end.X(); ++i)
-    for (int j=begin.Y(); j<end.Y(); ++j)
-      for (int k=begin.Z() + (i + j + begin.Z() + off) % 2; k<end.Z(); k+=2)
-	sol(i,j,k) = prefactor * rhs.GetVal(i,j,k) + fac * (sol.GetVal(i-1,j  ,k  ) +
-							    sol.GetVal(i+1,j  ,k  ) +
-							    sol.GetVal(i  ,j-1,k  ) +
-							    sol.GetVal(i  ,j+1,k  ) +
-							    sol.GetVal(i  ,j  ,k-1) +
-							    sol.GetVal(i  ,j  ,k+1));
+  if (begin.X() >= end.X() || begin.Y() >= end.Y() || begin.Z() >= end.Z())
+    return;
+
+  /*
+   * Work on raw lines of the grid, so that the index translation is
+   * done once per line and the stride-2 inner loop over the points of
+   * one color can be vectorized by the compiler.
+   */
+  for (int jt=begin.Y(); jt<end.Y(); jt+=tile_size) {
+    const int jt_end = std::min(jt + tile_size, end.Y());
+    for (int i=begin.X(); i<end.X(); ++i)
+      for (int j=jt; j<jt_end; ++j) {
+
+	vmg_float* s = &sol(i,j,0);
+	const vmg_float* r = &rhs.GetVal(i,j,0);
+	const vmg_float* s_xm = &sol.GetVal(i-1,j,0);
+	const vmg_float* s_xp = &sol.GetVal(i+1,j,0);
+	const vmg_float* s_ym = &sol.GetVal(i,j-1,0);
+	const vmg_float* s_yp = &sol.GetVal(i,j+1,0);
+
+	for (int k=begin.Z() + (i + j + begin.Z() + off) % 2; k<end.Z(); k+=2)
+	  s[k] = prefactor * r[k] + fac * (s_xm[k] + s_xp[k] +
+					   s_ym[k] + s_yp[k] +
+					   s[k-1] + s[k+1]);
+      }
+  }
 }
 
 void GaussSeidelRBPoisson2::Compute(Grid& sol, Grid& rhs)
@@ -28,12 +28,15 @@
 #ifndef BSPLINE_HPP_
 #define BSPLINE_HPP_
 
+#include <vector>
+
 #include "base/helper.hpp"
 #include "base/index.hpp"
 #include "base/polynomial.hpp"
 #include "base/vector.hpp"
 #include "grid/grid.hpp"
 #include "units/particle/particle.hpp"
+#include "units/particle/particle_storage.hpp"
 
 namespace VMG
 {
@@ -56,19 +59,51 @@ public:
 
   void SetSpline(Grid& grid, const Particle& p) const
   {
-    assert(p.Pos().X() >= grid.Extent().Begin().X() && p.Pos().X() < grid.Extent().End().X());
-    assert(p.Pos().Y() >= grid.Extent().Begin().Y() && p.Pos().Y() < grid.Extent().End().Y());
-    assert(p.Pos().Z() >= grid.Extent().Begin().Z() && p.Pos().Z() < grid.Extent().End().Z());
+    std::vector<vmg_float> vals(3*(2*near_field_cells+1) + Helper::intpow(2*near_field_cells+1,3));
+
+    SetSpline(grid, p.Pos().vec(), p.Charge(), &vals.front());
+  }
+
+  /**
+   * Assigns the charges of all particles of a storage to the grid.
+   */
+  void SetSplines(Grid& grid, const ParticleStorage& particles) const
+  {
+    std::vector<vmg_float> vals(3*(2*near_field_cells+1) + Helper::intpow(2*near_field_cells+1,3));
+    vmg_float pos[3];
+
+    for (vmg_int i=0; i<particles.Size(); ++i) {
+      pos[0] = particles.Pos(0)[i];
+      pos[1] = particles.Pos(1)[i];
+      pos[2] = particles.Pos(2)[i];
+      SetSpline(grid, pos, particles.Charge()[i], &vals.front());
+    }
+  }
 
-    vmg_float* vals = new vmg_float[Helper::intpow(2*near_field_cells+1,3)];
+  /**
+   * Assigns the charge q at position x to the grid. The buffer vals
+   * has to hold 3*(2*near_field_cells+1) + (2*near_field_cells+1)^3
+   * values.
+   */
+  void SetSpline(Grid& grid, const vmg_float* x, const vmg_float& q, vmg_float* vals) const
+  {
+    assert(x[0] >= grid.Extent().Begin().X() && x[0] < grid.Extent().End().X());
+    assert(x[1] >= grid.Extent().Begin().Y() && x[1] < grid.Extent().End().Y());
+    assert(x[2] >= grid.Extent().Begin().Z() && x[2] < grid.Extent().End().Z());
+
+    const int width = 2*near_field_cells+1;
+    vmg_float* dir2_x = vals;
+    vmg_float* dir2_y = dir2_x + width;
+    vmg_float* dir2_z = dir2_y + width;
+    vmg_float* weights = dir2_z + width;
 
     vmg_float temp_val;
     vmg_float int_val = 0.0;
     int c = 0;
 
-    const int index_global_x = (p.Pos().X() - grid.Extent().Begin().X()) / grid.Extent().MeshWidth().X();
-    const int index_global_y = (p.Pos().Y() - grid.Extent().Begin().Y()) / grid.Extent().MeshWidth().Y();
-    const int index_global_z = (p.Pos().Z() - grid.Extent().Begin().Z()) / grid.Extent().MeshWidth().Z();
+    const int index_global_x = (x[0] - grid.Extent().Begin().X()) / grid.Extent().MeshWidth().X();
+    const int index_global_y = (x[1] - grid.Extent().Begin().Y()) / grid.Extent().MeshWidth().Y();
+    const int index_global_z = (x[2] - grid.Extent().Begin().Z()) / grid.Extent().MeshWidth().Z();
 
     assert(index_global_x >= grid.Global().LocalBegin().X() && index_global_x < grid.Global().LocalEnd().X());
     assert(index_global_y >= grid.Global().LocalBegin().Y() && index_global_y < grid.Global().LocalEnd().Y());
@@ -82,46 +117,49 @@ public:
     assert(index_local_y >= grid.Local().Begin().Y() && index_local_y < grid.Local().End().Y());
     assert(index_local_z >= grid.Local().Begin().Z() && index_local_z < grid.Local().End().Z());
 
-    const vmg_float pos_beg_x = p.Pos().X() - grid.Extent().Begin().X() - grid.Extent().MeshWidth().X() * (index_global_x - near_field_cells);
-    const vmg_float pos_beg_y = p.Pos().Y() - grid.Extent().Begin().Y() - grid.Extent().MeshWidth().Y() * (index_global_y - near_field_cells);
-    const vmg_float pos_beg_z = p.Pos().Z() - grid.Extent().Begin().Z() - grid.Extent().MeshWidth().Z() * (index_global_z - near_field_cells);
-
     const vmg_float& h_x = grid.Extent().MeshWidth().X();
     const vmg_float& h_y = grid.Extent().MeshWidth().Y();
     const vmg_float& h_z = grid.Extent().MeshWidth().Z();
 
+    // Squared distances from the grid planes in the support of the B-Spline to the particle
+    vmg_float dir_x = x[0] - grid.Extent().Begin().X() - h_x * (index_global_x - near_field_cells);
+    vmg_float dir_y = x[1] - grid.Extent().Begin().Y() - h_y * (index_global_y - near_field_cells);
+    vmg_float dir_z = x[2] - grid.Extent().Begin().Z() - h_z * (index_global_z - near_field_cells);
+    for (int i=0; i<width; ++i) {
+      dir2_x[i] = dir_x * dir_x;
+      dir2_y[i] = dir_y * dir_y;
+      dir2_z[i] = dir_z * dir_z;
+      dir_x -= h_x;
+      dir_y -= h_y;
+      dir_z -= h_z;
+    }
+
     // Iterate over all grid points which lie in the support of the interpolating B-Spline
-    vmg_float dir_x = pos_beg_x;
-    for (int i=-1*near_field_cells; i<=near_field_cells; ++i) {
-      vmg_float dir_y = pos_beg_y;
-      for (int j=-1*near_field_cells; j<=near_field_cells; ++j) {
-	vmg_float dir_z = pos_beg_z;
-	for (int k=-1*near_field_cells; k<=near_field_cells; ++k) {
-
-	  // Compute distance from grid point to particle
-	  temp_val = EvaluateSpline(std::sqrt(dir_x*dir_x+dir_y*dir_y+dir_z*dir_z));
-	  vals[c++] = temp_val * p.Charge();
+    for (int i=0; i<width; ++i)
+      for (int j=0; j<width; ++j)
+	for (int k=0; k<width; ++k) {
+	  temp_val = EvaluateSpline(std::sqrt(dir2_x[i]+dir2_y[j]+dir2_z[k]));
+	  weights[c++] = temp_val;
 	  int_val += temp_val;
-
-	  dir_z -= h_z;
 	}
-	dir_y -= h_y;
-      }
-      dir_x -= h_x;
-    }
 
     // Reciprocal value of the numerically integrated spline
-    int_val = 1.0 / (int_val * h_x * h_y * h_z);
+    int_val = q / (int_val * h_x * h_y * h_z);
+
+    // Add the weights to the grid with precomputed strides
+    const int stride_y = grid.Local().SizeTotal().Z();
+    const int stride_x = grid.Local().SizeTotal().Y() * stride_y;
+    vmg_float* g = &grid(index_local_x - near_field_cells,
+			 index_local_y - near_field_cells,
+			 index_local_z - near_field_cells);
 
     c = 0;
-    for (int i=-1*near_field_cells; i<=near_field_cells; ++i)
-      for (int j=-1*near_field_cells; j<=near_field_cells; ++j)
-	for (int k=-1*near_field_cells; k<=near_field_cells; ++k)
-	  grid(index_local_x + i,
-	       index_local_y + j,
-	       index_local_z + k) += vals[c++] * int_val;
-
-    delete [] vals;
+    for (int i=0; i<width; ++i)
+      for (int j=0; j<width; ++j) {
+	vmg_float* g_row = g + i * stride_x + j * stride_y;
+	for (int k=0; k<width; ++k)
+	  g_row[k] += weights[c++] * int_val;
+      }
   }
 
   vmg_float EvaluatePotential(const vmg_float& val) const
@@ -39,11 +39,11 @@
 
 #include "units/particle/comm_mpi_particle.hpp"
 #include "units/particle/linked_cell_list.hpp"
-#include "units/particle/particle.hpp"
+#include "units/particle/particle_storage.hpp"
 
 using namespace VMG;
 
-void Particle::CommMPI::CommParticles(const Grid& grid, std::list<Particle>& particles)
+void Particle::CommMPI::CommParticles(const Grid& grid, ParticleStorage& particles)
 {
   Factory& factory = MG::GetFactory();
 
@@ -68,11 +68,9 @@ void Particle::CommMPI::CommParticles(const Grid& grid, std::list<Particle>& par
   std::vector<int> recv_sizes(size);
   std::vector<Index> begin_remote(size);
   std::vector<Index> end_remote(size);
-  std::vector< std::vector<vmg_float> > send_buffer_x(size);
-  std::vector< std::vector<vmg_float> > send_buffer_q(size);
+  std::vector< std::vector<vmg_float> > send_buffer_xq(size);
   std::vector< std::vector<vmg_int> > send_buffer_ind(size);
-  std::vector< std::vector<vmg_float> > recv_buffer_x(size);
-  std::vector< std::vector<vmg_float> > recv_buffer_q(size);
+  std::vector< std::vector<vmg_float> > recv_buffer_xq(size);
   std::vector< std::vector<vmg_int> > recv_buffer_ind(size);
 
   std::memcpy(&global_extent[6*rank], grid.Global().LocalBegin().vec(), 3*sizeof(int));
@@ -85,14 +83,17 @@ void Particle::CommMPI::CommParticles(const Grid& grid, std::list<Particle>& par
     end_remote[i] = static_cast<Index>(&global_extent[6*i+3]);
   }
 
+  /*
+   * Positions and charges are packed into a single buffer per process
+   */
   for (int i=0; i<num_particles_local; ++i) {
     index = static_cast<Index>((Vector(&x[3*i]) - grid.Extent().Begin()) / grid.Extent().MeshWidth());
     for (int j=0; j<size; ++j)
       if (index.IsInBounds(begin_remote[j], end_remote[j])) {
-	send_buffer_x[j].push_back(x[3*i+0]);
-	send_buffer_x[j].push_back(x[3*i+1]);
-	send_buffer_x[j].push_back(x[3*i+2]);
-	send_buffer_q[j].push_back(q[i]);
+	send_buffer_xq[j].push_back(x[3*i+0]);
+	send_buffer_xq[j].push_back(x[3*i+1]);
+	send_buffer_xq[j].push_back(x[3*i+2]);
+	send_buffer_xq[j].push_back(q[i]);
 	send_buffer_ind[j].push_back(i);
 	break;
       }
@@ -102,7 +103,7 @@ void Particle::CommMPI::CommParticles(const Grid& grid, std::list<Particle>& par
    * Communicate which process gets how many particles
    */
   for (int i=0; i<size; ++i)
-    send_sizes[i] = send_buffer_q[i].size();
+    send_sizes[i] = send_buffer_ind[i].size();
 
   MPI_Alltoall(&send_sizes.front(), 1, MPI_INT, &recv_sizes.front(), 1, MPI_INT, comm_global);
 
@@ -113,48 +114,63 @@ void Particle::CommMPI::CommParticles(const Grid& grid, std::list<Particle>& par
    */
   for (int i=0; i<size; ++i) {
 
-    if (!send_buffer_q[i].empty()) {
-      MPI_Isend(&send_buffer_x[i].front(), send_buffer_x[i].size(), MPI_DOUBLE, i, 0, comm_global, &Request());
-      MPI_Isend(&send_buffer_q[i].front(), send_buffer_q[i].size(), MPI_DOUBLE, i, 1, comm_global, &Request());
+    if (!send_buffer_ind[i].empty()) {
+      MPI_Isend(&send_buffer_xq[i].front(), send_buffer_xq[i].size(), MPI_DOUBLE, i, 0, comm_global, &Request());
       MPI_Isend(&send_buffer_ind[i].front(), send_buffer_ind[i].size(), MPI_INT, i, 2, comm_global, &Request());
     }
 
 #ifndef VMG_ONE_SIDED
-    receiver[i] = send_buffer_q[i].size();
+    receiver[i] = send_buffer_ind[i].size();
 #endif
   }
 
   /*
    * Receive particles
    */
+  vmg_int num_particles_recv = 0;
+
   for (int i=0; i<size; ++i) {
 
     if (recv_sizes[i] > 0) {
 
-      recv_buffer_x[i].resize(3*recv_sizes[i]);
-      recv_buffer_q[i].resize(recv_sizes[i]);
+      recv_buffer_xq[i].resize(4*recv_sizes[i]);
       recv_buffer_ind[i].resize(recv_sizes[i]);
 
-      MPI_Irecv(&recv_buffer_x[i].front(), 3*recv_sizes[i], MPI_DOUBLE, i, 0, comm_global, &Request());
-      MPI_Irecv(&recv_buffer_q[i].front(), recv_sizes[i], MPI_DOUBLE, i, 1, comm_global, &Request());
+      MPI_Irecv(&recv_buffer_xq[i].front(), 4*recv_sizes[i], MPI_DOUBLE, i, 0, comm_global, &Request());
       MPI_Irecv(&recv_buffer_ind[i].front(), recv_sizes[i], MPI_INT, i, 2, comm_global, &Request());
 
+      num_particles_recv += recv_sizes[i];
     }
 
   }
 
   WaitAll();
 
-  particles.clear();
+  /*
+   * Store the particles contiguously and sort them by the local cells of the grid
+   */
+  const Index& local_begin = grid.Global().LocalBegin();
+  const Index& local_size = grid.Local().Size();
+
+  particles.Clear();
+  particles.Reserve(num_particles_recv);
 
   for (int i=0; i<size; ++i)
-    for (int j=0; j<recv_sizes[i]; ++j)
-      particles.push_back(Particle(&recv_buffer_x[i][3*j], recv_buffer_q[i][j], 0.0, 0.0, i, recv_buffer_ind[i][j]));
+    for (int j=0; j<recv_sizes[i]; ++j) {
+      index = static_cast<Index>((Vector(&recv_buffer_xq[i][4*j]) - grid.Extent().Begin()) / grid.Extent().MeshWidth()) - local_begin;
+      assert(index.IsInBounds(0, local_size));
+      particles.Add(&recv_buffer_xq[i][4*j], recv_buffer_xq[i][4*j+3], i, recv_buffer_ind[i][j],
+		    index.Z() + local_size.Z() * (index.Y() + local_size.Y() * index.X()));
+    }
+
+  particles.SortByCell(local_size.Product());
 }
 
-void Particle::CommMPI::CommParticlesBack(std::list<Particle>& particles)
+void Particle::CommMPI::CommParticlesBack(ParticleStorage& particles)
 {
-  std::list<Particle>::iterator iter;
+  const int* particle_rank = particles.Rank();
+  const vmg_int* particle_index = particles.Index();
+  vmg_float* particle_pot = particles.Pot();
 
 #ifdef VMG_ONE_SIDED
   if (!win_created) {
@@ -166,8 +182,8 @@ void Particle::CommMPI::CommParticlesBack(std::list<Particle>& particles)
 
   MPI_Win_fence(MPI_MODE_NOPRECEDE, win);
 
-  for (iter=particles.begin(); iter!=particles.end(); ++iter)
-    MPI_Put(&iter->Pot(), 1, MPI_DOUBLE, iter->Rank(), iter->Index(), 1, MPI_DOUBLE, win);
+  for (vmg_int i=0; i<particles.Size(); ++i)
+    MPI_Put(&particle_pot[i], 1, MPI_DOUBLE, particle_rank[i], particle_index[i], 1, MPI_DOUBLE, win);
 
   MPI_Win_fence(MPI_MODE_NOSTORE | MPI_MODE_NOSUCCEED, win);
 #else
@@ -185,12 +201,12 @@ void Particle::CommMPI::CommParticlesBack(std::list<Particle>& particles)
   vmg_float* f = MG::GetFactory().GetObjectStorageArray<vmg_float>("PARTICLE_FIELD_ARRAY");
 
   // Build send buffer
-  for (iter=particles.begin(); iter!=particles.end(); ++iter) {
-    send_buffer_float[iter->Rank()].push_back(iter->Pot());
-    send_buffer_float[iter->Rank()].push_back(iter->Field()[0]);
-    send_buffer_float[iter->Rank()].push_back(iter->Field()[1]);
-    send_buffer_float[iter->Rank()].push_back(iter->Field()[2]);
-    send_buffer_index[iter->Rank()].push_back(iter->Index());
+  for (vmg_int i=0; i<particles.Size(); ++i) {
+    send_buffer_float[particle_rank[i]].push_back(particle_pot[i]);
+    send_buffer_float[particle_rank[i]].push_back(particles.Field(0)[i]);
+    send_buffer_float[particle_rank[i]].push_back(particles.Field(1)[i]);
+    send_buffer_float[particle_rank[i]].push_back(particles.Field(2)[i]);
+    send_buffer_index[particle_rank[i]].push_back(particle_index[i]);
   }
 
   // Send potentials
@@ -228,7 +244,7 @@ void Particle::CommMPI::CommLCListToGhosts(LinkedCellList& lc)
   VMG::MPI::DatatypesLocal types(lc, comm_global, false);
   std::vector<int> send_size(types.NB().size());
   vmg_int recv_size;
-  std::list<Particle*>::iterator iter;
+  vmg_int p;
   Index ind;
   Vector offset;
 
@@ -249,16 +265,18 @@ void Particle::CommMPI::CommLCListToGhosts(LinkedCellList& lc)
       for (ind.X() = types.NB()[i].Starts().X(); ind.X() < types.NB()[i].Starts().X()+types.NB()[i].Subsizes().X(); ++ind.X())
 	for (ind.Y() = types.NB()[i].Starts().Y(); ind.Y() < types.NB()[i].Starts().Y()+types.NB()[i].Subsizes().Y(); ++ind.Y())
 	  for (ind.Z() = types.NB()[i].Starts().Z(); ind.Z() < types.NB()[i].Starts().Z()+types.NB()[i].Subsizes().Z(); ++ind.Z())
-	    for (iter=lc(ind).begin(); iter!=lc(ind).end(); ++iter) {
+	    for (p=lc(ind).begin; p<lc(ind).end; ++p) {
+
+              const ParticleStorage& storage = *lc(ind).storage;
 
               for (int j=0; j<3; ++j)
-                types.NB()[i].Buffer().push_back((*iter)->Pos()[j] + offset[j]);
-              types.NB()[i].Buffer().push_back((*iter)->Charge());
+                types.NB()[i].Buffer().push_back(storage.Pos(j)[p] + offset[j]);
+              types.NB()[i].Buffer().push_back(storage.Charge()[p]);
 
-              assert(lc.Extent().Begin().IsComponentwiseLessOrEqual((*iter)->Pos()));
-              assert(lc.Extent().End().IsComponentwiseGreaterOrEqual((*iter)->Pos()));
-              assert(lc.Extent().Begin().IsComponentwiseLessOrEqual((*iter)->Pos() + offset + halo_length));
-              assert(lc.Extent().End().IsComponentwiseGreaterOrEqual((*iter)->Pos() + offset - halo_length));
+              assert(lc.Extent().Begin().IsComponentwiseLessOrEqual(Vector(storage.Pos(0)[p], storage.Pos(1)[p], storage.Pos(2)[p])));
+              assert(lc.Extent().End().IsComponentwiseGreaterOrEqual(Vector(storage.Pos(0)[p], storage.Pos(1)[p], storage.Pos(2)[p])));
+              assert(lc.Extent().Begin().IsComponentwiseLessOrEqual(Vector(storage.Pos(0)[p], storage.Pos(1)[p], storage.Pos(2)[p]) + offset + halo_length));
+              assert(lc.Extent().End().IsComponentwiseGreaterOrEqual(Vector(storage.Pos(0)[p], storage.Pos(1)[p], storage.Pos(2)[p]) + offset - halo_length));
 	    }
 
       send_size[i] = types.NB()[i].Buffer().size();
@@ -286,6 +304,8 @@ void Particle::CommMPI::CommLCListToGhosts(LinkedCellList& lc)
   for (unsigned int i=0; i<types.Halo().size(); ++i)
     for (unsigned int j=0; j<types.Halo()[i].Buffer().size(); j+=4)
       lc.AddParticleToHalo(&types.Halo()[i].Buffer()[j], types.Halo()[i].Buffer()[j+3]);
+
+  lc.SortHalo();
 }
 
 #endif /* HAVE_MPI */
@@ -19,10 +19,7 @@
 #ifndef COMM_MPI_PARTICLE_HPP_
 #define COMM_MPI_PARTICLE_HPP_
 
-#include <list>
-
 #include "comm/comm_mpi.hpp"
-#include "units/particle/particle.hpp"
 
 namespace VMG
 {
@@ -31,6 +28,7 @@ namespace Particle
 {
 
 class LinkedCellList;
+class ParticleStorage;
 
 class CommMPI : public VMG::CommMPI
 {
@@ -45,8 +43,8 @@ public:
 
   virtual ~CommMPI() {}
 
-  void CommParticles(const Grid& grid, std::list<Particle>& particles);
-  void CommParticlesBack(std::list<Particle>& particles);
+  void CommParticles(const Grid& grid, ParticleStorage& particles);
+  void CommParticlesBack(ParticleStorage& particles);
   void CommLCListToGhosts(LinkedCellList& lc);
 };
 
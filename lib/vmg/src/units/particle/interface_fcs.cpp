@@ -77,6 +77,7 @@ namespace VMGBackupSettings
   static vmg_int near_field_cells = -1;
   static vmg_int interpolation_degree = -1;
   static vmg_int discretization_order = -1;
+  static vmg_int warm_start = -1;
   static MPI_Comm mpi_comm;
 }
 
@@ -84,7 +85,8 @@ static void VMG_fcs_init(vmg_int level, const vmg_int* periodic,vmg_int max_iter
 			 vmg_int smoothing_steps, vmg_int cycle_type, vmg_float precision,
 			 const vmg_float* box_offset, vmg_float box_size,
 			 vmg_int near_field_cells, vmg_int interpolation_degree,
-                         vmg_int discretization_order, MPI_Comm mpi_comm)
+                         vmg_int discretization_order, vmg_int warm_start,
+                         MPI_Comm mpi_comm)
 {
   VMGBackupSettings::level = level;
   std::memcpy(VMGBackupSettings::periodic, periodic, 3*sizeof(vmg_int));
@@ -97,6 +99,7 @@ static void VMG_fcs_init(vmg_int level, const vmg_int* periodic,vmg_int max_iter
   VMGBackupSettings::near_field_cells = near_field_cells;
   VMGBackupSettings::interpolation_degree = interpolation_degree;
   VMGBackupSettings::discretization_order = discretization_order;
+  VMGBackupSettings::warm_start = warm_start;
   VMGBackupSettings::mpi_comm = mpi_comm;
 
 #ifdef DEBUG
@@ -151,6 +154,7 @@ static void VMG_fcs_init(vmg_int level, const vmg_int* periodic,vmg_int max_iter
   new ObjectStorage<int>("MAX_ITERATION", max_iter);
   new ObjectStorage<int>("PARTICLE_NEAR_FIELD_CELLS", near_field_cells);
   new ObjectStorage<int>("PARTICLE_INTERPOLATION_DEGREE", interpolation_degree);
+  new ObjectStorage<int>("WARM_START", warm_start);
 
   /*
    * Post init
@@ -167,7 +171,8 @@ void VMG_fcs_setup(vmg_int level, const vmg_int* periodic, vmg_int max_iter,
 		   vmg_int smoothing_steps, vmg_int cycle_type, vmg_float precision,
 		   const vmg_float* box_offset, vmg_float box_size,
 		   vmg_int near_field_cells, vmg_int interpolation_degree,
-                   vmg_int discretization_order, MPI_Comm mpi_comm)
+                   vmg_int discretization_order, vmg_int warm_start,
+                   MPI_Comm mpi_comm)
 {
   if (VMGBackupSettings::level != level ||
       VMGBackupSettings::periodic[0] != periodic[0] ||
@@ -184,6 +189,7 @@ void VMG_fcs_setup(vmg_int level, const vmg_int* periodic, vmg_int max_iter,
       VMGBackupSettings::near_field_cells != near_field_cells ||
       VMGBackupSettings::interpolation_degree != interpolation_degree ||
       VMGBackupSettings::discretization_order != discretization_order ||
+      VMGBackupSettings::warm_start != warm_start ||
       VMGBackupSettings::mpi_comm != mpi_comm) {
 
     VMG_fcs_destroy();
@@ -191,7 +197,7 @@ void VMG_fcs_setup(vmg_int level, const vmg_int* periodic, vmg_int max_iter,
 		 smoothing_steps, cycle_type, precision,
 		 box_offset, box_size, near_field_cells,
                  interpolation_degree, discretization_order,
-		 mpi_comm);
+		 warm_start, mpi_comm);
 
   }
 }
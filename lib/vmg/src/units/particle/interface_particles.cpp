@@ -44,6 +44,7 @@
 #include "base/helper.hpp"
 #include "base/index.hpp"
 #include "base/math.hpp"
+#include "base/phase_timer.hpp"
 #include "base/vector.hpp"
 #include "comm/comm.hpp"
 #include "grid/grid.hpp"
@@ -61,6 +62,7 @@ void InterfaceParticles::ImportRightHandSide(Multigrid& multigrid)
 {
   Index index_global, index_local, index;
   Vector pos_rel, pos_abs, grid_val;
+  double timing;
 
   Factory& factory = MG::GetFactory();
   Particle::CommMPI& comm = *dynamic_cast<Particle::CommMPI*>(MG::GetComm());
@@ -77,25 +79,27 @@ void InterfaceParticles::ImportRightHandSide(Multigrid& multigrid)
   /*
    * Distribute particles to their processes
    */
-  particles.clear();
+  VMG_PHASE_START(timing);
+
   comm.CommParticles(grid, particles);
 
+  VMG_PHASE_STOP(SORT, timing);
+
+  VMG_PHASE_START(timing);
+
   /*
    * Charge assignment on the grid
    */
-  std::list<Particle::Particle>::iterator iter;
-
 #ifdef OUTPUT_DEBUG
   vmg_float particle_charges = 0.0;
-  for (iter=particles.begin(); iter!=particles.end(); ++iter)
-    particle_charges += iter->Charge();
+  for (vmg_int i=0; i<particles.Size(); ++i)
+    particle_charges += particles.Charge()[i];
   particle_charges = MG::GetComm()->GlobalSumRoot(particle_charges);
   comm.PrintOnce(Debug, "Particle list charge sum: %e", particle_charges);
-  comm.Print(Debug, "Local number of particles: %d", particles.size());
+  comm.Print(Debug, "Local number of particles: %d", particles.Size());
 #endif
 
-  for (iter=particles.begin(); iter!=particles.end(); ++iter)
-    spl.SetSpline(particle_grid, *iter);
+  spl.SetSplines(particle_grid, particles);
 
   // Communicate charges over halo
   comm.CommFromGhosts(particle_grid);
@@ -111,6 +115,8 @@ void InterfaceParticles::ImportRightHandSide(Multigrid& multigrid)
 			       particle_grid.Local().Begin().Y() + j,
 			       particle_grid.Local().Begin().Z() + k);
 
+  VMG_PHASE_STOP(SPREAD, timing);
+
 #ifdef OUTPUT_DEBUG
   Grid::iterator grid_iter;
   vmg_float charge_sum = 0.0;
@@ -124,6 +130,7 @@ void InterfaceParticles::ImportRightHandSide(Multigrid& multigrid)
 void InterfaceParticles::ExportSolution(Grid& grid)
 {
   Index i;
+  double timing;
 
 #ifdef OUTPUT_DEBUG
   vmg_float e = 0.0;
@@ -153,6 +160,8 @@ void InterfaceParticles::ExportSolution(Grid& grid)
    */
   Grid& particle_grid = comm.GetParticleGrid();
 
+  VMG_PHASE_START(timing);
+
   for (i.X()=0; i.X()<grid.Local().Size().X(); ++i.X())
     for (i.Y()=0; i.Y()<grid.Local().Size().Y(); ++i.Y())
       for (i.Z()=0; i.Z()<grid.Local().Size().Z(); ++i.Z())
@@ -164,75 +173,118 @@ void InterfaceParticles::ExportSolution(Grid& grid)
    * Compute potentials
    */
   Particle::LinkedCellList lc(particles, near_field_cells, grid);
-  Particle::LinkedCellList::iterator p1, p2;
-  Grid::iterator iter;
+  vmg_float pot;
+  Vector pos, field;
 
   comm.CommLCListToGhosts(lc);
 
+  VMG_PHASE_STOP(GHOSTS, timing);
+
+  /*
+   * Interpolation of the long-range part and near field (one loop over the particles)
+   */
+  VMG_PHASE_START(timing);
+
+  const vmg_float* x = particles.Pos(0);
+  const vmg_float* y = particles.Pos(1);
+  const vmg_float* z = particles.Pos(2);
+  const vmg_float* q = particles.Charge();
+  vmg_float* p = particles.Pot();
+  vmg_float* fx = particles.Field(0);
+  vmg_float* fy = particles.Field(1);
+  vmg_float* fz = particles.Field(2);
+
   for (int i=lc.Local().Begin().X(); i<lc.Local().End().X(); ++i)
     for (int j=lc.Local().Begin().Y(); j<lc.Local().End().Y(); ++j)
       for (int k=lc.Local().Begin().Z(); k<lc.Local().End().Z(); ++k) {
 
-	if (lc(i,j,k).size() > 0)
+	const Particle::ParticleRange& r1 = lc(i,j,k);
+
+	if (r1.end > r1.begin)
 	  ip.ComputeCoefficients(particle_grid, Index(i,j,k) - lc.Local().Begin() + particle_grid.Local().Begin());
 
-	for (p1=lc(i,j,k).begin(); p1!=lc(i,j,k).end(); ++p1) {
+	for (vmg_int p1=r1.begin; p1<r1.end; ++p1) {
+
+	  pos = Vector(x[p1], y[p1], z[p1]);
 
 	  // Interpolate long-range part of potential and electric field
-	  ip.Evaluate(**p1);
+	  ip.Evaluate(pos, pot, field);
 
 	  // Subtract self-induced potential
-	  (*p1)->Pot() -= (*p1)->Charge() * spl.GetAntiDerivativeAtZero();
+	  pot -= q[p1] * spl.GetAntiDerivativeAtZero();
 
 #ifdef OUTPUT_DEBUG
-	  e_long += 0.5 * (*p1)->Charge() * ip.EvaluatePotentialLR(**p1);
-	  e_self += 0.5 * (*p1)->Charge() * (*p1)->Charge() * spl.GetAntiDerivativeAtZero();
+	  e_long += 0.5 * q[p1] * ip.EvaluatePotentialLR(pos);
+	  e_self += 0.5 * q[p1] * q[p1] * spl.GetAntiDerivativeAtZero();
 #endif
 
 	  for (int dx=-1*near_field_cells; dx<=near_field_cells; ++dx)
 	    for (int dy=-1*near_field_cells; dy<=near_field_cells; ++dy)
 	      for (int dz=-1*near_field_cells; dz<=near_field_cells; ++dz) {
 
-		for (p2=lc(i+dx,j+dy,k+dz).begin(); p2!=lc(i+dx,j+dy,k+dz).end(); ++p2)
+		const Particle::ParticleRange& r2 = lc(i+dx,j+dy,k+dz);
+
+		if (r2.end == r2.begin)
+		  continue;
+
+		const vmg_float* x2 = r2.storage->Pos(0);
+		const vmg_float* y2 = r2.storage->Pos(1);
+		const vmg_float* z2 = r2.storage->Pos(2);
+		const vmg_float* q2 = r2.storage->Charge();
 
-		  if (*p1 != *p2) {
+		for (vmg_int p2=r2.begin; p2<r2.end; ++p2)
 
-		    const Vector dir = (*p1)->Pos() - (*p2)->Pos();
+		  if (r2.storage != &particles || p1 != p2) {
+
+		    const Vector dir(x[p1] - x2[p2], y[p1] - y2[p2], z[p1] - z2[p2]);
 		    const vmg_float length = dir.Length();
 
 		    if (length < r_cut) {
 
-		      (*p1)->Pot() += (*p2)->Charge() / length * (1.0 + spl.EvaluatePotential(length));
-		      (*p1)->Field() += (*p2)->Charge() * dir * spl.EvaluateField(length);
+		      pot += q2[p2] / length * (1.0 + spl.EvaluatePotential(length));
+		      field += q2[p2] * dir * spl.EvaluateField(length);
 
 #ifdef OUTPUT_DEBUG
-		      e_short_peak += 0.5 * (*p1)->Charge() * (*p2)->Charge() / length;
-		      e_short_spline += 0.5 * (*p1)->Charge() * (*p2)->Charge() / length * spl.EvaluatePotential(length);
+		      e_short_peak += 0.5 * q[p1] * q2[p2] / length;
+		      e_short_spline += 0.5 * q[p1] * q2[p2] / length * spl.EvaluatePotential(length);
 #endif
 		    }
 		  }
 	      }
+
+	  p[p1] = pot;
+	  fx[p1] = field[0];
+	  fy[p1] = field[1];
+	  fz[p1] = field[2];
 	}
       }
 
   /* Remove average force term */
   Vector average_force = 0.0;
-  for (std::list<Particle::Particle>::const_iterator iter=particles.begin(); iter!=particles.end(); ++iter)
-    average_force += iter->Charge() * iter->Field();
+  for (vmg_int i=0; i<particles.Size(); ++i)
+    average_force += q[i] * Vector(fx[i], fy[i], fz[i]);
   const vmg_int& npl = MG::GetFactory().GetObjectStorageVal<vmg_int>("PARTICLE_NUM_LOCAL");
   const vmg_int num_particles_global = comm.GlobalSum(npl);
   average_force /= num_particles_global;
   comm.GlobalSumArray(average_force.vec(), 3);
-  for (std::list<Particle::Particle>::iterator iter=particles.begin(); iter!=particles.end(); ++iter)
-    iter->Field() -= average_force / iter->Charge();
+  for (vmg_int i=0; i<particles.Size(); ++i) {
+    fx[i] -= average_force[0] / q[i];
+    fy[i] -= average_force[1] / q[i];
+    fz[i] -= average_force[2] / q[i];
+  }
+
+  VMG_PHASE_STOP(NEAR, timing);
+
+  VMG_PHASE_START(timing);
 
   comm.CommParticlesBack(particles);
 
+  VMG_PHASE_STOP(BACK_SORT, timing);
+
 #ifdef OUTPUT_DEBUG
-  vmg_float* q = factory.GetObjectStorageArray<vmg_float>("PARTICLE_CHARGE_ARRAY");
+  const vmg_float* q_local = factory.GetObjectStorageArray<vmg_float>("PARTICLE_CHARGE_ARRAY");
   const vmg_int& num_particles_local = factory.GetObjectStorageVal<vmg_int>("PARTICLE_NUM_LOCAL");
-  const vmg_float* p = factory.GetObjectStorageArray<vmg_float>("PARTICLE_POTENTIAL_ARRAY");
-  const vmg_float* f = factory.GetObjectStorageArray<vmg_float>("PARTICLE_FIELD_ARRAY");
+  const vmg_float* p_local = factory.GetObjectStorageArray<vmg_float>("PARTICLE_POTENTIAL_ARRAY");
 
 
   e_long = comm.GlobalSumRoot(e_long);
@@ -241,7 +293,7 @@ void InterfaceParticles::ExportSolution(Grid& grid)
   e_self = comm.GlobalSumRoot(e_self);
 
   for (int j=0; j<num_particles_local; ++j)
-    e += 0.5 * p[j] * q[j];
+    e += 0.5 * p_local[j] * q_local[j];
   e = comm.GlobalSumRoot(e);
 
   comm.PrintOnce(Debug, "E_long:         %e", e_long);
@@ -29,12 +29,10 @@
 #ifndef INTERFACE_PARTICLES_HPP
 #define INTERFACE_PARTICLES_HPP
 
-#include <list>
-
 #include "base/defs.hpp"
 #include "base/interface.hpp"
 #include "units/particle/bspline.hpp"
-#include "units/particle/particle.hpp"
+#include "units/particle/particle_storage.hpp"
 
 namespace VMG
 {
@@ -60,7 +58,7 @@ protected:
   Particle::BSpline spl;
 
 private:
-  std::list<Particle::Particle> particles;
+  Particle::ParticleStorage particles;
 };
 
 }
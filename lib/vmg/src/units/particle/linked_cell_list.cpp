@@ -29,17 +29,17 @@
 #include <config.h>
 #endif
 
+#include "base/vector.hpp"
 #include "comm/comm.hpp"
 #include "units/particle/linked_cell_list.hpp"
 #include "mg.hpp"
 
 using namespace VMG;
 
-Particle::LinkedCellList::LinkedCellList(std::list<Particle>& particles,
-					 const int& near_field_cells, const Grid& grid)
+Particle::LinkedCellList::LinkedCellList(ParticleStorage& particles_,
+					 const int& near_field_cells, const Grid& grid) :
+  particles(particles_)
 {
-  std::list<Particle>::iterator iter;
-  Index index_global, index_local;
   LocalIndices local = grid.Local();
 
   local.BoundaryBegin1() = 0;
@@ -82,22 +82,41 @@ Particle::LinkedCellList::LinkedCellList(std::list<Particle>& particles,
 
   SetGridSize(grid.Global(), local, grid.Extent());
 
-  for (iter=particles.begin(); iter!=particles.end(); ++iter)
-    AddParticle(&(*iter));
+  SetRanges();
 }
 
 Particle::LinkedCellList::~LinkedCellList()
 {
-  ClearHalo();
 }
 
-void Particle::LinkedCellList::AddParticle(Particle* p)
+void Particle::LinkedCellList::SetRanges()
 {
-  const Index global_index = (p->Pos() - Extent().Begin()) / Extent().MeshWidth();
-  const Index local_index = global_index - Global().LocalBegin() + Local().Begin();
-
-  assert(local_index.IsInBounds(Local().Begin(), Local().End()));
-  (*this)(local_index).push_back(p);
+  Index i;
+
+  /*
+   * The local particles are sorted by the local cells of the grid,
+   * the ghost particles by all cells of the linked cell list.
+   */
+  for (i.X()=0; i.X()<Local().SizeTotal().X(); ++i.X())
+    for (i.Y()=0; i.Y()<Local().SizeTotal().Y(); ++i.Y())
+      for (i.Z()=0; i.Z()<Local().SizeTotal().Z(); ++i.Z()) {
+
+	ParticleRange& range = (*this)(i);
+
+	if (i.IsInBounds(Local().Begin(), Local().End())) {
+	  const Index l = i - Local().Begin();
+	  const vmg_int cell = l.Z() + Local().Size().Z() * (l.Y() + Local().Size().Y() * l.X());
+	  range.storage = &particles;
+	  range.begin = particles.CellBegin(cell);
+	  range.end = particles.CellEnd(cell);
+	}else {
+	  const vmg_int cell = i.Z() + Local().SizeTotal().Z() * (i.Y() + Local().SizeTotal().Y() * i.X());
+	  range.storage = &ghosts;
+	  range.begin = (ghosts.Size() > 0) ? ghosts.CellBegin(cell) : 0;
+	  range.end = (ghosts.Size() > 0) ? ghosts.CellEnd(cell) : 0;
+	}
+
+      }
 }
 
 void Particle::LinkedCellList::AddParticleToHalo(const vmg_float* x, const vmg_float& q)
@@ -113,23 +132,17 @@ void Particle::LinkedCellList::AddParticleToHalo(const vmg_float* x, const vmg_f
 	 (local_index[1] >= Local().HaloBegin2()[1] && local_index[1] < Local().HaloEnd2()[1]) ||
 	 (local_index[2] >= Local().HaloBegin2()[2] && local_index[2] < Local().HaloEnd2()[2]));
 
-  (*this)(local_index).push_back(new Particle(x, q));
+  ghosts.Add(x, q, -1, -1, local_index.Z() + Local().SizeTotal().Z() * (local_index.Y() + Local().SizeTotal().Y() * local_index.X()));
 }
 
-void Particle::LinkedCellList::ClearHalo()
+void Particle::LinkedCellList::SortHalo()
 {
-  Grid::iterator g_iter;
-  std::list<Particle*>::iterator p_iter;
-
-  for (int i=0; i<3; ++i) {
-
-    for (g_iter = Iterators().Halo1()[i].Begin(); g_iter != Iterators().Halo1()[i].End(); ++g_iter)
-      for (p_iter = (*this)(*g_iter).begin(); p_iter!=(*this)(*g_iter).end(); ++p_iter)
-	delete *p_iter;
-
-    for (g_iter = Iterators().Halo2()[i].Begin(); g_iter != Iterators().Halo2()[i].End(); ++g_iter)
-      for (p_iter = (*this)(*g_iter).begin(); p_iter!=(*this)(*g_iter).end(); ++p_iter)
-	delete *p_iter;
+  ghosts.SortByCell(Local().SizeTotal().Product());
+  SetRanges();
+}
 
-  }
+void Particle::LinkedCellList::ClearHalo()
+{
+  ghosts.Clear();
+  SetRanges();
 }
@@ -28,12 +28,11 @@
 #ifndef LINKED_CELL_LIST_HPP_
 #define LINKED_CELL_LIST_HPP_
 
-#include <list>
 #include <vector>
 
 #include "base/index.hpp"
 #include "grid/is_grid.hpp"
-#include "units/particle/particle.hpp"
+#include "units/particle/particle_storage.hpp"
 
 namespace VMG
 {
@@ -41,26 +40,45 @@ namespace VMG
 namespace Particle
 {
 
-class LinkedCellList : public IsGrid< std::list<Particle*> >
+/**
+ * Range of particles of a cell in a particle storage.
+ */
+struct ParticleRange
 {
-public:
-  typedef std::list<Particle*>::iterator iterator;
-  typedef std::list<Particle*>::const_iterator const_iterator;
-  typedef std::list<Particle*>::reverse_iterator reverse_iterator;
-  typedef std::list<Particle*>::const_reverse_iterator const_reverse_iterator;
+  ParticleRange() :
+    storage(NULL),
+    begin(0),
+    end(0)
+  {}
+
+  ParticleStorage* storage;
+  vmg_int begin, end;
+};
 
-  LinkedCellList(std::list<Particle>& particles,
+/**
+ * Linked cell list on top of particle storages that are sorted
+ * by cells. The local cells refer to the local particles, the
+ * halo cells refer to an internal storage of ghost particles.
+ */
+class LinkedCellList : public IsGrid<ParticleRange>
+{
+public:
+  LinkedCellList(ParticleStorage& particles,
 		 const int& near_field_cells, const Grid& grid);
 
   ~LinkedCellList();
 
-  void AddParticle(Particle* particle);
   void AddParticleToHalo(const vmg_float* x, const vmg_float& q);
+  void SortHalo();
 
   void ClearHalo();
 
   const Index& NearFieldCells() const {return near_field_cells_;}
 private:
+  void SetRanges();
+
+  ParticleStorage& particles;
+  ParticleStorage ghosts;
   Index near_field_cells_;
 };
 
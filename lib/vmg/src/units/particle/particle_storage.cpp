@@ -0,0 +1,102 @@
+/*
+ *    vmg - a versatile multigrid solver
+ *    Copyright (C) 2012 Institute for Numerical Simulation, University of Bonn
+ *
+ *  vmg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  vmg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   particle_storage.cpp
+ *
+ * @brief  Contiguous structure-of-arrays storage of particles
+ *         that can be sorted by grid cells.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "units/particle/particle_storage.hpp"
+
+using namespace VMG;
+
+void Particle::ParticleStorage::Clear()
+{
+  for (int i=0; i<3; ++i) {
+    pos[i].clear();
+    field[i].clear();
+  }
+  charge.clear();
+  pot.clear();
+  rank_.clear();
+  index_.clear();
+  cell_.clear();
+  cell_begin.clear();
+}
+
+void Particle::ParticleStorage::Reserve(const vmg_int& num_particles)
+{
+  for (int i=0; i<3; ++i)
+    pos[i].reserve(num_particles);
+  charge.reserve(num_particles);
+  rank_.reserve(num_particles);
+  index_.reserve(num_particles);
+  cell_.reserve(num_particles);
+}
+
+template <class T>
+static void Permute(std::vector<T>& vec, const std::vector<vmg_int>& perm, std::vector<T>& temp)
+{
+  temp.resize(vec.size());
+  for (unsigned int i=0; i<vec.size(); ++i)
+    temp[perm[i]] = vec[i];
+  vec.swap(temp);
+}
+
+void Particle::ParticleStorage::SortByCell(const vmg_int& num_cells)
+{
+  const vmg_int num_particles = Size();
+  std::vector<vmg_int> perm(num_particles);
+  std::vector<vmg_float> temp_float;
+  std::vector<vmg_int> temp_int;
+  std::vector<int> temp_rank;
+
+  /*
+   * Counting sort by cell
+   */
+  cell_begin.assign(num_cells+1, 0);
+
+  for (vmg_int i=0; i<num_particles; ++i)
+    ++cell_begin[cell_[i]+1];
+
+  for (vmg_int c=0; c<num_cells; ++c)
+    cell_begin[c+1] += cell_begin[c];
+
+  std::vector<vmg_int> next(cell_begin.begin(), cell_begin.end()-1);
+
+  for (vmg_int i=0; i<num_particles; ++i)
+    perm[i] = next[cell_[i]]++;
+
+  for (int i=0; i<3; ++i)
+    Permute(pos[i], perm, temp_float);
+  Permute(charge, perm, temp_float);
+  Permute(rank_, perm, temp_rank);
+  Permute(index_, perm, temp_int);
+  Permute(cell_, perm, temp_int);
+
+  pot.assign(num_particles, 0.0);
+  for (int i=0; i<3; ++i)
+    field[i].assign(num_particles, 0.0);
+}
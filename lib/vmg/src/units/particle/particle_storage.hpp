@@ -0,0 +1,108 @@
+/*
+ *    vmg - a versatile multigrid solver
+ *    Copyright (C) 2012 Institute for Numerical Simulation, University of Bonn
+ *
+ *  vmg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  vmg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   particle_storage.hpp
+ *
+ * @brief  Contiguous structure-of-arrays storage of particles
+ *         that can be sorted by grid cells.
+ *
+ */
+
+#ifndef PARTICLE_STORAGE_HPP_
+#define PARTICLE_STORAGE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "base/defs.hpp"
+
+namespace VMG
+{
+
+namespace Particle
+{
+
+class ParticleStorage
+{
+public:
+  ParticleStorage() {}
+
+  void Clear();
+  void Reserve(const vmg_int& num_particles);
+
+  /**
+   * Appends a particle. The cell is the key for SortByCell
+   * and has to be in [0, num_cells).
+   */
+  void Add(const vmg_float* x, const vmg_float& q, const int& rank, const vmg_int& index, const vmg_int& cell)
+  {
+    pos[0].push_back(x[0]);
+    pos[1].push_back(x[1]);
+    pos[2].push_back(x[2]);
+    charge.push_back(q);
+    rank_.push_back(rank);
+    index_.push_back(index);
+    cell_.push_back(cell);
+  }
+
+  /**
+   * Sorts all particles by their cells (stable) and sets up
+   * the ranges of particles of each cell. Potentials and
+   * fields are reset to zero.
+   */
+  void SortByCell(const vmg_int& num_cells);
+
+  vmg_int Size() const {return charge.size();}
+
+  vmg_float* Pos(const int& dim) {return Data(pos[dim]);}
+  const vmg_float* Pos(const int& dim) const {return Data(pos[dim]);}
+
+  vmg_float* Charge() {return Data(charge);}
+  const vmg_float* Charge() const {return Data(charge);}
+
+  vmg_float* Pot() {return Data(pot);}
+  const vmg_float* Pot() const {return Data(pot);}
+
+  vmg_float* Field(const int& dim) {return Data(field[dim]);}
+  const vmg_float* Field(const int& dim) const {return Data(field[dim]);}
+
+  const int* Rank() const {return Data(rank_);}
+  const vmg_int* Index() const {return Data(index_);}
+
+  vmg_int CellBegin(const vmg_int& cell) const {return cell_begin[cell];}
+  vmg_int CellEnd(const vmg_int& cell) const {return cell_begin[cell+1];}
+
+private:
+  template <class T>
+  static T* Data(std::vector<T>& vec) {return vec.empty() ? NULL : &vec[0];}
+  template <class T>
+  static const T* Data(const std::vector<T>& vec) {return vec.empty() ? NULL : &vec[0];}
+
+  std::vector<vmg_float> pos[3], field[3];
+  std::vector<vmg_float> charge, pot;
+  std::vector<int> rank_;
+  std::vector<vmg_int> index_, cell_;
+  std::vector<vmg_int> cell_begin;
+};
+
+}
+
+}
+
+#endif /* PARTICLE_STORAGE_HPP_ */
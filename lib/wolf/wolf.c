@@ -376,3 +376,9 @@ void ifcs_wolf_resort_bytes(ifcs_wolf_t *wolf, void *src, void *dst, fcs_int n,
   
   fcs_near_resort_bytes(wolf->near_resort, src, dst, n, comm);
 }
+
+
+void ifcs_wolf_get_resort_object(ifcs_wolf_t *wolf, fcs_resort_t *resort)
+{
+  *resort = wolf->near_resort;
+}
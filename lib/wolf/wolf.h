@@ -66,6 +66,7 @@ void ifcs_wolf_run(ifcs_wolf_t *wolf, MPI_Comm comm);
 void ifcs_wolf_resort_ints(ifcs_wolf_t *wolf, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm);
 void ifcs_wolf_resort_floats(ifcs_wolf_t *wolf, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm);
 void ifcs_wolf_resort_bytes(ifcs_wolf_t *wolf, void *src, void *dst, fcs_int n, MPI_Comm comm);
+void ifcs_wolf_get_resort_object(ifcs_wolf_t *wolf, fcs_resort_t *resort);
 
 
 #ifdef __cplusplus
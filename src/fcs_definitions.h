@@ -147,4 +147,28 @@ typedef fcs_int fcs_bool;
 #define FCS_TOLERANCE_TYPE_FIELD_REL      6
 
 
+/**
+ * @brief definitions of the phases of a run (see fcs_get_timings)
+ */
+#define FCS_PHASE_TOTAL        0
+#define FCS_PHASE_SORT         1
+#define FCS_PHASE_GHOSTS       2
+#define FCS_PHASE_NEAR         3
+#define FCS_PHASE_SPREAD       4
+#define FCS_PHASE_FFT          5
+#define FCS_PHASE_SOLVE        6
+#define FCS_PHASE_INTERPOLATE  7
+#define FCS_PHASE_BACK_SORT    8
+#define FCS_NUM_PHASES         9
+
+
+/**
+ * @brief definitions of the counters of a run (see fcs_get_counters)
+ */
+#define FCS_COUNTER_NEAR_PAIRS       0
+#define FCS_COUNTER_COMM_BYTES       1
+#define FCS_COUNTER_GHOST_PARTICLES  2
+#define FCS_NUM_COUNTERS             3
+
+
 #endif
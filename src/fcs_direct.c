@@ -74,6 +74,8 @@ FCSResult fcs_direct_init(FCS handle)
 
   fcs_direct_set_cutoff_with_near(handle, FCS_FALSE);
 
+  fcs_direct_set_half_ring(handle, FCS_TRUE);
+
   fcs_direct_set_metallic_boundary_conditions(handle, FCS_TRUE);
 
   handle->shift_positions = 0;
@@ -94,6 +96,7 @@ FCSResult fcs_direct_init(FCS handle)
   handle->resort_ints = fcs_direct_resort_ints;
   handle->resort_floats = fcs_direct_resort_floats;
   handle->resort_bytes = fcs_direct_resort_bytes;
+  handle->get_resort_object = fcs_direct_get_resort_object;
 
   FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
 
@@ -212,6 +215,7 @@ FCSResult fcs_direct_set_parameter(FCS handle, fcs_bool continue_on_errors, char
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("direct_cutoff_with_near",             direct_set_cutoff_with_near,             FCS_PARSE_VAL(fcs_bool));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("direct_metallic_boundary_conditions", direct_set_metallic_boundary_conditions, FCS_PARSE_VAL(fcs_bool));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("direct_periodic_images",              direct_set_periodic_images,              FCS_PARSE_SEQ(fcs_int, 3));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("direct_half_ring",                    direct_set_half_ring,                    FCS_PARSE_VAL(fcs_bool));
 
   return FCS_RESULT_SUCCESS;
 
@@ -228,7 +232,7 @@ next_param:
 FCSResult fcs_direct_print_parameters(FCS handle)
 {
   fcs_float cutoff;
-  fcs_bool cutoff_with_near, metallic_boundary_conditions;
+  fcs_bool cutoff_with_near, metallic_boundary_conditions, half_ring;
   fcs_int images[3];
   FCSResult result;
 
@@ -258,6 +262,14 @@ FCSResult fcs_direct_print_parameters(FCS handle)
     fcs_result_destroy(result);
   } else printf("direct metallic boundary conditions: %s\n", FCS_IS_TRUE(metallic_boundary_conditions)?"yes":"no");
 
+  result = fcs_direct_get_half_ring(handle, &half_ring);
+  if (result != FCS_RESULT_SUCCESS)
+  {
+    printf("direct half ring: FAILED!");
+    fcs_result_print_result(result);
+    fcs_result_destroy(result);
+  } else printf("direct half ring: %s\n", FCS_IS_TRUE(half_ring)?"yes":"no");
+
   result = fcs_direct_get_periodic_images(handle, images);
   if (result != FCS_RESULT_SUCCESS)
   {
@@ -359,6 +371,37 @@ FCSResult fcs_direct_get_cutoff_with_near(FCS handle, fcs_bool *cutoff_with_near
 }
 
 
+FCSResult fcs_direct_set_half_ring(FCS handle, fcs_bool half_ring)
+{
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  DIRECT_CHECK_RETURN_RESULT(handle, __func__);
+
+  fcs_directc_set_half_ring(&handle->direct_param->directc, FCS_IS_TRUE(half_ring));
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+
+FCSResult fcs_direct_get_half_ring(FCS handle, fcs_bool *half_ring)
+{
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  DIRECT_CHECK_RETURN_RESULT(handle, __func__);
+
+  fcs_int i;
+  fcs_directc_get_half_ring(&handle->direct_param->directc, &i);
+
+  *half_ring = (i)?FCS_TRUE:FCS_FALSE;
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+
 FCSResult fcs_direct_set_metallic_boundary_conditions(FCS handle, fcs_bool metallic_boundary_conditions)
 {
   FCS_DEBUG_FUNC_INTRO(__func__);
@@ -541,6 +584,20 @@ FCSResult fcs_direct_resort_bytes(FCS handle, void *src, void *dst, fcs_int n, M
 }
 
 
+FCSResult fcs_direct_get_resort_object(FCS handle, fcs_resort_t *resort)
+{
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  DIRECT_CHECK_RETURN_RESULT(handle, __func__);
+
+  fcs_directc_get_resort_object(&handle->direct_param->directc, resort);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+  
+  return FCS_RESULT_SUCCESS;
+}
+
+
 FCSResult fcs_direct_setup(FCS handle, fcs_float cutoff)
 {
   FCSResult result;
@@ -76,6 +76,25 @@ FCSResult fcs_direct_set_cutoff_with_near(FCS handle, fcs_bool cutoff_with_near)
 FCSResult fcs_direct_get_cutoff_with_near(FCS handle, fcs_bool *cutoff_with_near);
 
 
+/**
+ * @brief function to set whether the direct solver passes the particles only around half of the ring of processes
+ * and computes the interactions between the particles of two processes only once (using symmetry)
+ * @param handle FCS-object
+ * @param half_ring fcs_bool if true, then the half ring is used (default)
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_direct_set_half_ring(FCS handle, fcs_bool half_ring);
+
+
+/**
+ * @brief function to get whether the direct solver passes the particles only around half of the ring of processes
+ * @param handle FCS-object
+ * @param half_ring fcs_bool whether the half ring is used
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_direct_get_half_ring(FCS handle, fcs_bool *half_ring);
+
+
 /**
  * @brief function to set whether the direct solver should use metallic boundary conditions for periodic systems
  * @param handle FCS-object
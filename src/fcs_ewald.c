@@ -99,6 +99,8 @@ FCSResult fcs_ewald_init(FCS handle)
   d->r_cut = 0.0;
   d->kmax = 0;
   d->maxkmax = MAXKMAX_DEFAULT;
+  d->distributed_kspace = 1;
+  d->balance_near = 0;
   /* d->alpha = 1.0; */
   /* d->r_cut = 3.0; */
   /* d->kmax = 40; */
@@ -161,6 +163,34 @@ FCSResult fcs_ewald_get_maxkmax(FCS handle, fcs_int *maxkmax)
   return FCS_RESULT_SUCCESS;
 }
 
+FCSResult fcs_ewald_set_distributed_kspace(FCS handle, fcs_int distributed_kspace)
+{
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  EWALD_CHECK_RETURN_RESULT(handle, __func__);
+  
+  ewald_data_struct *d = (ewald_data_struct*)handle->method_context;
+  d->distributed_kspace = distributed_kspace;
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_ewald_get_distributed_kspace(FCS handle, fcs_int *distributed_kspace)
+{
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  EWALD_CHECK_RETURN_RESULT(handle, __func__);
+
+  ewald_data_struct *d = (ewald_data_struct*)handle->method_context;
+  *distributed_kspace = d->distributed_kspace;
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
 FCSResult fcs_ewald_set_kmax(FCS handle, fcs_int kmax)
 {
   FCS_DEBUG_FUNC_INTRO(__func__);
@@ -206,6 +236,34 @@ FCSResult fcs_ewald_get_kmax(FCS handle, fcs_int *kmax)
   return FCS_RESULT_SUCCESS;
 }
 
+FCSResult fcs_ewald_set_balance_near(FCS handle, fcs_int balance_near)
+{
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  EWALD_CHECK_RETURN_RESULT(handle, __func__);
+  
+  ewald_data_struct *d = (ewald_data_struct*)handle->method_context;
+  d->balance_near = balance_near;
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_ewald_get_balance_near(FCS handle, fcs_int *balance_near)
+{
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  EWALD_CHECK_RETURN_RESULT(handle, __func__);
+
+  ewald_data_struct *d = (ewald_data_struct*)handle->method_context;
+  *balance_near = d->balance_near;
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
 FCSResult fcs_ewald_set_r_cut(FCS handle, fcs_float r_cut)
 {
   FCS_DEBUG_FUNC_INTRO(__func__);
@@ -720,6 +778,8 @@ FCSResult fcs_ewald_set_parameter(FCS handle, fcs_bool continue_on_errors, char
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("ewald_kmax",    ewald_set_kmax,    FCS_PARSE_VAL(fcs_int));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("ewald_r_cut",   ewald_set_r_cut,   FCS_PARSE_VAL(fcs_float));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("ewald_alpha",   ewald_set_alpha,   FCS_PARSE_VAL(fcs_float));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("ewald_distributed_kspace", ewald_set_distributed_kspace, FCS_PARSE_VAL(fcs_int));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("ewald_balance_near", ewald_set_balance_near, FCS_PARSE_VAL(fcs_int));
 
   return FCS_RESULT_SUCCESS;
 
@@ -766,6 +826,9 @@ FCSResult fcs_ewald_print_parameters(FCS handle)
   else
     printf("ewald alpha=%" FCS_LMOD_FLOAT "f\n", d->alpha);
 
+  printf("ewald distributed_kspace=%" FCS_LMOD_INT "d\n", d->distributed_kspace);
+  printf("ewald balance_near=%" FCS_LMOD_INT "d\n", d->balance_near);
+
   FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
 
   return FCS_RESULT_SUCCESS;
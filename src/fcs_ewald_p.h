@@ -38,6 +38,12 @@ FCSResult fcs_ewald_set_maxkmax(FCS handle, fcs_int maxkmax);
 FCSResult fcs_ewald_set_maxkmax_tune(FCS handle);
 FCSResult fcs_ewald_get_maxkmax(FCS handle, fcs_int *maxkmax);
 
+FCSResult fcs_ewald_set_distributed_kspace(FCS handle, fcs_int distributed_kspace);
+FCSResult fcs_ewald_get_distributed_kspace(FCS handle, fcs_int *distributed_kspace);
+
+FCSResult fcs_ewald_set_balance_near(FCS handle, fcs_int balance_near);
+FCSResult fcs_ewald_get_balance_near(FCS handle, fcs_int *balance_near);
+
 FCSResult fcs_ewald_set_r_cut(FCS handle, fcs_float r_cut);
 FCSResult fcs_ewald_set_r_cut_tune(FCS handle);
 FCSResult fcs_ewald_get_r_cut(FCS handle, fcs_float *r_cut);
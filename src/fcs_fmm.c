@@ -329,6 +329,7 @@ FCSResult fcs_fmm_init(FCS handle)
   handle->resort_ints = fcs_fmm_resort_ints;
   handle->resort_floats = fcs_fmm_resort_floats;
   handle->resort_bytes = fcs_fmm_resort_bytes;
+  handle->get_resort_object = fcs_fmm_get_resort_object;
 
   return FCS_RESULT_SUCCESS;
 }
@@ -1025,3 +1026,13 @@ FCSResult fcs_fmm_resort_bytes(FCS handle, void *src, void *dst, fcs_int n, MPI_
   
   return FCS_RESULT_SUCCESS;
 }
+
+
+FCSResult fcs_fmm_get_resort_object(FCS handle, fcs_resort_t *resort)
+{
+  FMM_CHECK_RETURN_RESULT(handle, __func__);
+
+  *resort = (handle->fmm_param->fmm_resort != FCS_FMM_RESORT_NULL)?handle->fmm_param->fmm_resort->resort:FCS_RESORT_NULL;
+
+  return FCS_RESULT_SUCCESS;
+}
@@ -183,6 +183,20 @@ FCSResult fcs_init(FCS *new_handle, const char* method_name, MPI_Comm communicat
   handle->resort_ints = NULL;
   handle->resort_floats = NULL;
   handle->resort_bytes = NULL;
+  handle->get_resort_object = NULL;
+
+  fcs_timing_create(&handle->timing);
+
+  /* the trace can also be enabled without changing the application */
+  if (getenv("FCS_TRACE")) fcs_timing_set_trace(&handle->timing, getenv("FCS_TRACE"));
+
+  handle->tuning_db = NULL;
+  handle->tuning_db_retune = 0;
+
+  handle->resort_plan = FCS_RESORT_PLAN_NULL;
+
+  /* the same applies to the tuning database */
+  if (getenv("FCS_TUNING_DB")) fcs_set_tuning_db(handle, getenv("FCS_TUNING_DB"));
 
   *new_handle = handle;
 
@@ -251,6 +265,12 @@ FCSResult fcs_destroy(FCS handle)
     if (result != FCS_RESULT_SUCCESS) return result;
   }
 
+  fcs_timing_destroy(&handle->timing);
+
+  if (handle->tuning_db) free(handle->tuning_db);
+
+  fcs_resort_plan_destroy(&handle->resort_plan);
+
   free(handle);
 
   return FCS_RESULT_SUCCESS;
@@ -778,6 +798,9 @@ FCSResult fcs_set_parameters(FCS handle, const char *parameters, fcs_bool contin
     FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("total_particles",         set_total_particles, FCS_PARSE_VAL(fcs_int));
     FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("r_cut",                   set_r_cut,           FCS_PARSE_VAL(fcs_float));
     FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("require_virial",          set_compute_virial,  FCS_PARSE_VAL(fcs_int));
+    FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("trace",                   set_trace,           FCS_PARSE_VAL(fcs_p_char_t));
+    FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("tuning_db",               set_tuning_db,       FCS_PARSE_VAL(fcs_p_char_t));
+    FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("tuning_db_retune",        set_tuning_db_retune, FCS_PARSE_VAL(fcs_int));
     FCS_PARSE_IF_PARAM_THEN_FUNC2_GOTO_NEXT("",                        set_tolerance,       FCS_PARSE_VAL(fcs_int),                                     FCS_PARSE_VAL(fcs_float));
     FCS_PARSE_IF_PARAM_THEN_FUNC2_GOTO_NEXT("tolerance_energy",        set_tolerance,       FCS_PARSE_CONST(fcs_int, FCS_TOLERANCE_TYPE_ENERGY),        FCS_PARSE_VAL(fcs_float));
     FCS_PARSE_IF_PARAM_THEN_FUNC2_GOTO_NEXT("tolerance_energy_rel",    set_tolerance,       FCS_PARSE_CONST(fcs_int, FCS_TOLERANCE_TYPE_ENERGY_REL),    FCS_PARSE_VAL(fcs_float));
@@ -929,6 +952,10 @@ FCSResult fcs_run(FCS handle, fcs_int local_particles,
   if (handle->run == NULL)
     return fcs_result_create(FCS_ERROR_NOT_IMPLEMENTED, __func__, "Running solver method '%s' not implemented", fcs_get_method_name(handle));
 
+  fcs_timing_begin(&handle->timing);
+
+  double timing_total = fcs_timing_start();
+
   fcs_float original_box_origin[3] = { handle->box_origin[0], handle->box_origin[1], handle->box_origin[2] };
 
   if (handle->shift_positions)
@@ -964,10 +991,135 @@ FCSResult fcs_run(FCS handle, fcs_int local_particles,
     handle->box_origin[2] = original_box_origin[2];
   }
 
+  fcs_timing_stop(FCS_PHASE_TOTAL, timing_total);
+
+  fcs_timing_end(&handle->timing, handle->communicator);
+
   return result;
 }
 
 
+/**
+ * return the timings of the phases of the last run
+ */
+FCSResult fcs_get_timings(FCS handle, fcs_float *timings)
+{
+  fcs_int i;
+
+  CHECK_HANDLE_RETURN_RESULT(handle, __func__);
+
+  if (timings == NULL)
+    return fcs_result_create(FCS_ERROR_NULL_ARGUMENT, __func__, "null pointer supplied as timings");
+
+  for (i = 0; i < FCS_NUM_PHASES; ++i) timings[i] = handle->timing.timings[i];
+
+  return FCS_RESULT_SUCCESS;
+}
+
+
+/**
+ * return the counters of the last run
+ */
+FCSResult fcs_get_counters(FCS handle, long long *counters)
+{
+  fcs_int i;
+
+  CHECK_HANDLE_RETURN_RESULT(handle, __func__);
+
+  if (counters == NULL)
+    return fcs_result_create(FCS_ERROR_NULL_ARGUMENT, __func__, "null pointer supplied as counters");
+
+  for (i = 0; i < FCS_NUM_COUNTERS; ++i) counters[i] = handle->timing.counters[i];
+
+  return FCS_RESULT_SUCCESS;
+}
+
+
+/**
+ * return the name of a phase
+ */
+const char *fcs_get_phase_name(fcs_int phase)
+{
+  return fcs_timing_phase_name(phase);
+}
+
+
+/**
+ * return the name of a counter
+ */
+const char *fcs_get_counter_name(fcs_int counter)
+{
+  return fcs_timing_counter_name(counter);
+}
+
+
+/**
+ * enable or disable the trace of the runs
+ */
+FCSResult fcs_set_trace(FCS handle, const char *filename)
+{
+  CHECK_HANDLE_RETURN_RESULT(handle, __func__);
+
+  fcs_timing_set_trace(&handle->timing, filename);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+
+/**
+ * enable or disable the tuning database
+ */
+FCSResult fcs_set_tuning_db(FCS handle, const char *filename)
+{
+  CHECK_HANDLE_RETURN_RESULT(handle, __func__);
+
+  if (handle->tuning_db) free(handle->tuning_db);
+  handle->tuning_db = NULL;
+
+  if (filename == NULL || filename[0] == '\0') return FCS_RESULT_SUCCESS;
+
+  handle->tuning_db = malloc(strlen(filename) + 1);
+  strcpy(handle->tuning_db, filename);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+
+/**
+ * return the file of the tuning database
+ */
+const char *fcs_get_tuning_db(FCS handle)
+{
+  CHECK_HANDLE_RETURN_VAL(handle, __func__, NULL);
+
+  return handle->tuning_db;
+}
+
+
+/**
+ * set whether existing entries of the tuning database are ignored
+ */
+FCSResult fcs_set_tuning_db_retune(FCS handle, fcs_int retune)
+{
+  CHECK_HANDLE_RETURN_RESULT(handle, __func__);
+
+  handle->tuning_db_retune = retune;
+
+  return FCS_RESULT_SUCCESS;
+}
+
+
+/**
+ * return whether existing entries of the tuning database are ignored
+ */
+fcs_int fcs_get_tuning_db_retune(FCS handle)
+{
+  CHECK_HANDLE_RETURN_VAL(handle, __func__, -1);
+
+  return handle->tuning_db_retune;
+}
+
+
 /**
  * compute the correction to the field and total energy 
  */
@@ -1269,12 +1421,21 @@ FCSResult fcs_get_resort_particles(FCS handle, fcs_int *resort_particles)
  */
 FCSResult fcs_resort_ints(FCS handle, fcs_int *src, fcs_int *dst, fcs_int n)
 {
+  FCSResult result;
+
   CHECK_HANDLE_RETURN_RESULT(handle, __func__);
 
   if (handle->resort_ints == NULL)
     return fcs_result_create(FCS_ERROR_INCOMPATIBLE_METHOD, __func__, "resorting not supported");
 
-  return handle->resort_ints(handle, src, dst, n, fcs_get_communicator(handle));
+  /* the resorting belongs to the last run */
+  fcs_timing_resume(&handle->timing);
+
+  result = handle->resort_ints(handle, src, dst, n, fcs_get_communicator(handle));
+
+  fcs_timing_end(&handle->timing, handle->communicator);
+
+  return result;
 }
 
 
@@ -1283,12 +1444,21 @@ FCSResult fcs_resort_ints(FCS handle, fcs_int *src, fcs_int *dst, fcs_int n)
  */
 FCSResult fcs_resort_floats(FCS handle, fcs_float *src, fcs_float *dst, fcs_int n)
 {
+  FCSResult result;
+
   CHECK_HANDLE_RETURN_RESULT(handle, __func__);
 
   if (handle->resort_floats == NULL)
     return fcs_result_create(FCS_ERROR_INCOMPATIBLE_METHOD, __func__, "resorting not supported");
 
-  return handle->resort_floats(handle, src, dst, n, fcs_get_communicator(handle));
+  /* the resorting belongs to the last run */
+  fcs_timing_resume(&handle->timing);
+
+  result = handle->resort_floats(handle, src, dst, n, fcs_get_communicator(handle));
+
+  fcs_timing_end(&handle->timing, handle->communicator);
+
+  return result;
 }
 
 
@@ -1297,12 +1467,116 @@ FCSResult fcs_resort_floats(FCS handle, fcs_float *src, fcs_float *dst, fcs_int
  */
 FCSResult fcs_resort_bytes(FCS handle, void *src, void *dst, fcs_int n)
 {
+  FCSResult result;
+
   CHECK_HANDLE_RETURN_RESULT(handle, __func__);
 
   if (handle->resort_bytes == NULL)
     return fcs_result_create(FCS_ERROR_INCOMPATIBLE_METHOD, __func__, "resorting not supported");
 
-  return handle->resort_bytes(handle, src, dst, n, fcs_get_communicator(handle));
+  /* the resorting belongs to the last run */
+  fcs_timing_resume(&handle->timing);
+
+  result = handle->resort_bytes(handle, src, dst, n, fcs_get_communicator(handle));
+
+  fcs_timing_end(&handle->timing, handle->communicator);
+
+  return result;
+}
+
+
+static FCSResult resort_add(FCS handle, const char *func, void *src, void *dst, fcs_int n, fcs_int type)
+{
+  CHECK_HANDLE_RETURN_RESULT(handle, func);
+
+  if (handle->get_resort_object == NULL)
+    return fcs_result_create(FCS_ERROR_INCOMPATIBLE_METHOD, func, "resorting not supported");
+
+  /* the resort object is set when the plan is executed */
+  if (handle->resort_plan == FCS_RESORT_PLAN_NULL) fcs_resort_plan_create(&handle->resort_plan, FCS_RESORT_NULL);
+
+  switch (type)
+  {
+    case 0: fcs_resort_plan_add_ints(handle->resort_plan, src, dst, n); break;
+    case 1: fcs_resort_plan_add_floats(handle->resort_plan, src, dst, n); break;
+    case 2: fcs_resort_plan_add_bytes(handle->resort_plan, src, dst, n); break;
+  }
+
+  return FCS_RESULT_SUCCESS;
+}
+
+
+/**
+ * add integer particle data to the arrays sorted by fcs_resort_execute
+ */
+FCSResult fcs_resort_add_ints(FCS handle, fcs_int *src, fcs_int *dst, fcs_int n)
+{
+  return resort_add(handle, __func__, src, dst, n, 0);
+}
+
+
+/**
+ * add float particle data to the arrays sorted by fcs_resort_execute
+ */
+FCSResult fcs_resort_add_floats(FCS handle, fcs_float *src, fcs_float *dst, fcs_int n)
+{
+  return resort_add(handle, __func__, src, dst, n, 1);
+}
+
+
+/**
+ * add byte particle data to the arrays sorted by fcs_resort_execute
+ */
+FCSResult fcs_resort_add_bytes(FCS handle, void *src, void *dst, fcs_int n)
+{
+  return resort_add(handle, __func__, src, dst, n, 2);
+}
+
+
+/**
+ * sort all added particle data with a single exchange
+ */
+FCSResult fcs_resort_execute(FCS handle)
+{
+  FCSResult result;
+  fcs_resort_t resort;
+
+  CHECK_HANDLE_RETURN_RESULT(handle, __func__);
+
+  if (handle->get_resort_object == NULL)
+    return fcs_result_create(FCS_ERROR_INCOMPATIBLE_METHOD, __func__, "resorting not supported");
+
+  if (handle->resort_plan == FCS_RESORT_PLAN_NULL) return FCS_RESULT_SUCCESS;
+
+  result = handle->get_resort_object(handle, &resort);
+  if (result != FCS_RESULT_SUCCESS) return result;
+
+  if (resort == FCS_RESORT_NULL) return FCS_RESULT_SUCCESS;
+
+  fcs_resort_plan_set_resort(handle->resort_plan, resort);
+
+  /* the resorting belongs to the last run */
+  fcs_timing_resume(&handle->timing);
+
+  if (fcs_resort_plan_execute(handle->resort_plan, fcs_get_communicator(handle)) != 0)
+    result = fcs_result_create(FCS_ERROR_LOGICAL_ERROR, __func__, "resort indices do not match the number of sorted particles");
+
+  fcs_timing_end(&handle->timing, handle->communicator);
+
+  return result;
+}
+
+
+/**
+ * remove all added particle data
+ */
+FCSResult fcs_resort_clear(FCS handle)
+{
+  CHECK_HANDLE_RETURN_RESULT(handle, __func__);
+
+  fcs_resort_plan_destroy(&handle->resort_plan);
+
+  return FCS_RESULT_SUCCESS;
 }
 
 
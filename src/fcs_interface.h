@@ -36,6 +36,8 @@
 
 #include "fcs_interface_p.h"
 #include "fcs_result.h"
+#include "FCSTiming.h"
+#include "common/resort/resort.h"
 
 #ifdef FCS_ENABLE_DIRECT
 #include "fcs_direct.h"
@@ -198,6 +200,16 @@ typedef struct _FCS_t
 
   fcs_int shift_positions;
 
+  /* timings, counters, and trace of the last run */
+  fcs_timing_t timing;
+
+  /* file of the tuning database (NULL if disabled) and whether existing entries are ignored */
+  char *tuning_db;
+  fcs_int tuning_db_retune;
+
+  /* resort plan of the arrays registered with fcs_resort_add_[ints,floats,bytes] */
+  fcs_resort_plan_t resort_plan;
+
   /* functions and parameters set by the solvers */
   FCSResult (*destroy)(FCS handle);
 
@@ -226,6 +238,7 @@ typedef struct _FCS_t
   FCSResult (*resort_ints)(FCS handle, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm);
   FCSResult (*resort_floats)(FCS handle, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm);
   FCSResult (*resort_bytes)(FCS handle, void *src, void *dst, fcs_int n, MPI_Comm comm);
+  FCSResult (*get_resort_object)(FCS handle, fcs_resort_t *resort);
 
 } FCS_t;
 
@@ -341,6 +341,83 @@ FCSResult fcs_tune(FCS handle, fcs_int local_particles,
 FCSResult fcs_run(FCS handle, fcs_int local_particles,
   fcs_float *positions, fcs_float *charges, fcs_float *field, fcs_float *potentials);
 
+/**
+ * @brief function to return the timings of the phases of the last run on the local process
+ * (sort, ghost creation, near field, spread, FFT, solve, interpolate, back sort, see FCS_PHASE_* in fcs_definitions.h),
+ * phases that are not performed by the solver method have the timing 0
+ * @param handle FCS-object representing an FCS solver
+ * @param timings array of FCS_NUM_PHASES values receiving the timings in seconds
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_get_timings(FCS handle, fcs_float *timings);
+
+/**
+ * @brief function to return the counters of the last run on the local process
+ * (near field pairs, communicated bytes, ghost particles, see FCS_COUNTER_* in fcs_definitions.h)
+ * @param handle FCS-object representing an FCS solver
+ * @param counters array of FCS_NUM_COUNTERS values receiving the counters
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_get_counters(FCS handle, long long *counters);
+
+/**
+ * @brief function to return the name of a phase
+ * @param phase phase (see FCS_PHASE_* in fcs_definitions.h)
+ * @return name of the phase, NULL if the phase is unknown
+ */
+const char *fcs_get_phase_name(fcs_int phase);
+
+/**
+ * @brief function to return the name of a counter
+ * @param counter counter (see FCS_COUNTER_* in fcs_definitions.h)
+ * @return name of the counter, NULL if the counter is unknown
+ */
+const char *fcs_get_counter_name(fcs_int counter);
+
+/**
+ * @brief function to enable a trace of the phases of all subsequent runs, each process appends
+ * the start times and durations of the phases and the counters of each run to the file '<filename>.<rank>'
+ * (the trace can also be enabled with the environment variable FCS_TRACE)
+ * @param handle FCS-object representing an FCS solver
+ * @param filename base name of the trace files, NULL disables the trace
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_set_trace(FCS handle, const char *filename);
+
+/**
+ * @brief function to enable a database of tuned parameters, methods that support the database (P2NFFT, P3M)
+ * skip their tuning if the file contains an entry for the current system (method, box, periodicity, number of
+ * particles, sum of the squared charges, tolerance, number of processes) and append the tuned parameters otherwise
+ * (the database can also be enabled with the environment variable FCS_TUNING_DB)
+ * @param handle FCS-object representing an FCS solver
+ * @param filename name of the database file, NULL disables the database
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_set_tuning_db(FCS handle, const char *filename);
+
+/**
+ * @brief function to return the file of the tuning database
+ * @param handle FCS-object representing an FCS solver
+ * @return name of the database file, NULL if the database is disabled
+ */
+const char *fcs_get_tuning_db(FCS handle);
+
+/**
+ * @brief function to set whether existing entries of the tuning database are ignored, i.e., whether the
+ * tuning is forced and its result replaces the existing entry
+ * @param handle FCS-object representing an FCS solver
+ * @param retune whether existing entries are ignored (1) or not (0)
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_set_tuning_db_retune(FCS handle, fcs_int retune);
+
+/**
+ * @brief function to return whether existing entries of the tuning database are ignored
+ * @param handle FCS-object representing an FCS solver
+ * @return whether existing entries are ignored (1) or not (0), -1 if the handle is invalid
+ */
+fcs_int fcs_get_tuning_db_retune(FCS handle);
+
 /**
  * @brief function to compute the correction to the field and total energy when
  * periodic boundary conditions with a finite dielectric constant of
@@ -515,6 +592,52 @@ FCSResult fcs_resort_floats(FCS handle, fcs_float *src, fcs_float *dst, fcs_int
  */
 FCSResult fcs_resort_bytes(FCS handle, void *src, void *dst, fcs_int n);
 
+/**
+ * @brief function to add integer particle data to the arrays that are sorted together by ::fcs_resort_execute,
+ *   the arrays remain added (also for subsequent runs) until ::fcs_resort_clear is called, arrays that are reallocated have to be added again
+ * @param handle FCS-object representing an FCS solver
+ * @param src array of integer values in unsorted (original) order
+ * @param dst array to store the sorted integer values (if NULL, the sorted values are stored in src)
+ * @param n number of integer values for each particle
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_resort_add_ints(FCS handle, fcs_int *src, fcs_int *dst, fcs_int n);
+
+/**
+ * @brief function to add float particle data to the arrays that are sorted together by ::fcs_resort_execute (see ::fcs_resort_add_ints)
+ * @param handle FCS-object representing an FCS solver
+ * @param src array of float values in unsorted (original) order
+ * @param dst array to store the sorted float values (if NULL, the sorted values are stored in src)
+ * @param n number of float values for each particle
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_resort_add_floats(FCS handle, fcs_float *src, fcs_float *dst, fcs_int n);
+
+/**
+ * @brief function to add byte particle data to the arrays that are sorted together by ::fcs_resort_execute (see ::fcs_resort_add_ints)
+ * @param handle FCS-object representing an FCS solver
+ * @param src array of byte values in unsorted (original) order
+ * @param dst array to store the sorted byte values (if NULL, the sorted values are stored in src)
+ * @param n number of byte values for each particle
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_resort_add_bytes(FCS handle, void *src, void *dst, fcs_int n);
+
+/**
+ * @brief function to sort all added particle data into the new sorted particle order with a single exchange
+ *   (instead of one exchange for each call of fcs_resort_[ints,floats,bytes]), can be called after each ::fcs_run
+ * @param handle FCS-object representing an FCS solver
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_resort_execute(FCS handle);
+
+/**
+ * @brief function to remove all particle data added with fcs_resort_add_[ints,floats,bytes]
+ * @param handle FCS-object representing an FCS solver
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_resort_clear(FCS handle);
+
 
 #ifdef FCS_ENABLE_DEPRECATED
 #define fcs_set_dimension    fcs_set_dimensions
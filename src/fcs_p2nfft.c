@@ -112,6 +112,7 @@ FCSResult fcs_p2nfft_init(
   handle->resort_ints = fcs_p2nfft_resort_ints;
   handle->resort_floats = fcs_p2nfft_resort_floats;
   handle->resort_bytes = fcs_p2nfft_resort_bytes;
+  handle->get_resort_object = fcs_p2nfft_get_resort_object;
 
   ifcs_p2nfft_init(&(handle->method_context), handle->communicator);
 
@@ -208,6 +209,9 @@ FCSResult fcs_p2nfft_tune(
       return fcs_result_create(FCS_ERROR_WRONG_ARGUMENT, __func__,
           "The p2nfft method currently depends on equal nonperiodic box lengths with 1d-periodic boundary conditions.");
 
+  ifcs_p2nfft_set_tuning_db(handle->method_context,
+      fcs_get_tuning_db(handle), fcs_get_tuning_db_retune(handle));
+
   /* Call the p2nfft solver's tuning routine */
   result = ifcs_p2nfft_tune(handle->method_context, periodicity,
       local_particles, positions, charges, a, b, c, fcs_get_offset(handle), 
@@ -294,6 +298,8 @@ FCSResult fcs_p2nfft_set_parameter(FCS handle, fcs_bool continue_on_errors, char
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p2nfft_ignore_tolerance", p2nfft_set_ignore_tolerance,          FCS_PARSE_VAL(fcs_int));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p2nfft_ignore_field",     p2nfft_set_ignore_field,              FCS_PARSE_VAL(fcs_int));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p2nfft_verbose_tuning",   p2nfft_set_verbose_tuning,            FCS_PARSE_VAL(fcs_int));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p2nfft_overlap_near_far", p2nfft_set_overlap_near_far,         FCS_PARSE_VAL(fcs_int));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p2nfft_cache_dir",        p2nfft_set_cache_dir,                 FCS_PARSE_VAL(fcs_p_char_t));
 
   /* PNFFT specific parameters */
   FCS_PARSE_IF_PARAM_THEN_FUNC3_GOTO_NEXT("pnfft_N",                 p2nfft_set_pnfft_N,                   FCS_PARSE_VAL(fcs_int), FCS_PARSE_VAL(fcs_int), FCS_PARSE_VAL(fcs_int));
@@ -450,3 +456,11 @@ FCSResult fcs_p2nfft_resort_bytes(FCS handle, void *src, void *dst, fcs_int n, M
 
   return FCS_RESULT_SUCCESS;
 }
+
+
+FCSResult fcs_p2nfft_get_resort_object(FCS handle, fcs_resort_t *resort)
+{
+  ifcs_p2nfft_get_resort_object(handle->method_context, resort);
+
+  return FCS_RESULT_SUCCESS;
+}
@@ -149,6 +149,7 @@ FCSResult fcs_p2nfft_get_resort_particles(FCS handle, fcs_int *resort_particles)
 FCSResult fcs_p2nfft_resort_ints(FCS handle, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm);
 FCSResult fcs_p2nfft_resort_floats(FCS handle, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm);
 FCSResult fcs_p2nfft_resort_bytes(FCS handle, void *src, void *dst, fcs_int n, MPI_Comm comm);
+FCSResult fcs_p2nfft_get_resort_object(FCS handle, fcs_resort_t *resort);
 
 
 #endif
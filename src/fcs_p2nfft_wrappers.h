@@ -78,6 +78,13 @@ FCS_P2NFFT_SET_GET_WRAPPER_1(ignore_tolerance, ignore_tolerance, fcs_int, set_ig
 FCS_P2NFFT_SET_GET_WRAPPER_1(ignore_potential, ignore_potential, fcs_int, set_ignore_potential)
 FCS_P2NFFT_SET_GET_WRAPPER_1(ignore_field,     ignore_field,     fcs_int, set_ignore_field)
 
+/* Getters and Setters for overlapping the near field with the far field computation */
+FCS_P2NFFT_SET_GET_WRAPPER_1(overlap_near_far, overlap_near_far, fcs_int, set_overlap_near_far)
+
+/* Getters and Setters for directory of the on-disk cache of precomputed data */
+FCS_P2NFFT_INTERFACE_WRAPPER_1(set_cache_dir, set_cache_dir, const char*,  cache_dir)
+FCS_P2NFFT_INTERFACE_WRAPPER_1(get_cache_dir, get_cache_dir, const char**, cache_dir)
+
 /************************************************************
  *     Setter and Getter functions for pnfft parameters
  ************************************************************/
@@ -59,6 +59,15 @@ FCSResult fcs_p3m_init(FCS handle)
   handle->print_parameters = fcs_p3m_print_parameters;
   handle->tune = fcs_p3m_tune;
   handle->run = fcs_p3m_run;
+  handle->set_max_particle_move = fcs_p3m_set_max_particle_move;
+  handle->set_resort = fcs_p3m_set_resort;
+  handle->get_resort = fcs_p3m_get_resort;
+  handle->get_resort_availability = fcs_p3m_get_resort_availability;
+  handle->get_resort_particles = fcs_p3m_get_resort_particles;
+  handle->resort_ints = fcs_p3m_resort_ints;
+  handle->resort_floats = fcs_p3m_resort_floats;
+  handle->resort_bytes = fcs_p3m_resort_bytes;
+  handle->get_resort_object = fcs_p3m_get_resort_object;
 
   ifcs_p3m_init(&handle->method_context, handle->communicator);
 
@@ -113,6 +122,9 @@ FCSResult fcs_p3m_tune(FCS handle,
   ifcs_p3m_set_near_field_flag(handle->method_context, 
 				 fcs_get_near_field_flag(handle));
 
+  ifcs_p3m_set_tuning_db(handle->method_context,
+			 fcs_get_tuning_db(handle), fcs_get_tuning_db_retune(handle));
+
   fcs_int max_local_particles = fcs_get_max_local_particles(handle);
   if (local_particles > max_local_particles) max_local_particles = local_particles;
 
@@ -327,6 +339,253 @@ FCSResult fcs_p3m_get_cao(FCS handle, fcs_int *cao) {
   return FCS_RESULT_SUCCESS;
 }
 
+FCSResult fcs_p3m_set_max_particle_move(FCS handle, fcs_float max_particle_move) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_set_max_particle_move(handle->method_context, max_particle_move);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_set_resort(FCS handle, fcs_int resort) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_set_resort(handle->method_context, resort);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_get_resort(FCS handle, fcs_int *resort) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_get_resort(handle->method_context, resort);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_get_resort_availability(FCS handle, fcs_int *availability) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_get_resort_availability(handle->method_context, availability);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_get_resort_particles(FCS handle, fcs_int *resort_particles) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_get_resort_particles(handle->method_context, resort_particles);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_resort_ints(FCS handle, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_resort_ints(handle->method_context, src, dst, n, comm);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_resort_floats(FCS handle, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_resort_floats(handle->method_context, src, dst, n, comm);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_resort_bytes(FCS handle, void *src, void *dst, fcs_int n, MPI_Comm comm) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_resort_bytes(handle->method_context, src, dst, n, comm);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_get_resort_object(FCS handle, fcs_resort_t *resort) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_get_resort_object(handle->method_context, resort);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_set_num_threads(FCS handle, fcs_int num_threads) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_set_num_threads(handle->method_context, num_threads);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_get_num_threads(FCS handle, fcs_int *num_threads) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_get_num_threads(handle->method_context, num_threads);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_set_pipelined_fft(FCS handle, fcs_int flag) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_set_pipelined_fft(handle->method_context, flag);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_get_pipelined_fft(FCS handle, fcs_int *flag) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_get_pipelined_fft(handle->method_context, flag);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_set_verlet_skin(FCS handle, fcs_float verlet_skin) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_set_verlet_skin(handle->method_context, verlet_skin);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_get_verlet_skin(FCS handle, fcs_float *verlet_skin) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_get_verlet_skin(handle->method_context, verlet_skin);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_set_batched_fft(FCS handle, fcs_int flag) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_set_batched_fft(handle->method_context, flag);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_get_batched_fft(FCS handle, fcs_int *flag) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_get_batched_fft(handle->method_context, flag);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_set_mixed_precision(FCS handle, fcs_int flag) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_set_mixed_precision(handle->method_context, flag);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
+FCSResult fcs_p3m_get_mixed_precision(FCS handle, fcs_int *flag) {
+
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  P3M_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_p3m_get_mixed_precision(handle->method_context, flag);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+
+  return FCS_RESULT_SUCCESS;
+}
+
 FCSResult fcs_p3m_require_total_energy(FCS handle, fcs_int flag) {
 
   FCS_DEBUG_FUNC_INTRO(__func__);
@@ -460,6 +719,11 @@ FCSResult fcs_p3m_set_parameter(FCS handle, fcs_bool continue_on_errors, char **
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p3m_alpha",                p3m_set_alpha,            FCS_PARSE_VAL(fcs_float));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p3m_grid",                 p3m_set_grid,             FCS_PARSE_VAL(fcs_int));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p3m_cao",                  p3m_set_cao,              FCS_PARSE_VAL(fcs_int));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p3m_num_threads",          p3m_set_num_threads,      FCS_PARSE_VAL(fcs_int));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p3m_pipelined_fft",        p3m_set_pipelined_fft,    FCS_PARSE_VAL(fcs_int));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p3m_batched_fft",          p3m_set_batched_fft,      FCS_PARSE_VAL(fcs_int));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p3m_mixed_precision",      p3m_set_mixed_precision,  FCS_PARSE_VAL(fcs_int));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p3m_verlet_skin",          p3m_set_verlet_skin,      FCS_PARSE_VAL(fcs_float));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("p3m_require_total_energy", p3m_require_total_energy, FCS_PARSE_VAL(fcs_int));
 
   return FCS_RESULT_SUCCESS;
@@ -482,6 +746,21 @@ FCSResult fcs_p3m_print_parameters(FCS handle)
   fcs_float tolerance;
   fcs_p3m_get_tolerance_field(handle, &tolerance);
   printf("p3m absolute field tolerance: %" FCS_LMOD_FLOAT "e\n", tolerance);
+  fcs_int num_threads;
+  fcs_p3m_get_num_threads(handle, &num_threads);
+  printf("p3m number of threads: %" FCS_LMOD_INT "d\n", num_threads);
+  fcs_int pipelined_fft;
+  fcs_p3m_get_pipelined_fft(handle, &pipelined_fft);
+  printf("p3m pipelined fft: %" FCS_LMOD_INT "d\n", pipelined_fft);
+  fcs_int batched_fft;
+  fcs_p3m_get_batched_fft(handle, &batched_fft);
+  printf("p3m batched fft: %" FCS_LMOD_INT "d\n", batched_fft);
+  fcs_int mixed_precision;
+  fcs_p3m_get_mixed_precision(handle, &mixed_precision);
+  printf("p3m mixed precision: %" FCS_LMOD_INT "d\n", mixed_precision);
+  fcs_float verlet_skin;
+  fcs_p3m_get_verlet_skin(handle, &verlet_skin);
+  printf("p3m verlet skin: %" FCS_LMOD_FLOAT "e\n", verlet_skin);
 
   FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
 
@@ -76,6 +76,14 @@ FCSResult fcs_p3m_run(FCS handle,
  */
 FCSResult fcs_p3m_destroy(FCS handle);
 
+/**
+ * @brief return the resort object of the last run (used for resorting with a resort plan)
+ * @param handle the FCS-object, which contains the parameters
+ * @param resort resort object (FCS_RESORT_NULL if not available)
+ * @return FCSResult-object containing the return state
+ */
+FCSResult fcs_p3m_get_resort_object(FCS handle, fcs_resort_t *resort);
+
 FCSResult fcs_p3m_set_tolerance(FCS handle, fcs_int tolerance_type, fcs_float tolerance);
 FCSResult fcs_p3m_get_tolerance(FCS handle, fcs_int *tolerance_type, fcs_float *tolerance);
 
@@ -233,6 +233,31 @@ FCSResult fcs_p3m_set_cao(FCS handle, fcs_int cao);
 FCSResult fcs_p3m_set_cao_tune(FCS handle);
 FCSResult fcs_p3m_get_cao(FCS handle, fcs_int *cao);
 
+FCSResult fcs_p3m_set_max_particle_move(FCS handle, fcs_float max_particle_move);
+
+FCSResult fcs_p3m_set_resort(FCS handle, fcs_int resort);
+FCSResult fcs_p3m_get_resort(FCS handle, fcs_int *resort);
+FCSResult fcs_p3m_get_resort_availability(FCS handle, fcs_int *availability);
+FCSResult fcs_p3m_get_resort_particles(FCS handle, fcs_int *resort_particles);
+FCSResult fcs_p3m_resort_ints(FCS handle, fcs_int *src, fcs_int *dst, fcs_int n, MPI_Comm comm);
+FCSResult fcs_p3m_resort_floats(FCS handle, fcs_float *src, fcs_float *dst, fcs_int n, MPI_Comm comm);
+FCSResult fcs_p3m_resort_bytes(FCS handle, void *src, void *dst, fcs_int n, MPI_Comm comm);
+
+FCSResult fcs_p3m_set_num_threads(FCS handle, fcs_int num_threads);
+FCSResult fcs_p3m_get_num_threads(FCS handle, fcs_int *num_threads);
+
+FCSResult fcs_p3m_set_pipelined_fft(FCS handle, fcs_int flag);
+FCSResult fcs_p3m_get_pipelined_fft(FCS handle, fcs_int *flag);
+
+FCSResult fcs_p3m_set_batched_fft(FCS handle, fcs_int flag);
+FCSResult fcs_p3m_get_batched_fft(FCS handle, fcs_int *flag);
+
+FCSResult fcs_p3m_set_mixed_precision(FCS handle, fcs_int flag);
+FCSResult fcs_p3m_get_mixed_precision(FCS handle, fcs_int *flag);
+
+FCSResult fcs_p3m_set_verlet_skin(FCS handle, fcs_float verlet_skin);
+FCSResult fcs_p3m_get_verlet_skin(FCS handle, fcs_float *verlet_skin);
+
 FCSResult fcs_p3m_require_total_energy(FCS handle, fcs_int total_energy);
 FCSResult fcs_p3m_get_total_energy(FCS handle, fcs_float *total_energy);
 
@@ -198,6 +198,19 @@ FCSResult fcs_pepc_run(FCS handle, fcs_int local_particles,
 		    fcs_get_periodicity(handle), &handle->pepc_param->dipole_correction,
 		    &handle->pepc_param->epsilon, &handle->pepc_param->theta, &handle->pepc_param->debug_level, &handle->pepc_param->num_walk_threads, &handle->pepc_param->npm);
 
+  /* the phases are measured with the internal timers of pepc */
+  if (fcs_timing_active())
+  {
+    double timings[4];
+
+    pepc_scafacos_timings(timings);
+
+    fcs_timing_add(FCS_PHASE_SORT, timings[0]);
+    fcs_timing_add(FCS_PHASE_GHOSTS, timings[1]);
+    fcs_timing_add(FCS_PHASE_SOLVE, timings[2]);
+    fcs_timing_add(FCS_PHASE_BACK_SORT, timings[3]);
+  }
+
   if (handle->pepc_param->debug_level > 3)
   {
     printf("virial(0,0) %12.4e\n", ((fcs_pepc_internal_t*)(handle->method_context))->virial[0]);
@@ -177,4 +177,9 @@ void pepc_scafacos_run(fcs_int *local_particles, fcs_int *total_particles,
 			      fcs_int *lattice_corr, fcs_float *eps, fcs_float *theta, 
                               fcs_int *db_level, fcs_int *num_walk_threads, fcs_float *npm );
 
+/**
+ * @brief return the sort, ghosts, solve, and back_sort timings of the last pepc run
+ */
+void pepc_scafacos_timings(double *timings);
+
 #endif
@@ -215,7 +215,11 @@ FCSResult fcs_pp3mg_run(FCS handle, fcs_int local_particles, fcs_float *position
       z[i] = sorted_positions[3*i+2];
     }
     
+    double timing = fcs_timing_start();
+
     pp3mg(x, y, z, sorted_charges, sorted_potentials, fx, fy, fz, sorted_num_particles, ctx->data, ctx->parameters);
+
+    fcs_timing_stop(FCS_PHASE_SOLVE, timing);
     
     for (i=0; i<sorted_num_particles; i++) {
       sorted_field[3*i+0] = fx[i]/(1.0/(4.0*FCS_PI)*sorted_charges[i]);
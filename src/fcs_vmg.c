@@ -64,6 +64,7 @@ FCSResult fcs_vmg_init(FCS handle)
   handle->vmg_param->near_field_cells = -1;
   handle->vmg_param->interpolation_order = -1;
   handle->vmg_param->discretization_order = -1;
+  handle->vmg_param->warm_start = 0;
 
   return FCS_RESULT_SUCCESS;
 }
@@ -100,6 +101,7 @@ FCSResult fcs_vmg_tune(FCS handle, fcs_int local_particles,
   fcs_int near_field_cells;
   fcs_int interpolation_order;
   fcs_int discretization_order;
+  fcs_int warm_start;
 
   result = fcs_vmg_get_max_level(handle, &level);
   if (result)
@@ -138,12 +140,16 @@ FCSResult fcs_vmg_tune(FCS handle, fcs_int local_particles,
   if (result)
     return result;
 
+  result  = fcs_vmg_get_warm_start(handle, &warm_start);
+  if (result)
+    return result;
+
   MPI_Comm comm = fcs_get_communicator(handle);
 
   VMG_fcs_setup(level, periodic, max_iter, smoothing_steps,
 		cycle_type, precision, offset, box_a[0],
 		near_field_cells, interpolation_order,
-		discretization_order, comm);
+		discretization_order, warm_start, comm);
 
   result = fcs_vmg_library_check(handle);
   if (result)
@@ -646,6 +652,43 @@ FCSResult fcs_vmg_get_discretization_order(FCS handle, fcs_int* discretization_o
   return FCS_RESULT_SUCCESS;
 }
 
+/**
+ * @brief Set the initial guess of the multigrid iteration.
+ *
+ * @param handle FCS-object that contains the parameter.
+ * @param warm_start Initial guess (0: zero, 1: previous solution, 2: linear extrapolation of the last two solutions).
+ *
+ * @return FCSResult-object containing the return state.
+ */
+FCSResult fcs_vmg_set_warm_start(FCS handle, fcs_int warm_start)
+{
+  VMG_CHECK_RETURN_RESULT(handle, __func__);
+
+  if (warm_start < 0 || warm_start > 2)
+    return fcs_result_create(FCS_ERROR_WRONG_ARGUMENT, __func__, "The warm start must be 0, 1, or 2.");
+
+  handle->vmg_param->warm_start = warm_start;
+
+  return FCS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief Get the initial guess of the multigrid iteration.
+ *
+ * @param handle FCS-object that contains the parameter.
+ * @param warm_start Initial guess.
+ *
+ * @return FCSResult-object containing the return state.
+ */
+FCSResult fcs_vmg_get_warm_start(FCS handle, fcs_int *warm_start)
+{
+  VMG_CHECK_RETURN_RESULT(handle, __func__);
+
+  *warm_start = handle->vmg_param->warm_start;
+
+  return FCS_RESULT_SUCCESS;
+}
+
 FCSResult fcs_vmg_check(FCS handle)
 {
   FCSResult result;
@@ -768,6 +811,7 @@ FCSResult fcs_vmg_set_parameter(FCS handle, fcs_bool continue_on_errors, char **
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("vmg_near_field_cells",     vmg_set_near_field_cells,     FCS_PARSE_VAL(fcs_int));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("vmg_interpolation_order",  vmg_set_interpolation_order,  FCS_PARSE_VAL(fcs_int));
   FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("vmg_discretization_order", vmg_set_discretization_order, FCS_PARSE_VAL(fcs_int));
+  FCS_PARSE_IF_PARAM_THEN_FUNC1_GOTO_NEXT("vmg_warm_start",           vmg_set_warm_start,           FCS_PARSE_VAL(fcs_int));
 
   return FCS_RESULT_SUCCESS;
 
@@ -791,6 +835,7 @@ FCSResult fcs_vmg_print_parameters(FCS handle)
   fcs_int near_field_cells;
   fcs_int interpolation_order;
   fcs_int discretization_order;
+  fcs_int warm_start;
 
   VMG_CHECK_RETURN_RESULT(handle, __func__);
 
@@ -802,6 +847,7 @@ FCSResult fcs_vmg_print_parameters(FCS handle)
   fcs_vmg_get_near_field_cells(handle, &near_field_cells);
   fcs_vmg_get_interpolation_order(handle, &interpolation_order);
   fcs_vmg_get_discretization_order(handle, &discretization_order);
+  fcs_vmg_get_warm_start(handle, &warm_start);
 
   printf("vmg max level:            %" FCS_LMOD_INT "d\n", level);
   printf("vmg max iterations:       %" FCS_LMOD_INT "d\n", max_iter);
@@ -811,6 +857,7 @@ FCSResult fcs_vmg_print_parameters(FCS handle)
   printf("vmg near field cells:     %" FCS_LMOD_INT "d\n", near_field_cells);
   printf("vmg interpolation degree: %" FCS_LMOD_INT "d\n", interpolation_order);
   printf("vmg discretization order: %" FCS_LMOD_INT "d\n", discretization_order);
+  printf("vmg warm start:           %" FCS_LMOD_INT "d\n", warm_start);
   
   return FCS_RESULT_SUCCESS;
 }
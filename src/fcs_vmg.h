@@ -45,6 +45,7 @@ typedef struct fcs_vmg_parameters_t
   fcs_int near_field_cells;
   fcs_int interpolation_order;
   fcs_int discretization_order;
+  fcs_int warm_start;
 }fcs_vmg_parameters_t;
 
 /**
@@ -143,13 +144,14 @@ FCSResult fcs_vmg_print_parameters(FCS handle);
  * @param near_field_cells Splitting of short/long range part of the potential.
  * @param interpolation_order Interpolation order.
  * @param discretization_order Discretization order.
+ * @param warm_start Initial guess of the multigrid iteration (0: zero, 1: previous solution, 2: linear extrapolation of the last two solutions).
  * @param comm MPI communicator.
  */
 void VMG_fcs_setup(fcs_int max_level, const fcs_int* periodic, fcs_int max_iteration,
 			  fcs_int smoothing_steps, fcs_int cycle_type, fcs_float precision,
 			  const fcs_float* box_offset, fcs_float box_size, fcs_int near_field_cells,
 			  fcs_int interpolation_order, fcs_int discretization_order,
-			  MPI_Comm comm);
+			  fcs_int warm_start, MPI_Comm comm);
 
 /**
  * @brief External interface definition for running internal vmg library checks.
@@ -233,6 +233,31 @@ FCSResult fcs_vmg_set_discretization_order(FCS handle, fcs_int discretization_or
  */
 FCSResult fcs_vmg_get_discretization_order(FCS handle, fcs_int *discretization_order);
 
+/**
+ * @brief Set the initial guess of the multigrid iteration.
+ *        With 0, each run starts from zero. With 1, the solution
+ *        of the previous run on the finest level is used. With 2,
+ *        the solutions of the last two runs are extrapolated
+ *        linearly. Warm starts reduce the number of iterations
+ *        if the particles move little between the runs.
+ *
+ * @param handle FCS-object that contains the parameter.
+ * @param warm_start Initial guess (0, 1, or 2).
+ *
+ * @return FCSResult-object containing the return value.
+ */
+FCSResult fcs_vmg_set_warm_start(FCS handle, fcs_int warm_start);
+
+/**
+ * @brief Get the initial guess of the multigrid iteration.
+ *
+ * @param handle FCS-object that contains the parameter.
+ * @param warm_start Initial guess (0, 1, or 2).
+ *
+ * @return FCSResult-object containing the return value.
+ */
+FCSResult fcs_vmg_get_warm_start(FCS handle, fcs_int *warm_start);
+
 /**
  * @brief Print runtimes of various vmg subsystems. vmg has to be configured
  *        with --enable-debug-measure-time in order to do so.
@@ -90,6 +90,7 @@ FCSResult fcs_wolf_init(FCS handle)
   handle->resort_ints = fcs_wolf_resort_ints;
   handle->resort_floats = fcs_wolf_resort_floats;
   handle->resort_bytes = fcs_wolf_resort_bytes;
+  handle->get_resort_object = fcs_wolf_get_resort_object;
 
   FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
 
@@ -431,6 +432,20 @@ FCSResult fcs_wolf_resort_bytes(FCS handle, void *src, void *dst, fcs_int n, MPI
 }
 
 
+FCSResult fcs_wolf_get_resort_object(FCS handle, fcs_resort_t *resort)
+{
+  FCS_DEBUG_FUNC_INTRO(__func__);
+
+  WOLF_CHECK_RETURN_RESULT(handle, __func__);
+
+  ifcs_wolf_get_resort_object(&handle->wolf_param->wolf, resort);
+
+  FCS_DEBUG_FUNC_OUTRO(__func__, FCS_RESULT_SUCCESS);
+  
+  return FCS_RESULT_SUCCESS;
+}
+
+
 FCSResult fcs_wolf_setup(FCS handle, fcs_float cutoff, fcs_float alpha)
 {
   FCSResult result;
@@ -95,6 +95,22 @@ module fcs_module
   integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_TOLERANCE_TYPE_FIELD         = 5
   integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_TOLERANCE_TYPE_FIELD_REL     = 6
 
+  ! definitions of phases and counters, use timings(0:FCS_NUM_PHASES-1) and counters(0:FCS_NUM_COUNTERS-1)
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_PHASE_TOTAL             = FCS4FORTRAN_PHASE_TOTAL
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_PHASE_SORT              = FCS4FORTRAN_PHASE_SORT
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_PHASE_GHOSTS            = FCS4FORTRAN_PHASE_GHOSTS
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_PHASE_NEAR              = FCS4FORTRAN_PHASE_NEAR
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_PHASE_SPREAD            = FCS4FORTRAN_PHASE_SPREAD
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_PHASE_FFT               = FCS4FORTRAN_PHASE_FFT
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_PHASE_SOLVE             = FCS4FORTRAN_PHASE_SOLVE
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_PHASE_INTERPOLATE       = FCS4FORTRAN_PHASE_INTERPOLATE
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_PHASE_BACK_SORT         = FCS4FORTRAN_PHASE_BACK_SORT
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_NUM_PHASES              = FCS4FORTRAN_NUM_PHASES
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_COUNTER_NEAR_PAIRS      = FCS4FORTRAN_COUNTER_NEAR_PAIRS
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_COUNTER_COMM_BYTES      = FCS4FORTRAN_COUNTER_COMM_BYTES
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_COUNTER_GHOST_PARTICLES = FCS4FORTRAN_COUNTER_GHOST_PARTICLES
+  integer(kind = fcs_integer_kind_isoc), parameter  :: FCS_NUM_COUNTERS            = FCS4FORTRAN_NUM_COUNTERS
+
   ! interface containing the calls to the wrapper functions in C
 
   interface
@@ -467,6 +483,30 @@ module fcs_module
           real(kind = fcs_real_kind_isoc)                   :: virial(9)
           type(c_ptr)                                       :: fcs_get_virial
       end function
+
+      function fcs_get_timings(handle, timings) BIND(C,name="fcs_get_timings")
+          use iso_c_binding
+          implicit none
+          type(c_ptr), value                                :: handle
+          real(kind = fcs_real_kind_isoc)                   :: timings(*)
+          type(c_ptr)                                       :: fcs_get_timings
+      end function
+
+      function fcs_get_counters(handle, counters) BIND(C,name="fcs_get_counters")
+          use iso_c_binding
+          implicit none
+          type(c_ptr), value                                :: handle
+          integer(kind = c_long_long)                       :: counters(*)
+          type(c_ptr)                                       :: fcs_get_counters
+      end function
+
+      function fcs_set_trace(handle, filename) BIND(C,name="fcs_set_trace")
+          use iso_c_binding
+          implicit none
+          type(c_ptr), value                                :: handle
+          character(kind = c_char)                          :: filename(*)
+          type(c_ptr)                                       :: fcs_set_trace
+      end function
       
 !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 !                                  method specific setups
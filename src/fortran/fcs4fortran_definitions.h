@@ -82,4 +82,24 @@
 #define FCS4FORTRAN_TOLERANCE_TYPE_FIELD_REL      6
 
 
+!
+! @brief definitions of phases and counters (indices of the arrays returned by fcs_get_timings and fcs_get_counters start with 0)
+!
+#define FCS4FORTRAN_PHASE_TOTAL        0
+#define FCS4FORTRAN_PHASE_SORT         1
+#define FCS4FORTRAN_PHASE_GHOSTS       2
+#define FCS4FORTRAN_PHASE_NEAR         3
+#define FCS4FORTRAN_PHASE_SPREAD       4
+#define FCS4FORTRAN_PHASE_FFT          5
+#define FCS4FORTRAN_PHASE_SOLVE        6
+#define FCS4FORTRAN_PHASE_INTERPOLATE  7
+#define FCS4FORTRAN_PHASE_BACK_SORT    8
+#define FCS4FORTRAN_NUM_PHASES         9
+
+#define FCS4FORTRAN_COUNTER_NEAR_PAIRS       0
+#define FCS4FORTRAN_COUNTER_COMM_BYTES       1
+#define FCS4FORTRAN_COUNTER_GHOST_PARTICLES  2
+#define FCS4FORTRAN_NUM_COUNTERS             3
+
+
 #endif
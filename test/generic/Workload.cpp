@@ -0,0 +1,205 @@
+/*
+  Copyright (C) 2011,2012 Olaf Lenz, Michael Hofmann
+
+  This file is part of ScaFaCoS.
+
+  ScaFaCoS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ScaFaCoS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser Public License for more details.
+
+  You should have received a copy of the GNU Lesser Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstring>
+#include <cmath>
+
+#include "Workload.hpp"
+
+
+/* bond length and angle of the water molecules (relative to the mean particle distance) */
+#define WATER_BOND   0.3
+#define WATER_ANGLE  (109.47 * M_PI / 180.0)
+
+/* SPC/E partial charges */
+#define WATER_CHARGE_O  -0.8476
+#define WATER_CHARGE_H   0.4238
+
+/* maximum displacement of the ions from their lattice sites */
+#define NACL_DISPLACEMENT  0.1
+
+
+workload_type::type_t workload_type::fromstr(const char *s)
+{
+  if (strcmp(s, "cloud") == 0) return TYPE_CLOUD;
+  if (strcmp(s, "nacl") == 0) return TYPE_NACL;
+  if (strcmp(s, "water") == 0) return TYPE_WATER;
+  if (strcmp(s, "slab") == 0) return TYPE_SLAB;
+  if (strcmp(s, "rod") == 0) return TYPE_ROD;
+
+  return TYPE_NONE;
+}
+
+
+Workload::Workload(workload_type::type_t type, fcs_int nparticles, fcs_int seed)
+  : type(type), total_nparticles(0), seed(seed), lattice_size(0), box_length(0)
+{
+  switch (type)
+  {
+    case workload_type::TYPE_CLOUD:
+      total_nparticles = nparticles - nparticles % 2;
+      box_length = cbrt((fcs_float) total_nparticles);
+      break;
+    case workload_type::TYPE_NACL:
+      lattice_size = (fcs_int) floor(cbrt((fcs_float) nparticles) + 1e-6);
+      lattice_size -= lattice_size % 2;
+      if (lattice_size < 2) lattice_size = 2;
+      total_nparticles = lattice_size * lattice_size * lattice_size;
+      box_length = lattice_size;
+      break;
+    case workload_type::TYPE_WATER:
+      total_nparticles = nparticles - nparticles % 3;
+      box_length = cbrt((fcs_float) total_nparticles);
+      break;
+    case workload_type::TYPE_SLAB:
+      total_nparticles = nparticles - nparticles % 2;
+      box_length = cbrt(2.0 * total_nparticles);
+      break;
+    case workload_type::TYPE_ROD:
+      total_nparticles = nparticles - nparticles % 2;
+      box_length = cbrt(16.0 * total_nparticles / M_PI);
+      break;
+    default:
+      break;
+  }
+
+  for (fcs_int i = 0; i < 3; ++i)
+  {
+    box_base[i] = 0.0;
+    box_a[i] = box_b[i] = box_c[i] = 0.0;
+  }
+  box_a[0] = box_b[1] = box_c[2] = box_length;
+
+  periodicity[0] = periodicity[1] = periodicity[2] = 1;
+  if (type == workload_type::TYPE_SLAB) periodicity[2] = 0;
+  if (type == workload_type::TYPE_ROD) periodicity[0] = periodicity[1] = 0;
+}
+
+
+fcs_int Workload::get_local_nparticles(int comm_size, int comm_rank)
+{
+  long long first = (long long) total_nparticles * comm_rank / comm_size;
+  long long last = (long long) total_nparticles * (comm_rank + 1) / comm_size;
+
+  return (fcs_int) (last - first);
+}
+
+
+fcs_int Workload::get_local_particles(fcs_float *positions, fcs_float *charges, int comm_size, int comm_rank)
+{
+  fcs_int first = (fcs_int) ((long long) total_nparticles * comm_rank / comm_size);
+  fcs_int n = get_local_nparticles(comm_size, comm_rank);
+
+  for (fcs_int i = 0; i < n; ++i) make_particle(first + i, &positions[3 * i], &charges[i]);
+
+  return n;
+}
+
+
+/* uniform random number in [0,1) depending only on seed, index and stream (splitmix64 finalizer) */
+fcs_float Workload::random(fcs_int index, fcs_int stream)
+{
+  unsigned long long z = (unsigned long long) seed * 0x9E3779B97F4A7C15ULL;
+
+  z += ((unsigned long long) index << 4) + (unsigned long long) stream + 1;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= z >> 31;
+
+  return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+void Workload::make_particle(fcs_int index, fcs_float *position, fcs_float *charge)
+{
+  switch (type)
+  {
+    case workload_type::TYPE_CLOUD:
+      for (fcs_int j = 0; j < 3; ++j) position[j] = box_length * random(index, j);
+      *charge = (index % 2)?-1.0:1.0;
+      break;
+
+    case workload_type::TYPE_NACL:
+    {
+      fcs_int l[3] = { index % lattice_size, (index / lattice_size) % lattice_size, index / (lattice_size * lattice_size) };
+      for (fcs_int j = 0; j < 3; ++j) position[j] = l[j] + 0.5 + NACL_DISPLACEMENT * (2.0 * random(index, j) - 1.0);
+      *charge = ((l[0] + l[1] + l[2]) % 2)?-1.0:1.0;
+      break;
+    }
+
+    case workload_type::TYPE_WATER:
+    {
+      fcs_int molecule = index / 3, atom = index % 3;
+
+      for (fcs_int j = 0; j < 3; ++j) position[j] = box_length * random(molecule, j);
+
+      if (atom == 0)
+      {
+        *charge = WATER_CHARGE_O;
+        break;
+      }
+
+      /* random orientation: direction u of the first bond, the second bond is rotated by a random angle around u */
+      fcs_float cos_theta = 2.0 * random(molecule, 3) - 1.0, sin_theta = sqrt(1.0 - cos_theta * cos_theta);
+      fcs_float phi = 2.0 * M_PI * random(molecule, 4), psi = 2.0 * M_PI * random(molecule, 5);
+      fcs_float u[3] = { sin_theta * cos(phi), sin_theta * sin(phi), cos_theta };
+      fcs_float v[3] = { cos_theta * cos(phi), cos_theta * sin(phi), -sin_theta };
+      fcs_float w[3] = { -sin(phi), cos(phi), 0.0 };
+      fcs_float bond[3];
+
+      for (fcs_int j = 0; j < 3; ++j)
+      {
+        if (atom == 1) bond[j] = u[j];
+        else bond[j] = cos(WATER_ANGLE) * u[j] + sin(WATER_ANGLE) * (cos(psi) * v[j] + sin(psi) * w[j]);
+
+        position[j] += WATER_BOND * bond[j];
+        position[j] = fmod(position[j] + box_length, box_length);
+      }
+
+      *charge = WATER_CHARGE_H;
+      break;
+    }
+
+    case workload_type::TYPE_SLAB:
+      position[0] = box_length * random(index, 0);
+      position[1] = box_length * random(index, 1);
+      position[2] = box_length * (0.25 + 0.5 * random(index, 2));
+      *charge = (index % 2)?-1.0:1.0;
+      break;
+
+    case workload_type::TYPE_ROD:
+    {
+      fcs_float r = 0.25 * box_length * sqrt(random(index, 0)), phi = 2.0 * M_PI * random(index, 1);
+      position[0] = 0.5 * box_length + r * cos(phi);
+      position[1] = 0.5 * box_length + r * sin(phi);
+      position[2] = box_length * random(index, 2);
+      *charge = (index % 2)?-1.0:1.0;
+      break;
+    }
+
+    default:
+      position[0] = position[1] = position[2] = 0.0;
+      *charge = 0.0;
+      break;
+  }
+}
@@ -0,0 +1,96 @@
+/*
+  Copyright (C) 2011,2012 Olaf Lenz, Michael Hofmann
+
+  This file is part of ScaFaCoS.
+
+  ScaFaCoS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ScaFaCoS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser Public License for more details.
+
+  You should have received a copy of the GNU Lesser Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _WORKLOAD_HPP
+#define _WORKLOAD_HPP
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "fcs.h"
+
+#include "common.hpp"
+
+using namespace std;
+
+
+class workload_type
+{
+  public:
+    typedef enum {
+      TYPE_NONE,
+      TYPE_CLOUD,
+      TYPE_NACL,
+      TYPE_WATER,
+      TYPE_SLAB,
+      TYPE_ROD
+    } type_t;
+
+    static const char *tostr(workload_type::type_t type) {
+      switch (type) {
+        case TYPE_NONE: return "none";
+        case TYPE_CLOUD: return "cloud";
+        case TYPE_NACL: return "nacl";
+        case TYPE_WATER: return "water";
+        case TYPE_SLAB: return "slab";
+        case TYPE_ROD: return "rod";
+      }
+      return "unknown";
+    }
+
+    static type_t fromstr(const char *s);
+};
+
+
+/* Synthetic particle systems for benchmarking. Every particle is a pure function of its global index and
+   the seed, i.e., the generated system does not depend on the number of processes. All systems are charge
+   neutral and have a mean particle distance of about 1.
+
+   cloud: random positions in a 3d-periodic cube, alternating charges +1/-1
+   nacl:  3d-periodic simple cubic lattice with alternating charges +1/-1 and small random displacements
+   water: 3d-periodic random arrangement of rigid SPC/E-like molecules (i.e., three particles each)
+   slab:  2d-periodic (x,y) random positions within the middle half of the box in z-direction
+   rod:   1d-periodic (z) random positions within a cylinder around the center axis of the box */
+class Workload {
+public:
+  Workload(workload_type::type_t type, fcs_int nparticles, fcs_int seed);
+
+  workload_type::type_t get_type() { return type; }
+  /* number of particles, may be less than the requested number to fit the structure of the system */
+  fcs_int get_total_nparticles() { return total_nparticles; }
+
+  fcs_float box_base[3], box_a[3], box_b[3], box_c[3];
+  fcs_int periodicity[3];
+
+  fcs_int get_local_nparticles(int comm_size, int comm_rank);
+  fcs_int get_local_particles(fcs_float *positions, fcs_float *charges, int comm_size, int comm_rank);
+
+private:
+  workload_type::type_t type;
+  fcs_int total_nparticles, seed;
+  fcs_int lattice_size;
+  fcs_float box_length;
+
+  fcs_float random(fcs_int index, fcs_int stream);
+  void make_particle(fcs_int index, fcs_float *position, fcs_float *charge);
+};
+
+
+#endif /* _WORKLOAD_HPP */
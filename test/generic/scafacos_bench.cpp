@@ -0,0 +1,613 @@
+/*
+  Copyright (C) 2011,2012 Olaf Lenz, Michael Hofmann
+
+  This file is part of ScaFaCoS.
+
+  ScaFaCoS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ScaFaCoS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser Public License for more details.
+
+  You should have received a copy of the GNU Lesser Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <getopt.h>
+#include <mpi.h>
+
+#include "fcs.h"
+
+#include "common.hpp"
+#include "Workload.hpp"
+
+
+using namespace std;
+
+
+MPI_Comm communicator;
+int comm_rank, comm_size;
+
+
+static void usage(char** argv, int argc, int c) {
+  if (comm_rank != MASTER_RANK) exit(2);
+
+  cout << "Call: " << argv[0];
+  for (int i = 1; i < argc; ++i)
+    cout << " " << argv[i];
+  cout << endl;
+  cout << "Usage: " << argv[0] << " [OPTIONS] METHOD[:CONF] [METHOD[:CONF] ...]" << endl;
+  cout << "  OPTIONS:" << endl;
+  cout << "    -w | --workloads <w>" << endl
+       << "      comma-separated list of workloads cloud|nacl|water|slab|rod, default <w>=cloud" << endl;
+  cout << "    -n | --nparticles <n>" << endl
+       << "      comma-separated list of (total) numbers of particles, default <n>=10000" << endl;
+  cout << "    -P | --nprocs <p>" << endl
+       << "      comma-separated list of numbers of processes to use (each at most the number of" << endl
+       << "      MPI processes), default is all MPI processes" << endl;
+  cout << "    -t | --tolerances <tol>" << endl
+       << "      comma-separated list of tolerances of the absolute rms field error, values <= 0" << endl
+       << "      keep the default tolerance of the method, default <tol>=0" << endl;
+  cout << "    -R | --reference <ref>" << endl
+       << "      method and configuration METHOD[:CONF] for computing the reference results or 'none'," << endl
+       << "      default is ewald (3d-periodic), mmm2d (2d-periodic), mmm1d (1d-periodic), or direct" << endl;
+  cout << "    -T | --reference-tolerance <tol>" << endl
+       << "      tolerance of the absolute rms field error of the reference method, default <tol>=1e-8" << endl;
+  cout << "    -i | --iterations <it>" << endl
+       << "      perform <it> number of runs with each configuration, default <it>=3" << endl;
+  cout << "    -s | --seed <seed>" << endl
+       << "      seed for generating the workloads, default <seed>=1" << endl;
+  cout << "    -o | --output <file>" << endl
+       << "      write results in JSON format to <file> instead of stdout" << endl;
+  cout << "  METHOD: name of a method as given to fcs_init" << endl;
+  cout << "  CONF: configuration string for setting method parameters" << endl;
+
+  exit(2);
+}
+
+
+typedef struct
+{
+  string method, conf;
+
+} method_spec_t;
+
+static struct {
+  vector<workload_type::type_t> workloads;
+  vector<fcs_int> nparticles;
+  vector<int> nprocs;
+  vector<fcs_float> tolerances;
+  vector<method_spec_t> methods;
+
+  bool have_reference;
+  method_spec_t reference;
+  fcs_float reference_tolerance;
+
+  fcs_int iterations;
+  fcs_int seed;
+
+  string outfilename;
+
+} global_params;
+
+
+static method_spec_t parse_method_spec(const char *s)
+{
+  method_spec_t spec;
+  const char *c = strchr(s, ':');
+
+  if (c)
+  {
+    spec.method = string(s, c - s);
+    spec.conf = string(c + 1);
+
+  } else spec.method = s;
+
+  return spec;
+}
+
+
+template<typename T>
+static bool parse_list(const char *s, vector<T> &v)
+{
+  istringstream is(s);
+  string item;
+
+  v.clear();
+  while (getline(is, item, ','))
+  {
+    T r;
+    if (parse_value(item, r)) return false;
+    v.push_back(r);
+  }
+
+  return !v.empty();
+}
+
+
+static void parse_commandline(int argc, char* argv[]) {
+  int c;
+  string s;
+  istringstream is;
+
+  global_params.workloads.assign(1, workload_type::TYPE_CLOUD);
+  global_params.nparticles.assign(1, 10000);
+  global_params.nprocs.assign(1, comm_size);
+  global_params.tolerances.assign(1, 0.0);
+  global_params.have_reference = true;
+  global_params.reference_tolerance = 1e-8;
+  global_params.iterations = 3;
+  global_params.seed = 1;
+
+  static struct option long_options[] = {
+    {"workloads",           required_argument, 0, 'w'},
+    {"nparticles",          required_argument, 0, 'n'},
+    {"nprocs",              required_argument, 0, 'P'},
+    {"tolerances",          required_argument, 0, 't'},
+    {"reference",           required_argument, 0, 'R'},
+    {"reference-tolerance", required_argument, 0, 'T'},
+    {"iterations",          required_argument, 0, 'i'},
+    {"seed",                required_argument, 0, 's'},
+    {"output",              required_argument, 0, 'o'},
+    {0, 0, 0, 0}
+  };
+
+  while (1)
+  {
+    c = getopt_long(argc, argv, "w:n:P:t:R:T:i:s:o:", long_options, NULL);
+    if (c == -1) break;
+
+    switch (c)
+    {
+      case 'w':
+      {
+        is.clear(); is.str(optarg);
+        global_params.workloads.clear();
+        while (getline(is, s, ','))
+        {
+          workload_type::type_t t = workload_type::fromstr(s.c_str());
+          if (t == workload_type::TYPE_NONE) usage(argv, argc, c);
+          global_params.workloads.push_back(t);
+        }
+        break;
+      }
+      case 'n':
+        if (!parse_list(optarg, global_params.nparticles)) usage(argv, argc, c);
+        break;
+      case 'P':
+      {
+        vector<fcs_int> p;
+        if (!parse_list(optarg, p)) usage(argv, argc, c);
+        global_params.nprocs.clear();
+        for (size_t i = 0; i < p.size(); ++i)
+        {
+          if (p[i] <= 0 || p[i] > comm_size)
+          {
+            MASTER(cerr << "ERROR: invalid number of processes " << p[i] << " (has to be between 1 and " << comm_size << ")" << endl);
+            usage(argv, argc, c);
+          }
+          global_params.nprocs.push_back(p[i]);
+        }
+        break;
+      }
+      case 't':
+        if (!parse_list(optarg, global_params.tolerances)) usage(argv, argc, c);
+        break;
+      case 'R':
+        if (strcmp(optarg, "none") == 0) global_params.have_reference = false;
+        else global_params.reference = parse_method_spec(optarg);
+        break;
+      case 'T':
+        global_params.reference_tolerance = atof(optarg);
+        break;
+      case 'i':
+        global_params.iterations = z_max(atoi(optarg), 1);
+        break;
+      case 's':
+        global_params.seed = atoi(optarg);
+        break;
+      case 'o':
+        global_params.outfilename = optarg;
+        break;
+      default:
+        usage(argv, argc, c);
+    }
+  }
+
+  if (optind >= argc) usage(argv, argc, 0);
+
+  for (int i = optind; i < argc; ++i) global_params.methods.push_back(parse_method_spec(argv[i]));
+}
+
+
+static const char *default_reference_method(fcs_int *periodicity)
+{
+  fcs_int num_periodic = periodicity[0] + periodicity[1] + periodicity[2];
+
+#ifdef FCS_ENABLE_EWALD
+  if (num_periodic == 3) return "ewald";
+#endif
+#ifdef FCS_ENABLE_MMM2D
+  if (num_periodic == 2) return "mmm2d";
+#endif
+#ifdef FCS_ENABLE_MMM1D
+  if (num_periodic == 1) return "mmm1d";
+#endif
+#ifdef FCS_ENABLE_DIRECT
+  if (num_periodic == 0) return "direct";
+#endif
+
+  return NULL;
+}
+
+
+static string json_string(const string &s)
+{
+  ostringstream os;
+
+  os << '"';
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    switch (s[i])
+    {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if ((unsigned char) s[i] < 0x20) os << "\\u" << hex << setw(4) << setfill('0') << (int) s[i] << dec << setfill(' ');
+        else os << s[i];
+    }
+  }
+  os << '"';
+
+  return os.str();
+}
+
+
+static string json_float(fcs_float v)
+{
+  ostringstream os;
+
+  if (isnan(v) || isinf(v)) return "null";
+
+  os << scientific << setprecision(6) << v;
+
+  return os.str();
+}
+
+
+/* particle data of the current workload and the results of one method */
+typedef struct
+{
+  fcs_int total_nparticles, nparticles;
+  fcs_float *positions, *charges;
+  fcs_float *work_positions, *work_charges;
+  fcs_float *potentials, *field;
+
+} particles_t;
+
+
+/* outcome of benchmarking one method */
+typedef struct
+{
+  string status;
+  double tune_time, run_time_avg, run_time_min, run_time_max;
+  /* phase timings (average over the runs of the maximum over the processes) and counters of the last run (sum over the processes) */
+  double phases[FCS_NUM_PHASES];
+  long long counters[FCS_NUM_COUNTERS];
+
+} bench_result_t;
+
+
+static string result_message(FCSResult result)
+{
+  string msg = string(fcs_result_get_function(result)) + ": " + fcs_result_get_message(result);
+
+  fcs_result_destroy(result);
+
+  return msg;
+}
+
+
+static bool bench_method(const method_spec_t &spec, fcs_float tolerance, Workload &workload, particles_t *parts, MPI_Comm comm, bench_result_t *res)
+{
+  FCS fcs = FCS_NULL;
+  FCSResult result;
+  double t;
+  fcs_int i, j;
+  fcs_float phases[FCS_NUM_PHASES];
+  double local_phases[FCS_NUM_PHASES];
+  long long counters[FCS_NUM_COUNTERS];
+
+  res->status = "ok";
+  res->tune_time = res->run_time_avg = res->run_time_min = res->run_time_max = 0.0;
+  for (i = 0; i < FCS_NUM_PHASES; ++i) res->phases[i] = 0.0;
+  for (i = 0; i < FCS_NUM_COUNTERS; ++i) res->counters[i] = 0;
+
+  result = fcs_init(&fcs, spec.method.c_str(), comm);
+  if (result != FCS_RESULT_SUCCESS)
+  {
+    res->status = result_message(result);
+    return false;
+  }
+
+  result = fcs_set_common(fcs, (fcs_get_near_field_flag(fcs) == 0)?0:1,
+    workload.box_a, workload.box_b, workload.box_c, workload.box_base, workload.periodicity, parts->total_nparticles);
+  if (result == FCS_RESULT_SUCCESS && !spec.conf.empty()) result = fcs_set_parameters(fcs, spec.conf.c_str(), FCS_FALSE);
+  if (result == FCS_RESULT_SUCCESS && tolerance > 0)
+  {
+    /* methods without tolerance (e.g., direct) are used as they are */
+    result = fcs_set_tolerance(fcs, FCS_TOLERANCE_TYPE_FIELD, tolerance);
+    if (fcs_result_get_return_code(result) == FCS_ERROR_NOT_IMPLEMENTED)
+    {
+      fcs_result_destroy(result);
+      result = FCS_RESULT_SUCCESS;
+    }
+  }
+  if (result == FCS_RESULT_SUCCESS) result = fcs_set_max_local_particles(fcs, parts->nparticles);
+
+  if (result == FCS_RESULT_SUCCESS)
+  {
+    /* fcs_tune and fcs_run may modify positions and charges, so always work on copies */
+    memcpy(parts->work_positions, parts->positions, 3 * parts->nparticles * sizeof(fcs_float));
+    memcpy(parts->work_charges, parts->charges, parts->nparticles * sizeof(fcs_float));
+
+    MPI_Barrier(comm);
+    t = MPI_Wtime();
+    result = fcs_tune(fcs, parts->nparticles, parts->work_positions, parts->work_charges);
+    MPI_Barrier(comm);
+    res->tune_time = MPI_Wtime() - t;
+  }
+
+  for (i = 0; result == FCS_RESULT_SUCCESS && i < global_params.iterations; ++i)
+  {
+    memcpy(parts->work_positions, parts->positions, 3 * parts->nparticles * sizeof(fcs_float));
+    memcpy(parts->work_charges, parts->charges, parts->nparticles * sizeof(fcs_float));
+
+    MPI_Barrier(comm);
+    t = MPI_Wtime();
+    result = fcs_run(fcs, parts->nparticles, parts->work_positions, parts->work_charges, parts->field, parts->potentials);
+    MPI_Barrier(comm);
+    t = MPI_Wtime() - t;
+
+    res->run_time_avg += t;
+    res->run_time_min = (i == 0)?t:z_min(res->run_time_min, t);
+    res->run_time_max = z_max(res->run_time_max, t);
+
+    if (result == FCS_RESULT_SUCCESS) result = fcs_get_timings(fcs, phases);
+    if (result == FCS_RESULT_SUCCESS)
+    {
+      for (j = 0; j < FCS_NUM_PHASES; ++j) local_phases[j] = phases[j];
+      MPI_Allreduce(MPI_IN_PLACE, local_phases, FCS_NUM_PHASES, MPI_DOUBLE, MPI_MAX, comm);
+      for (j = 0; j < FCS_NUM_PHASES; ++j) res->phases[j] += local_phases[j];
+    }
+  }
+  if (i > 0)
+  {
+    res->run_time_avg /= i;
+    for (j = 0; j < FCS_NUM_PHASES; ++j) res->phases[j] /= i;
+  }
+
+  if (result == FCS_RESULT_SUCCESS && i > 0)
+  {
+    result = fcs_get_counters(fcs, counters);
+    if (result == FCS_RESULT_SUCCESS) MPI_Allreduce(counters, res->counters, FCS_NUM_COUNTERS, MPI_LONG_LONG, MPI_SUM, comm);
+  }
+
+  if (result != FCS_RESULT_SUCCESS) res->status = result_message(result);
+
+  fcs_destroy(fcs);
+
+  return (res->status == "ok");
+}
+
+
+static void json_bench_result(ostream &os, bench_result_t *res)
+{
+  os << "\"status\": " << json_string(res->status) << ", "
+     << "\"tune_time\": " << json_float(res->tune_time) << ", "
+     << "\"run_time\": " << json_float(res->run_time_avg) << ", "
+     << "\"run_time_min\": " << json_float(res->run_time_min) << ", "
+     << "\"run_time_max\": " << json_float(res->run_time_max) << ", "
+     << "\"phases\": { \"tune\": " << json_float(res->tune_time) << ", \"run\": " << json_float(res->run_time_avg);
+  for (fcs_int i = 1; i < FCS_NUM_PHASES; ++i) os << ", " << json_string(fcs_get_phase_name(i)) << ": " << json_float(res->phases[i]);
+  os << " }, \"counters\": { ";
+  for (fcs_int i = 0; i < FCS_NUM_COUNTERS; ++i) os << ((i > 0)?", ":"") << json_string(fcs_get_counter_name(i)) << ": " << res->counters[i];
+  os << " }";
+}
+
+
+static void json_errors(ostream &os, errors_t *err)
+{
+  os << "\"errors\": ";
+  if (!err->have_potential_errors && !err->have_field_errors)
+  {
+    os << "null";
+    return;
+  }
+
+  os << "{ ";
+  if (err->have_field_errors)
+    os << "\"abs_rms_field\": " << json_float(err->abs_rms_field_error) << ", "
+       << "\"abs_max_field\": " << json_float(err->abs_max_field_error) << ", "
+       << "\"rel_rms_field\": " << json_float(err->rel_rms_field_error) << ", ";
+  if (err->have_potential_errors)
+    os << "\"abs_rms_potential\": " << json_float(err->abs_rms_potential_error) << ", "
+       << "\"abs_max_potential\": " << json_float(err->abs_max_potential_error) << ", "
+       << "\"rel_rms_potential\": " << json_float(err->rel_rms_potential_error) << ", "
+       << "\"rel_total_energy\": " << json_float(err->rel_total_energy_error) << ", ";
+  os << "\"total_energy\": " << json_float(err->total_energy) << " }";
+}
+
+
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+
+  communicator = MPI_COMM_WORLD;
+
+  MPI_Comm_rank(communicator, &comm_rank);
+  MPI_Comm_size(communicator, &comm_size);
+
+  /* all processes parse the command line, since it only consists of plain values */
+  parse_commandline(argc, argv);
+
+  ostringstream json;
+  bool first_record = true;
+
+  json << "{" << endl
+       << "  \"benchmark\": \"scafacos_bench\"," << endl
+       << "  \"mpi_processes\": " << comm_size << "," << endl
+       << "  \"iterations\": " << global_params.iterations << "," << endl
+       << "  \"seed\": " << global_params.seed << "," << endl
+       << "  \"results\": [";
+
+  for (size_t ip = 0; ip < global_params.nprocs.size(); ++ip)
+  {
+    int nprocs = global_params.nprocs[ip];
+    int active = (comm_rank < nprocs);
+    MPI_Comm comm;
+
+    MPI_Comm_split(communicator, active?0:MPI_UNDEFINED, comm_rank, &comm);
+
+    if (!active) continue;
+
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    for (size_t iw = 0; iw < global_params.workloads.size(); ++iw)
+    for (size_t in = 0; in < global_params.nparticles.size(); ++in)
+    {
+      Workload workload(global_params.workloads[iw], global_params.nparticles[in], global_params.seed);
+
+      particles_t parts;
+      parts.total_nparticles = workload.get_total_nparticles();
+      parts.nparticles = workload.get_local_nparticles(size, rank);
+      parts.positions = new fcs_float[3 * parts.nparticles];
+      parts.charges = new fcs_float[parts.nparticles];
+      parts.work_positions = new fcs_float[3 * parts.nparticles];
+      parts.work_charges = new fcs_float[parts.nparticles];
+      parts.potentials = new fcs_float[parts.nparticles];
+      parts.field = new fcs_float[3 * parts.nparticles];
+
+      workload.get_local_particles(parts.positions, parts.charges, size, rank);
+
+      const char *workload_name = workload_type::tostr(workload.get_type());
+
+      MASTER(cerr << "Benchmarking workload " << workload_name << " with " << parts.total_nparticles << " particles on " << size << " process(es)" << endl);
+
+      /* reference results */
+      method_spec_t reference = global_params.reference;
+      bench_result_t ref_res;
+      fcs_float *reference_potentials = NULL, *reference_field = NULL;
+
+      if (global_params.have_reference && reference.method.empty())
+      {
+        const char *m = default_reference_method(workload.periodicity);
+        if (m) reference.method = m;
+      }
+
+      if (global_params.have_reference && !reference.method.empty())
+      {
+        MASTER(cerr << "  Computing reference with " << reference.method << "..." << endl);
+
+        if (bench_method(reference, global_params.reference_tolerance, workload, &parts, comm, &ref_res))
+        {
+          reference_potentials = new fcs_float[parts.nparticles];
+          reference_field = new fcs_float[3 * parts.nparticles];
+          memcpy(reference_potentials, parts.potentials, parts.nparticles * sizeof(fcs_float));
+          memcpy(reference_field, parts.field, 3 * parts.nparticles * sizeof(fcs_float));
+
+        } else MASTER(cerr << "  Reference failed: " << ref_res.status << endl);
+      }
+
+      for (size_t im = 0; im < global_params.methods.size(); ++im)
+      for (size_t it = 0; it < global_params.tolerances.size(); ++it)
+      {
+        const method_spec_t &spec = global_params.methods[im];
+        fcs_float tolerance = global_params.tolerances[it];
+        bench_result_t res;
+        errors_t err;
+        fcs_float zero_correction[3] = { 0.0, 0.0, 0.0 };
+
+        MASTER(cerr << "  Running " << spec.method << ((tolerance > 0)?" with tolerance ":"") << ((tolerance > 0)?json_float(tolerance):"") << "..." << endl);
+
+        bool ok = bench_method(spec, tolerance, workload, &parts, comm, &res);
+
+        /* collective on comm, so that also failed runs yield (empty) errors */
+        compute_errors(&err, parts.nparticles, parts.positions, parts.charges,
+          (ok)?reference_potentials:NULL, (ok)?reference_field:NULL,
+          (ok)?parts.potentials:NULL, (ok)?parts.field:NULL,
+          zero_correction, 0.0, comm);
+
+        if (rank == MASTER_RANK)
+        {
+          json << ((first_record)?"":",") << endl << "    { "
+               << "\"nprocs\": " << size << ", "
+               << "\"workload\": " << json_string(workload_name) << ", "
+               << "\"nparticles\": " << parts.total_nparticles << ", "
+               << "\"method\": " << json_string(spec.method) << ", "
+               << "\"configuration\": " << json_string(spec.conf) << ", "
+               << "\"tolerance\": " << ((tolerance > 0)?json_float(tolerance):"null") << ", ";
+          json_bench_result(json, &res);
+          json << ", " << "\"reference\": ";
+          if (reference_field) json << "{ \"method\": " << json_string(reference.method) << ", \"configuration\": " << json_string(reference.conf) << ", \"run_time\": " << json_float(ref_res.run_time_avg) << " }";
+          else json << "null";
+          json << ", ";
+          json_errors(json, &err);
+          json << " }";
+
+          first_record = false;
+        }
+      }
+
+      delete[] reference_potentials;
+      delete[] reference_field;
+
+      delete[] parts.positions;
+      delete[] parts.charges;
+      delete[] parts.work_positions;
+      delete[] parts.work_charges;
+      delete[] parts.potentials;
+      delete[] parts.field;
+    }
+
+    MPI_Comm_free(&comm);
+  }
+
+  json << endl << "  ]" << endl << "}" << endl;
+
+  if (comm_rank == MASTER_RANK)
+  {
+    if (global_params.outfilename.empty()) cout << json.str();
+    else
+    {
+      ofstream out(global_params.outfilename.c_str());
+      out << json.str();
+    }
+  }
+
+  MPI_Finalize();
+
+  return 0;
+}